@@ -117,6 +117,10 @@ struct s_lgknd
   float input_paths_affect;
   float output_paths_affect;
   float depth_source;
+  /* Position in libgate_ptrs/latch_ptrs tracked by the SAT pool, -1 if not pooled */
+  int sat_pool_idx;
+  /* Position in the array scanned by count_lgknds_comb_num */
+  int comb_idx;
   
   /*BLE IDs*/
   int ble_idx;
@@ -116,6 +116,8 @@ void init_lgknd(t_lgknd* lgknd)
   lgknd->input_paths_affect = 0.0;
   lgknd->output_paths_affect = 0.0;
   lgknd->depth_source = 0.0;
+  lgknd->sat_pool_idx = -1;
+  lgknd->comb_idx = -1;
 
   lgknd->ble_idx = -1;
   lgknd->ble_cell_idx = -1;
@@ -345,9 +347,9 @@ int copy_ble_info(t_ble_arch* ble_arch,
   int im;
   int ip;
 
-  /*Initial the destination*/
-  blank_ble_info(ble_arch,des);
-  
+  /* Every field of des is overwritten below, src and des share ble_arch,
+   * so there is no need to blank des first.
+   */
   des->idx = src->idx;
   /*Copy information*/
   /*BLE inputs*/
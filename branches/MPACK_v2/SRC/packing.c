@@ -94,6 +94,9 @@ t_ble_info* pack_BLEs(t_lgkntwk* lgkntwk,
     printf("Info: After packing, estimated critical delay = %.3g\n",lgkntwk->critical_delay);
     printf("Info: After packing, max_slack = %.3g\n",lgkntwk->max_slack);
   } 
+
+  /*Release SAT solver scratch state*/
+  free_sat_scratch(verbose);
   
   return ret;
 }
@@ -107,7 +110,6 @@ int check_all_mapped(t_lgkntwk* lgkntwk,
                      int verbose)
 {
   t_lgknd* head;
-  t_lgknd* tmp;
   //int im;
 
   /*
@@ -134,7 +136,6 @@ int check_all_mapped(t_lgkntwk* lgkntwk,
       } 
       return 1;
     }
-    tmp = head;
     head = head->next;
   }
   
@@ -194,11 +195,13 @@ t_ble_info* sat_pack(t_lgkntwk* lgkntwk,
   int cur_sat_type = 0;
   int ble_num = 0;
   int sat_done = 0;
+  /*Unmapped logic nodes, bucketed by SAT type*/
+  t_sat_pool* sat_pool = alloc_sat_pool(lgkntwk,mpack_opts.pattern_member_type,verbose);
   
   init_ble_info(ble_arch,ret);
 
   /*Packing...*/
-  while(check_all_mapped(lgkntwk,0)) {
+  while(0 < sat_pool->unmapped_num) {
     /*Create a New BLE info, to store packing result*/
     insert_ble_list_node(cur_ble,sizeof(t_ble_info));
     init_ble_info(ble_arch,cur_ble->next);
@@ -227,14 +230,14 @@ t_ble_info* sat_pack(t_lgkntwk* lgkntwk,
          */
         /*Check each logic node has been tried SAT*/
         while(1) {
-          sat_root = pick_sat_lgknd_from_lgkntwk(lgkntwk,
-                                                 cur_sat_type,
-                                                 cur_ble->next,
-                                                 mpack_opts.alpha,
-                                                 mpack_opts.beta,
-                                                 mpack_opts.pattern_member_type,
-                                                 mpack_opts.packer_area_attraction,
-                                                 verbose);
+          sat_root = pick_sat_lgknd_from_sat_pool(sat_pool,
+                                                  lgkntwk,
+                                                  cur_sat_type,
+                                                  cur_ble->next,
+                                                  mpack_opts.alpha,
+                                                  mpack_opts.beta,
+                                                  mpack_opts.packer_area_attraction,
+                                                  verbose);
           if (NULL == sat_root) {
             break;
           }
@@ -253,6 +256,7 @@ t_ble_info* sat_pack(t_lgkntwk* lgkntwk,
             if (1 == verbose) {
               printf("Info:(sat_pack)lgknd(Index:%d) SAT%d mapper success on BLE(Index:%d) cell(Index:%d).\n",sat_root->idx,cur_sat_type,cur_ble->next->idx,cell_idx);
             }
+            update_sat_pool(sat_pool,lgkntwk,cur_ble->next,verbose);
             sat_done = 1;
             break;
           }
@@ -292,9 +296,12 @@ t_ble_info* sat_pack(t_lgkntwk* lgkntwk,
   }
  
   printf("Info: Circuit(%d gates,%d latches) is packed into %d BLEs\n",lgkntwk->libgate_num,lgkntwk->latch_num,ble_num);
+  /*The pool is updated incrementally, it should agree with a full scan*/
+  assert(0 == check_all_mapped(lgkntwk,0));
 
   /*Don't forget free resources*/
   free(blends_tried);
+  free_sat_pool(sat_pool);
 
   return ret;
 }
@@ -2,6 +2,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <assert.h>
+#include <time.h>
 #include "util.h"
 #include "mpack_types.h"
 #include "mpack_conf.h"
@@ -1138,6 +1139,103 @@ int depth_local_router(int sat_lgknd_num,
                      
 
 
+/* Scratch state of the SAT solver.
+ * mini_sat_solver() is called for every candidate root, most of them fail.
+ * Instead of allocating a BLE mirror and a few arrays on every attempt,
+ * they are allocated once per BLE architecture and grown on demand.
+ * ble_info_mirror: working copy of the BLE, swapped with the original on success
+ * lgknds/comb_tmp/comb_nums: sized for sat_lgknds plus logic nodes already in BLE
+ * sat_idxes/logic_equivalent/strict: sized for sat_type+1
+ */
+typedef struct s_sat_scratch t_sat_scratch;
+struct s_sat_scratch
+{
+  t_ble_arch* ble_arch;
+  t_ble_info ble_info_mirror;
+
+  int lgknd_cap;
+  t_lgknd** lgknds;
+  int* comb_tmp;
+  int* comb_nums;
+
+  int sat_cap;
+  int* sat_idxes;
+  int* logic_equivalent;
+  int* strict;
+
+  /* Statistics */
+  int solver_calls;
+  int solver_success;
+  clock_t solver_clocks;
+};
+
+static t_sat_scratch sat_scratch = {NULL};
+
+/* Bind the BLE mirror to ble_arch, allocated only when the architecture changes */
+static t_ble_info* get_sat_scratch_mirror(t_ble_arch* ble_arch)
+{
+  if (ble_arch != sat_scratch.ble_arch) {
+    if (NULL != sat_scratch.ble_arch) {
+      free_ble_info(&sat_scratch.ble_info_mirror);
+    }
+    init_ble_info(ble_arch,&sat_scratch.ble_info_mirror);
+    sat_scratch.ble_arch = ble_arch;
+  }
+  return &sat_scratch.ble_info_mirror;
+}
+
+static void reserve_sat_scratch_lgknds(int lgknd_num)
+{
+  if (lgknd_num > sat_scratch.lgknd_cap) {
+    sat_scratch.lgknd_cap = 2*lgknd_num;
+    sat_scratch.lgknds = (t_lgknd**)my_realloc(sat_scratch.lgknds,sizeof(t_lgknd*)*sat_scratch.lgknd_cap);
+    sat_scratch.comb_tmp = (int*)my_realloc(sat_scratch.comb_tmp,sizeof(int)*sat_scratch.lgknd_cap);
+    sat_scratch.comb_nums = (int*)my_realloc(sat_scratch.comb_nums,sizeof(int)*sat_scratch.lgknd_cap);
+  }
+}
+
+static void reserve_sat_scratch_sat_type(int sat_type)
+{
+  if (sat_type+1 > sat_scratch.sat_cap) {
+    sat_scratch.sat_cap = 2*(sat_type+1);
+    sat_scratch.sat_idxes = (int*)my_realloc(sat_scratch.sat_idxes,sizeof(int)*sat_scratch.sat_cap);
+    sat_scratch.logic_equivalent = (int*)my_realloc(sat_scratch.logic_equivalent,sizeof(int)*sat_scratch.sat_cap);
+    sat_scratch.strict = (int*)my_realloc(sat_scratch.strict,sizeof(int)*sat_scratch.sat_cap);
+  }
+}
+
+/* Commit the mirror: exchange the arrays of des and src, keep des in its list */
+static void swap_ble_info_arrays(t_ble_info* src,
+                                 t_ble_info* des)
+{
+  t_ble_info tmp = (*des);
+
+  (*des) = (*src);
+  des->idx = tmp.idx;
+  des->next = tmp.next;
+  (*src) = tmp;
+}
+
+/* Print SAT solver statistics (when verbose) and release the scratch state */
+void free_sat_scratch(int verbose)
+{
+  if ((1 == verbose)&&(0 < sat_scratch.solver_calls)) {
+    printf("Info: SAT solver called %d times, %d success, %.3g sec.\n",
+           sat_scratch.solver_calls,sat_scratch.solver_success,
+           (float)sat_scratch.solver_clocks/CLOCKS_PER_SEC);
+  }
+  if (NULL != sat_scratch.ble_arch) {
+    free_ble_info(&sat_scratch.ble_info_mirror);
+  }
+  free(sat_scratch.lgknds);
+  free(sat_scratch.comb_tmp);
+  free(sat_scratch.comb_nums);
+  free(sat_scratch.sat_idxes);
+  free(sat_scratch.logic_equivalent);
+  free(sat_scratch.strict);
+  memset(&sat_scratch,0,sizeof(t_sat_scratch));
+}
+
 /* A mini SAT solver, sat_type >= 0
  * ATTENTION: All used BLE cell' outputs/inputs will be mapped as well. This is a killer for run time.
  *            But it can increase resource utilization. 
@@ -1169,17 +1267,16 @@ int mini_sat_solver(int sat_type,
    *         inside BLE. Array include each node to be mapped or already mapped in BLE.
    */
   int* comb_nums = NULL;
-  /* UPDATE: array to flag which cell require remapping inputs
-   */
-  int* remap_cells = NULL;
-  /*Create a local copy*/
-  t_ble_info* ble_info_mirror = (t_ble_info*)my_malloc(sizeof(t_ble_info));
+  /*Local copy, preallocated in the scratch state*/
+  t_ble_info* ble_info_mirror = get_sat_scratch_mirror(ble_arch);
 
-  /*Initial local copy*/
-  init_ble_info(ble_arch,ble_info_mirror);
+  /* A flat copy rather than an undo log: every attempt below frees and re-maps
+   * the inputs of all used cells, so an undo log would record as many writes.
+   */
   copy_ble_info(ble_arch,ble_info,ble_info_mirror);
 
-  comb_nums = (int*)my_malloc(sizeof(int)*(sat_type+1));
+  reserve_sat_scratch_lgknds(sat_type+1+ble_info->blend_num);
+  comb_nums = sat_scratch.comb_nums;
   my_init_int_ary(sat_type+1,comb_nums,0);
 
   /*Determine comb_num*/
@@ -1192,10 +1289,6 @@ int mini_sat_solver(int sat_type,
     if (1 == verbose) {
       printf("Info: (mini_sat_solver)Fail sat_lgknd_output(Cell idx:%d,Logic node idx: %d).\n",sat_idxes[sat_type],sat_lgknds[sat_type]->idx);
     }
-    /*Don't forget free resources*/
-    free(comb_nums);
-    free_ble_info(ble_info_mirror);
-    free(ble_info_mirror);
     return 0;
   }
 
@@ -1209,10 +1302,6 @@ int mini_sat_solver(int sat_type,
       if (1 == verbose) {
         printf("Info: (mini_sat_solver)Fail sat_lgknd_output(Cell idx:%d,Logic node idx: %d).\n",sat_idxes[im],sat_lgknds[im]->idx);
       }
-      /*Don't forget free resources*/
-      free(comb_nums);
-      free_ble_info(ble_info_mirror);
-      free(ble_info_mirror);
       return 0;
     }
   }
@@ -1258,11 +1347,6 @@ int mini_sat_solver(int sat_type,
         if (1 == verbose) {
           printf("Info: (mini_sat_solver)Fail remap sat_lgknd_inputs(Cell idx:%d,Logic node idx: %d).\n",im,ble_info->blend_lgknds[im]->idx);
         }
-        /*Don't forget free resources*/
-        free(remap_cells);
-        free(comb_nums);
-        free_ble_info(ble_info_mirror);
-        free(ble_info_mirror);
         return 0;
       }
       else {
@@ -1302,14 +1386,8 @@ int mini_sat_solver(int sat_type,
   //  }
   //}
   
-  /*Reach here, mapping is a success, copy mirror to orginal*/ 
-  copy_ble_info(ble_arch,ble_info_mirror,ble_info);  
- 
-  /*Don't forget free resources*/
-  free(remap_cells);
-  free(comb_nums);
-  free_ble_info(ble_info_mirror);
-  free(ble_info_mirror);
+  /*Reach here, mapping is a success, the mirror becomes the orginal*/ 
+  swap_ble_info_arrays(ble_info_mirror,ble_info);  
   
   return 1;
 }
@@ -1349,20 +1427,21 @@ int run_sat_solver(t_lgkntwk* lgkntwk,
   int* sat_idxes = NULL; 
   int* logic_equivalent = NULL; 
   int* strict = NULL;
+  int solver_ret;
+  clock_t solver_start;
   /*Create a local copy*/
   //t_ble_info* ble_info_mirror = (t_ble_info*)my_malloc(sizeof(t_ble_info));
 
   int im;
   
-  sat_idxes = (int*)my_malloc(sizeof(int)*(sat_type+1));
+  reserve_sat_scratch_sat_type(sat_type);
+  sat_idxes = sat_scratch.sat_idxes;
 
   /*Initial sat_idxes*/
   my_init_int_ary(sat_type+1,sat_idxes,-1); 
 
   /*Check if BLE has enough resource required...*/
   if (0 == check_sat(sat_type,ble_arch,ble_info,&ble_arch->blends[cell_idx],sat_idxes,0)) {
-    /*Don't forget free resources*/
-    free(sat_idxes);
     return 0;
   }
   /*Fill the cell idx as the "last" element */
@@ -1372,22 +1451,23 @@ int run_sat_solver(t_lgkntwk* lgkntwk,
   //init_ble_info(ble_arch,ble_info_mirror);
   //copy_ble_info(ble_arch,ble_info,ble_info_mirror);
   /*Initial*/
-  logic_equivalent = (int*)my_malloc(sizeof(int)*sat_type+1);
-  strict = (int*)my_malloc(sizeof(int)*sat_type+1);
+  logic_equivalent = sat_scratch.logic_equivalent;
+  strict = sat_scratch.strict;
 
   /*Logic equivalents and strict*/
   my_init_int_ary(sat_type+1,logic_equivalent,1); 
   my_init_int_ary(sat_type+1,strict,1); 
   
   /*Call Mini_SAT_solver*/
-  if (0 == mini_sat_solver(sat_type,lgkntwk,sat_lgknds,sat_idxes,ble_arch,ble_info,logic_equivalent,strict,verbose)) {
+  sat_scratch.solver_calls++;
+  solver_start = clock();
+  solver_ret = mini_sat_solver(sat_type,lgkntwk,sat_lgknds,sat_idxes,ble_arch,ble_info,logic_equivalent,strict,verbose);
+  sat_scratch.solver_clocks += clock() - solver_start;
+  if (0 == solver_ret) {
     sat_lgknds[sat_type]->try_sat = 1;
-    /*Don't forget free resources*/
-    free(logic_equivalent);
-    free(strict);
-    free(sat_idxes);
     return 0;
   } 
+  sat_scratch.solver_success++;
 
   /*SAT success, we should mark these lgknds and latch followers*/
   for (im=0; im<sat_type+1; im++) {
@@ -1414,11 +1494,6 @@ int run_sat_solver(t_lgkntwk* lgkntwk,
       merge_weights_lgkntwk(lgkntwk,alpha,verbose);
     }
   }
-  
-  /*Don't forget free resources*/
-  free(logic_equivalent);
-  free(strict);
-  free(sat_idxes);
 
   return 1;
 }
@@ -1438,12 +1513,18 @@ int count_lgknds_comb_num_ble(t_ble_info* ble_info,
 {
   int used_blend_num = count_used_blend(ble_info,verbose);
   int comb_total = lgknd_num + used_blend_num; 
-  int* comb_tmp = (int*)my_malloc(sizeof(int)*comb_total);
-  t_lgknd** lgknds_tmp = (t_lgknd**)my_malloc(sizeof(t_lgknd*)*comb_total);
+  int* comb_tmp = NULL;
+  t_lgknd** lgknds_tmp = NULL;
 
   int im; 
   int ip;
 
+  /*Scratch arrays, comb_num may already be the scratch comb_nums*/
+  reserve_sat_scratch_lgknds(comb_total);
+  comb_tmp = sat_scratch.comb_tmp;
+  lgknds_tmp = sat_scratch.lgknds;
+  assert(comb_num != comb_tmp);
+
   /* Construct the array containg all logic nodes 
    * (lgknds + lgknds_already_in_ble)
    */ 
@@ -1470,10 +1551,6 @@ int count_lgknds_comb_num_ble(t_ble_info* ble_info,
     comb_num[im] = comb_tmp[im];
   } 
   
-  /*Don't forget free resources*/
-  free(comb_tmp);
-  free(lgknds_tmp);
-
   return 1;
 }
 
@@ -1482,6 +1559,7 @@ int count_lgknds_comb_num_ble(t_ble_info* ble_info,
  * IMPORTANT: 1. COMBINATIONAL ONLY!
  *            2. We DON'T malloc comb_num in this function. Do it before called.
  *               The length should equal to lgknd_num.
+ *            3. Logic nodes in lgknds should be unique.
  */
 int count_lgknds_comb_num(int lgknd_num,
                           t_lgknd** lgknds,
@@ -1495,16 +1573,20 @@ int count_lgknds_comb_num(int lgknd_num,
   /*Initial array comb_num*/
   my_init_int_ary(lgknd_num,comb_num,0);
 
+  /*Index each logic node by its position, stale indexes are rejected below*/
+  for (ind1=0; ind1<lgknd_num; ind1++) {
+    lgknds[ind1]->comb_idx = ind1;
+  }
+
   /* Search each predecessor of lgknds[i] for connections,
    * If exist connections, increase the counter of predecessors.
    * Important: we only search the nodes which sat_idxes is smaller than current node
    */
   for (ind1=0; ind1<lgknd_num; ind1++) {
     for (im=0; im<lgknds[ind1]->input_num; im++) {
-      for (ind2=0; ind2<lgknd_num; ind2++) {
-        if ((lgknds[ind2] == lgknds[ind1]->inputs[im])&&(ind1 > ind2)) {
-          comb_num[ind2]++; 
-        }
+      ind2 = lgknds[ind1]->inputs[im]->comb_idx;
+      if ((ind2 > -1)&&(ind2 < ind1)&&(lgknds[ind2] == lgknds[ind1]->inputs[im])) {
+        comb_num[ind2]++; 
       }
     } 
   }
@@ -2275,6 +2357,386 @@ t_lgknd* pick_sat_lgknd_from_lgkntwk(t_lgkntwk* lgkntwk,
   return ret; 
 }
 
+/* Compare libgate positions, used to keep pool buckets in libgate order */
+static int compare_sat_pool_pos(const void* a,
+                                const void* b)
+{
+  return (*(const int*)a) - (*(const int*)b);
+}
+
+/* Make sure the pool buckets cover SAT type [0..sat_type] */
+static void sat_pool_grow_buckets(t_sat_pool* sat_pool,
+                                  int sat_type)
+{
+  int i;
+  int num = sat_type + 1;
+
+  if (sat_type <= sat_pool->max_sat_type) {
+    return;
+  }
+  sat_pool->buckets = (int**)my_realloc(sat_pool->buckets,num*sizeof(int*));
+  sat_pool->bucket_sizes = (int*)my_realloc(sat_pool->bucket_sizes,num*sizeof(int));
+  sat_pool->bucket_caps = (int*)my_realloc(sat_pool->bucket_caps,num*sizeof(int));
+  sat_pool->bucket_sorted = (int*)my_realloc(sat_pool->bucket_sorted,num*sizeof(int));
+  for (i=sat_pool->max_sat_type+1; i<num; i++) {
+    sat_pool->buckets[i] = NULL;
+    sat_pool->bucket_sizes[i] = 0;
+    sat_pool->bucket_caps[i] = 0;
+    sat_pool->bucket_sorted[i] = 1;
+  }
+  sat_pool->max_sat_type = sat_type;
+}
+
+static void sat_pool_bucket_insert(t_sat_pool* sat_pool,
+                                   int pos,
+                                   int sat_type)
+{
+  int size;
+
+  sat_pool_grow_buckets(sat_pool,sat_type);
+  size = sat_pool->bucket_sizes[sat_type];
+  if (size == sat_pool->bucket_caps[sat_type]) {
+    sat_pool->bucket_caps[sat_type] = 2*size + 4;
+    sat_pool->buckets[sat_type] = (int*)my_realloc(sat_pool->buckets[sat_type],sat_pool->bucket_caps[sat_type]*sizeof(int));
+  }
+  if ((size > 0)&&(pos < sat_pool->buckets[sat_type][size-1])) {
+    sat_pool->bucket_sorted[sat_type] = 0;
+  }
+  sat_pool->buckets[sat_type][size] = pos;
+  sat_pool->bucket_pos[pos] = size;
+  sat_pool->bucket_sizes[sat_type]++;
+  sat_pool->sat_types[pos] = sat_type;
+}
+
+/* Swap-remove a libgate from its bucket, the order is restored lazily */
+static void sat_pool_bucket_remove(t_sat_pool* sat_pool,
+                                   int pos)
+{
+  int sat_type = sat_pool->sat_types[pos];
+  int last;
+
+  assert(-1 != sat_type);
+  last = sat_pool->bucket_sizes[sat_type] - 1;
+  if (sat_pool->bucket_pos[pos] != last) {
+    sat_pool->buckets[sat_type][sat_pool->bucket_pos[pos]] = sat_pool->buckets[sat_type][last];
+    sat_pool->bucket_pos[sat_pool->buckets[sat_type][last]] = sat_pool->bucket_pos[pos];
+    sat_pool->bucket_sorted[sat_type] = 0;
+  }
+  sat_pool->bucket_sizes[sat_type]--;
+  sat_pool->bucket_pos[pos] = -1;
+  sat_pool->sat_types[pos] = -1;
+}
+
+/* Return the libgate position of lgknd if it is still pooled, -1 otherwise */
+static int sat_pool_libgate_pos(t_sat_pool* sat_pool,
+                                t_lgkntwk* lgkntwk,
+                                t_lgknd* lgknd)
+{
+  int pos = lgknd->sat_pool_idx;
+
+  if ((ND_LATCH == lgknd->type)||(ND_PI == lgknd->type)||(ND_PO == lgknd->type)) {
+    return -1;
+  }
+  if ((pos < 0)||(pos >= sat_pool->libgate_num)||(lgknd != lgkntwk->libgate_ptrs[pos])) {
+    return -1;
+  }
+  if (-1 == sat_pool->sat_types[pos]) {
+    return -1;
+  }
+  return pos;
+}
+
+/* Re-evaluate the SAT type of a pooled libgate and move it to the right bucket */
+static void sat_pool_refresh_lgknd(t_sat_pool* sat_pool,
+                                   t_lgkntwk* lgkntwk,
+                                   t_lgknd* lgknd,
+                                   int verbose)
+{
+  int pos = sat_pool_libgate_pos(sat_pool,lgkntwk,lgknd);
+  int sat_type;
+
+  if (-1 == pos) {
+    return;
+  }
+  sat_type = lgknds_sat_type(lgknd,NULL,0,sat_pool->pattern_member_type,verbose);
+  if (sat_type != sat_pool->sat_types[pos]) {
+    sat_pool_bucket_remove(sat_pool,pos);
+    sat_pool_bucket_insert(sat_pool,pos,sat_type);
+  }
+}
+
+/* The SAT type of a libgate depends on its predecessors and on the
+ * predecessors of the latches driving it. Refresh these fanouts of lgknd.
+ */
+static void sat_pool_refresh_fanouts(t_sat_pool* sat_pool,
+                                     t_lgkntwk* lgkntwk,
+                                     t_lgknd* lgknd,
+                                     int verbose)
+{
+  int im;
+  int ip;
+
+  for (im=0; im<lgknd->output_num; im++) {
+    if (ND_LATCH == lgknd->outputs[im]->type) {
+      for (ip=0; ip<lgknd->outputs[im]->output_num; ip++) {
+        sat_pool_refresh_lgknd(sat_pool,lgkntwk,lgknd->outputs[im]->outputs[ip],verbose);
+      }
+    } else {
+      sat_pool_refresh_lgknd(sat_pool,lgkntwk,lgknd->outputs[im],verbose);
+    }
+  }
+}
+
+/* Pool the libgates/latches appended to lgkntwk since the last call.
+ * Buffers inserted by mark_lgknd_outputs_mapped() reach the pool here.
+ */
+static void sat_pool_add_new_lgknds(t_sat_pool* sat_pool,
+                                    t_lgkntwk* lgkntwk,
+                                    int verbose)
+{
+  int im;
+  int first_new = sat_pool->libgate_num;
+  t_lgknd* lgknd;
+
+  if (lgkntwk->libgate_num > sat_pool->libgate_num) {
+    sat_pool->sat_types = (int*)my_realloc(sat_pool->sat_types,lgkntwk->libgate_num*sizeof(int));
+    sat_pool->bucket_pos = (int*)my_realloc(sat_pool->bucket_pos,lgkntwk->libgate_num*sizeof(int));
+    sat_pool->weight_stamps = (int*)my_realloc(sat_pool->weight_stamps,lgkntwk->libgate_num*sizeof(int));
+    sat_pool->weights = (float*)my_realloc(sat_pool->weights,lgkntwk->libgate_num*sizeof(float));
+    sat_pool->paths_affects = (float*)my_realloc(sat_pool->paths_affects,lgkntwk->libgate_num*sizeof(float));
+    for (im=first_new; im<lgkntwk->libgate_num; im++) {
+      lgknd = lgkntwk->libgate_ptrs[im];
+      lgknd->sat_pool_idx = im;
+      sat_pool->sat_types[im] = -1;
+      sat_pool->bucket_pos[im] = -1;
+      sat_pool->weight_stamps[im] = -1;
+      sat_pool->weights[im] = -1.0;
+      sat_pool->paths_affects[im] = 0.0;
+      if (0 == lgknd->mapped) {
+        sat_pool_bucket_insert(sat_pool,im,lgknds_sat_type(lgknd,NULL,0,sat_pool->pattern_member_type,verbose));
+      }
+      if (1 != lgknd->mapped) {
+        sat_pool->unmapped_num++;
+      }
+    }
+    sat_pool->libgate_num = lgkntwk->libgate_num;
+    /*A new buffer takes the place of its predecessor for the latch it drives*/
+    for (im=first_new; im<lgkntwk->libgate_num; im++) {
+      sat_pool_refresh_fanouts(sat_pool,lgkntwk,lgkntwk->libgate_ptrs[im],verbose);
+    }
+  }
+
+  if (lgkntwk->latch_num > sat_pool->latch_num) {
+    sat_pool->latch_pooled = (int*)my_realloc(sat_pool->latch_pooled,lgkntwk->latch_num*sizeof(int));
+    for (im=sat_pool->latch_num; im<lgkntwk->latch_num; im++) {
+      lgknd = lgkntwk->latch_ptrs[im];
+      lgknd->sat_pool_idx = im;
+      sat_pool->latch_pooled[im] = 0;
+      if (1 != lgknd->mapped) {
+        sat_pool->latch_pooled[im] = 1;
+        sat_pool->unmapped_num++;
+      }
+    }
+    sat_pool->latch_num = lgkntwk->latch_num;
+  }
+}
+
+/* Build the pool of unmapped libgates and latches for sat_pack */
+t_sat_pool* alloc_sat_pool(t_lgkntwk* lgkntwk,
+                           enum e_pattern_member_type pattern_member_type,
+                           int verbose)
+{
+  t_sat_pool* sat_pool = (t_sat_pool*)my_malloc(sizeof(t_sat_pool));
+
+  sat_pool->pattern_member_type = pattern_member_type;
+  sat_pool->libgate_num = 0;
+  sat_pool->latch_num = 0;
+  sat_pool->unmapped_num = 0;
+  sat_pool->sat_types = NULL;
+  sat_pool->bucket_pos = NULL;
+  sat_pool->latch_pooled = NULL;
+  sat_pool->max_sat_type = -1;
+  sat_pool->buckets = NULL;
+  sat_pool->bucket_sizes = NULL;
+  sat_pool->bucket_caps = NULL;
+  sat_pool->bucket_sorted = NULL;
+  sat_pool->ble_info = NULL;
+  sat_pool->stamp = 0;
+  sat_pool->weight_stamps = NULL;
+  sat_pool->weights = NULL;
+  sat_pool->paths_affects = NULL;
+  sat_pool->org_weight = -1.0;
+  sat_pool->org_weight_stamp = -1;
+
+  sat_pool_add_new_lgknds(sat_pool,lgkntwk,verbose);
+
+  return sat_pool;
+}
+
+/* Update the pool after a successful sat_mapper on ble_info.
+ * Every logic node mapped by the SAT solver lands in ble_info, either
+ * in a BLE cell or as a latched output, so only those are visited.
+ */
+void update_sat_pool(t_sat_pool* sat_pool,
+                     t_lgkntwk* lgkntwk,
+                     t_ble_info* ble_info,
+                     int verbose)
+{
+  int im;
+  int pos;
+  t_lgknd* lgknd;
+
+  /*Remove newly mapped nodes first, SAT types depend on all of them*/
+  for (im=0; im<ble_info->blend_num; im++) {
+    if (1 != ble_info->blend_used[im]) {
+      continue;
+    }
+    pos = sat_pool_libgate_pos(sat_pool,lgkntwk,ble_info->blend_lgknds[im]);
+    if ((-1 != pos)&&(1 == ble_info->blend_lgknds[im]->mapped)) {
+      sat_pool_bucket_remove(sat_pool,pos);
+      sat_pool->unmapped_num--;
+    }
+  }
+  for (im=0; im<ble_info->output_num; im++) {
+    if ((1 != ble_info->output_used[im])||(NULL == ble_info->output_lgknds[im])) {
+      continue;
+    }
+    lgknd = ble_info->output_lgknds[im];
+    pos = lgknd->sat_pool_idx;
+    if ((ND_LATCH == lgknd->type)&&(pos >= 0)&&(pos < sat_pool->latch_num)
+       &&(lgknd == lgkntwk->latch_ptrs[pos])&&(1 == sat_pool->latch_pooled[pos])&&(1 == lgknd->mapped)) {
+      sat_pool->latch_pooled[pos] = 0;
+      sat_pool->unmapped_num--;
+    }
+  }
+
+  /*New buffers may have been inserted before unmapped latches*/
+  sat_pool_add_new_lgknds(sat_pool,lgkntwk,verbose);
+
+  /*Refresh the neighbours of the nodes in this BLE*/
+  for (im=0; im<ble_info->blend_num; im++) {
+    if (1 == ble_info->blend_used[im]) {
+      sat_pool_refresh_fanouts(sat_pool,lgkntwk,ble_info->blend_lgknds[im],verbose);
+    }
+  }
+
+  /*BLE contents and network weights changed, invalidate attraction cache*/
+  sat_pool->stamp++;
+}
+
+void free_sat_pool(t_sat_pool* sat_pool)
+{
+  int i;
+
+  for (i=0; i<sat_pool->max_sat_type+1; i++) {
+    free(sat_pool->buckets[i]);
+  }
+  free(sat_pool->buckets);
+  free(sat_pool->bucket_sizes);
+  free(sat_pool->bucket_caps);
+  free(sat_pool->bucket_sorted);
+  free(sat_pool->sat_types);
+  free(sat_pool->bucket_pos);
+  free(sat_pool->latch_pooled);
+  free(sat_pool->weight_stamps);
+  free(sat_pool->weights);
+  free(sat_pool->paths_affects);
+  free(sat_pool);
+}
+
+/* Same selection as pick_sat_lgknd_from_lgkntwk, but only visits the
+ * pooled libgates of the requested SAT type, in libgate order so that
+ * ties are broken identically. Attraction weights are reused until
+ * the BLE changes, a failed SAT attempt does not touch them.
+ */
+t_lgknd* pick_sat_lgknd_from_sat_pool(t_sat_pool* sat_pool,
+                                      t_lgkntwk* lgkntwk,
+                                      int sat_type,
+                                      t_ble_info* ble_info,
+                                      float alpha,
+                                      float beta,
+                                      enum e_packer_area_attraction packer_area_attraction,
+                                      int verbose)
+{
+  int im; 
+  int pos;
+  int* bucket;
+  float ble_average_weight = -1.0;
+  float ble_org_average_weight = -1.0;
+  float average_weight = -1.0;
+  float paths_affect = 0.0;
+  float temp_paths_affect = 0.0;
+  t_lgknd** sat_lgknds = NULL;
+  t_lgknd* cur;
+  t_lgknd* ret = NULL;
+
+  if ((sat_type > sat_pool->max_sat_type)||(0 == sat_pool->bucket_sizes[sat_type])) {
+    return NULL;
+  }
+  
+  /*A new BLE invalidates cached weights*/
+  if (ble_info != sat_pool->ble_info) {
+    sat_pool->ble_info = ble_info;
+    sat_pool->stamp++;
+  }
+  if (sat_pool->org_weight_stamp != sat_pool->stamp) {
+    sat_pool->org_weight = sat_lgknds_ble_average_weight(0,NULL,ble_info,alpha,beta,packer_area_attraction,&temp_paths_affect,verbose);
+    sat_pool->org_weight_stamp = sat_pool->stamp;
+  }
+  ble_org_average_weight = sat_pool->org_weight;
+
+  /*Restore libgate order in bucket*/
+  bucket = sat_pool->buckets[sat_type];
+  if (0 == sat_pool->bucket_sorted[sat_type]) {
+    qsort(bucket,sat_pool->bucket_sizes[sat_type],sizeof(int),compare_sat_pool_pos);
+    for (im=0; im<sat_pool->bucket_sizes[sat_type]; im++) {
+      sat_pool->bucket_pos[bucket[im]] = im;
+    }
+    sat_pool->bucket_sorted[sat_type] = 1;
+  }
+
+  for (im=0; im<sat_pool->bucket_sizes[sat_type]; im++) {
+    pos = bucket[im];
+    cur = lgkntwk->libgate_ptrs[pos];
+    assert(0 == cur->mapped);
+    if (0 != cur->try_sat) {
+      continue;
+    }
+    if (sat_pool->weight_stamps[pos] != sat_pool->stamp) {
+      if (NULL == sat_lgknds) {
+        sat_lgknds = (t_lgknd**)my_malloc(sizeof(t_lgknd*)*(sat_type+1));
+      }
+      // Copy sat_lgknds
+      lgknds_sat_type(cur,sat_lgknds,1,sat_pool->pattern_member_type,verbose); 
+      sat_lgknds[sat_type] = cur;
+      sat_pool->weights[pos] = sat_lgknds_ble_average_weight(sat_type+1,sat_lgknds,ble_info,alpha,beta,packer_area_attraction,&temp_paths_affect,verbose);
+      sat_pool->paths_affects[pos] = temp_paths_affect;
+      sat_pool->weight_stamps[pos] = sat_pool->stamp;
+    }
+    average_weight = sat_pool->weights[pos];
+    temp_paths_affect = sat_pool->paths_affects[pos];
+    if (-1.0 == average_weight) {
+      continue;
+    }
+    if (ble_average_weight < average_weight) {
+      ble_average_weight = average_weight;
+      paths_affect = temp_paths_affect; 
+      ret = cur;
+    } else if (ble_average_weight == average_weight) {
+      if ((0.0 != ble_org_average_weight)&&(-1.0 != ble_org_average_weight)&&((temp_paths_affect > paths_affect)||(temp_paths_affect == paths_affect))) {
+        ble_average_weight = average_weight;
+        paths_affect = temp_paths_affect; 
+        ret = cur;
+      } 
+    }
+  }
+
+  /*Don't forget free resources*/
+  free(sat_lgknds); 
+
+  return ret; 
+}
+
 int determine_unused_blend_num(t_ble_arch* ble_arch,
                                t_ble_info* ble_info,
                                int verbose) {
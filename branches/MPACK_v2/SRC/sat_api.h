@@ -1,3 +1,47 @@
+/**
+ * Pool of unmapped logic nodes used by sat_pack.
+ * Libgates are bucketed by the SAT type returned by lgknds_sat_type(),
+ * so picking a root only visits candidates of the requested type.
+ * The SAT type of a libgate only changes when one of its predecessors
+ * (or the predecessor of a latch driving it) gets mapped, so buckets are
+ * updated for the neighbours of newly mapped nodes only.
+ * Attraction weights are cached per candidate and stay valid until
+ * the BLE under construction changes (stamp).
+ * libgate_num/latch_num: number of libgate_ptrs/latch_ptrs already seen
+ * unmapped_num: unmapped libgates and latches, check_all_mapped() in O(1)
+ * sat_types: SAT type of each pooled libgate, -1 if mapped
+ * bucket_pos: position of each pooled libgate in its bucket
+ * buckets: libgate positions per SAT type [0..max_sat_type]
+ */
+typedef struct s_sat_pool t_sat_pool;
+struct s_sat_pool
+{
+  enum e_pattern_member_type pattern_member_type;
+
+  int libgate_num;
+  int latch_num;
+  int unmapped_num;
+
+  int* sat_types;
+  int* bucket_pos;
+  int* latch_pooled;
+
+  int max_sat_type;
+  int** buckets;
+  int* bucket_sizes;
+  int* bucket_caps;
+  int* bucket_sorted;
+
+  /* Attraction cache */
+  t_ble_info* ble_info;
+  int stamp;
+  int* weight_stamps;
+  float* weights;
+  float* paths_affects;
+  float org_weight;
+  int org_weight_stamp;
+};
+
 
 int count_used_ble_outputs(t_ble_info* ble_info,
                            int verbose);
@@ -72,6 +116,8 @@ int mark_lgknd_outputs_mapped(t_lgkntwk* lgkntwk,
                               int add_buf,
                               t_ble_info* ble_info);
 
+void free_sat_scratch(int verbose);
+
 int mini_sat_solver(int sat_type,
                     t_lgkntwk* lgkntwk,
                     t_lgknd** sat_lgknds,
@@ -175,6 +221,26 @@ t_lgknd* pick_sat_lgknd_from_lgkntwk(t_lgkntwk* lgkntwk,
                                      enum e_packer_area_attraction packer_area_attraction,
                                      int verbose);
 
+t_sat_pool* alloc_sat_pool(t_lgkntwk* lgkntwk,
+                           enum e_pattern_member_type pattern_member_type,
+                           int verbose);
+
+void update_sat_pool(t_sat_pool* sat_pool,
+                     t_lgkntwk* lgkntwk,
+                     t_ble_info* ble_info,
+                     int verbose);
+
+void free_sat_pool(t_sat_pool* sat_pool);
+
+t_lgknd* pick_sat_lgknd_from_sat_pool(t_sat_pool* sat_pool,
+                                      t_lgkntwk* lgkntwk,
+                                      int sat_type,
+                                      t_ble_info* ble_info,
+                                      float alpha,
+                                      float beta,
+                                      enum e_packer_area_attraction packer_area_attraction,
+                                      int verbose);
+
 int subgraph_legality_check(int num,
                             t_lgknd** subgraph,
                             t_ble_info* ble_info,
@@ -7,11 +7,35 @@ namespace blifparse {
 
 std::string escape_string(const std::string& near_text);
 
+static std::string format_error_msg(const char* fmt, va_list args);
+
 //We wrap the actual blif_error to issolate custom handlers from vaargs
 void blif_error_wrap(Callback& callback, const int line_no, const std::string& near_text, const char* fmt, ...) {
     va_list args;
     va_start(args, fmt);
+    std::string msg = format_error_msg(fmt, args);
+    va_end(args); //Clean-up
+
+    //TODO: escape near_text
+    std::string escaped_near_text = escape_string(near_text);
+
+    //Call the error handler
+    callback.parse_error(line_no, escaped_near_text, msg);
+}
+
+void blif_error_wrap(ViewCallback& callback, const int line_no, const std::string& near_text, const char* fmt, ...) {
+    va_list args;
+    va_start(args, fmt);
+    std::string msg = format_error_msg(fmt, args);
+    va_end(args); //Clean-up
 
+    std::string escaped_near_text = escape_string(near_text);
+
+    //Call the error handler
+    callback.parse_error(line_no, escaped_near_text, msg);
+}
+
+static std::string format_error_msg(const char* fmt, va_list args) {
     //We need to copy the args so we don't change them before the true formating
     va_list args_copy;
     va_copy(args_copy, args);
@@ -33,19 +57,11 @@ void blif_error_wrap(Callback& callback, const int line_no, const std::string& n
     //Format into the buffer using the original args
     len = std::vsnprintf(buf.get(), buf_size, fmt, args);
 
-    va_end(args); //Clean-up
-
     assert(len >= 0 && "Problem decoding format string");
     assert(static_cast<size_t>(len) == buf_size - 1);
 
     //Build the string from the buffer
-    std::string msg(buf.get(), len);
-
-    //TODO: escape near_text
-    std::string escaped_near_text = escape_string(near_text);
-
-    //Call the error handler
-    callback.parse_error(line_no, escaped_near_text, msg);
+    return std::string(buf.get(), len);
 }
 
 std::string escape_string(const std::string& near_text) {
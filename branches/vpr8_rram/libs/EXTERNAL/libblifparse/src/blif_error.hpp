@@ -5,5 +5,6 @@
 namespace blifparse {
 
     void blif_error_wrap(Callback& callback, const int line_no, const std::string& near_text, const char* fmt, ...);
+    void blif_error_wrap(ViewCallback& callback, const int line_no, const std::string& near_text, const char* fmt, ...);
 }
 #endif
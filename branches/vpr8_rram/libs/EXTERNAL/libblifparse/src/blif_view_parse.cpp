@@ -0,0 +1,579 @@
+/*
+ * Zero-copy BLIF parser
+ *
+ * A hand-written, line oriented parser which accepts the same BLIF (and
+ * extended BLIF) as the flex/bison parser, but works directly on an
+ * in-memory buffer (typically a memory-mapped file).
+ *
+ * Tokens never span lines (a line continuation can only occur between
+ * tokens), so every token is handed to the callback as a StringView
+ * into the buffer.  The token and cover storage is re-used between
+ * statements, so parsing performs no per-token heap allocations.
+ */
+#include <cstdio>
+#include <cassert>
+
+#ifdef _WIN32
+#include <vector>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "blifparse.hpp"
+#include "blif_error.hpp"
+
+namespace blifparse {
+
+//.conn [Extended BLIF]
+void ViewCallback::conn(StringView /*src*/, StringView /*dst*/) {
+    parse_error(-1, ".conn", "Unsupported BLIF extension");
+}
+
+//.cname [Extended BLIF]
+void ViewCallback::cname(StringView /*cell_name*/) {
+    parse_error(-1, ".cname", "Unsupported BLIF extension");
+}
+
+//.attr [Extended BLIF]
+void ViewCallback::attr(StringView /*name*/, StringView /*value*/) {
+    parse_error(-1, ".attr", "Unsupported BLIF extension");
+}
+
+//.param [Extended BLIF]
+void ViewCallback::param(StringView /*name*/, StringView /*value*/) {
+    parse_error(-1, ".param", "Unsupported BLIF extension");
+}
+
+std::vector<LogicValue> SopCover::row(size_t irow) const {
+    std::vector<LogicValue> row_values;
+    row_values.reserve(num_cols_);
+    for(size_t icol = 0; icol < num_cols_; ++icol) {
+        row_values.push_back(value(irow, icol));
+    }
+    return row_values;
+}
+
+/*
+ * CallbackAdapter
+ */
+static std::vector<std::string> to_strings(const std::vector<StringView>& views) {
+    std::vector<std::string> strs;
+    strs.reserve(views.size());
+    for(StringView view : views) {
+        strs.push_back(view.str());
+    }
+    return strs;
+}
+
+void CallbackAdapter::start_parse() { callback_.start_parse(); }
+void CallbackAdapter::filename(StringView fname) { callback_.filename(fname.str()); }
+void CallbackAdapter::lineno(int line_num) { callback_.lineno(line_num); }
+void CallbackAdapter::begin_model(StringView model_name) { callback_.begin_model(model_name.str()); }
+void CallbackAdapter::inputs(const std::vector<StringView>& inputs) { callback_.inputs(to_strings(inputs)); }
+void CallbackAdapter::outputs(const std::vector<StringView>& outputs) { callback_.outputs(to_strings(outputs)); }
+
+void CallbackAdapter::names(const std::vector<StringView>& nets, const SopCover& so_cover) {
+    std::vector<std::vector<LogicValue>> rows;
+    rows.reserve(so_cover.num_rows());
+    for(size_t irow = 0; irow < so_cover.num_rows(); ++irow) {
+        rows.push_back(so_cover.row(irow));
+    }
+    callback_.names(to_strings(nets), std::move(rows));
+}
+
+void CallbackAdapter::latch(StringView input, StringView output, LatchType type, StringView control, LogicValue init) {
+    callback_.latch(input.str(), output.str(), type, control.str(), init);
+}
+
+void CallbackAdapter::subckt(StringView model, const std::vector<StringView>& ports, const std::vector<StringView>& nets) {
+    callback_.subckt(model.str(), to_strings(ports), to_strings(nets));
+}
+
+void CallbackAdapter::blackbox() { callback_.blackbox(); }
+void CallbackAdapter::end_model() { callback_.end_model(); }
+void CallbackAdapter::conn(StringView src, StringView dst) { callback_.conn(src.str(), dst.str()); }
+void CallbackAdapter::cname(StringView cell_name) { callback_.cname(cell_name.str()); }
+void CallbackAdapter::attr(StringView name, StringView value) { callback_.attr(name.str(), value.str()); }
+void CallbackAdapter::param(StringView name, StringView value) { callback_.param(name.str(), value.str()); }
+void CallbackAdapter::finish_parse() { callback_.finish_parse(); }
+
+void CallbackAdapter::parse_error(const int curr_lineno, const std::string& near_text, const std::string& msg) {
+    callback_.parse_error(curr_lineno, near_text, msg);
+}
+
+/*
+ * The parser
+ */
+namespace {
+
+class ViewParser {
+    public:
+        ViewParser(const char* data, size_t size, ViewCallback& callback)
+            : curr_(data)
+            , end_(data + size)
+            , callback_(callback) {}
+
+        void parse() {
+            while(skip_blank_lines()) {
+                if(!read_statement(tokens_)) {
+                    continue;
+                }
+                if(tokens_.empty()) {
+                    continue;
+                }
+
+                StringView directive = tokens_[0];
+                if(directive == ".names") {
+                    parse_names();
+                } else if(directive == ".model") {
+                    if(expect_num_args(directive, 1, 1)) {
+                        callback_.lineno(stmt_lineno_);
+                        callback_.begin_model(tokens_[1]);
+                    }
+                } else if(directive == ".inputs") {
+                    args_.assign(tokens_.begin() + 1, tokens_.end());
+                    callback_.lineno(stmt_lineno_);
+                    callback_.inputs(args_);
+                } else if(directive == ".outputs") {
+                    args_.assign(tokens_.begin() + 1, tokens_.end());
+                    callback_.lineno(stmt_lineno_);
+                    callback_.outputs(args_);
+                } else if(directive == ".latch") {
+                    parse_latch();
+                } else if(directive == ".subckt") {
+                    parse_subckt();
+                } else if(directive == ".blackbox") {
+                    if(expect_num_args(directive, 0, 0)) {
+                        callback_.lineno(stmt_lineno_);
+                        callback_.blackbox();
+                    }
+                } else if(directive == ".end") {
+                    if(expect_num_args(directive, 0, 0)) {
+                        callback_.lineno(stmt_lineno_);
+                        callback_.end_model();
+                    }
+                } else if(directive == ".conn") {
+                    if(expect_num_args(directive, 2, 2)) {
+                        callback_.lineno(stmt_lineno_);
+                        callback_.conn(tokens_[1], tokens_[2]);
+                    }
+                } else if(directive == ".cname") {
+                    if(expect_num_args(directive, 1, 1)) {
+                        callback_.lineno(stmt_lineno_);
+                        callback_.cname(tokens_[1]);
+                    }
+                } else if(directive == ".attr") {
+                    if(expect_num_args(directive, 1, 2)) {
+                        callback_.lineno(stmt_lineno_);
+                        callback_.attr(tokens_[1], (tokens_.size() > 2) ? tokens_[2] : StringView());
+                    }
+                } else if(directive == ".param") {
+                    if(expect_num_args(directive, 1, 2)) {
+                        callback_.lineno(stmt_lineno_);
+                        callback_.param(tokens_[1], (tokens_.size() > 2) ? tokens_[2] : StringView());
+                    }
+                } else {
+                    error(stmt_lineno_, directive, "syntax error, unexpected '%s'", directive.str().c_str());
+                }
+            }
+        }
+
+    private:
+        /*
+         * Statements
+         */
+        void parse_names() {
+            args_.assign(tokens_.begin() + 1, tokens_.end());
+            int names_lineno = stmt_lineno_;
+
+            //The single-output cover rows follow on the next lines,
+            //each starting with a logic value
+            cover_.reset(args_.size());
+            while(skip_blank_lines() && is_logic_value(*curr_)) {
+                if(!read_cover_row()) {
+                    cover_.drop_row();
+                    continue;
+                }
+                if(cover_.curr_row_size() != args_.size()) {
+                    error(stmt_lineno_, StringView(), "Mismatched .names single-output cover row."
+                                        " names connected to %zu net(s), but cover row has %zu element(s)",
+                                        args_.size(), cover_.curr_row_size());
+                    cover_.drop_row();
+                    continue;
+                }
+                cover_.end_row();
+                names_lineno = stmt_lineno_;
+            }
+
+            callback_.lineno(names_lineno);
+            callback_.names(args_, cover_);
+        }
+
+        void parse_latch() {
+            //.latch <input> <output> [<type> <control>] [<init-val>]
+            if(!expect_num_args(tokens_[0], 2, 5)) return;
+
+            StringView control;
+            LatchType type = LatchType::UNSPECIFIED;
+            LogicValue init = LogicValue::UNKOWN;
+
+            size_t num_args = tokens_.size() - 1;
+            if(num_args >= 4) {
+                if(!to_latch_type(tokens_[3], type)) {
+                    error(stmt_lineno_, tokens_[3], "syntax error, unexpected '%s', expecting latch type", tokens_[3].str().c_str());
+                    return;
+                }
+                if(tokens_[4] != "NIL") {
+                    control = tokens_[4];
+                }
+            }
+            if(num_args == 3 || num_args == 5) {
+                StringView init_token = tokens_[num_args];
+                if(!to_latch_init(init_token, init)) {
+                    error(stmt_lineno_, init_token, "syntax error, unexpected '%s', expecting latch initial value", init_token.str().c_str());
+                    return;
+                }
+            }
+
+            callback_.lineno(stmt_lineno_);
+            callback_.latch(tokens_[1], tokens_[2], type, control, init);
+        }
+
+        void parse_subckt() {
+            //.subckt <model> <port>=<net> ...
+            if(tokens_.size() < 2) {
+                error(stmt_lineno_, tokens_[0], "syntax error, expecting subckt model");
+                return;
+            }
+
+            ports_.clear();
+            nets_.clear();
+            size_t i = 2;
+            while(i < tokens_.size()) {
+                if(i + 2 >= tokens_.size() || tokens_[i] == "=" || tokens_[i + 1] != "=" || tokens_[i + 2] == "=") {
+                    break;
+                }
+                ports_.push_back(tokens_[i]);
+                nets_.push_back(tokens_[i + 2]);
+                i += 3;
+            }
+
+            if(i != tokens_.size()) {
+                error(stmt_lineno_, tokens_[i], "Mismatched subckt port and net connection(s) size do not match"
+                                  " (%zu ports, %zu nets)", ports_.size() + 1, nets_.size());
+                return;
+            }
+
+            callback_.lineno(stmt_lineno_);
+            callback_.subckt(tokens_[1], ports_, nets_);
+        }
+
+        /*
+         * Tokenization
+         */
+
+        //Skips blank (or comment only) lines and leading white space,
+        //returns false at the end of the input
+        bool skip_blank_lines() {
+            while(curr_ != end_) {
+                while(curr_ != end_ && is_space(*curr_)) ++curr_;
+
+                if(curr_ == end_) {
+                    return false;
+                } else if(*curr_ == '#') {
+                    skip_to_eol();
+                    consume_eol();
+                } else if(is_eol(curr_)) {
+                    consume_eol();
+                } else {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        //Reads the tokens of the next (logical) line into 'tokens', consuming the end of line.
+        //Returns false if an error was reported
+        bool read_statement(std::vector<StringView>& tokens) {
+            tokens.clear();
+            bool ok = true;
+            while(curr_ != end_) {
+                if(is_space(*curr_)) {
+                    ++curr_;
+                } else if(*curr_ == '#') {
+                    skip_to_eol(); //Comment to end of line
+                } else if(is_eol(curr_)) {
+                    break;
+                } else if(*curr_ == '\\' && is_continuation(curr_)) {
+                    ++curr_;
+                    consume_eol();
+                    if(at_blank_line()) {
+                        //A continuation followed by a blank line ends the statement
+                        break;
+                    }
+                } else if(*curr_ == '=') {
+                    tokens.emplace_back(curr_, 1);
+                    ++curr_;
+                } else {
+                    //A string may contain backslashes, but can not end in one (it would be
+                    //ambiguous with a line continuation)
+                    const char* start = curr_;
+                    while(curr_ != end_ && (is_string_char(*curr_) || (*curr_ == '\\' && !is_continuation(curr_)))) {
+                        ++curr_;
+                    }
+                    const char* tok_end = curr_;
+                    while(tok_end != start && *(tok_end - 1) == '\\') --tok_end;
+
+                    if(tok_end != start) {
+                        tokens.emplace_back(start, tok_end - start);
+                        curr_ = tok_end;
+                    } else {
+                        if(curr_ == start) ++curr_; //Stray carriage return
+                        ok = false;
+                        error(lineno_, StringView(start, curr_ - start), "Unrecognized character");
+                    }
+                }
+            }
+            stmt_lineno_ = lineno_;
+            consume_eol();
+            return ok;
+        }
+
+        //Reads a single-output cover row into the current row of cover_
+        bool read_cover_row() {
+            bool ok = true;
+            while(curr_ != end_) {
+                char c = *curr_;
+                if(is_space(c)) {
+                    ++curr_;
+                } else if(c == '#') {
+                    skip_to_eol();
+                } else if(is_eol(curr_)) {
+                    break;
+                } else if(c == '\\' && is_continuation(curr_)) {
+                    ++curr_;
+                    consume_eol();
+                    if(at_blank_line()) break;
+                } else if(is_logic_value(c)) {
+                    cover_.push_value(c == '1' ? LogicValue::TRUE : (c == '0' ? LogicValue::FALSE : LogicValue::DONT_CARE));
+                    ++curr_;
+                } else {
+                    ok = false;
+                    error(lineno_, StringView(curr_, 1), "Unrecognized character");
+                    ++curr_;
+                }
+            }
+            stmt_lineno_ = lineno_;
+            consume_eol();
+            return ok;
+        }
+
+        /*
+         * Character classes
+         */
+        static bool is_space(char c) {
+            return c == ' ' || c == '\t';
+        }
+
+        static bool is_string_char(char c) {
+            return !is_space(c) && c != '\r' && c != '\n' && c != '\\' && c != '=';
+        }
+
+        static bool is_logic_value(char c) {
+            return c == '0' || c == '1' || c == '-';
+        }
+
+        bool is_eol(const char* p) const {
+            return *p == '\n' || (*p == '\r' && p + 1 != end_ && *(p + 1) == '\n');
+        }
+
+        bool is_continuation(const char* p) const {
+            return p + 1 != end_ && is_eol(p + 1);
+        }
+
+        //True if the remainder of the current line is blank
+        bool at_blank_line() const {
+            const char* p = curr_;
+            while(p != end_ && is_space(*p)) ++p;
+            return p == end_ || is_eol(p);
+        }
+
+        void skip_to_eol() {
+            while(curr_ != end_ && !is_eol(curr_)) ++curr_;
+        }
+
+        //Consumes an end of line (\n, \r\n or \n\r) if present
+        void consume_eol() {
+            if(curr_ == end_) return;
+            if(*curr_ == '\r') {
+                curr_ += 2;
+            } else if(*curr_ == '\n') {
+                ++curr_;
+                if(curr_ != end_ && *curr_ == '\r') ++curr_;
+            } else {
+                return;
+            }
+            ++lineno_;
+        }
+
+        /*
+         * Utilities
+         */
+        bool expect_num_args(StringView directive, size_t min_args, size_t max_args) {
+            size_t num_args = tokens_.size() - 1;
+            if(num_args < min_args || num_args > max_args) {
+                error(stmt_lineno_, directive, "syntax error, unexpected number of arguments to '%s' (%zu)",
+                      directive.str().c_str(), num_args);
+                return false;
+            }
+            return true;
+        }
+
+        static bool to_latch_type(StringView token, LatchType& type) {
+            if(token == "fe") type = LatchType::FALLING_EDGE;
+            else if(token == "re") type = LatchType::RISING_EDGE;
+            else if(token == "ah") type = LatchType::ACTIVE_HIGH;
+            else if(token == "al") type = LatchType::ACTIVE_LOW;
+            else if(token == "as") type = LatchType::ASYNCHRONOUS;
+            else return false;
+            return true;
+        }
+
+        static bool to_latch_init(StringView token, LogicValue& init) {
+            if(token == "0") init = LogicValue::FALSE;
+            else if(token == "1") init = LogicValue::TRUE;
+            else if(token == "2") init = LogicValue::DONT_CARE;
+            else if(token == "3") init = LogicValue::UNKOWN;
+            else return false;
+            return true;
+        }
+
+        template<typename... Args>
+        void error(int line_no, StringView near_text, const char* fmt, Args... args) {
+            blif_error_wrap(callback_, line_no, near_text.str(), fmt, args...);
+        }
+
+    private:
+        const char* curr_;
+        const char* end_;
+        int lineno_ = 1;
+        int stmt_lineno_ = 1; //Last line of the most recently read statement
+
+        ViewCallback& callback_;
+
+        //Re-used between statements
+        std::vector<StringView> tokens_;
+        std::vector<StringView> args_;
+        std::vector<StringView> ports_;
+        std::vector<StringView> nets_;
+        SopCover cover_;
+};
+
+//Read-only view of a whole file, memory-mapped where supported
+class MappedFile {
+    public:
+        MappedFile(const char* filename) {
+#ifdef _WIN32
+            FILE* file = std::fopen(filename, "rb");
+            if(!file) return;
+            char buf[1 << 16];
+            size_t nread;
+            while((nread = std::fread(buf, 1, sizeof(buf), file)) > 0) {
+                contents_.insert(contents_.end(), buf, buf + nread);
+            }
+            std::fclose(file);
+            data_ = contents_.data();
+            size_ = contents_.size();
+            valid_ = true;
+#else
+            int fd = ::open(filename, O_RDONLY);
+            if(fd < 0) return;
+
+            struct stat file_stat;
+            if(::fstat(fd, &file_stat) == 0) {
+                size_ = static_cast<size_t>(file_stat.st_size);
+                if(size_ == 0) {
+                    data_ = "";
+                    valid_ = true;
+                } else {
+                    void* addr = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+                    if(addr != MAP_FAILED) {
+                        ::madvise(addr, size_, MADV_SEQUENTIAL);
+                        data_ = static_cast<const char*>(addr);
+                        mapped_ = true;
+                        valid_ = true;
+                    }
+                }
+            }
+            ::close(fd);
+#endif
+        }
+
+        ~MappedFile() {
+#ifndef _WIN32
+            if(mapped_) {
+                ::munmap(const_cast<char*>(data_), size_);
+            }
+#endif
+        }
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        bool valid() const { return valid_; }
+        const char* data() const { return data_; }
+        size_t size() const { return size_; }
+
+    private:
+        const char* data_ = nullptr;
+        size_t size_ = 0;
+        bool valid_ = false;
+        bool mapped_ = false;
+#ifdef _WIN32
+        std::vector<char> contents_;
+#endif
+};
+
+} //namespace
+
+/*
+ * External functions
+ */
+void blif_parse_mapped_filename(std::string filename, ViewCallback& callback) {
+    blif_parse_mapped_filename(filename.c_str(), callback);
+}
+
+void blif_parse_mapped_filename(const char* filename, ViewCallback& callback) {
+    MappedFile file(filename);
+    if(file.valid()) {
+        blif_parse_buffer(file.data(), file.size(), callback, filename);
+    } else {
+        blif_error_wrap(callback, 0, "", "Could not open file '%s'.\n", filename);
+    }
+}
+
+void blif_parse_mapped_filename(const char* filename, Callback& callback) {
+    CallbackAdapter adapter(callback);
+    blif_parse_mapped_filename(filename, adapter);
+}
+
+void blif_parse_buffer(const char* data, size_t size, ViewCallback& callback, const char* filename) {
+    ViewParser parser(data, size, callback);
+
+    //Just before parsing starts
+    callback.start_parse();
+
+    //Tell the caller the file name
+    callback.filename(filename);
+
+    //Do the actual parse
+    parser.parse();
+
+    //Finished parsing
+    callback.finish_parse();
+}
+
+} //namespace
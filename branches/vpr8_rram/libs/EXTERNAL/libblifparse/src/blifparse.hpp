@@ -21,7 +21,24 @@
  *
  * See main.cpp and blif_pretty_print.hpp for example usage.
  *
+ * ZERO-COPY USAGE
+ * --------------------------
+ * For large netlists derive from blifparse::ViewCallback instead, and pass it to
+ * blif_parse_mapped_filename(). The file is memory-mapped and tokens are handed
+ * to the callback as StringViews pointing directly into the mapped file, while
+ * .names covers are handed over as a packed SopCover. Nothing is copied unless
+ * the callback chooses to.
+ *
+ * StringViews are only valid for the duration of the callback method they are
+ * passed to; use StringView::str() to keep a copy.
+ *
+ * Existing Callback implementations can use the zero-copy parser through
+ * CallbackAdapter (see blif_parse_mapped_filename(const char*, Callback&)).
+ *
  */
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
 #include <vector>
 #include <string>
 #include <memory>
@@ -93,7 +110,175 @@ class Callback {
 
 
 /*
- * External functions for loading an SDC file
+ * A non-owning reference to a token in the parsed input
+ */
+class StringView {
+    public:
+        StringView() = default;
+        StringView(const char* str)
+            : data_(str), size_(std::strlen(str)) {}
+        StringView(const char* data, size_t size)
+            : data_(data), size_(size) {}
+        StringView(const std::string& str)
+            : data_(str.data()), size_(str.size()) {}
+
+        const char* data() const { return data_; }
+        size_t size() const { return size_; }
+        bool empty() const { return size_ == 0; }
+
+        const char* begin() const { return data_; }
+        const char* end() const { return data_ + size_; }
+        char operator[](size_t i) const { return data_[i]; }
+
+        //Returns an owning copy of the token
+        std::string str() const { return std::string(data_, size_); }
+
+        friend bool operator==(StringView lhs, StringView rhs) {
+            return lhs.size_ == rhs.size_ && std::memcmp(lhs.data_, rhs.data_, lhs.size_) == 0;
+        }
+        friend bool operator!=(StringView lhs, StringView rhs) { return !(lhs == rhs); }
+    private:
+        const char* data_ = "";
+        size_t size_ = 0;
+};
+
+/*
+ * The single-output cover of a .names
+ *
+ * All rows are stored back-to-back (row-major) in a single array, one byte per
+ * value, rather than as a vector per row.
+ */
+class SopCover {
+    public:
+        size_t num_rows() const { return num_rows_; }
+        size_t num_cols() const { return num_cols_; }
+        bool empty() const { return num_rows_ == 0; }
+
+        LogicValue value(size_t irow, size_t icol) const {
+            return static_cast<LogicValue>(values_[irow * num_cols_ + icol]);
+        }
+
+        //Returns the row as a std::vector (i.e. the format used by Callback::names())
+        std::vector<LogicValue> row(size_t irow) const;
+
+    public: //Mutators, used by the parser
+        //Removes all rows, and sets the number of values per row
+        void reset(size_t num_cols) {
+            num_cols_ = num_cols;
+            num_rows_ = 0;
+            values_.clear();
+        }
+
+        //Appends a value to the row currently being built
+        void push_value(LogicValue val) { values_.push_back(static_cast<uint8_t>(val)); }
+
+        //Number of values in the row currently being built
+        size_t curr_row_size() const { return values_.size() - num_rows_ * num_cols_; }
+
+        //Finishes the row currently being built (which must have num_cols() values)
+        void end_row() { ++num_rows_; }
+
+        //Discards the values of the row currently being built
+        void drop_row() { values_.resize(num_rows_ * num_cols_); }
+
+    private:
+        size_t num_cols_ = 0;
+        size_t num_rows_ = 0;
+        std::vector<uint8_t> values_;
+};
+
+/*
+ * Zero-copy callback interface, see ZERO-COPY USAGE above
+ */
+class ViewCallback {
+    public:
+        virtual ~ViewCallback() {};
+
+        //Start of parsing
+        virtual void start_parse() = 0;
+
+        //Sets current filename
+        virtual void filename(StringView fname) = 0;
+
+        //Sets current line number
+        virtual void lineno(int line_num) = 0;
+
+        //Start of a .model
+        virtual void begin_model(StringView model_name) = 0;
+
+        //.inputs
+        virtual void inputs(const std::vector<StringView>& inputs) = 0;
+
+        //.outputs
+        virtual void outputs(const std::vector<StringView>& outputs) = 0;
+
+        //.names
+        virtual void names(const std::vector<StringView>& nets, const SopCover& so_cover) = 0;
+
+        //.latch
+        virtual void latch(StringView input, StringView output, LatchType type, StringView control, LogicValue init) = 0;
+
+        //.subckt
+        virtual void subckt(StringView model, const std::vector<StringView>& ports, const std::vector<StringView>& nets) = 0;
+
+        //.blackbox
+        virtual void blackbox() = 0;
+
+        //.end (of a .model)
+        virtual void end_model() = 0;
+
+        //.conn [Extended BLIF, produces an error if not overriden]
+        virtual void conn(StringView src, StringView dst);
+
+        //.cname [Extended BLIF, produces an error if not overriden]
+        virtual void cname(StringView cell_name);
+
+        //.attr [Extended BLIF, produces an error if not overriden]
+        virtual void attr(StringView name, StringView value);
+
+        //.param [Extended BLIF, produces an error if not overriden]
+        virtual void param(StringView name, StringView value);
+
+        //End of parsing
+        virtual void finish_parse() = 0;
+
+        //Error during parsing
+        virtual void parse_error(const int curr_lineno, const std::string& near_text, const std::string& msg) = 0;
+};
+
+/*
+ * Forwards the zero-copy callbacks to a regular Callback, copying
+ * the tokens into the by-value arguments it expects.
+ */
+class CallbackAdapter : public ViewCallback {
+    public:
+        CallbackAdapter(Callback& callback)
+            : callback_(callback) {}
+
+        void start_parse() override;
+        void filename(StringView fname) override;
+        void lineno(int line_num) override;
+        void begin_model(StringView model_name) override;
+        void inputs(const std::vector<StringView>& inputs) override;
+        void outputs(const std::vector<StringView>& outputs) override;
+        void names(const std::vector<StringView>& nets, const SopCover& so_cover) override;
+        void latch(StringView input, StringView output, LatchType type, StringView control, LogicValue init) override;
+        void subckt(StringView model, const std::vector<StringView>& ports, const std::vector<StringView>& nets) override;
+        void blackbox() override;
+        void end_model() override;
+        void conn(StringView src, StringView dst) override;
+        void cname(StringView cell_name) override;
+        void attr(StringView name, StringView value) override;
+        void param(StringView name, StringView value) override;
+        void finish_parse() override;
+        void parse_error(const int curr_lineno, const std::string& near_text, const std::string& msg) override;
+
+    private:
+        Callback& callback_;
+};
+
+/*
+ * External functions for loading a BLIF file
  */
 void blif_parse_filename(std::string filename, Callback& callback);
 void blif_parse_filename(const char* filename, Callback& callback);
@@ -101,6 +286,17 @@ void blif_parse_filename(const char* filename, Callback& callback);
 //Loads from 'blif'. 'filename' only used to pass a filename to callback and can be left unspecified
 void blif_parse_file(FILE* blif, Callback& callback, const char* filename=""); 
 
+//Zero-copy parsing of a memory-mapped file
+void blif_parse_mapped_filename(std::string filename, ViewCallback& callback);
+void blif_parse_mapped_filename(const char* filename, ViewCallback& callback);
+
+//Zero-copy parsing of a memory-mapped file, driving a regular Callback through a CallbackAdapter
+void blif_parse_mapped_filename(const char* filename, Callback& callback);
+
+//Zero-copy parsing of an in-memory buffer (which must outlive the parse).
+//'filename' only used to pass a filename to callback and can be left unspecified
+void blif_parse_buffer(const char* data, size_t size, ViewCallback& callback, const char* filename="");
+
 /*
  * Enumerations
  */
@@ -1,6 +1,10 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <assert.h>
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <vector>
 #include "blifparse.hpp"
 #include "blif_pretty_print.hpp"
 
@@ -40,12 +44,113 @@ class NoOpCallback : public Callback {
         bool had_error_ = false;
 };
 
+class RecordingCallback : public Callback {
+    //Records every parsed statement as a line of text, so the results of different parsers can be compared.
+    //Line numbers are only used for diagnostics, and are not recorded.
+    public:
+        void start_parse() override { record("start_parse"); }
+
+        void filename(std::string fname) override { record("filename " + fname); }
+        void lineno(int /*line_num*/) override {}
+
+        void begin_model(std::string model_name) override { record(".model " + model_name); }
+        void inputs(std::vector<std::string> inputs) override { record(".inputs" + join(inputs)); }
+        void outputs(std::vector<std::string> outputs) override { record(".outputs" + join(outputs)); }
+
+        void names(std::vector<std::string> nets, std::vector<std::vector<LogicValue>> so_cover) override {
+            std::string stmt = ".names" + join(nets);
+            for (const auto& row : so_cover) {
+                stmt += " |";
+                for (LogicValue val : row) {
+                    stmt += " " + std::to_string(static_cast<int>(val));
+                }
+            }
+            record(stmt);
+        }
+        void latch(std::string input, std::string output, LatchType type, std::string control, LogicValue init) override {
+            record(".latch " + input + " " + output + " " + std::to_string(static_cast<int>(type))
+                   + " " + control + " " + std::to_string(static_cast<int>(init)));
+        }
+        void subckt(std::string model, std::vector<std::string> ports, std::vector<std::string> nets) override {
+            record(".subckt " + model + join(ports) + " |" + join(nets));
+        }
+        void blackbox() override { record(".blackbox"); }
+
+        void end_model() override { record(".end"); }
+
+        void conn(std::string src, std::string dst) override { record(".conn " + src + " " + dst); }
+        void cname(std::string cell_name) override { record(".cname " + cell_name); }
+        void attr(std::string name, std::string value) override { record(".attr " + name + " " + value); }
+        void param(std::string name, std::string value) override { record(".param " + name + " " + value); }
+
+        void finish_parse() override { record("finish_parse"); }
+
+        void parse_error(const int curr_lineno, const std::string& near_text, const std::string& msg) override {
+            fprintf(stderr, "Error at line %d near '%s': %s\n", curr_lineno, near_text.c_str(), msg.c_str());
+            had_error_ = true;
+        }
+
+        bool had_error() const { return had_error_; }
+        const std::vector<std::string>& statements() const { return statements_; }
+
+    private:
+        void record(const std::string& stmt) { statements_.push_back(stmt); }
+
+        static std::string join(const std::vector<std::string>& strs) {
+            std::string joined;
+            for (const auto& str : strs) {
+                joined += " " + str;
+            }
+            return joined;
+        }
+
+    private:
+        std::vector<std::string> statements_;
+        bool had_error_ = false;
+};
+
+//Parses the file with both the flex/bison parser and the memory-mapped parser,
+//and checks that they produce the same sequence of callbacks
+static int compare_parsers(const char* filename) {
+    RecordingCallback flex_callback;
+    blif_parse_filename(filename, flex_callback);
+
+    RecordingCallback mapped_callback;
+    blif_parse_mapped_filename(filename, mapped_callback);
+
+    if (flex_callback.had_error() || mapped_callback.had_error()) {
+        return 1;
+    }
+
+    const auto& flex_stmts = flex_callback.statements();
+    const auto& mapped_stmts = mapped_callback.statements();
+    for (size_t i = 0; i < std::max(flex_stmts.size(), mapped_stmts.size()); ++i) {
+        const char* flex_stmt = (i < flex_stmts.size()) ? flex_stmts[i].c_str() : "<none>";
+        const char* mapped_stmt = (i < mapped_stmts.size()) ? mapped_stmts[i].c_str() : "<none>";
+        if (std::strcmp(flex_stmt, mapped_stmt) != 0) {
+            fprintf(stderr, "Parsers differ at statement %zu:\n", i);
+            fprintf(stderr, "  flex/bison:    %s\n", flex_stmt);
+            fprintf(stderr, "  memory-mapped: %s\n", mapped_stmt);
+            return 1;
+        }
+    }
+    printf("Parsers agree on %zu statements\n", flex_stmts.size());
+    return 0;
+}
+
 int main(int argc, char **argv) {
+    if(argc == 3 && std::strcmp(argv[1], "--compare") == 0) {
+        return compare_parsers(argv[2]);
+    }
+
     if(argc != 2) {
-        fprintf(stderr, "Usage: %s filename.blif\n", argv[0]);
+        fprintf(stderr, "Usage: %s [--compare] filename.blif\n", argv[0]);
         fprintf(stderr, "\n");
         fprintf(stderr, "Reads in an blif file into internal data structures\n");
         fprintf(stderr, "and then prints it out\n");
+        fprintf(stderr, "\n");
+        fprintf(stderr, "With --compare, the file is instead parsed with both the flex/bison\n");
+        fprintf(stderr, "and memory-mapped parsers, and their results compared\n");
         exit(1);
     }
 
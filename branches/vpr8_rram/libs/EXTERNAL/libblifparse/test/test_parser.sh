@@ -19,6 +19,14 @@ do
             echo "Error" >&2 
             exit 1
         fi
+
+        #The memory-mapped parser must agree with the flex/bison parser
+        ./blifparse_test --compare $blif_file
+        exit_code=$?
+        if [[ $exit_code -ne 0 ]]; then
+            echo "Error: parsers disagree" >&2 
+            exit 1
+        fi
     done
 
 done
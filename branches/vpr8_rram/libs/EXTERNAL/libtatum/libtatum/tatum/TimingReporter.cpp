@@ -94,9 +94,9 @@ void TimingReporter::report_timing_setup(std::string filename,
 void TimingReporter::report_timing_setup(std::ostream& os, 
                                          const SetupTimingAnalyzer& setup_analyzer,
                                          size_t npaths) const {
-    auto paths = path_collector_.collect_worst_setup_timing_paths(timing_graph_, setup_analyzer, npaths);
-
-    report_timing(os, paths);
+    report_timing(os, [&](const TimingPathCollector::TimingPathVisitor& visit_path) {
+        path_collector_.visit_worst_setup_timing_paths(timing_graph_, setup_analyzer, npaths, visit_path);
+    });
 }
 
 void TimingReporter::report_timing_hold(std::string filename, 
@@ -109,9 +109,9 @@ void TimingReporter::report_timing_hold(std::string filename,
 void TimingReporter::report_timing_hold(std::ostream& os, 
                                          const HoldTimingAnalyzer& hold_analyzer,
                                          size_t npaths) const {
-    auto paths = path_collector_.collect_worst_hold_timing_paths(timing_graph_, hold_analyzer, npaths);
-
-    report_timing(os, paths);
+    report_timing(os, [&](const TimingPathCollector::TimingPathVisitor& visit_path) {
+        path_collector_.visit_worst_hold_timing_paths(timing_graph_, hold_analyzer, npaths, visit_path);
+    });
 }
 
 void TimingReporter::report_skew_setup(std::string filename, 
@@ -124,11 +124,11 @@ void TimingReporter::report_skew_setup(std::string filename,
 void TimingReporter::report_skew_setup(std::ostream& os, 
                                          const SetupTimingAnalyzer& setup_analyzer,
                                          size_t nworst) const {
-    auto paths = path_collector_.collect_worst_setup_skew_paths(timing_graph_, timing_constraints_, setup_analyzer, nworst);
-
     os << "#Clock skew for setup timing startpoint/endpoint\n";
     os << "\n";
-    report_skew(os, paths, TimingType::SETUP);
+    report_skew(os, [&](const TimingPathCollector::SkewPathVisitor& visit_path) {
+        path_collector_.visit_worst_setup_skew_paths(timing_graph_, timing_constraints_, setup_analyzer, nworst, visit_path);
+    }, TimingType::SETUP);
     os << "#End of clock skew for setup timing startpoint/endpoint report\n";
 }
 
@@ -142,11 +142,11 @@ void TimingReporter::report_skew_hold(std::string filename,
 void TimingReporter::report_skew_hold(std::ostream& os, 
                                          const HoldTimingAnalyzer& hold_analyzer,
                                          size_t nworst) const {
-    auto paths = path_collector_.collect_worst_hold_skew_paths(timing_graph_, timing_constraints_, hold_analyzer, nworst);
-
     os << "#Clock skew for hold timing startpoint/endpoint\n";
     os << "\n";
-    report_skew(os, paths, TimingType::HOLD);
+    report_skew(os, [&](const TimingPathCollector::SkewPathVisitor& visit_path) {
+        path_collector_.visit_worst_hold_skew_paths(timing_graph_, timing_constraints_, hold_analyzer, nworst, visit_path);
+    }, TimingType::HOLD);
     os << "#End of clock skew for hold timing startpoint/endpoint report\n";
 }
 
@@ -195,20 +195,27 @@ void TimingReporter::report_unconstrained_hold(std::ostream& os,
  */
 
 void TimingReporter::report_timing(std::ostream& os,
-                                   const std::vector<TimingPath>& paths) const {
+                                   const TimingPathSource& visit_paths) const {
     tatum::OsFormatGuard flag_guard(os);
 
-    os << "#Timing report of worst " << paths.size() << " path(s)\n";
-    os << "# Unit scale: " << std::setprecision(0) << std::scientific << unit_scale_ << " seconds\n";
-    os << "# Output precision: " << precision_ << "\n";
-    os << "\n";
+    auto report_header = [&](size_t num_paths) {
+        os << "#Timing report of worst " << num_paths << " path(s)\n";
+        os << "# Unit scale: " << std::setprecision(0) << std::scientific << unit_scale_ << " seconds\n";
+        os << "# Output precision: " << precision_ << "\n";
+        os << "\n";
+    };
 
+    //Each path is written as soon as it is traced, so the report is never held in memory
     size_t i = 0;
-    for(const auto& path : paths) {
+    visit_paths([&](size_t num_paths, const TimingPath& path) {
+        if (i == 0) report_header(num_paths);
+
         os << "#Path " << ++i << "\n";
         report_timing_path(os, path);
         os << "\n";
-    }
+    });
+
+    if (i == 0) report_header(0);
 
     os << "#End of timing report\n";
 }
@@ -362,16 +369,16 @@ void TimingReporter::report_unconstrained(std::ostream& os, const NodeType type,
     }
 }
 
-void TimingReporter::report_skew(std::ostream& os, const std::vector<SkewPath>& skew_paths, TimingType timing_type) const {
+void TimingReporter::report_skew(std::ostream& os, const SkewPathSource& visit_paths, TimingType timing_type) const {
     tatum::OsFormatGuard flag_guard(os);
 
     int i = 1;
-    for (const auto& skew_path : skew_paths) {
+    visit_paths([&](size_t /*num_paths*/, const SkewPath& skew_path) {
         os << "#Skew Path " << i << "\n";
         report_skew_path(os, skew_path, timing_type); 
         os << "\n";
         ++i;
-    }
+    });
 }
 
 void TimingReporter::report_skew_path(std::ostream& os, const SkewPath& skew_path, TimingType timing_type) const {
@@ -94,13 +94,17 @@ class TimingReporter {
         };
 
     private:
-        void report_timing(std::ostream& os, const std::vector<TimingPath>& paths) const;
+        //Visits the paths to be reported (in report order) with the provided visitor
+        typedef std::function<void(const TimingPathCollector::TimingPathVisitor&)> TimingPathSource;
+        typedef std::function<void(const TimingPathCollector::SkewPathVisitor&)> SkewPathSource;
+
+        void report_timing(std::ostream& os, const TimingPathSource& visit_paths) const;
 
         void report_timing_path(std::ostream& os, const TimingPath& path) const;
 
         void report_unconstrained(std::ostream& os, const NodeType type, const detail::TagRetriever& tag_retriever) const;
 
-        void report_skew(std::ostream& os, const std::vector<SkewPath>& paths, TimingType timing_type) const;
+        void report_skew(std::ostream& os, const SkewPathSource& visit_paths, TimingType timing_type) const;
 
         void report_skew_path(std::ostream& os, const SkewPath& skew_path, TimingType timing_type) const;
 
@@ -3,187 +3,262 @@
 #include "tatum/report/TimingPathCollector.hpp"
 #include "tatum/report/TimingReportTagRetriever.hpp"
 #include "tatum/report/timing_path_tracing.hpp"
-#include <map>
+#include <algorithm>
+#include <functional>
 
 namespace tatum {
 
 namespace detail {
-std::vector<TimingPath> collect_worst_timing_paths(const TimingGraph& timing_graph, const detail::TagRetriever& tag_retriever, size_t npaths);
-std::vector<SkewPath> collect_worst_skew_paths(const TimingGraph& timing_graph, const TimingConstraints& timing_constraings,
-                                              const detail::TagRetriever& tag_retriever, TimingType timing_type, size_t npaths);
 
-std::vector<TimingPath> collect_worst_timing_paths(const TimingGraph& timing_graph, const detail::TagRetriever& tag_retriever, size_t npaths) {
-    std::vector<TimingPath> paths;
+//Returns the (at most) npaths worst keys produced by for_each_key, sorted worst first.
+//
+//Keys are selected with a bounded max-heap (ordered by is_worse, so the best of the kept
+//keys is at the top and is evicted whenever a worse key is found), so only O(npaths)
+//keys are ever held in memory regardless of how many are produced.
+template<class Key, class ForEachKey, class IsWorse>
+static std::vector<Key> select_worst_keys(size_t npaths, ForEachKey for_each_key, IsWorse is_worse) {
+    std::vector<Key> heap;
+    if (npaths == 0) return heap;
+
+    for_each_key([&](const Key& key) {
+        if (heap.size() < npaths) {
+            heap.push_back(key);
+            std::push_heap(heap.begin(), heap.end(), is_worse);
+        } else if (is_worse(key, heap.front())) {
+            std::pop_heap(heap.begin(), heap.end(), is_worse);
+            heap.back() = key;
+            std::push_heap(heap.begin(), heap.end(), is_worse);
+        }
+    });
+
+    //Worst first
+    std::sort_heap(heap.begin(), heap.end(), is_worse);
+
+    return heap;
+}
 
+//Orders end-points by the clock domains and node, so ties in the primary sort key are
+//broken deterministically
+template<class Key>
+static bool id_order(const Key& lhs, const Key& rhs) {
+    if (lhs.node != rhs.node) return lhs.node < rhs.node;
+    if (lhs.tag.launch_clock_domain() != rhs.tag.launch_clock_domain()) return lhs.tag.launch_clock_domain() < rhs.tag.launch_clock_domain();
+    return lhs.tag.capture_clock_domain() < rhs.tag.capture_clock_domain();
+}
+
+static void visit_worst_timing_paths(const TimingGraph& timing_graph, const detail::TagRetriever& tag_retriever, size_t npaths,
+                              const TimingPathCollector::TimingPathVisitor& visit_path) {
     struct TagNode {
         TagNode(TimingTag t, NodeId n)
             : tag(t), node(n) {}
 
         TimingTag tag;
         NodeId node;
-
     };
 
-    std::vector<TagNode> tags_and_sinks;
+    //Most negative slack is worst
+    auto worse_slack = [](const TagNode& lhs, const TagNode& rhs) {
+        if (lhs.tag.time() < rhs.tag.time()) return true;
+        if (rhs.tag.time() < lhs.tag.time()) return false;
+        return id_order(lhs, rhs);
+    };
 
-    //Add the slacks of all sink
-    for(NodeId node : timing_graph.logical_outputs()) {
-        for(TimingTag tag : tag_retriever.slacks(node)) {
-            tags_and_sinks.emplace_back(tag,node);
+    auto for_each_sink_slack = [&](const std::function<void(const TagNode&)>& add_key) {
+        for(NodeId node : timing_graph.logical_outputs()) {
+            for(TimingTag tag : tag_retriever.slacks(node)) {
+                add_key(TagNode(tag, node));
+            }
         }
-    }
-
-    //Sort in ascending slack order so most negative slacks are first
-    auto ascending_slack_order = [](const TagNode& lhs, const TagNode& rhs) {
-        return lhs.tag.time() < rhs.tag.time();
     };
-    std::sort(tags_and_sinks.begin(), tags_and_sinks.end(), ascending_slack_order);
-
-
-    //Trace the paths for each tag/node pair
-    // The the map will sort the nodes and tags from worst to best slack (i.e. ascending slack order),
-    // so the first pair is the most critical end-point
-    for(const auto& tag_node : tags_and_sinks) {
-        NodeId sink_node = tag_node.node;
-        TimingTag sink_tag = tag_node.tag;
 
-        TimingPath path = detail::trace_path(timing_graph, tag_retriever, sink_tag.launch_clock_domain(), sink_tag.capture_clock_domain(), sink_node); 
+    std::vector<TagNode> worst_sinks = select_worst_keys<TagNode>(npaths, for_each_sink_slack, worse_slack);
 
-        paths.push_back(path);
+    //Trace each path only when it is visited, so only one full path is held at a time
+    for(const auto& tag_node : worst_sinks) {
+        TimingPath path = detail::trace_path(timing_graph, tag_retriever, tag_node.tag.launch_clock_domain(), tag_node.tag.capture_clock_domain(), tag_node.node);
 
-        if(paths.size() >= npaths) break;
+        visit_path(worst_sinks.size(), path);
     }
-
-    return paths;
 }
 
-std::vector<SkewPath> collect_worst_skew_paths(const TimingGraph& timing_graph, const TimingConstraints& timing_constraints, 
-                                               const detail::TagRetriever& tag_retriever, TimingType timing_type, size_t npaths) {
-    std::vector<SkewPath> paths;
-
-    for(NodeId node : timing_graph.nodes()) {
-        NodeType node_type = timing_graph.node_type(node);
-        if (node_type != NodeType::SINK) continue;
+//Builds the skew path ending at the data capture node for the specified required tag.
+//
+//Returns false if the path has no skew (i.e. it is launched by a constant generator)
+static bool build_skew_path(SkewPath& path, const TimingGraph& timing_graph, const TimingConstraints& timing_constraints,
+                     const detail::TagRetriever& tag_retriever, TimingType timing_type,
+                     NodeId node, const TimingTag& required_tag) {
+    path.launch_domain = required_tag.launch_clock_domain();
+    path.capture_domain = required_tag.capture_clock_domain();
 
-        const auto& required_tags = tag_retriever.tags(node, TagType::DATA_REQUIRED);
+    TimingSubPath data_arrival_path = detail::trace_data_arrival_path(timing_graph, tag_retriever, path.launch_domain, path.capture_domain, node);
 
-        for (auto& required_tag : required_tags) {
-            SkewPath path;
+    TATUM_ASSERT(!data_arrival_path.elements().empty());
+    auto& data_launch_elem = *data_arrival_path.elements().begin(); 
 
-            path.launch_domain = required_tag.launch_clock_domain();
-            path.capture_domain = required_tag.capture_clock_domain();
+    //Constant generators do not have skew
+    if (is_const_gen_tag(data_launch_elem.tag())) return false;
 
-            TimingSubPath data_arrival_path = detail::trace_data_arrival_path(timing_graph, tag_retriever, path.launch_domain, path.capture_domain, node);
+    path.data_launch_node = data_launch_elem.node();
+    path.data_capture_node = node;
 
-            TATUM_ASSERT(!data_arrival_path.elements().empty());
-            auto& data_launch_elem = *data_arrival_path.elements().begin(); 
+    path.clock_launch_path = detail::trace_clock_launch_path(timing_graph, tag_retriever, path.launch_domain, path.capture_domain, path.data_launch_node);
+    path.clock_capture_path = detail::trace_clock_capture_path(timing_graph, tag_retriever, path.launch_domain, path.capture_domain, path.data_capture_node);
 
-            //Constant generators do not have skew
-            if (is_const_gen_tag(data_launch_elem.tag())) continue;
+    if (path.clock_launch_path.elements().empty()) {
+        //Primary input
+        path.clock_launch_arrival = data_launch_elem.tag().time();
 
-            path.data_launch_node = data_launch_elem.node();
-            path.data_capture_node = node;
+        //Adjust for input delay
+        if (timing_type == TimingType::SETUP) {
+            path.clock_launch_arrival -= timing_constraints.input_constraint(path.data_launch_node, path.launch_domain, DelayType::MAX);
+        } else {
+            TATUM_ASSERT(timing_type == TimingType::HOLD);
+            path.clock_launch_arrival -= timing_constraints.input_constraint(path.data_launch_node, path.launch_domain, DelayType::MIN);
+        }
+    } else {
+        //FF source
+        path.clock_launch_arrival = path_end(path.clock_launch_path);
+    }
 
-            path.clock_launch_path = detail::trace_clock_launch_path(timing_graph, tag_retriever, path.launch_domain, path.capture_domain, path.data_launch_node);
-            path.clock_capture_path = detail::trace_clock_capture_path(timing_graph, tag_retriever, path.launch_domain, path.capture_domain, path.data_capture_node);
+    if (path.clock_capture_path.elements().empty()) {
+        //Primary output
+        path.clock_capture_arrival = required_tag.time();
 
-            if (path.clock_launch_path.elements().empty()) {
-                //Primary input
-                path.clock_launch_arrival = data_launch_elem.tag().time();
+        //Adjust for output delay and clock uncertainty
+        if (timing_type == TimingType::SETUP) {
+            path.clock_capture_arrival += timing_constraints.output_constraint(path.data_capture_node, path.capture_domain, DelayType::MAX);
+        } else {
+            TATUM_ASSERT(timing_type == TimingType::HOLD);
+            path.clock_capture_arrival += timing_constraints.output_constraint(path.data_capture_node, path.capture_domain, DelayType::MIN);
+        }
+        //TODO: need to think about why we don't need to adjust for uncertainty on these paths...
+    } else {
+        //FF capture
+        path.clock_capture_arrival = path_end(path.clock_capture_path);
 
-                //Adjust for input delay
-                if (timing_type == TimingType::SETUP) {
-                    path.clock_launch_arrival -= timing_constraints.input_constraint(path.data_launch_node, path.launch_domain, DelayType::MAX);
-                } else {
-                    TATUM_ASSERT(timing_type == TimingType::HOLD);
-                    path.clock_launch_arrival -= timing_constraints.input_constraint(path.data_launch_node, path.launch_domain, DelayType::MIN);
-                }
-            } else {
-                //FF source
-                path.clock_launch_arrival = path_end(path.clock_launch_path);
-            }
+        //Adjust for clock uncertainty
+        if (timing_type == TimingType::SETUP) {
+            path.clock_capture_arrival -= timing_constraints.setup_clock_uncertainty(path.launch_domain, path.capture_domain);
+        } else {
+            TATUM_ASSERT(timing_type == TimingType::HOLD);
+            path.clock_capture_arrival += timing_constraints.hold_clock_uncertainty(path.launch_domain, path.capture_domain);
+        }
+    }
 
-            if (path.clock_capture_path.elements().empty()) {
-                //Primary output
-                path.clock_capture_arrival = required_tag.time();
-
-                //Adjust for output delay and clock uncertainty
-                if (timing_type == TimingType::SETUP) {
-                    path.clock_capture_arrival += timing_constraints.output_constraint(path.data_capture_node, path.capture_domain, DelayType::MAX);
-                } else {
-                    TATUM_ASSERT(timing_type == TimingType::HOLD);
-                    path.clock_capture_arrival += timing_constraints.output_constraint(path.data_capture_node, path.capture_domain, DelayType::MIN);
-                }
-                //TODO: need to think about why we don't need to adjust for uncertainty on these paths...
-            } else {
-                //FF capture
-                path.clock_capture_arrival = path_end(path.clock_capture_path);
-
-                //Adjust for clock uncertainty
-                if (timing_type == TimingType::SETUP) {
-                    path.clock_capture_arrival -= timing_constraints.setup_clock_uncertainty(path.launch_domain, path.capture_domain);
-                } else {
-                    TATUM_ASSERT(timing_type == TimingType::HOLD);
-                    path.clock_capture_arrival += timing_constraints.hold_clock_uncertainty(path.launch_domain, path.capture_domain);
-                }
-            }
 
+    //Record period constraint
+    if (timing_type == TimingType::SETUP) {
+        path.clock_constraint = timing_constraints.setup_constraint(path.launch_domain, path.capture_domain);
+    } else {
+        TATUM_ASSERT(timing_type == TimingType::HOLD);
+        path.clock_constraint = timing_constraints.hold_constraint(path.launch_domain, path.capture_domain);
+    }
 
-            //Record period constraint
-            if (timing_type == TimingType::SETUP) {
-                path.clock_constraint = timing_constraints.setup_constraint(path.launch_domain, path.capture_domain);
-            } else {
-                TATUM_ASSERT(timing_type == TimingType::HOLD);
-                path.clock_constraint = timing_constraints.hold_constraint(path.launch_domain, path.capture_domain);
-            }
+    path.clock_skew = path.clock_capture_arrival - path.clock_launch_arrival - path.clock_constraint;
 
-            path.clock_skew = path.clock_capture_arrival - path.clock_launch_arrival - path.clock_constraint;
+    return true;
+}
 
-            paths.push_back(path);
-        }
-    }
+static void visit_worst_skew_paths(const TimingGraph& timing_graph, const TimingConstraints& timing_constraints, 
+                            const detail::TagRetriever& tag_retriever, TimingType timing_type, size_t npaths,
+                            const TimingPathCollector::SkewPathVisitor& visit_path) {
+    //Only the end-point and its skew are kept while selecting the worst paths; the
+    //selected paths are re-built when they are visited
+    struct SkewKey {
+        SkewKey(TimingTag t, NodeId n, Time s)
+            : tag(t), node(n), skew(s) {}
+
+        TimingTag tag; //The required tag
+        NodeId node; //The data capture node
+        Time skew;
+    };
 
-    auto skew_order = [&](const SkewPath& lhs, const SkewPath& rhs) {
+    auto worse_skew = [&](const SkewKey& lhs, const SkewKey& rhs) {
         if (timing_type == TimingType::SETUP) {
             //Positive skew helps setup paths (since the capture clock edge is delayed, 
             //lengthening the clock period), so show the most negative skews first.
-            return lhs.clock_skew < rhs.clock_skew;
+            if (lhs.skew < rhs.skew) return true;
+            if (rhs.skew < lhs.skew) return false;
         } else {
             //Positive skew hurts hold paths (since the capture clock edge is delay,
             //this gives the data more time to catch-up to the capture clock),
             //so show the most positive skews first.
             TATUM_ASSERT(timing_type == TimingType::HOLD);
-            return lhs.clock_skew > rhs.clock_skew;
+            if (rhs.skew < lhs.skew) return true;
+            if (lhs.skew < rhs.skew) return false;
         }
+        return id_order(lhs, rhs);
     };
-    std::sort(paths.begin(), paths.end(), skew_order);
 
-    //TODO: not very efficient, since we generate all paths first and then trim to npaths...
-    paths.resize(std::min(paths.size(), npaths));
+    auto for_each_sink_skew = [&](const std::function<void(const SkewKey&)>& add_key) {
+        for(NodeId node : timing_graph.nodes()) {
+            NodeType node_type = timing_graph.node_type(node);
+            if (node_type != NodeType::SINK) continue;
 
-    return paths;
+            for (const TimingTag& required_tag : tag_retriever.tags(node, TagType::DATA_REQUIRED)) {
+                SkewPath path;
+                if (!build_skew_path(path, timing_graph, timing_constraints, tag_retriever, timing_type, node, required_tag)) continue;
+
+                add_key(SkewKey(required_tag, node, path.clock_skew));
+            }
+        }
+    };
+
+    std::vector<SkewKey> worst_sinks = select_worst_keys<SkewKey>(npaths, for_each_sink_skew, worse_skew);
+
+    for (const SkewKey& key : worst_sinks) {
+        SkewPath path;
+        bool has_skew = build_skew_path(path, timing_graph, timing_constraints, tag_retriever, timing_type, key.node, key.tag);
+        TATUM_ASSERT(has_skew);
+
+        visit_path(worst_sinks.size(), path);
+    }
 }
 
 } //namespace detail
 
 std::vector<TimingPath> TimingPathCollector::collect_worst_setup_timing_paths(const TimingGraph& timing_graph, const tatum::SetupTimingAnalyzer& setup_analyzer, size_t npaths) const {
-    detail::SetupTagRetriever tag_retriever(setup_analyzer);
-    return collect_worst_timing_paths(timing_graph, tag_retriever, npaths);
+    std::vector<TimingPath> paths;
+    visit_worst_setup_timing_paths(timing_graph, setup_analyzer, npaths, [&](size_t /*num_paths*/, const TimingPath& path) { paths.push_back(path); });
+    return paths;
 }
 
 std::vector<TimingPath> TimingPathCollector::collect_worst_hold_timing_paths(const TimingGraph& timing_graph, const tatum::HoldTimingAnalyzer& hold_analyzer, size_t npaths) const {
-    detail::HoldTagRetriever tag_retriever(hold_analyzer);
-    return collect_worst_timing_paths(timing_graph, tag_retriever, npaths);
+    std::vector<TimingPath> paths;
+    visit_worst_hold_timing_paths(timing_graph, hold_analyzer, npaths, [&](size_t /*num_paths*/, const TimingPath& path) { paths.push_back(path); });
+    return paths;
 }
 
 std::vector<SkewPath> TimingPathCollector::collect_worst_setup_skew_paths(const TimingGraph& timing_graph, const TimingConstraints& timing_constraints, const tatum::SetupTimingAnalyzer& setup_analyzer, size_t npaths) const {
-    detail::SetupTagRetriever tag_retriever(setup_analyzer);
-    return collect_worst_skew_paths(timing_graph, timing_constraints, tag_retriever, TimingType::SETUP, npaths);
+    std::vector<SkewPath> paths;
+    visit_worst_setup_skew_paths(timing_graph, timing_constraints, setup_analyzer, npaths, [&](size_t /*num_paths*/, const SkewPath& path) { paths.push_back(path); });
+    return paths;
 }
 
 std::vector<SkewPath> TimingPathCollector::collect_worst_hold_skew_paths(const TimingGraph& timing_graph, const TimingConstraints& timing_constraints, const tatum::HoldTimingAnalyzer& hold_analyzer, size_t npaths) const {
+    std::vector<SkewPath> paths;
+    visit_worst_hold_skew_paths(timing_graph, timing_constraints, hold_analyzer, npaths, [&](size_t /*num_paths*/, const SkewPath& path) { paths.push_back(path); });
+    return paths;
+}
+
+void TimingPathCollector::visit_worst_setup_timing_paths(const TimingGraph& timing_graph, const tatum::SetupTimingAnalyzer& setup_analyzer, size_t npaths, const TimingPathVisitor& visit_path) const {
+    detail::SetupTagRetriever tag_retriever(setup_analyzer);
+    detail::visit_worst_timing_paths(timing_graph, tag_retriever, npaths, visit_path);
+}
+
+void TimingPathCollector::visit_worst_hold_timing_paths(const TimingGraph& timing_graph, const tatum::HoldTimingAnalyzer& hold_analyzer, size_t npaths, const TimingPathVisitor& visit_path) const {
+    detail::HoldTagRetriever tag_retriever(hold_analyzer);
+    detail::visit_worst_timing_paths(timing_graph, tag_retriever, npaths, visit_path);
+}
+
+void TimingPathCollector::visit_worst_setup_skew_paths(const TimingGraph& timing_graph, const TimingConstraints& timing_constraints, const tatum::SetupTimingAnalyzer& setup_analyzer, size_t npaths, const SkewPathVisitor& visit_path) const {
+    detail::SetupTagRetriever tag_retriever(setup_analyzer);
+    detail::visit_worst_skew_paths(timing_graph, timing_constraints, tag_retriever, TimingType::SETUP, npaths, visit_path);
+}
+
+void TimingPathCollector::visit_worst_hold_skew_paths(const TimingGraph& timing_graph, const TimingConstraints& timing_constraints, const tatum::HoldTimingAnalyzer& hold_analyzer, size_t npaths, const SkewPathVisitor& visit_path) const {
     detail::HoldTagRetriever tag_retriever(hold_analyzer);
-    return collect_worst_skew_paths(timing_graph, timing_constraints, tag_retriever, TimingType::HOLD, npaths);
+    detail::visit_worst_skew_paths(timing_graph, timing_constraints, tag_retriever, TimingType::HOLD, npaths, visit_path);
 }
 
 } //namespace tatum
@@ -1,5 +1,6 @@
 #ifndef TATUM_TIMING_PATH_COLLECTOR_HPP
 #define TATUM_TIMING_PATH_COLLECTOR_HPP
+#include <functional>
 #include "tatum/timing_analyzers_fwd.hpp"
 #include "TimingPath.hpp"
 #include "SkewPath.hpp"
@@ -7,12 +8,29 @@
 namespace tatum {
 
     class TimingPathCollector {
+        public:
+            //Called on each path visited, with the total number of paths which will be visited
+            typedef std::function<void(size_t num_paths, const TimingPath& path)> TimingPathVisitor;
+            typedef std::function<void(size_t num_paths, const SkewPath& path)> SkewPathVisitor;
+
         public:
             std::vector<TimingPath> collect_worst_setup_timing_paths(const TimingGraph& timing_graph, const tatum::SetupTimingAnalyzer& setup_analyzer, size_t npaths) const;
             std::vector<TimingPath> collect_worst_hold_timing_paths(const TimingGraph& timing_graph, const tatum::HoldTimingAnalyzer& hold_analyzer, size_t npaths) const;
 
             std::vector<SkewPath> collect_worst_setup_skew_paths(const TimingGraph& timing_graph, const TimingConstraints& timing_constraints, const tatum::SetupTimingAnalyzer& setup_analyzer, size_t npaths) const;
             std::vector<SkewPath> collect_worst_hold_skew_paths(const TimingGraph& timing_graph, const TimingConstraints& timing_constraints, const tatum::HoldTimingAnalyzer& hold_analyzer, size_t npaths) const;
+
+            //Streaming versions of the above, which visit the worst paths in order (worst first) instead
+            //of returning them.
+            //
+            //The worst path end-points are selected with a bounded priority queue, and each path is only
+            //traced just before it is visited, so memory use is proportional to npaths (and independent
+            //of the number and length of the other paths). This suits writing large reports incrementally.
+            void visit_worst_setup_timing_paths(const TimingGraph& timing_graph, const tatum::SetupTimingAnalyzer& setup_analyzer, size_t npaths, const TimingPathVisitor& visit_path) const;
+            void visit_worst_hold_timing_paths(const TimingGraph& timing_graph, const tatum::HoldTimingAnalyzer& hold_analyzer, size_t npaths, const TimingPathVisitor& visit_path) const;
+
+            void visit_worst_setup_skew_paths(const TimingGraph& timing_graph, const TimingConstraints& timing_constraints, const tatum::SetupTimingAnalyzer& setup_analyzer, size_t npaths, const SkewPathVisitor& visit_path) const;
+            void visit_worst_hold_skew_paths(const TimingGraph& timing_graph, const TimingConstraints& timing_constraints, const tatum::HoldTimingAnalyzer& hold_analyzer, size_t npaths, const SkewPathVisitor& visit_path) const;
     };
 
 } //namespace
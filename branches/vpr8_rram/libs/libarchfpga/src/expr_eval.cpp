@@ -2,11 +2,14 @@
 #include "arch_error.h"
 #include "vtr_util.h"
 #include "vtr_math.h"
+#include "vtr_assert.h"
 #include <vector>
 #include <stack>
 #include <string>
 #include <sstream>
 #include <cstring> //memset
+#include <algorithm>
+#include <iterator>
 
 using std::vector;
 using std::stack;
@@ -21,6 +24,7 @@ typedef enum e_formula_obj{
 	E_FML_BRACKET,
 	E_FML_COMMA,
 	E_FML_OPERATOR,
+	E_FML_VARIABLE,
 	E_FML_NUM_FORMULA_OBJS
 } t_formula_obj;
 
@@ -50,7 +54,7 @@ public:
 
 	/* object data, accessed based on what kind of object this is */
 	union u_Data {
-		int num;		/*for number objects*/
+		int num;		/*for number objects, or the slot of variable objects*/
 		t_operator op;		/*for operator objects*/
 		bool left_bracket;	/*for bracket objects -- specifies if this is a left bracket*/
 
@@ -72,6 +76,8 @@ public:
             }
         } else if (type == E_FML_COMMA) {
             return ",";
+        } else if (type == E_FML_VARIABLE) {
+            return "$" + std::to_string(data.num);
         } else if (type == E_FML_OPERATOR) {
             if (data.op == E_OP_ADD) {
                 return "+";
@@ -102,12 +108,14 @@ public:
 
 /*---- Functions for Parsing the Symbolic Formulas ----*/
 
-/* converts specified formula to a vector in reverse-polish notation */
-static void formula_to_rpn( const char* formula, const t_formula_data &mydata,
-				vector<Formula_Object> &rpn_output );
+/* converts specified formula to a vector in reverse-polish notation. Variables are
+   replaced by their values in mydata, or, if var_names is specified, by variable
+   objects referring to their index in var_names */
+static void formula_to_rpn( const char* formula, const t_formula_data *mydata,
+				const vector<string> *var_names, vector<Formula_Object> &rpn_output );
 
-static void get_formula_object( const char *ch, int &ichar, const t_formula_data &mydata,
-				 Formula_Object *fobj );
+static void get_formula_object( const char *ch, int &ichar, const t_formula_data *mydata,
+				const vector<string> *var_names, Formula_Object *fobj );
 
 /* returns integer specifying precedence of passed-in operator. higher integer
    means higher precedence */
@@ -135,6 +143,9 @@ static int parse_rpn_vector( vector<Formula_Object> &rpn_vec );
 static int apply_rpn_op( const Formula_Object &arg1, const Formula_Object &arg2,
 					const Formula_Object &op );
 
+/* applies the operator 'op' to the integer arguments. arg1 comes before arg2 */
+static int apply_operator( t_operator op, int arg1, int arg2 );
+
 /* checks if specified character represents an ASCII number */
 static bool is_char_number( const char ch );
 
@@ -160,7 +171,7 @@ int parse_formula(std::string formula, const t_formula_data& mydata ){
 	vector<Formula_Object> rpn_output;
 
 	/* now we have to run the shunting-yard algorithm to convert formula to reverse polish notation */
-	formula_to_rpn( formula.c_str(), mydata, rpn_output );
+	formula_to_rpn( formula.c_str(), &mydata, nullptr, rpn_output );
 
 	/* then we run an RPN parser to get the final result */
 	result = parse_rpn_vector(rpn_output);
@@ -169,6 +180,159 @@ int parse_formula(std::string formula, const t_formula_data& mydata ){
 }
 
 
+/*---- Compiled Formulas ----*/
+
+CompiledFormula::CompiledFormula(const std::string& formula, const std::vector<std::string>& var_names)
+        : formula_(formula) {
+	if (formula.empty()){
+		archfpga_throw( __FILE__, __LINE__, "CompiledFormula: formula empty\n");
+	}
+
+	if ( !is_piecewise_formula(formula.c_str()) ){
+		program_ = compile(formula, var_names);
+		return;
+	}
+
+	/* piece-wise formula: {start_0:end_0} formula_0; ... {start_i:end_i} formula_i; ...
+	   each range and formula is compiled separately; the piece is selected by 't' at evaluation */
+	auto t_iter = std::find(var_names.begin(), var_names.end(), "t");
+	if (t_iter == var_names.end()){
+		archfpga_throw( __FILE__, __LINE__, "CompiledFormula: piece-wise formula '%s' requires variable 't'\n", formula.c_str());
+	}
+	piece_var_slot_ = std::distance(var_names.begin(), t_iter);
+
+	size_t pos = 0;
+	while (true){
+		pos = formula.find_first_not_of(' ', pos);
+		if (pos == string::npos){
+			break;
+		}
+		if (formula[pos] != '{'){
+			archfpga_throw( __FILE__, __LINE__, "CompiledFormula: expected '{' at position %zu of piece-wise formula '%s'\n", pos, formula.c_str());
+		}
+		size_t colon = formula.find(':', pos);
+		size_t close = (colon == string::npos) ? string::npos : formula.find('}', colon);
+		if (colon == string::npos || close == string::npos){
+			archfpga_throw( __FILE__, __LINE__, "CompiledFormula: unterminated range in piece-wise formula '%s'\n", formula.c_str());
+		}
+		size_t end = formula.find(';', close);
+		if (end == string::npos){
+			end = formula.size();
+		}
+
+		Piece piece;
+		piece.range_start = compile(formula.substr(pos + 1, colon - pos - 1), var_names);
+		piece.range_end = compile(formula.substr(colon + 1, close - colon - 1), var_names);
+		piece.body = compile(formula.substr(close + 1, end - close - 1), var_names);
+		pieces_.push_back(std::move(piece));
+
+		pos = (end == formula.size()) ? end : end + 1;
+	}
+
+	if (pieces_.empty()){
+		archfpga_throw( __FILE__, __LINE__, "CompiledFormula: piece-wise formula '%s' has no pieces\n", formula.c_str());
+	}
+}
+
+int CompiledFormula::evaluate(const int* var_values) const {
+	if (pieces_.empty()){
+		return run(program_, var_values);
+	}
+
+	int t = var_values[piece_var_slot_];
+	for (const Piece& piece : pieces_){
+		int range_start = run(piece.range_start, var_values);
+		int range_end = run(piece.range_end, var_values);
+		if (range_start > range_end){
+			archfpga_throw( __FILE__, __LINE__, "CompiledFormula: range_start, %d, is bigger than range end, %d\n", range_start, range_end);
+		}
+
+		/* is the incoming wire within this range? (inclusive) */
+		if (range_start <= t && range_end >= t){
+			return run(piece.body, var_values);
+		}
+	}
+	archfpga_throw( __FILE__, __LINE__, "CompiledFormula: no range of piece-wise formula '%s' contains t=%d\n", formula_.c_str(), t);
+	return -1;
+}
+
+/* converts an expression to a program in reverse-polish notation, checking that each
+   operator has its two arguments so that running it can not fail */
+CompiledFormula::Program CompiledFormula::compile(const std::string& expr, const std::vector<std::string>& var_names){
+	vector<Formula_Object> rpn_output;
+	formula_to_rpn( expr.c_str(), nullptr, &var_names, rpn_output );
+
+	if (rpn_output.empty()){
+		archfpga_throw( __FILE__, __LINE__, "CompiledFormula: empty expression\n");
+	}
+	if (E_FML_OPERATOR == rpn_output[0].type){
+		archfpga_throw( __FILE__, __LINE__, "CompiledFormula: first entry is not a number (was %s)\n", rpn_output[0].to_string().c_str());
+	}
+
+	Program program;
+	int depth = 0;
+	for (const Formula_Object& fobj : rpn_output){
+		Instr instr;
+		if (E_FML_NUMBER == fobj.type){
+			instr.type = InstrType::CONSTANT;
+			instr.value = fobj.data.num;
+			++depth;
+		} else if (E_FML_VARIABLE == fobj.type){
+			instr.type = InstrType::VARIABLE;
+			instr.value = fobj.data.num;
+			++depth;
+		} else {
+			VTR_ASSERT(E_FML_OPERATOR == fobj.type);
+			if (depth < 2){
+				archfpga_throw( __FILE__, __LINE__, "CompiledFormula: operator '%s' is missing an argument in '%s'\n", fobj.to_string().c_str(), expr.c_str());
+			}
+			instr.type = InstrType::OPERATOR;
+			instr.value = fobj.data.op;
+			--depth;
+		}
+		program.instrs.push_back(instr);
+		program.max_depth = std::max(program.max_depth, depth);
+	}
+
+	if (depth != 1){
+		archfpga_throw( __FILE__, __LINE__, "CompiledFormula: found multiple numbers in formula '%s', but no operator\n", expr.c_str());
+	}
+
+	return program;
+}
+
+int CompiledFormula::run(const Program& program, const int* var_values){
+	/* formulas are short, so the evaluation stack normally lives on the C++ stack */
+	constexpr int INLINE_DEPTH = 16;
+	int inline_stack[INLINE_DEPTH] = {};
+	vector<int> heap_stack;
+	int* stack = inline_stack;
+	if (program.max_depth > INLINE_DEPTH){
+		heap_stack.resize(program.max_depth);
+		stack = heap_stack.data();
+	}
+
+	int top = 0;
+	for (const Instr& instr : program.instrs){
+		switch (instr.type){
+			case InstrType::CONSTANT:
+				stack[top++] = instr.value;
+				break;
+			case InstrType::VARIABLE:
+				stack[top++] = var_values[instr.value];
+				break;
+			case InstrType::OPERATOR:
+				--top;
+				stack[top - 1] = apply_operator(static_cast<t_operator>(instr.value), stack[top - 1], stack[top]);
+				break;
+			default:
+				archfpga_throw( __FILE__, __LINE__, "CompiledFormula: invalid instruction type %d\n", int(instr.type));
+		}
+	}
+	return stack[0];
+}
+
+
 /* EXPERIMENTAL:
 
    returns integer result according to specified piece-wise formula and data. the piecewise
@@ -297,8 +461,8 @@ static bool goto_next_char( int *str_ind, const string &pw_formula, char ch){
 
 /* Parses the specified formula using a shunting yard algorithm (see wikipedia). The function's result
    is stored in the rpn_output vector in reverse-polish notation */
-static void formula_to_rpn( const char* formula, const t_formula_data &mydata,
-				vector<Formula_Object> &rpn_output ){
+static void formula_to_rpn( const char* formula, const t_formula_data *mydata,
+				const vector<string> *var_names, vector<Formula_Object> &rpn_output ){
 
 	stack<Formula_Object> op_stack;		/* stack for handling operators and brackets in formula */
 	Formula_Object fobj;		 	/* for parsing formula objects */
@@ -316,9 +480,10 @@ static void formula_to_rpn( const char* formula, const t_formula_data &mydata,
 			/* skip space */
 		} else {
 			/* parse the character */
-			get_formula_object( ch, ichar, mydata, &fobj );
+			get_formula_object( ch, ichar, mydata, var_names, &fobj );
 			switch (fobj.type){
-				case E_FML_NUMBER:
+				case E_FML_NUMBER: //fallthrough
+				case E_FML_VARIABLE:
 					/* add to output vector */
 					rpn_output.push_back( fobj );
 					break;
@@ -360,10 +525,12 @@ static void formula_to_rpn( const char* formula, const t_formula_data &mydata,
 
 /* Fills the formula object fobj according to specified character and mydata,
    which help determine which numeric value, if any, gets assigned to fobj
+   (if var_names is specified, variables are instead left unresolved as references
+   to their index in var_names).
    ichar is incremented by the corresponding count if the need to step through the
    character array arises */
-static void get_formula_object( const char *ch, int &ichar, const t_formula_data &mydata,
-				 Formula_Object *fobj ){
+static void get_formula_object( const char *ch, int &ichar, const t_formula_data *mydata,
+				const vector<string> *var_names, Formula_Object *fobj ){
 
 	/* the character can either be part of a number, or it can be an object like W, t, (, +, etc
 	   here we have to account for both possibilities */
@@ -384,10 +551,19 @@ static void get_formula_object( const char *ch, int &ichar, const t_formula_data
 				archfpga_throw( __FILE__, __LINE__, "in get_formula_object: recognized function: %s\n", var_name.c_str());
             }
 
+        } else if (var_names) {
+            //A variable, bound to its slot
+            auto iter = std::find(var_names->begin(), var_names->end(), var_name);
+            if (iter == var_names->end()) {
+                archfpga_throw(__FILE__, __LINE__,
+                    "No value found for variable '%s' from expression\n", var_name.c_str());
+            }
+            fobj->type = E_FML_VARIABLE;
+            fobj->data.num = std::distance(var_names->begin(), iter);
         } else {
             //A variable
             fobj->type = E_FML_NUMBER;
-            fobj->data.num = mydata.get_var_value(var_name);
+            fobj->data.num = mydata->get_var_value(var_name);
         }
 
         ichar += (id_len - 1); //-1 since ichar is incremented at end of loop in formula_to_rpn()
@@ -696,33 +872,43 @@ static int apply_rpn_op( const Formula_Object &arg1, const Formula_Object &arg2,
 	}
 
 	/* apply operation to arguments */
-	switch (op.data.op){
+	result = apply_operator(op.data.op, arg1.data.num, arg2.data.num);
+
+	return result;
+}
+
+
+/* applies the operator 'op' to the integer arguments. arg1 comes before arg2 */
+static int apply_operator( t_operator op, int arg1, int arg2 ){
+	int result = -1;
+
+	switch (op){
 		case E_OP_ADD:
-			result = arg1.data.num + arg2.data.num;
+			result = arg1 + arg2;
 			break;
 		case E_OP_SUB:
-			result = arg1.data.num - arg2.data.num;
+			result = arg1 - arg2;
 			break;
 		case E_OP_MULT:
-			result = arg1.data.num * arg2.data.num;
+			result = arg1 * arg2;
 			break;
 		case E_OP_DIV:
-			result = arg1.data.num / arg2.data.num;
+			result = arg1 / arg2;
 			break;
         case E_OP_MAX:
-            result = std::max(arg1.data.num, arg2.data.num);
+            result = std::max(arg1, arg2);
             break;
         case E_OP_MIN:
-            result = std::min(arg1.data.num, arg2.data.num);
+            result = std::min(arg1, arg2);
             break;
         case E_OP_GCD:
-            result = vtr::gcd(arg1.data.num, arg2.data.num);
+            result = vtr::gcd(arg1, arg2);
             break;
         case E_OP_LCM:
-            result = vtr::lcm(arg1.data.num, arg2.data.num);
+            result = vtr::lcm(arg1, arg2);
             break;
 		default:
-			archfpga_throw( __FILE__, __LINE__, "in apply_rpn_op: invalid operation: %d\n", op.data.op);
+			archfpga_throw( __FILE__, __LINE__, "in apply_operator: invalid operation: %d\n", op);
 			break;
 	}
 
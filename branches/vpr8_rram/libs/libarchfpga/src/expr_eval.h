@@ -2,6 +2,7 @@
 #define EXPR_EVAL_H
 #include <map>
 #include <string>
+#include <vector>
 #include "arch_error.h"
 
 /**** Structs ****/
@@ -24,6 +25,55 @@ class t_formula_data {
         std::map<std::string,int> vars_;
 };
 
+/* A formula which is parsed once (into reverse-polish notation) and can then be
+   evaluated repeatedly without re-tokenizing the formula string. Variables are
+   bound to integer slots when the formula is compiled: evaluate() takes an array
+   of values indexed in the same order as the var_names given at construction.
+   Piece-wise formulas (see parse_piecewise_formula) are also supported, provided
+   't' is one of the variables. */
+class CompiledFormula {
+    public:
+        CompiledFormula() = default;
+        CompiledFormula(const std::string& formula, const std::vector<std::string>& var_names);
+
+        /* returns the integer result of the formula for the given variable values */
+        int evaluate(const int* var_values) const;
+
+        const std::string& formula() const { return formula_; }
+
+    private:
+        enum class InstrType : char {
+            CONSTANT,   /* push value */
+            VARIABLE,   /* push var_values[value] */
+            OPERATOR    /* pop two arguments, push the result of operator 'value' */
+        };
+
+        struct Instr {
+            InstrType type;
+            int value;
+        };
+
+        struct Program {
+            std::vector<Instr> instrs;
+            int max_depth = 0; /* deepest evaluation stack required */
+        };
+
+        struct Piece {
+            Program range_start;
+            Program range_end;
+            Program body;
+        };
+
+        static Program compile(const std::string& expr, const std::vector<std::string>& var_names);
+        static int run(const Program& program, const int* var_values);
+
+    private:
+        std::string formula_;
+        Program program_;           /* non-piece-wise formulas */
+        std::vector<Piece> pieces_; /* piece-wise formulas */
+        int piece_var_slot_ = -1;   /* slot of 't', which selects the piece */
+};
+
 /* returns integer result according to specified formula and data */
 int parse_formula(std::string formula, const t_formula_data &mydata);
 
@@ -0,0 +1,80 @@
+#include <string>
+#include <vector>
+
+#include "catch.hpp"
+
+#include "expr_eval.h"
+
+namespace {
+
+//Evaluates formula with the reference (re-parsing) evaluator
+int reference_eval(const std::string& formula, int W, int t) {
+    t_formula_data data;
+    data.set_var_value("W", W);
+    data.set_var_value("t", t);
+
+    if (is_piecewise_formula(formula.c_str())) {
+        return parse_piecewise_formula(formula.c_str(), data);
+    }
+    return parse_formula(formula, data);
+}
+
+}
+
+TEST_CASE("Compiled formula matches parse_formula", "[expr_eval]") {
+    const std::vector<std::string> var_names = {"W", "t"};
+
+    const std::vector<std::string> formulas = {
+        "42",
+        "t",
+        "W - t",
+        "t + 1",
+        "W - t - 1",
+        "(t + W/2) * 3",
+        "W + t / 2 - 1",
+        "2 * (W - (t + 1))",
+        "W / 4 * 4 - t",
+        "min(W, t + 3)",
+        "max(t, W - t)",
+        "gcd(W, t + 2) + lcm(2, t + 1)",
+        "min(max(t, 2), W / 2) * 2",
+        "{0:(W/2)} t-1; {(W/2):W} t+1;",
+        "{0:W/4} W-t; {W/4:W} t*2;",
+    };
+
+    for (const std::string& formula : formulas) {
+        CompiledFormula compiled(formula, var_names);
+        CHECK(compiled.formula() == formula);
+
+        for (int W : {4, 8, 12, 20}) {
+            for (int t = 0; t < W; ++t) {
+                int var_values[2] = {W, t};
+
+                INFO("formula: " << formula << " W: " << W << " t: " << t);
+                CHECK(compiled.evaluate(var_values) == reference_eval(formula, W, t));
+            }
+        }
+    }
+}
+
+TEST_CASE("Compiled formula variable slots", "[expr_eval]") {
+    //Slots follow the order of var_names, not the order of appearance in the formula
+    CompiledFormula compiled("from * 10 + to", {"to", "from"});
+
+    int var_values[2] = {3, 7};
+    REQUIRE(compiled.evaluate(var_values) == 73);
+
+    t_formula_data data;
+    data.set_var_value("from", 7);
+    data.set_var_value("to", 3);
+    REQUIRE(parse_formula("from * 10 + to", data) == 73);
+}
+
+TEST_CASE("Compiled formula errors", "[expr_eval]") {
+    const std::vector<std::string> var_names = {"W", "t"};
+
+    REQUIRE_THROWS_AS(CompiledFormula("", var_names), const ArchFpgaError&);
+    REQUIRE_THROWS_AS(CompiledFormula("W + x", var_names), const ArchFpgaError&);
+    REQUIRE_THROWS_AS(CompiledFormula("(W + t", var_names), const ArchFpgaError&);
+    REQUIRE_THROWS_AS(CompiledFormula("{0:W} t;", {"W"}), const ArchFpgaError&);
+}
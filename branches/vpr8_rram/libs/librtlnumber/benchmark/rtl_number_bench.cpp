@@ -0,0 +1,77 @@
+/* Micro-benchmark for the librtlnumber operators on wide buses
+ *
+ * usage: rtl_number_bench [iterations]
+ *
+ * prints the average time per operation for a few bus widths, with and without x/z bits
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <random>
+#include <string>
+
+#include "rtl_int.hpp"
+
+static std::mt19937_64 rng(0x5eed);
+
+static VNumber random_number(size_t width, bool with_unknowns)
+{
+	const char *digits = (with_unknowns)? "01xz": "01";
+	size_t digit_count = (with_unknowns)? 4: 2;
+
+	std::string bitstring = std::to_string(width) + "'b";
+	for(size_t i=0; i < width; i++)
+		bitstring.push_back(digits[rng() % digit_count]);
+
+	return VNumber(bitstring);
+}
+
+static void run(const char *name, size_t width, bool with_unknowns, size_t iterations, std::function<VNumber(VNumber&, VNumber&)> op)
+{
+	VNumber a = random_number(width, with_unknowns);
+	VNumber b = random_number(width, with_unknowns);
+
+	// keep the result size in check so the compiler can't drop the work
+	size_t checksum = 0;
+
+	auto start = std::chrono::steady_clock::now();
+	for(size_t i=0; i < iterations; i++)
+		checksum += op(a, b).size();
+	auto end = std::chrono::steady_clock::now();
+
+	double total_ns = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+	printf("%-6s %6zu bits %-8s %12.1f ns/op  (%zu)\n", name, width, (with_unknowns)? "4-state": "2-state", total_ns / static_cast<double>(iterations), checksum);
+}
+
+int main(int argc, char **argv)
+{
+	size_t iterations = (argc > 1)? strtoul(argv[1], nullptr, 10): 200;
+
+	VNumber shift_amount("'d13");
+
+	for(size_t width : {64UL, 1024UL, 16384UL})
+	{
+		for(bool with_unknowns : {false, true})
+		{
+			run("+", width, with_unknowns, iterations, [](VNumber& a, VNumber& b){ return V_ADD(a, b); });
+			run("-", width, with_unknowns, iterations, [](VNumber& a, VNumber& b){ return V_MINUS(a, b); });
+			run("&", width, with_unknowns, iterations, [](VNumber& a, VNumber& b){ return V_BITWISE_AND(a, b); });
+			run("^", width, with_unknowns, iterations, [](VNumber& a, VNumber& b){ return V_BITWISE_XOR(a, b); });
+			run("<<", width, with_unknowns, iterations, [&](VNumber& a, VNumber&){ return V_SHIFT_LEFT(a, shift_amount); });
+			run(">>>", width, with_unknowns, iterations, [&](VNumber& a, VNumber&){ return V_SIGNED_SHIFT_RIGHT(a, shift_amount); });
+			run("<", width, with_unknowns, iterations, [](VNumber& a, VNumber& b){ return V_LT(a, b); });
+			run("==", width, with_unknowns, iterations, [](VNumber& a, VNumber& b){ return V_EQUAL(a, b); });
+		}
+
+		// these need known values, and are quadratic in the width
+		if(width <= 1024)
+		{
+			run("*", width, false, iterations, [](VNumber& a, VNumber& b){ return V_MULTIPLY(a, b); });
+			run("/", width, false, iterations, [](VNumber& a, VNumber& b){ return V_DIV(a, b); });
+		}
+	}
+
+	return 0;
+}
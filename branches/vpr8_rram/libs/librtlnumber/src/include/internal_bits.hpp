@@ -232,6 +232,58 @@ namespace BitSpace {
             default:    return _x;
         }
     }
+
+    /*****
+     * word level helpers, these work on a whole veri_internal_bits_t at once
+     */
+
+    /* a word with every bit set to value */
+    static veri_internal_bits_t spread_bit(bit_value_t value)
+    {
+        return (_All_1 * value);
+    }
+
+    /* the low bit of every bit pair set to 1 where the bit in word is equal to value */
+    static veri_internal_bits_t match_bit(veri_internal_bits_t word, bit_value_t value)
+    {
+        veri_internal_bits_t same = ~(word ^ spread_bit(value));
+        return (same & (same >> 1) & _All_1);
+    }
+
+    /* pack the value of the bits into a binary word, only meaningful when there are no x or z */
+    static uint32_t to_binary_word(veri_internal_bits_t word)
+    {
+        word &= _All_1;
+        word = (word | (word >> 1)) & 0x3333333333333333UL;
+        word = (word | (word >> 2)) & 0x0F0F0F0F0F0F0F0FUL;
+        word = (word | (word >> 4)) & 0x00FF00FF00FF00FFUL;
+        word = (word | (word >> 8)) & 0x0000FFFF0000FFFFUL;
+        word = (word | (word >> 16)) & 0x00000000FFFFFFFFUL;
+        return static_cast<uint32_t>(word);
+    }
+
+    static veri_internal_bits_t from_binary_word(uint32_t binary)
+    {
+        veri_internal_bits_t word = binary;
+        word = (word | (word << 16)) & 0x0000FFFF0000FFFFUL;
+        word = (word | (word << 8)) & 0x00FF00FF00FF00FFUL;
+        word = (word | (word << 4)) & 0x0F0F0F0F0F0F0F0FUL;
+        word = (word | (word << 2)) & 0x3333333333333333UL;
+        word = (word | (word << 1)) & 0x5555555555555555UL;
+        return word;
+    }
+
+    typedef std::vector<uint32_t> binary_t;
+
+    static int compare_binary(const binary_t& a, const binary_t& b)
+    {
+        for(size_t i=a.size()-1; i < a.size(); i--)
+        {
+            if(a[i] != b[i])
+                return (a[i] > b[i])? 1: -1;
+        }
+        return 0;
+    }
     template<typename T>
     class BitFields
     {
@@ -293,6 +345,16 @@ namespace BitSpace {
         {
             return static_cast<bool>(this->bits & _All_x);
         }
+
+        T get_bits()
+        {
+            return this->bits;
+        }
+
+        void set_bits(T value)
+        {
+            this->bits = value;
+        }
     };
 
     #define DEBUG_V_BITS
@@ -393,13 +455,81 @@ namespace BitSpace {
 
         bool has_unknowns()
         {
-            for(auto bitField : this->bits)
-                if(bitField.has_unknowns())
+            // the bits past the msb are not part of the number
+            for(size_t i=0; i<this->list_size(); i++)
+                if(this->get_extended_word(i, _0) & _All_x)
                     return true;
             
             return false;
         }
 
+        /**
+         * Word access
+         * a word holds BitFields<veri_internal_bits_t>::size() bits, bits past the msb read as pad
+         */
+        veri_internal_bits_t get_extended_word(size_t index, bit_value_t pad)
+        {
+            const size_t word_size = BitFields<veri_internal_bits_t>::size();
+
+            size_t first_bit = index * word_size;
+            if(first_bit >= this->size())
+                return spread_bit(pad);
+
+            veri_internal_bits_t word = this->get_bitfield(index)->get_bits();
+            size_t valid_bits = this->size() - first_bit;
+            if(valid_bits >= word_size)
+                return word;
+
+            veri_internal_bits_t valid_mask = (static_cast<veri_internal_bits_t>(1) << (valid_bits << 1)) - 1;
+            return ((word & valid_mask) | (spread_bit(pad) & ~valid_mask));
+        }
+
+        /* the word starting at first_bit, bits below the lsb read as pad_low */
+        veri_internal_bits_t get_window_word(int64_t first_bit, bit_value_t pad_low, bit_value_t pad_high)
+        {
+            const int64_t word_size = static_cast<int64_t>(BitFields<veri_internal_bits_t>::size());
+
+            int64_t index = first_bit / word_size;
+            int64_t offset = first_bit % word_size;
+            if(offset < 0)
+            {
+                offset += word_size;
+                index--;
+            }
+
+            veri_internal_bits_t low = (index < 0)? spread_bit(pad_low): this->get_extended_word(static_cast<size_t>(index), pad_high);
+            if(!offset)
+                return low;
+
+            veri_internal_bits_t high = (index+1 < 0)? spread_bit(pad_low): this->get_extended_word(static_cast<size_t>(index+1), pad_high);
+            return ((low >> (offset << 1)) | (high << ((word_size - offset) << 1)));
+        }
+
+        /* the value of the lowest 'length' bits as binary words, only meaningful when there are no x or z */
+        binary_t to_binary(size_t length, bit_value_t pad)
+        {
+            const size_t word_size = BitFields<veri_internal_bits_t>::size();
+
+            binary_t binary(length / word_size + 1, 0);
+            for(size_t i=0; i<binary.size(); i++)
+                binary[i] = to_binary_word(this->get_extended_word(i, pad));
+
+            size_t last_bits = length % word_size;
+            binary.back() &= static_cast<uint32_t>((static_cast<uint64_t>(1) << last_bits) - 1);
+
+            return binary;
+        }
+
+        static VerilogBits *from_binary(const binary_t& binary, size_t length)
+        {
+            VerilogBits *other = new VerilogBits(length, _0);
+
+            for(size_t i=0; i<other->list_size() && i<binary.size(); i++)
+                other->get_bitfield(i)->set_bits(from_binary_word(binary[i]));
+
+            return other;
+        }
+
         /**
          * Unary Reduction operations
          * This is Msb to Lsb on purpose, as per specs
@@ -420,14 +550,34 @@ namespace BitSpace {
         {
             VerilogBits *other = new VerilogBits(this->bit_size, _0);
 
-            for(size_t i=0; i<this->size(); i++)
-                other->set_bit(i, BitSpace::l_not[this->get_bit(i)]);
+            // 0 -> 1, 1 -> 0, x and z -> x
+            for(size_t i=0; i<this->list_size(); i++)
+            {
+                veri_internal_bits_t word = this->get_bitfield(i)->get_bits();
+                veri_internal_bits_t unknowns = word & _All_x;
+                other->get_bitfield(i)->set_bits(unknowns | (~(unknowns >> 1) & ~word & _All_1));
+            }
                         
             return other;
         }
 
         VerilogBits *twos_complement()
         {
+            if(!this->has_unknowns())
+            {
+                binary_t binary = this->to_binary(this->size(), _0);
+
+                uint64_t carry = 1;
+                for(uint32_t& word : binary)
+                {
+                    uint64_t sum = static_cast<uint64_t>(static_cast<uint32_t>(~word)) + carry;
+                    word = static_cast<uint32_t>(sum);
+                    carry = sum >> 32;
+                }
+
+                return from_binary(binary, this->size());
+            }
+
             BitSpace::bit_value_t previous_carry = BitSpace::_1;
             VerilogBits *other = new VerilogBits(this->bit_size, _0);
 
@@ -441,13 +591,171 @@ namespace BitSpace {
                         
             return other;
         }
+
+        /**
+         * Binary operations, both operands are extended to result_size with their pad
+         */
+        VerilogBits *bitwise(VerilogBits& other, bit_value_t pad_this, bit_value_t pad_other, size_t result_size, const bit_value_t lut[4][4])
+        {
+            VerilogBits *result = new VerilogBits(result_size, _0);
+
+            for(size_t i=0; i<result->list_size(); i++)
+            {
+                veri_internal_bits_t word_a = this->get_extended_word(i, pad_this);
+                veri_internal_bits_t word_b = other.get_extended_word(i, pad_other);
+
+                veri_internal_bits_t match_b[4];
+                for(bit_value_t value_b = _0; value_b <= _z; value_b++)
+                    match_b[value_b] = match_bit(word_b, value_b);
+
+                // evaluate the lut for the pairs of values present in the words,
+                // so words without x or z only visit the 0 and 1 entries
+                veri_internal_bits_t word = _All_0;
+                for(bit_value_t value_a = _0; value_a <= _z; value_a++)
+                {
+                    veri_internal_bits_t match_a = match_bit(word_a, value_a);
+                    if(!match_a)
+                        continue;
+
+                    for(bit_value_t value_b = _0; value_b <= _z; value_b++)
+                        if(match_b[value_b])
+                            word |= (match_a & match_b[value_b]) * lut[value_a][value_b];
+                }
+
+                result->get_bitfield(i)->set_bits(word);
+            }
+
+            return result;
+        }
+
+        /* the result has an extra msb, so the carry out is kept and signed operands keep their sign */
+        VerilogBits *sum(VerilogBits& other, bit_value_t pad_this, bit_value_t pad_other, bit_value_t initial_carry, size_t length)
+        {
+            size_t result_size = length + 1;
+
+            if(!this->has_unknowns() && !other.has_unknowns() && (initial_carry == _0 || initial_carry == _1))
+            {
+                binary_t binary_a = this->to_binary(result_size, pad_this);
+                binary_t binary_b = other.to_binary(result_size, pad_other);
+
+                uint64_t carry = initial_carry;
+                for(size_t i=0; i<binary_a.size(); i++)
+                {
+                    uint64_t sum = static_cast<uint64_t>(binary_a[i]) + binary_b[i] + carry;
+                    binary_a[i] = static_cast<uint32_t>(sum);
+                    carry = sum >> 32;
+                }
+
+                return from_binary(binary_a, result_size);
+            }
+
+            VerilogBits *result = new VerilogBits(result_size, _x);
+
+            bit_value_t previous_carry = initial_carry;
+            for(size_t i=0; i<result_size; i++)
+            {
+                bit_value_t bit_a = (i < this->size())? this->get_bit(i): pad_this;
+                bit_value_t bit_b = (i < other.size())? other.get_bit(i): pad_other;
+
+                result->set_bit(i, l_sum[previous_carry][bit_a][bit_b]);
+                previous_carry = l_carry[previous_carry][bit_a][bit_b];
+            }
+
+            return result;
+        }
+
+        /* result bit i is this bit (i + offset), bits below the lsb are pad_low, bits past the msb are pad_high */
+        VerilogBits *shift(int64_t offset, bit_value_t pad_low, bit_value_t pad_high, size_t result_size)
+        {
+            const int64_t word_size = static_cast<int64_t>(BitFields<veri_internal_bits_t>::size());
+
+            VerilogBits *result = new VerilogBits(result_size, _0);
+
+            for(size_t i=0; i<result->list_size(); i++)
+            {
+                int64_t first_bit = static_cast<int64_t>(i) * word_size + offset;
+                result->get_bitfield(i)->set_bits(this->get_window_word(first_bit, pad_low, pad_high));
+            }
+
+            return result;
+        }
+
+        /* unsigned product, only valid when there are no x or z */
+        VerilogBits *multiply(VerilogBits& other)
+        {
+            binary_t binary_a = this->to_binary(this->size(), _0);
+            binary_t binary_b = other.to_binary(other.size(), _0);
+            binary_t binary_result(binary_a.size() + binary_b.size(), 0);
+
+            for(size_t i=0; i<binary_a.size(); i++)
+            {
+                if(!binary_a[i])
+                    continue;
+
+                uint64_t carry = 0;
+                for(size_t j=0; j<binary_b.size(); j++)
+                {
+                    uint64_t product = static_cast<uint64_t>(binary_a[i]) * binary_b[j] + binary_result[i+j] + carry;
+                    binary_result[i+j] = static_cast<uint32_t>(product);
+                    carry = product >> 32;
+                }
+                binary_result[i + binary_b.size()] = static_cast<uint32_t>(carry);
+            }
+
+            return from_binary(binary_result, this->size() + other.size());
+        }
+
+        /* unsigned quotient or remainder, only valid when there are no x or z and other is not 0 */
+        VerilogBits *divide(VerilogBits& other, bool get_remainder, size_t result_size)
+        {
+            const size_t word_size = BitFields<veri_internal_bits_t>::size();
+            size_t length = std::max(this->size(), other.size());
+
+            binary_t dividend = this->to_binary(length, _0);
+            binary_t divisor = other.to_binary(length, _0);
+            binary_t quotient(dividend.size(), 0);
+            binary_t remainder(dividend.size(), 0);
+
+            // restoring division, one bit of the dividend at a time from the msb
+            for(size_t bit=length-1; bit < length; bit--)
+            {
+                uint32_t carry = (dividend[bit / word_size] >> (bit % word_size)) & 0x1;
+                for(uint32_t& word : remainder)
+                {
+                    uint32_t next_carry = word >> 31;
+                    word = (word << 1) | carry;
+                    carry = next_carry;
+                }
+
+                if(compare_binary(remainder, divisor) >= 0)
+                {
+                    uint64_t borrow = 0;
+                    for(size_t i=0; i<remainder.size(); i++)
+                    {
+                        uint64_t difference = static_cast<uint64_t>(remainder[i]) - divisor[i] - borrow;
+                        remainder[i] = static_cast<uint32_t>(difference);
+                        borrow = (difference >> 32) & 0x1;
+                    }
+                    quotient[bit / word_size] |= (static_cast<uint32_t>(1) << (bit % word_size));
+                }
+            }
+
+            return from_binary((get_remainder)? remainder: quotient, result_size);
+        }
+
+        /* -1, 0 or 1, only valid when there are no x or z */
+        int compare(VerilogBits& other, bit_value_t pad_this, bit_value_t pad_other)
+        {
+            size_t length = std::max(this->size(), other.size());
+            return compare_binary(this->to_binary(length, pad_this), other.to_binary(length, pad_other));
+        }
     }; 
 }
 
 class VNumber 
 {
 private:
-    bool sign;
+    bool sign = false;
     BitSpace::VerilogBits *bitstring = nullptr;
 
     VNumber(BitSpace::VerilogBits *other_bitstring, bool other_sign)
@@ -470,15 +778,45 @@ public:
 
     }
 
-    VNumber(VNumber&&) = default;
-    VNumber& operator=(VNumber&&) = default;
-    VNumber& operator=(const VNumber& other) = default;
+    VNumber(VNumber&& other)
+    {
+
+        this->sign = other.sign;
+        this->bitstring = other.bitstring;
+        other.bitstring = nullptr;
+
+    }
+
+    VNumber& operator=(VNumber&& other)
+    {
+        if(this != &other)
+        {
+            delete this->bitstring;
+
+            this->sign = other.sign;
+            this->bitstring = other.bitstring;
+            other.bitstring = nullptr;
+        }
+        return *this;
+    }
+
+    VNumber& operator=(const VNumber& other)
+    {
+        if(this != &other)
+        {
+            delete this->bitstring;
+
+            this->sign = other.sign;
+            this->bitstring = (other.bitstring)? new BitSpace::VerilogBits(*other.bitstring): nullptr;
+        }
+        return *this;
+    }
 
     VNumber(const VNumber& other)
     {
 
         this->sign = other.sign;
-        this->bitstring = new BitSpace::VerilogBits(*other.bitstring);
+        this->bitstring = (other.bitstring)? new BitSpace::VerilogBits(*other.bitstring): nullptr;
 
     }
 
@@ -586,7 +924,7 @@ public:
 
         //remove underscores
         std::string v_value_str = verilog_string.substr(loc+2+sign);
-        verilog_string.erase(std::remove(v_value_str.begin(), v_value_str.end(), '_'), v_value_str.end());
+        v_value_str.erase(std::remove(v_value_str.begin(), v_value_str.end(), '_'), v_value_str.end());
 
         //little endian bitstring string
         std::string temp_bitstring = string_of_radix_to_bitstring(v_value_str, radix);
@@ -708,22 +1046,68 @@ public:
         const BitSpace::bit_value_t pad_a = this->get_padding_bit();
         const BitSpace::bit_value_t pad_b = b.get_padding_bit();
 
-        VNumber result(std_length, BitSpace::_x, false);
+        return VNumber(this->bitstring->bitwise(*b.bitstring, pad_a, pad_b, std_length, lut), false);
+    }
 
-        for(size_t i=0; i < result.size(); i++)
-        {
-            BitSpace::bit_value_t bit_a = pad_a;
-            if(i < this->size())
-                bit_a = this->get_bit_from_lsb(i);
+    /**
+     * Arithmetic, these process a word of bits at a time
+     */
+    VNumber sum(VNumber& b)
+    {
+        size_t std_length = std::max(this->size(), b.size());
+        const BitSpace::bit_value_t pad_a = this->get_padding_bit();
+        const BitSpace::bit_value_t pad_b = b.get_padding_bit();
 
-            BitSpace::bit_value_t bit_b = pad_b;
-            if(i < b.size())
-                bit_b = b.get_bit_from_lsb(i);
+        return VNumber(this->bitstring->sum(*b.bitstring, pad_a, pad_b, BitSpace::_0, std_length), false);
+    }
 
-            result.set_bit_from_lsb(i, lut[bit_a][bit_b]);
-        }
+    /* a - b is a + ~b + 1, b is extended before it is inverted */
+    VNumber difference(VNumber& b)
+    {
+        size_t std_length = std::max(this->size(), b.size());
+        const BitSpace::bit_value_t pad_a = this->get_padding_bit();
+        const BitSpace::bit_value_t pad_b = BitSpace::l_not[b.get_padding_bit()];
 
-        return result;
+        BitSpace::VerilogBits *inverted_b = b.bitstring->invert();
+        BitSpace::VerilogBits *result = this->bitstring->sum(*inverted_b, pad_a, pad_b, BitSpace::_1, std_length);
+        delete inverted_b;
+
+        return VNumber(result, false);
+    }
+
+    VNumber shift_left(size_t amount, bool result_sign)
+    {
+        int64_t offset = -static_cast<int64_t>(amount);
+        return VNumber(this->bitstring->shift(offset, BitSpace::_0, BitSpace::_0, this->size() + amount), result_sign);
+    }
+
+    VNumber shift_right(size_t amount, BitSpace::bit_value_t pad, bool result_sign)
+    {
+        int64_t offset = static_cast<int64_t>(amount);
+        return VNumber(this->bitstring->shift(offset, BitSpace::_0, pad, this->size()), result_sign);
+    }
+
+    /* the following treat both numbers as unsigned and must not contain x or z */
+    VNumber multiply(VNumber& b)
+    {
+        return VNumber(this->bitstring->multiply(*b.bitstring), false);
+    }
+
+    VNumber divide(VNumber& b)
+    {
+        size_t std_length = std::max(this->size(), b.size());
+        return VNumber(this->bitstring->divide(*b.bitstring, false, std_length), false);
+    }
+
+    VNumber modulo(VNumber& b)
+    {
+        size_t std_length = std::max(this->size(), b.size());
+        return VNumber(this->bitstring->divide(*b.bitstring, true, std_length), false);
+    }
+
+    int compare(VNumber& b)
+    {
+        return this->bitstring->compare(*b.bitstring, this->get_padding_bit(), b.get_padding_bit());
     }
 
 };
@@ -55,11 +55,18 @@ static compare_bit eval_op(VNumber& a_in, VNumber& b_in)
 
 	if(neg_a && !neg_b)
 	{
-		return GT_EVAL;
+		return LT_EVAL;
 	}
 	else if(!neg_a && neg_b)
 	{
-		return LT_EVAL;
+		return GT_EVAL;
+	}
+
+	if(!a_in.is_dont_care_string() && !b_in.is_dont_care_string())
+	{
+		// both have the same sign so the sign extended bits compare as unsigned
+		int cmp = a_in.compare(b_in);
+		return (cmp < 0)? LT_EVAL: (cmp > 0)? GT_EVAL: EQ_EVAL;
 	}
 
 	VNumber a;
@@ -125,7 +132,7 @@ static compare_bit eval_op(VNumber a,int64_t b)
 /**
  * Addition operations
  */
-static VNumber sum_op(VNumber& a, VNumber& b, const bit_value_t& initial_carry)
+static VNumber sum_op(VNumber& a, VNumber& b, bool subtract)
 {
 	assert_Werr( a.size() ,
 		"empty 1st bit string" 
@@ -135,36 +142,12 @@ static VNumber sum_op(VNumber& a, VNumber& b, const bit_value_t& initial_carry)
 		"empty 2nd bit string" 
 	);
 
-	size_t std_length = std::max(a.size(), b.size());
-	const bit_value_t pad_a = a.get_padding_bit();
-	const bit_value_t pad_b = b.get_padding_bit();
-
-	bit_value_t previous_carry = initial_carry;
-	VNumber result(std_length+1, _x, false);
-
-	for(size_t i=0; i < std_length-1; i++)
-	{
-		bit_value_t bit_a = pad_a;
-		if(i < a.size())
-			bit_a = a.get_bit_from_lsb(i);
-
-		bit_value_t bit_b = pad_b;
-		if(i < b.size())
-			bit_b = b.get_bit_from_lsb(i);
-
-		result.set_bit_from_lsb(i, l_sum[previous_carry][bit_a][bit_b]);
-		previous_carry = l_carry[previous_carry][bit_a][bit_b];
-	}
-	result.set_bit_from_lsb(std_length-1, previous_carry);
-
-	return result;
+	return (subtract)? a.difference(b): a.sum(b);
 }
 
 static VNumber shift_op(VNumber& a, int64_t b, bool sign_shift)
 {
 	VNumber to_return;
-	if(b < static_cast<int64_t>(a.size()))
-		b = 0;
 
 	//if b is negative than shift right
 	if(b==0)
@@ -175,21 +158,12 @@ static VNumber shift_op(VNumber& a, int64_t b, bool sign_shift)
 	{
 		size_t u_b = static_cast<size_t>(-b);
 		bit_value_t pad = ( sign_shift ) ? a.get_padding_bit(): BitSpace::_0;
-		to_return = VNumber(a.size(), pad, sign_shift);
-		for(size_t i=0; i < (a.size() + u_b); i++)
-		{
-			to_return.set_bit_from_lsb(i, a.get_bit_from_lsb(i-u_b));
-		}
+		to_return = a.shift_right(u_b, pad, sign_shift);
 	}
 	else
 	{
 		size_t u_b = static_cast<size_t>(b);
-		bit_value_t pad = BitSpace::_0;
-		to_return =VNumber((a.size() + u_b), pad, sign_shift);
-		for(size_t i=0; i < a.size(); i++)
-		{
-			to_return.set_bit_from_lsb(i+u_b, a.get_bit_from_lsb(i));
-		}
+		to_return = a.shift_left(u_b, sign_shift);
 	}
 	return to_return;
 }
@@ -419,13 +393,12 @@ VNumber V_SHIFT_RIGHT(VNumber& a, VNumber& b)
 
 VNumber V_ADD(VNumber& a, VNumber& b)
 {
-	return sum_op(a, b, _0);
+	return sum_op(a, b, false);
 }
 
 VNumber V_MINUS(VNumber& a, VNumber& b)
 {
-	VNumber complement = V_MINUS(b);
-	return sum_op(a, complement, _1);
+	return sum_op(a, b, true);
 }
 
 VNumber V_MULTIPLY(VNumber& a_in, VNumber& b_in)
@@ -451,16 +424,7 @@ VNumber V_MULTIPLY(VNumber& a_in, VNumber& b_in)
 		
 	bool invert_result = ((!neg_a && neg_b) || (neg_a && !neg_b));
 
-	VNumber result("0");
-	VNumber b_copy = b;
-
-	for(size_t i=0; i< a.size(); i++)
-	{
-		bit_value_t bit_a = a.get_bit_from_lsb(i);
-		if(bit_a == _1)
-			result = V_ADD(result,b);
-		shift_op(b_copy, 1, _0);
-	}
+	VNumber result = a.multiply(b);
 
 	if(invert_result)	
 		result = V_MINUS(result);
@@ -518,47 +482,42 @@ VNumber V_POWER(VNumber& a, VNumber& b)
 }
 
 /////////////////////////////
-VNumber V_DIV(VNumber& a_in, VNumber& b)
+VNumber V_DIV(VNumber& a_in, VNumber& b_in)
 {
-	if(a_in.is_dont_care_string() || b.is_dont_care_string() || eval_op(b,0).is_eq())
+	if(a_in.is_dont_care_string() || b_in.is_dont_care_string() || eval_op(b_in,0).is_eq())
 		return VNumber("x");
 
-	VNumber a(a_in);
+	bool neg_a = a_in.is_negative();
+	bool neg_b = b_in.is_negative();
+
+	VNumber a = (neg_a)? V_MINUS(a_in): a_in;
+	VNumber b = (neg_b)? V_MINUS(b_in): b_in;
+
+	// the quotient is negative when only one of the operands is
+	VNumber result = a.divide(b);
+	if(neg_a != neg_b)
+		result = V_MINUS(result);
 
-	VNumber result("0");
-	while(eval_op(a, b).is_gt() )
-	{
-		VNumber  count("1");
-		VNumber  sub_with = b;
-		VNumber  tmp = b;
-		while(eval_op(tmp, a).is_lt())
-		{
-			sub_with = tmp;
-			shift_op(count, 1,_0);
-			shift_op(tmp, 1,_0);
-		}
-		a = V_MINUS(a, sub_with);
-		result = V_ADD(result, count);
-	}
 	return result;
 }
 
-VNumber V_MOD(VNumber& a_in, VNumber& b)
+VNumber V_MOD(VNumber& a_in, VNumber& b_in)
 {
-	if(a_in.is_dont_care_string() || b.is_dont_care_string() || eval_op(b, 0).is_eq())
+	if(a_in.is_dont_care_string() || b_in.is_dont_care_string() || eval_op(b_in, 0).is_eq())
 		return VNumber("x");
 
-	VNumber to_return(a_in);
-	while(eval_op(b, to_return).is_lt())
-	{
-		VNumber  sub_with = b;
-		for( VNumber  tmp = b; eval_op(tmp, to_return).is_lt(); shift_op(tmp, 1,_0))
-		{
-			sub_with = tmp;
-		}
-		to_return = V_MINUS(to_return, sub_with);
-	}
-	return to_return;
+	bool neg_a = a_in.is_negative();
+	bool neg_b = b_in.is_negative();
+
+	VNumber a = (neg_a)? V_MINUS(a_in): a_in;
+	VNumber b = (neg_b)? V_MINUS(b_in): b_in;
+
+	// the remainder takes the sign of the first operand
+	VNumber result = a.modulo(b);
+	if(neg_a)
+		result = V_MINUS(result);
+
+	return result;
 }
 
 /***
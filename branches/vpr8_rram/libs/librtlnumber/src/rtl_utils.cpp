@@ -159,10 +159,10 @@ std::string string_of_radix_to_bitstring(std::string orig_string, short radix)
 				}
 
                 result.insert(result.begin(),rem_digit);
-                if(new_number == "0")
-                    orig_string = "";
-                else
-                    orig_string = new_number;
+
+                // drop the leading zeros, the number is done once nothing is left
+                new_number.erase(0, new_number.find_first_not_of('0'));
+                orig_string = new_number;
 
 				break;
 			}
@@ -174,5 +174,10 @@ std::string string_of_radix_to_bitstring(std::string orig_string, short radix)
 			}
 		}
 	}
+
+	// decimal numbers are never negative, keep a 0 msb for when they are read as signed
+	if(radix == 10)
+		result.insert(result.begin(), '0');
+
 	return result;
 }
@@ -87,6 +87,7 @@ void SetupVPR(t_options *Options,
 	FileNameOpts->PlaceFile = Options->PlaceFile;
 	FileNameOpts->RouteFile = Options->RouteFile;
 	FileNameOpts->ActFile = Options->ActFile;
+	FileNameOpts->BatchActFiles = Options->BatchActFiles;
 	FileNameOpts->PowerFile = Options->PowerFile;
 	FileNameOpts->CmosTechFile = Options->CmosTechFile;
 	FileNameOpts->out_file_prefix = Options->out_file_prefix;
@@ -365,6 +366,13 @@ static void SetupRouterOpts(const t_options& Options, t_router_opts *RouterOpts)
     RouterOpts->max_convergence_count = Options.router_max_convergence_count;
     RouterOpts->reconvergence_cpd_threshold = Options.router_reconvergence_cpd_threshold;
     RouterOpts->first_iteration_timing_report_file = Options.router_first_iteration_timing_report_file;
+    RouterOpts->telemetry_file = Options.router_telemetry_file;
+    RouterOpts->checkpoint_file = Options.router_checkpoint_file;
+    RouterOpts->checkpoint_interval = Options.router_checkpoint_interval;
+    if (RouterOpts->checkpoint_interval < 1) {
+        vpr_throw(VPR_ERROR_OTHER, __FILE__, __LINE__, "router_checkpoint_interval must be at least 1.\n");
+    }
+    RouterOpts->resume_checkpoint_file = Options.router_resume_checkpoint;
 }
 
 static void SetupAnnealSched(const t_options& Options,
@@ -433,6 +441,7 @@ void SetupPackerOpts(const t_options& Options,
     PackerOpts->device_layout = Options.device_layout;
 
 	PackerOpts->hmetis_input_file = Options.hmetis_input_file;
+	PackerOpts->num_partitions = Options.pack_num_partitions;
 }
 
 static void SetupNetlistOpts(const t_options& Options, t_netlist_opts& NetlistOpts) {
@@ -469,6 +478,8 @@ static void SetupPlacerOpts(const t_options& Options, t_placer_opts *PlacerOpts)
 	PlacerOpts->pad_loc_type = Options.pad_loc_type;
 
 	PlacerOpts->place_chan_width = Options.PlaceChanWidth;
+	PlacerOpts->num_partitions = Options.place_num_partitions;
+	PlacerOpts->analytic_initial_placement = Options.analytic_initial_placement;
 
 	PlacerOpts->recompute_crit_iter = Options.RecomputeCritIter;
 
@@ -501,6 +512,7 @@ static void SetupAnalysisOpts(const t_options& Options, t_analysis_opts& analysi
     analysis_opts.timing_report_npaths = Options.timing_report_npaths;
     analysis_opts.timing_report_detail = Options.timing_report_detail;
     analysis_opts.timing_report_skew = Options.timing_report_skew;
+    analysis_opts.congestion_report_prefix = Options.congestion_report_prefix;
 }
 
 static void SetupPowerOpts(const t_options& Options, t_power_opts *power_opts,
@@ -414,6 +414,7 @@
 #include <string>
 #include <vector>
 #include <unordered_map>
+#include <iterator>
 #include "vtr_range.h"
 #include "vtr_logic.h"
 #include "vtr_vector_map.h"
@@ -444,10 +445,44 @@ class NetlistIdRemapper {
 
 template<typename BlockId, typename PortId, typename PinId, typename NetId>
 class Netlist {
+    protected: //Protected Base Types
+        struct string_id_tag;
+
+        //A unique identifier for a string in the netlist
+        typedef vtr::StrongId<string_id_tag> StringId;
+
+        //A block attribute/parameter, stored as interned (name, value) strings
+        typedef std::pair<StringId,StringId> StringIdPair;
+
     public: //Public Types
+        //Iterates over a block's attributes (or parameters), resolving the interned
+        //names and values back to strings. Dereferencing yields a (name, value) pair
+        //of string references, so clients may use it like a map entry.
+        class attr_iterator {
+            public:
+                typedef std::forward_iterator_tag                           iterator_category;
+                typedef std::pair<const std::string&, const std::string&>   value_type;
+                typedef std::ptrdiff_t                                      difference_type;
+                typedef void                                                pointer;
+                typedef value_type                                          reference;
+
+                attr_iterator(typename std::vector<StringIdPair>::const_iterator iter, const vtr::vector_map<StringId,std::string>& strings)
+                    : iter_(iter), strings_(&strings) {}
+
+                reference operator*() const { return reference((*strings_)[iter_->first], (*strings_)[iter_->second]); }
+
+                attr_iterator& operator++() { ++iter_; return *this; }
+                attr_iterator operator++(int) { attr_iterator prev = *this; ++iter_; return prev; }
+
+                friend bool operator==(const attr_iterator& lhs, const attr_iterator& rhs) { return lhs.iter_ == rhs.iter_; }
+                friend bool operator!=(const attr_iterator& lhs, const attr_iterator& rhs) { return !(lhs == rhs); }
+            private:
+                typename std::vector<StringIdPair>::const_iterator iter_;
+                const vtr::vector_map<StringId,std::string>* strings_;
+        };
+
         typedef typename vtr::vector_map<BlockId, BlockId>::const_iterator              block_iterator;
-        typedef typename std::unordered_map<std::string, std::string>::const_iterator   attr_iterator;
-        typedef typename std::unordered_map<std::string, std::string>::const_iterator   param_iterator;
+        typedef attr_iterator                                                           param_iterator;
         typedef typename vtr::vector_map<NetId, NetId>::const_iterator                  net_iterator;
         typedef typename vtr::vector_map<PinId, PinId>::const_iterator                  pin_iterator;
         typedef typename vtr::vector_map<PortId, PortId>::const_iterator                port_iterator;
@@ -492,6 +527,10 @@ class Netlist {
         //Item counts and container info (for debugging)
         void print_stats() const;
 
+        //Approximate memory footprint of each netlist component (blocks, ports,
+        //pins, nets, strings and block attributes/parameters)
+        void print_memory_usage() const;
+
         /*
          * Blocks
          */
@@ -777,12 +816,6 @@ class Netlist {
         //  sinks   : The net's sink pins
         NetId   add_net(const std::string name, PinId driver, std::vector<PinId> sinks);
 
-    protected: //Protected Base Types
-        struct string_id_tag;
-
-        //A unique identifier for a string in the netlist
-        typedef vtr::StrongId<string_id_tag> StringId;
-
     protected: //Protected Base Members
         /*
          * Lookups
@@ -806,6 +839,10 @@ class Netlist {
         //  str: The string whose ID is requested
         StringId create_string(const std::string& str);
 
+        //Sets the value of the named entry in a block's attribute/parameter list,
+        //adding it if not already present
+        void set_block_string_pair(std::vector<StringIdPair>& pairs, const std::string& name, const std::string& value);
+
         //Updates net cross-references for the specified pin
         //Returns the pin's index within the net
         int associate_pin_with_net(const PinId pin_id, const PinType type, const NetId net_id);
@@ -939,8 +976,11 @@ class Netlist {
         vtr::vector_map<BlockId, unsigned>                  block_num_output_pins_;    //Number of output pins on each block
         vtr::vector_map<BlockId, unsigned>                  block_num_clock_pins_;     //Number of clock pins on each block
 
-        vtr::vector_map<BlockId, std::unordered_map<std::string,std::string>>       block_params_;        //Parameters of each block
-        vtr::vector_map<BlockId, std::unordered_map<std::string,std::string>>       block_attrs_;         //Attributes of each block
+        //Block parameters and attributes are typically few per block (and absent on most),
+        //so they are kept as small flat arrays of interned (name, value) pairs in creation
+        //order, rather than a hash table of strings per block
+        vtr::vector_map<BlockId, std::vector<StringIdPair>> block_params_;             //Parameters of each block
+        vtr::vector_map<BlockId, std::vector<StringIdPair>> block_attrs_;              //Attributes of each block
 
         //Port data
         vtr::vector_map<PortId, PortId>                 port_ids_;      //Valid port ids
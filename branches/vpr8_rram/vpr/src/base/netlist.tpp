@@ -78,6 +78,80 @@ void Netlist<BlockId, PortId, PinId, NetId>::print_stats() const {
     VTR_LOG("Strings %zu capacity/size: %.2f\n", string_ids_.size(), float(string_ids_.capacity()) / string_ids_.size());
 }
 
+//Bytes allocated by a vector-like container (excluding any heap storage owned by its elements)
+template<typename Container>
+static size_t netlist_container_bytes(const Container& container) {
+    return container.capacity() * sizeof(*container.begin());
+}
+
+//Bytes allocated by a vector-like container of vector-like containers
+template<typename Container>
+static size_t netlist_nested_container_bytes(const Container& container) {
+    size_t bytes = netlist_container_bytes(container);
+    for (const auto& inner : container) {
+        bytes += netlist_container_bytes(inner);
+    }
+    return bytes;
+}
+
+template<typename BlockId, typename PortId, typename PinId, typename NetId>
+void Netlist<BlockId, PortId, PinId, NetId>::print_memory_usage() const {
+    size_t block_bytes = netlist_container_bytes(block_ids_)
+                       + netlist_container_bytes(block_names_)
+                       + netlist_nested_container_bytes(block_ports_)
+                       + netlist_container_bytes(block_num_input_ports_)
+                       + netlist_container_bytes(block_num_output_ports_)
+                       + netlist_container_bytes(block_num_clock_ports_)
+                       + netlist_nested_container_bytes(block_pins_)
+                       + netlist_container_bytes(block_num_input_pins_)
+                       + netlist_container_bytes(block_num_output_pins_)
+                       + netlist_container_bytes(block_num_clock_pins_)
+                       + netlist_container_bytes(block_name_to_block_id_);
+
+    size_t attr_bytes = netlist_nested_container_bytes(block_attrs_)
+                      + netlist_nested_container_bytes(block_params_);
+
+    size_t port_bytes = netlist_container_bytes(port_ids_)
+                      + netlist_container_bytes(port_names_)
+                      + netlist_container_bytes(port_blocks_)
+                      + netlist_nested_container_bytes(port_pins_)
+                      + netlist_container_bytes(port_widths_)
+                      + netlist_container_bytes(port_types_);
+
+    size_t pin_bytes = netlist_container_bytes(pin_ids_)
+                     + netlist_container_bytes(pin_ports_)
+                     + netlist_container_bytes(pin_port_bits_)
+                     + netlist_container_bytes(pin_nets_)
+                     + netlist_container_bytes(pin_net_indices_)
+                     + netlist_container_bytes(pin_is_constant_);
+
+    size_t net_bytes = netlist_container_bytes(net_ids_)
+                     + netlist_container_bytes(net_names_)
+                     + netlist_nested_container_bytes(net_pins_)
+                     + netlist_container_bytes(net_name_to_net_id_);
+
+    //The string look-up is a hash table of node-allocated entries; approximate each node
+    //as the key/value pair plus a next pointer, alongside the bucket array
+    size_t string_bytes = netlist_nested_container_bytes(strings_)
+                        + netlist_container_bytes(string_ids_)
+                        + string_to_string_id_.bucket_count() * sizeof(void*)
+                        + string_to_string_id_.size() * (sizeof(typename decltype(string_to_string_id_)::value_type) + sizeof(void*));
+    for (const auto& kv : string_to_string_id_) {
+        string_bytes += kv.first.capacity();
+    }
+
+    size_t total_bytes = block_bytes + attr_bytes + port_bytes + pin_bytes + net_bytes + string_bytes;
+
+    VTR_LOG("Netlist '%s' memory usage (approximate):\n", netlist_name_.c_str());
+    VTR_LOG("  Blocks        : %10.2f KiB\n", block_bytes / 1024.);
+    VTR_LOG("  Attrs/Params  : %10.2f KiB\n", attr_bytes / 1024.);
+    VTR_LOG("  Ports         : %10.2f KiB\n", port_bytes / 1024.);
+    VTR_LOG("  Pins          : %10.2f KiB\n", pin_bytes / 1024.);
+    VTR_LOG("  Nets          : %10.2f KiB\n", net_bytes / 1024.);
+    VTR_LOG("  Strings       : %10.2f KiB (%zu unique)\n", string_bytes / 1024., strings_.size());
+    VTR_LOG("  Total         : %10.2f KiB\n", total_bytes / 1024.);
+}
+
 /*
  *
  * Blocks
@@ -100,14 +174,16 @@ template<typename BlockId, typename PortId, typename PinId, typename NetId>
 typename Netlist<BlockId, PortId, PinId, NetId>::attr_range Netlist<BlockId, PortId, PinId, NetId>::block_attrs(const BlockId blk_id) const {
     VTR_ASSERT_SAFE(valid_block_id(blk_id));
 
-    return vtr::make_range(block_attrs_[blk_id].begin(), block_attrs_[blk_id].end());
+    return vtr::make_range(attr_iterator(block_attrs_[blk_id].begin(), strings_),
+                           attr_iterator(block_attrs_[blk_id].end(), strings_));
 }
 
 template<typename BlockId, typename PortId, typename PinId, typename NetId>
 typename Netlist<BlockId, PortId, PinId, NetId>::param_range Netlist<BlockId, PortId, PinId, NetId>::block_params(const BlockId blk_id) const {
     VTR_ASSERT_SAFE(valid_block_id(blk_id));
 
-    return vtr::make_range(block_params_[blk_id].begin(), block_params_[blk_id].end());
+    return vtr::make_range(param_iterator(block_params_[blk_id].begin(), strings_),
+                           param_iterator(block_params_[blk_id].end(), strings_));
 }
 
 template<typename BlockId, typename PortId, typename PinId, typename NetId>
@@ -859,14 +935,14 @@ template<typename BlockId, typename PortId, typename PinId, typename NetId>
 void Netlist<BlockId, PortId, PinId, NetId>::set_block_attr(const BlockId blk_id, const std::string &name, const std::string &value) {
     VTR_ASSERT(valid_block_id(blk_id));
 
-    block_attrs_[blk_id][name] = value;
+    set_block_string_pair(block_attrs_[blk_id], name, value);
 }
 
 template<typename BlockId, typename PortId, typename PinId, typename NetId>
 void Netlist<BlockId, PortId, PinId, NetId>::set_block_param(const BlockId blk_id, const std::string &name, const std::string &value) {
     VTR_ASSERT(valid_block_id(blk_id));
 
-    block_params_[blk_id][name] = value;
+    set_block_string_pair(block_params_[blk_id], name, value);
 }
 
 template<typename BlockId, typename PortId, typename PinId, typename NetId>
@@ -1381,6 +1457,15 @@ void Netlist<BlockId, PortId, PinId, NetId>::shrink_to_fit() {
     block_num_output_ports_.shrink_to_fit();
     block_num_clock_ports_.shrink_to_fit();
 
+    block_attrs_.shrink_to_fit();
+    for (auto& attrs : block_attrs_) {
+        attrs.shrink_to_fit();
+    }
+    block_params_.shrink_to_fit();
+    for (auto& params : block_params_) {
+        params.shrink_to_fit();
+    }
+
     VTR_ASSERT(validate_block_sizes());
 
     //Port data
@@ -1988,6 +2073,21 @@ typename Netlist<BlockId, PortId, PinId, NetId>::StringId Netlist<BlockId, PortI
     return str_id;
 }
 
+template<typename BlockId, typename PortId, typename PinId, typename NetId>
+void Netlist<BlockId, PortId, PinId, NetId>::set_block_string_pair(std::vector<StringIdPair>& pairs, const std::string& name, const std::string& value) {
+    StringId name_id = create_string(name);
+    StringId value_id = create_string(value);
+
+    //Blocks carry only a handful of entries, so a linear scan beats any lookup structure
+    for (StringIdPair& pair : pairs) {
+        if (pair.first == name_id) {
+            pair.second = value_id;
+            return;
+        }
+    }
+    pairs.emplace_back(name_id, value_id);
+}
+
 template<typename BlockId, typename PortId, typename PinId, typename NetId>
 NetId Netlist<BlockId, PortId, PinId, NetId>::find_net(const typename Netlist<BlockId, PortId, PinId, NetId>::StringId name_id) const {
     VTR_ASSERT_SAFE(valid_string_id(name_id));
@@ -18,7 +18,6 @@
 #include <cstdio>
 #include <cstring>
 #include <ctime>
-#include <sstream>
 #include <unordered_set>
 #include <cctype> //std::isdigit
 using namespace std;
@@ -44,7 +43,7 @@ using namespace std;
 
 vtr::LogicValue to_vtr_logic_value(blifparse::LogicValue);
 
-struct BlifAllocCallback : public blifparse::Callback {
+struct BlifAllocCallback : public blifparse::ViewCallback {
     public:
         BlifAllocCallback(e_circuit_format blif_format, AtomNetlist& main_netlist, 
                           const std::string netlist_id, 
@@ -73,16 +72,16 @@ struct BlifAllocCallback : public blifparse::Callback {
             main_netlist_ = std::move(blif_models_[main_netlist_idx]);
         }
 
-        void begin_model(std::string model_name) override {
+        void begin_model(blifparse::StringView model_name) override {
             //Create a new model, and set it's name
 
-            blif_models_.emplace_back(model_name, netlist_id_);
+            blif_models_.emplace_back(model_name.str(), netlist_id_);
             blif_models_black_box_.emplace_back(false);
             ended_ = false;
             set_curr_block(AtomBlockId::INVALID()); //This statement doesn't define a block, so mark invalid
         }
 
-        void inputs(std::vector<std::string> input_names) override {
+        void inputs(const std::vector<blifparse::StringView>& input_names) override {
             const t_model* blk_model = find_model(MODEL_INPUT);
 
             VTR_ASSERT_MSG(!blk_model->inputs, "Inpad model has an input port");
@@ -91,7 +90,8 @@ struct BlifAllocCallback : public blifparse::Callback {
             VTR_ASSERT_MSG(!blk_model->outputs->next, "Inpad model has multiple output ports");
 
             std::string pin_name = blk_model->outputs->name;
-            for(const auto& input : input_names) {
+            for(blifparse::StringView input_view : input_names) {
+                std::string input = input_view.str();
                 AtomBlockId blk_id = curr_model().create_block(input, blk_model);
                 AtomPortId port_id = curr_model().create_port(blk_id, blk_model->outputs);
                 AtomNetId net_id = curr_model().create_net(input);
@@ -100,7 +100,7 @@ struct BlifAllocCallback : public blifparse::Callback {
             set_curr_block(AtomBlockId::INVALID()); //This statement doesn't define a block, so mark invalid
         }
 
-        void outputs(std::vector<std::string> output_names) override {
+        void outputs(const std::vector<blifparse::StringView>& output_names) override {
             const t_model* blk_model = find_model(MODEL_OUTPUT);
 
             VTR_ASSERT_MSG(!blk_model->outputs, "Outpad model has an output port");
@@ -109,7 +109,8 @@ struct BlifAllocCallback : public blifparse::Callback {
             VTR_ASSERT_MSG(!blk_model->inputs->next, "Outpad model has multiple input ports");
 
             std::string pin_name = blk_model->inputs->name;
-            for(const auto& output : output_names) {
+            for(blifparse::StringView output_view : output_names) {
+                std::string output = output_view.str();
                 //Since we name blocks based on their drivers we need to uniquify outpad names,
                 //which we do with a prefix
                 AtomBlockId blk_id = curr_model().create_block(OUTPAD_NAME_PREFIX + output, blk_model);
@@ -120,7 +121,7 @@ struct BlifAllocCallback : public blifparse::Callback {
             set_curr_block(AtomBlockId::INVALID()); //This statement doesn't define a block, so mark invalid
         }
 
-        void names(std::vector<std::string> nets, std::vector<std::vector<blifparse::LogicValue>> so_cover) override {
+        void names(const std::vector<blifparse::StringView>& nets, const blifparse::SopCover& so_cover) override {
             const t_model* blk_model = find_model(MODEL_NAMES);
 
             VTR_ASSERT_MSG(nets.size() > 0, "BLIF .names has no connections");
@@ -138,20 +139,22 @@ struct BlifAllocCallback : public blifparse::Callback {
 
             //Convert the single-output cover to a netlist truth table
             AtomNetlist::TruthTable truth_table;
-            for(const auto& row : so_cover) {
-                truth_table.emplace_back();
-                for(auto val : row) {
-                    truth_table[truth_table.size()-1].push_back(to_vtr_logic_value(val));
+            truth_table.resize(so_cover.num_rows());
+            for(size_t irow = 0; irow < so_cover.num_rows(); ++irow) {
+                truth_table[irow].reserve(so_cover.num_cols());
+                for(size_t icol = 0; icol < so_cover.num_cols(); ++icol) {
+                    truth_table[irow].push_back(to_vtr_logic_value(so_cover.value(irow, icol)));
                 }
             }
 
-            AtomBlockId blk_id = curr_model().create_block(nets[nets.size()-1], blk_model, truth_table);
+            std::string output_name = nets[nets.size()-1].str();
+            AtomBlockId blk_id = curr_model().create_block(output_name, blk_model, truth_table);
             set_curr_block(blk_id);
 
             //Create inputs
             AtomPortId input_port_id = curr_model().create_port(blk_id, blk_model->inputs);
             for(size_t i = 0; i < nets.size() - 1; ++i) {
-                AtomNetId net_id = curr_model().create_net(nets[i]);
+                AtomNetId net_id = curr_model().create_net(nets[i].str());
 
                 curr_model().create_pin(input_port_id, i, net_id, PinType::SINK);
             }
@@ -174,7 +177,7 @@ struct BlifAllocCallback : public blifparse::Callback {
                 //  0
                 //
                 output_is_const = true;
-                VTR_LOG("Found constant-zero generator '%s'\n", nets[nets.size()-1].c_str());
+                VTR_LOG("Found constant-zero generator '%s'\n", output_name.c_str());
             } else if(truth_table.size() == 1 && truth_table[0].size() == 1 && truth_table[0][0] == vtr::LogicValue::TRUE) {
                 //A single-entry truth table with value '1' in BLIF corresponds to a constant-one
                 //  e.g.
@@ -184,18 +187,18 @@ struct BlifAllocCallback : public blifparse::Callback {
                 //  1
                 //
                 output_is_const = true;
-                VTR_LOG("Found constant-one generator '%s'\n", nets[nets.size()-1].c_str());
+                VTR_LOG("Found constant-one generator '%s'\n", output_name.c_str());
             }
 
             //Create output
-            AtomNetId net_id = curr_model().create_net(nets[nets.size()-1]);
+            AtomNetId net_id = curr_model().create_net(output_name);
             AtomPortId output_port_id = curr_model().create_port(blk_id, blk_model->outputs);
             curr_model().create_pin(output_port_id, 0, net_id, PinType::DRIVER, output_is_const);
         }
 
-        void latch(std::string input, std::string output, blifparse::LatchType type, std::string control, blifparse::LogicValue init) override {
+        void latch(blifparse::StringView input, blifparse::StringView output, blifparse::LatchType type, blifparse::StringView control, blifparse::LogicValue init) override {
             if(type == blifparse::LatchType::UNSPECIFIED) {
-                VTR_LOGF_WARN(filename_.c_str(), lineno_, "Treating latch '%s' of unspecified type as rising edge triggered\n", output.c_str());
+                VTR_LOGF_WARN(filename_.c_str(), lineno_, "Treating latch '%s' of unspecified type as rising edge triggered\n", output.str().c_str());
             } else if(type != blifparse::LatchType::RISING_EDGE) {
                 vpr_throw(VPR_ERROR_BLIF_F, filename_.c_str(), lineno_, "Only rising edge latches supported\n");
             }
@@ -228,26 +231,26 @@ struct BlifAllocCallback : public blifparse::Callback {
             AtomNetlist::TruthTable truth_table(1);
             truth_table[0].push_back(to_vtr_logic_value(init));
 
-            AtomBlockId blk_id = curr_model().create_block(output, blk_model, truth_table);
+            AtomBlockId blk_id = curr_model().create_block(output.str(), blk_model, truth_table);
             set_curr_block(blk_id);
 
             //The input
             AtomPortId d_port_id = curr_model().create_port(blk_id, d_model_port);
-            AtomNetId d_net_id = curr_model().create_net(input);
+            AtomNetId d_net_id = curr_model().create_net(input.str());
             curr_model().create_pin(d_port_id, 0, d_net_id, PinType::SINK);
 
             //The output
             AtomPortId q_port_id = curr_model().create_port(blk_id, q_model_port);
-            AtomNetId q_net_id = curr_model().create_net(output);
+            AtomNetId q_net_id = curr_model().create_net(output.str());
             curr_model().create_pin(q_port_id, 0, q_net_id, PinType::DRIVER);
 
             //The clock
             AtomPortId clk_port_id = curr_model().create_port(blk_id, clk_model_port);
-            AtomNetId clk_net_id = curr_model().create_net(control);
+            AtomNetId clk_net_id = curr_model().create_net(control.str());
             curr_model().create_pin(clk_port_id, 0, clk_net_id, PinType::SINK);
         }
 
-        void subckt(std::string subckt_model, std::vector<std::string> ports, std::vector<std::string> nets) override {
+        void subckt(blifparse::StringView subckt_model, const std::vector<blifparse::StringView>& ports, const std::vector<blifparse::StringView>& nets) override {
             VTR_ASSERT(ports.size() == nets.size());
 
             const t_model* blk_model = find_model(subckt_model);
@@ -259,7 +262,7 @@ struct BlifAllocCallback : public blifparse::Callback {
                 VTR_ASSERT(model_port);
 
                 if(model_port->dir == OUT_PORT) {
-                    subckt_name = nets[i];
+                    subckt_name = nets[i].str();
                     break;
                 }
             }
@@ -281,7 +284,7 @@ struct BlifAllocCallback : public blifparse::Callback {
                 vpr_throw(VPR_ERROR_BLIF_F, filename_.c_str(), lineno_,
                           "Duplicate blocks named '%s' found in netlist."
                           " Existing block of type '%s' conflicts with subckt of type '%s'.",
-                          subckt_name.c_str(), conflicting_model->name, subckt_model.c_str());
+                          subckt_name.c_str(), conflicting_model->name, subckt_model.str().c_str());
             }
 
             //Create the block
@@ -302,14 +305,14 @@ struct BlifAllocCallback : public blifparse::Callback {
                 }
 
                 //Make the port
-                std::string port_base;
+                blifparse::StringView port_base;
                 size_t port_bit;
                 std::tie(port_base, port_bit) = split_index(ports[i]);
 
                 AtomPortId port_id = curr_model().create_port(blk_id, find_model_port(blk_model, port_base));
 
                 //Make the net
-                AtomNetId net_id = curr_model().create_net(nets[i]);
+                AtomNetId net_id = curr_model().create_net(nets[i].str());
 
                 //Make the pin
                 curr_model().create_pin(port_id, port_bit, net_id, pin_type);
@@ -343,15 +346,15 @@ struct BlifAllocCallback : public blifparse::Callback {
         }
 
         //BLIF Extensions
-        void conn(std::string src, std::string dst) override {
+        void conn(blifparse::StringView src, blifparse::StringView dst) override {
             if (blif_format_ != e_circuit_format::EBLIF) {
                 parse_error(lineno_, ".conn", "Supported only in extended BLIF format");
             }
 
             //We allow the .conn to create the nets if they don't exist,
             //however typically they will have already been defined.
-            AtomNetId driver_net = curr_model().create_net(src);
-            AtomNetId sink_net = curr_model().create_net(dst);
+            AtomNetId driver_net = curr_model().create_net(src.str());
+            AtomNetId sink_net = curr_model().create_net(dst.str());
 
             //We eventually need to merge the driver and sink nets,
             //however we must defer that until all the net drivers 
@@ -366,35 +369,35 @@ struct BlifAllocCallback : public blifparse::Callback {
             set_curr_block(AtomBlockId::INVALID());
         }
 
-        void cname(std::string cell_name) override {
+        void cname(blifparse::StringView cell_name) override {
             if (blif_format_ != e_circuit_format::EBLIF) {
                 parse_error(lineno_, ".cname", "Supported only in extended BLIF format");
             }
 
             //Re-name the block
-            curr_model().set_block_name(curr_block(), cell_name);
+            curr_model().set_block_name(curr_block(), cell_name.str());
         }
 
-        void attr(std::string name, std::string value) override {
+        void attr(blifparse::StringView name, blifparse::StringView value) override {
             if (blif_format_ != e_circuit_format::EBLIF) {
                 parse_error(lineno_, ".attr", "Supported only in extended BLIF format");
             }
 
-            curr_model().set_block_attr(curr_block(), name, value);
+            curr_model().set_block_attr(curr_block(), name.str(), value.str());
         }
 
-        void param(std::string name, std::string value) override {
+        void param(blifparse::StringView name, blifparse::StringView value) override {
             if (blif_format_ != e_circuit_format::EBLIF) {
                 parse_error(lineno_, ".param", "Supported only in extended BLIF format");
             }
 
-            curr_model().set_block_param(curr_block(), name, value);
+            curr_model().set_block_param(curr_block(), name.str(), value.str());
         }
 
 
 
         //Utilities
-        void filename(std::string fname) override { filename_ = fname; }
+        void filename(blifparse::StringView fname) override { filename_ = fname.str(); }
 
         void lineno(int line_num) override { lineno_ = line_num; }
 
@@ -439,7 +442,7 @@ struct BlifAllocCallback : public blifparse::Callback {
         }
 
     private:
-        const t_model* find_model(std::string name) {
+        const t_model* find_model(blifparse::StringView name) {
             const t_model* arch_model = nullptr;
             for(const t_model* arch_models : {user_arch_models_, library_arch_models_}) {
                 arch_model = arch_models;
@@ -457,12 +460,12 @@ struct BlifAllocCallback : public blifparse::Callback {
             }
             if(!arch_model) {
                 vpr_throw(VPR_ERROR_BLIF_F, filename_.c_str(), lineno_, "Failed to find matching architecture model for '%s'\n",
-                          name.c_str());
+                          name.str().c_str());
             }
             return arch_model;
         }
 
-        const t_model_ports* find_model_port(const t_model* blk_model, std::string port_name) {
+        const t_model_ports* find_model_port(const t_model* blk_model, blifparse::StringView port_name) {
             //We need to handle both single, and multi-bit port names
             //
             //By convention multi-bit port names have the bit index stored in square brackets
@@ -471,7 +474,7 @@ struct BlifAllocCallback : public blifparse::Callback {
             //   my_signal_name[2]
             //
             //indicates the 2nd bit of the port 'my_signal_name'.
-            std::string trimmed_port_name;
+            blifparse::StringView trimmed_port_name;
             int bit_index;
 
             //Extract the index bit
@@ -494,7 +497,7 @@ struct BlifAllocCallback : public blifparse::Callback {
                             //Out of range
                             vpr_throw(VPR_ERROR_BLIF_F, filename_.c_str(), lineno_,
                                      "Port '%s' on architecture model '%s' exceeds port width (%d bits)\n",
-                                      port_name.c_str(), blk_model->name, curr_port->size);
+                                      port_name.str().c_str(), blk_model->name, curr_port->size);
                         }
                     }
                     curr_port = curr_port->next;
@@ -504,7 +507,7 @@ struct BlifAllocCallback : public blifparse::Callback {
             //No match
             vpr_throw(VPR_ERROR_BLIF_F, filename_.c_str(), lineno_,
                      "Found no matching port '%s' on architecture model '%s'\n",
-                      port_name.c_str(), blk_model->name);
+                      port_name.str().c_str(), blk_model->name);
             return nullptr;
         }
 
@@ -512,12 +515,14 @@ struct BlifAllocCallback : public blifparse::Callback {
         //the index) and the index as an integer. For example
         //
         //  "my_signal_name[2]"   -> "my_signal_name", 2
-        std::pair<std::string, int> split_index(const std::string& signal_name) {
+        //
+        //The returned name refers to the same characters as signal_name (nothing is copied).
+        std::pair<blifparse::StringView, int> split_index(blifparse::StringView signal_name) {
             int bit_index = 0;
 
-            std::string trimmed_signal_name = signal_name;
+            blifparse::StringView trimmed_signal_name = signal_name;
 
-            auto iter = --signal_name.end(); //Initialized to the last char
+            auto iter = signal_name.end() - 1; //Initialized to the last char
             if(*iter == ']') {
                 //The name may end in an index
                 //
@@ -528,16 +533,18 @@ struct BlifAllocCallback : public blifparse::Callback {
 
                 //We are at the first non-digit character from the end (or the beginning of the string)
                 if(*iter == '[') {
-                    //We have a valid index in the open range (iter, --signal_name.end())
-                    std::string index_str(iter+1, --signal_name.end());
+                    //We have a valid index in the open range (iter, signal_name.end() - 1)
+                    auto index_begin = iter + 1;
+                    auto index_end = signal_name.end() - 1;
+                    VTR_ASSERT_MSG(index_begin != index_end, "Failed to extract signal index");
 
                     //Convert to an integer
-                    std::stringstream ss(index_str);
-                    ss >> bit_index;
-                    VTR_ASSERT_MSG(!ss.fail() && ss.eof(), "Failed to extract signal index");
+                    for(auto digit = index_begin; digit != index_end; ++digit) {
+                        bit_index = 10 * bit_index + (*digit - '0');
+                    }
 
                     //Trim the signal name to exclude the final index
-                    trimmed_signal_name = std::string(signal_name.begin(), iter);
+                    trimmed_signal_name = blifparse::StringView(signal_name.begin(), iter - signal_name.begin());
                 }
             }
             return std::make_pair(trimmed_signal_name, bit_index);
@@ -671,7 +678,7 @@ AtomNetlist read_blif(e_circuit_format circuit_format,
     std::string netlist_id = vtr::secure_digest_file(blif_file);
 
     BlifAllocCallback alloc_callback(circuit_format, netlist, netlist_id, user_models, library_models, verbosity);
-    blifparse::blif_parse_filename(blif_file, alloc_callback);
+    blifparse::blif_parse_mapped_filename(blif_file, alloc_callback);
 
     return netlist;
 }
@@ -76,6 +76,10 @@ AtomNetlist read_and_process_circuit(e_circuit_format circuit_format,
 
     show_circuit_stats(netlist);
 
+    if (verbosity > 1) {
+        netlist.print_memory_usage();
+    }
+
     return netlist;
 }
 
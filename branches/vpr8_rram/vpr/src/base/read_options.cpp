@@ -979,6 +979,13 @@ static argparse::ArgumentParser create_arg_parser(std::string prog_name, t_optio
             .default_value("2")
             .show_in(argparse::ShowIn::HELP_ONLY);
 
+    pack_grp.add_argument<int>(args.pack_num_partitions, "--pack_num_partitions")
+            .help("Number of parts the atom netlist is partitioned into (with the built-in multilevel"
+                  " min-cut partitioner) before clustering. Clustering seeds are chosen one part at a time,"
+                  " so clusters rarely span parts. Values below 2 disable partitioning")
+            .default_value("0")
+            .show_in(argparse::ShowIn::HELP_ONLY);
+
     auto& place_grp = parser.add_argument_group("placement options");
 
     place_grp.add_argument(args.Seed, "--seed")
@@ -1032,6 +1039,21 @@ static argparse::ArgumentParser create_arg_parser(std::string prog_name, t_optio
             .default_value("100")
             .show_in(argparse::ShowIn::HELP_ONLY);
 
+    place_grp.add_argument<int>(args.place_num_partitions, "--place_num_partitions")
+            .help("Number of parts the atom netlist is partitioned into (with the built-in multilevel"
+                  " min-cut partitioner) for the initial placement. Each part is assigned a region of the"
+                  " device, and each block starts in the region of the part most of its atoms belong to."
+                  " Values below 2 disable partitioning (i.e. a purely random initial placement)")
+            .default_value("0")
+            .show_in(argparse::ShowIn::HELP_ONLY);
+
+    place_grp.add_argument<bool,ParseOnOff>(args.analytic_initial_placement, "--analytic_initial_placement")
+            .help("Controls whether the initial placement is improved by analytic (quadratic wirelength)"
+                  " placement and legalization before annealing. When on, annealing starts at a lower"
+                  " temperature with a smaller range limit, refining rather than re-randomizing the placement")
+            .default_value("off")
+            .show_in(argparse::ShowIn::HELP_ONLY);
+
 
     auto& place_timing_grp = parser.add_argument_group("timing-driven placement options");
 
@@ -1322,6 +1344,32 @@ static argparse::ArgumentParser create_arg_parser(std::string prog_name, t_optio
             .default_value("")
             .show_in(argparse::ShowIn::HELP_ONLY);
 
+    route_timing_grp.add_argument(args.router_telemetry_file, "--router_telemetry_file")
+            .help("Name of the file to which per-iteration router telemetry (heap pushes/pops, nodes expanded"
+                  " per connection, nets re-routed, time per net fanout, predictor estimates, ...) is written."
+                  " Written as JSON if the name ends in '.json', and CSV otherwise (not generated if unspecified)")
+            .default_value("")
+            .show_in(argparse::ShowIn::HELP_ONLY);
+
+    route_timing_grp.add_argument(args.router_checkpoint_file, "--router_checkpoint_file")
+            .help("Name of the binary checkpoint file periodically written during routing"
+                  " (see --router_checkpoint_interval), from which an interrupted run can be"
+                  " resumed with --router_resume_checkpoint (not generated if unspecified)")
+            .default_value("")
+            .show_in(argparse::ShowIn::HELP_ONLY);
+
+    route_timing_grp.add_argument(args.router_checkpoint_interval, "--router_checkpoint_interval")
+            .help("Number of routing iterations between routing checkpoints")
+            .default_value("5")
+            .show_in(argparse::ShowIn::HELP_ONLY);
+
+    route_timing_grp.add_argument(args.router_resume_checkpoint, "--router_resume_checkpoint")
+            .help("Name of a routing checkpoint file to resume routing from."
+                  " It must have been written for the same netlist, placement and channel width;"
+                  " otherwise it is ignored and routing starts from scratch")
+            .default_value("")
+            .show_in(argparse::ShowIn::HELP_ONLY);
+
     auto& analysis_grp = parser.add_argument_group("analysis options");
 
     analysis_grp.add_argument<bool,ParseOnOff>(args.full_stats, "--full_stats")
@@ -1354,6 +1402,14 @@ static argparse::ArgumentParser create_arg_parser(std::string prog_name, t_optio
             .default_value("off")
             .show_in(argparse::ShowIn::HELP_ONLY);
 
+    analysis_grp.add_argument(args.congestion_report_prefix, "--congestion_report")
+            .help("If specified, writes congestion maps (which do not need graphics) to files starting with this prefix:"
+                  " <prefix>.place.{json,svg,png} with the congestion estimated from the placement, and"
+                  " <prefix>.route.{json,svg,png} with the routing channel utilization and overuse."
+                  " The JSON files hold per-channel-segment grids; the images are heat maps of the device")
+            .default_value("")
+            .show_in(argparse::ShowIn::HELP_ONLY);
+
 
     auto& power_grp = parser.add_argument_group("power analysis options");
 
@@ -1371,6 +1427,14 @@ static argparse::ArgumentParser create_arg_parser(std::string prog_name, t_optio
             .help("Signal activities file for all nets (see documentation).")
             .show_in(argparse::ShowIn::HELP_ONLY);
 
+    power_grp.add_argument(args.BatchActFiles, "--activity_files")
+            .help("Signal activity files to estimate power for, one after the other."
+                  " The implementation is loaded once, and a single report covering"
+                  " all the activity profiles is written to the power output file."
+                  " If --activity_file is not specified the first file is used for it.")
+            .nargs('+')
+            .show_in(argparse::ShowIn::HELP_ONLY);
+
     return parser;
 }
 
@@ -1428,9 +1492,13 @@ static void set_conditional_defaults(t_options& args) {
 	}
 
 	if (args.ActFile.provenance() != Provenance::SPECIFIED) {
-        std::string activity_file = args.out_file_prefix;
-        activity_file += default_output_name + ".act";
-		args.ActFile.set(activity_file, Provenance::INFERRED);
+        if (!args.BatchActFiles.value().empty()) {
+            args.ActFile.set(args.BatchActFiles.value()[0], Provenance::INFERRED);
+        } else {
+            std::string activity_file = args.out_file_prefix;
+            activity_file += default_output_name + ".act";
+            args.ActFile.set(activity_file, Provenance::INFERRED);
+        }
 	}
 
 	if (args.PowerFile.provenance() != Provenance::SPECIFIED) {
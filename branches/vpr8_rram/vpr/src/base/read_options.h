@@ -15,6 +15,7 @@ struct t_options {
     argparse::ArgValue<std::string> RouteFile;
     argparse::ArgValue<std::string> BlifFile;
     argparse::ArgValue<std::string> ActFile;
+    argparse::ArgValue<std::vector<std::string>> BatchActFiles;
     argparse::ArgValue<std::string> PowerFile;
     argparse::ArgValue<std::string> CmosTechFile;
     argparse::ArgValue<std::string> SDCFile;
@@ -71,6 +72,7 @@ struct t_options {
     argparse::ArgValue<bool> enable_clustering_pin_feasibility_filter;
     argparse::ArgValue<std::vector<std::string>> target_external_pin_util;
     argparse::ArgValue<int> pack_verbosity;
+    argparse::ArgValue<int> pack_num_partitions;
 
     /* Placement options */
     argparse::ArgValue<int> Seed;
@@ -83,6 +85,8 @@ struct t_options {
     argparse::ArgValue<e_place_algorithm> PlaceAlgorithm;
     argparse::ArgValue<e_pad_loc_type> pad_loc_type;
     argparse::ArgValue<int> PlaceChanWidth;
+    argparse::ArgValue<int> place_num_partitions;
+    argparse::ArgValue<bool> analytic_initial_placement;
 
     /* Timing-driven placement options only */
     argparse::ArgValue<float> PlaceTimingTradeoff;
@@ -132,6 +136,10 @@ struct t_options {
     argparse::ArgValue<int> router_max_convergence_count;
     argparse::ArgValue<float> router_reconvergence_cpd_threshold;
     argparse::ArgValue<std::string> router_first_iteration_timing_report_file;
+    argparse::ArgValue<std::string> router_telemetry_file;
+    argparse::ArgValue<std::string> router_checkpoint_file;
+    argparse::ArgValue<int> router_checkpoint_interval;
+    argparse::ArgValue<std::string> router_resume_checkpoint;
 
     /* Analysis options */
     argparse::ArgValue<bool> full_stats;
@@ -139,6 +147,7 @@ struct t_options {
     argparse::ArgValue<int> timing_report_npaths;
     argparse::ArgValue<e_timing_report_detail> timing_report_detail;
     argparse::ArgValue<bool> timing_report_skew;
+    argparse::ArgValue<std::string> congestion_report_prefix;
 
 };
 
@@ -75,6 +75,7 @@ using namespace std;
 
 #include "timing_graph_builder.h"
 #include "timing_reports.h"
+#include "congestion_report.h"
 #include "tatum/echo_writer.hpp"
 
 #include "read_route.h"
@@ -580,6 +581,10 @@ bool vpr_place_flow(t_vpr_setup& vpr_setup, const t_arch& arch) {
 
         sync_grid_to_blocks();
         post_place_sync();
+
+        if (!vpr_setup.AnalysisOpts.congestion_report_prefix.empty()) {
+            write_placement_congestion_report(vpr_setup.AnalysisOpts.congestion_report_prefix);
+        }
     }
 
     return true;
@@ -1117,6 +1122,10 @@ void vpr_analysis(t_vpr_setup& vpr_setup, const t_arch& Arch, const RouteStatus&
 #endif
             );
 
+    if (!vpr_setup.AnalysisOpts.congestion_report_prefix.empty()) {
+        write_routing_congestion_report(vpr_setup.AnalysisOpts.congestion_report_prefix);
+    }
+
     if (vpr_setup.TimingEnabled) {
 
         //Do final timing analysis
@@ -1194,11 +1203,18 @@ void vpr_power_estimation(const t_vpr_setup& vpr_setup, const t_arch& Arch, cons
     if (!power_error) {
         float power_runtime_s = 0;
 
-        VTR_LOG("Running power estimation\n");
-
         /* Run power estimation */
-        e_power_ret_code power_ret_code = power_total(&power_runtime_s, vpr_setup,
-                &Arch, &vpr_setup.RoutingArch);
+        e_power_ret_code power_ret_code;
+        if (vpr_setup.FileNameOpts.BatchActFiles.empty()) {
+            VTR_LOG("Running power estimation\n");
+            power_ret_code = power_total(&power_runtime_s, vpr_setup,
+                    &Arch, &vpr_setup.RoutingArch);
+        } else {
+            VTR_LOG("Running power estimation for %zu activity files\n",
+                    vpr_setup.FileNameOpts.BatchActFiles.size());
+            power_ret_code = power_total_activity_profiles(&power_runtime_s, vpr_setup,
+                    &Arch, &vpr_setup.RoutingArch, vpr_setup.FileNameOpts.BatchActFiles);
+        }
 
         /* Check for errors/warnings */
         if (power_ret_code == POWER_RET_CODE_ERRORS) {
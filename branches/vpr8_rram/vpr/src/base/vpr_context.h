@@ -48,6 +48,11 @@ struct AtomContext : public Context {
 
     /* Mappings to/from the Atom Netlist to physically described .blif models*/
     AtomLookup lookup;
+
+    /* Part of each atom block from partition_atom_netlist(), shared by packing (seed selection)
+     * and placement (initial regions). Empty if the netlist has not been partitioned */
+    vtr::vector<AtomBlockId,int> block_partitions;
+    int num_partitions = 0;
 };
 
 //State relating to timing
@@ -21,3 +21,15 @@ void t_ext_pin_util_targets::set_block_pin_util(std::string block_type_name, t_e
 void t_ext_pin_util_targets::set_default_pin_util(t_ext_pin_util default_target) {
     defaults_ = default_target;
 }
+
+unsigned t_rr_node_route_inf::current_search_epoch_ = 1;
+
+bool t_rr_node_route_inf::advance_search_epoch() {
+    ++current_search_epoch_;
+    if (current_search_epoch_ == 0) {
+        //Wrapped around: stale stamps could now look current again
+        current_search_epoch_ = 1;
+        return false;
+    }
+    return true;
+}
@@ -25,6 +25,7 @@
 
 #include <vector>
 #include <unordered_map>
+#include <limits>
 #include "arch_types.h"
 #include "atom_netlist_fwd.h"
 #include "clustered_netlist_fwd.h"
@@ -735,6 +736,7 @@ struct t_file_name_opts {
 	std::string PlaceFile;
 	std::string RouteFile;
 	std::string ActFile;
+	std::vector<std::string> BatchActFiles; /* Activity profiles to estimate power for in one run (empty if not batched) */
 	std::string PowerFile;
 	std::string CmosTechFile;
 	std::string out_file_prefix;
@@ -789,6 +791,7 @@ struct t_packer_opts {
 	enum e_packer_algorithm packer_algorithm;
     std::string device_layout;
 	std::string hmetis_input_file;
+	int num_partitions;
 };
 
 /* Annealing schedule information for the placer.  The schedule type      *
@@ -871,6 +874,9 @@ struct t_placer_opts {
     float tsu_abs_margin;
 
     std::string post_place_timing_report_file;
+
+    int num_partitions;
+    bool analytic_initial_placement;
 };
 
 /* All the parameters controlling the router's operation are in this        *
@@ -992,6 +998,10 @@ struct t_router_opts {
     int max_convergence_count;
     float reconvergence_cpd_threshold;
     std::string first_iteration_timing_report_file;
+    std::string telemetry_file; //Per-iteration router telemetry (CSV, or JSON if *.json), not written if empty
+    std::string checkpoint_file; //Routing checkpoint written every checkpoint_interval iterations, not written if empty
+    int checkpoint_interval;
+    std::string resume_checkpoint_file; //Routing checkpoint to resume from, if not empty
 };
 
 struct t_analysis_opts {
@@ -1002,6 +1012,8 @@ struct t_analysis_opts {
     int timing_report_npaths;
     e_timing_report_detail timing_report_detail;
     bool timing_report_skew;
+
+    std::string congestion_report_prefix;
 };
 
 /* Defines the detailed routing architecture of the FPGA.  Only important   *
@@ -1212,6 +1224,8 @@ struct t_trace {
 	short iswitch;
 };
 
+#define NO_PREVIOUS -1
+
 /* Extra information about each rr_node needed only during routing (i.e.    *
  * during the maze expansion).                                              *
  *                                                                          *
@@ -1230,37 +1244,85 @@ struct t_trace {
  *                      node.  Not used by breadth-first router.            *
  * target_flag:  Is this node a target (sink) for the current routing?      *
  *               Number of times this node must be reached to fully route.  *
- * occ:        The current occupancy of the associated rr node              */
+ * occ:        The current occupancy of the associated rr node              *
+ *                                                                          *
+ * prev_node, prev_edge, path_cost and backward_path_cost describe the      *
+ * current search only.  They are stamped with the search epoch they were   *
+ * set in, and read back as unset (NO_PREVIOUS/infinite) once the epoch has *
+ * moved on, so all nodes are reset at once by advance_search_epoch().      */
 struct t_rr_node_route_inf {
-	int prev_node;
-	short prev_edge;
-
 	float pres_cost;
 	float acc_cost;
-	float path_cost;
-	float backward_path_cost;
 
 	short target_flag;
 
     public: //Accessors
         short occ() const { return occ_; }
 
+        int prev_node() const { return is_current() ? prev_node_ : NO_PREVIOUS; }
+        short prev_edge() const { return is_current() ? prev_edge_ : NO_PREVIOUS; }
+        float path_cost() const { return is_current() ? path_cost_ : std::numeric_limits<float>::infinity(); }
+        float backward_path_cost() const { return is_current() ? backward_path_cost_ : std::numeric_limits<float>::infinity(); }
+
     public: //Mutators
         void set_occ(int new_occ) { occ_ = new_occ; }
 
+        void set_prev(int new_prev_node, short new_prev_edge) {
+            make_current();
+            prev_node_ = new_prev_node;
+            prev_edge_ = new_prev_edge;
+        }
+        void set_path_cost(float new_path_cost) {
+            make_current();
+            path_cost_ = new_path_cost;
+        }
+        void set_backward_path_cost(float new_backward_path_cost) {
+            make_current();
+            backward_path_cost_ = new_backward_path_cost;
+        }
+
+        //Unsets the search state of this node
+        void reset_search_state() { search_epoch_ = 0; }
+
+        //Unsets the search state of all nodes.  Returns false if the epoch
+        //counter wrapped around, in which case the caller must call
+        //reset_search_state() on every node.
+        static bool advance_search_epoch();
+
+    private:
+        bool is_current() const { return search_epoch_ == current_search_epoch_; }
+
+        void make_current() {
+            if (!is_current()) {
+                search_epoch_ = current_search_epoch_;
+                prev_node_ = NO_PREVIOUS;
+                prev_edge_ = NO_PREVIOUS;
+                path_cost_ = std::numeric_limits<float>::infinity();
+                backward_path_cost_ = std::numeric_limits<float>::infinity();
+            }
+        }
+
     private: //Data
         short occ_ = 0;
+
+        int prev_node_ = NO_PREVIOUS;
+        short prev_edge_ = NO_PREVIOUS;
+        float path_cost_ = std::numeric_limits<float>::infinity();
+        float backward_path_cost_ = std::numeric_limits<float>::infinity();
+        unsigned search_epoch_ = 0; //Never current: current_search_epoch_ starts at 1
+
+        static unsigned current_search_epoch_;
 };
 
 //Information about the current status of a particular net as pertains to routing
 struct t_net_routing_status {
     bool is_routed = false; //Whether the net has been legally routed
     bool is_fixed = false; //Whether the net is fixed (i.e. not to be re-routed)
+    bool is_checked = false; //Whether the net's current routing has been verified by check_route() (cleared when re-routed)
 };
 
 
 
-#define NO_PREVIOUS -1
 
 /* Index of the SOURCE, SINK, OPIN, IPIN, etc. member of device_ctx.rr_indexed_data.    */
 enum e_cost_indices {
@@ -18,6 +18,7 @@
 #include <algorithm>
 #include <sstream>
 #include <array>
+#include <numeric>
 using namespace std;
 
 #include "vtr_assert.h"
@@ -72,6 +73,11 @@ constexpr float SB_EDGE_STRAIGHT_ARROW_POSITION = 0.95;
 
 constexpr float EMPTY_BLOCK_LIGHTEN_FACTOR = 0.10;
 
+//Routing tracks are drawn 1 unit apart. When a 1x1 square covers less than this
+//screen area (in pixels^2) adjacent tracks can not be told apart, so the utilization
+//of each channel segment is drawn instead of the individual wires.
+constexpr float MIN_TRACK_SCREEN_AREA = 4.;
+
 //Kelly's maximum contrast colors are selected to be easily distinguishable as described in:
 //  Kenneth Kelly, "Twenty-Two Colors of Maximum Contrast", Color Eng. 3(6), 1943
 //We use these to highlight a relatively small number of things (e.g. stages in a critical path,
@@ -298,11 +304,17 @@ static void act_on_key_press(char key_pressed, int keysym);
 static void draw_routed_net(ClusterNetId net);
 void draw_partial_route(const std::vector<int>& rr_nodes_to_draw);
 static void draw_rr();
+static void draw_rr_chan_util();
 static void draw_rr_edges(int from_node);
 static void draw_rr_pin(int inode, const t_color& color);
 static void draw_rr_chan(int inode, const t_color color);
 static void draw_rr_src_sink(int inode, t_color color);
 static t_bound_box draw_get_rr_chan_bbox(int inode);
+static t_bound_box draw_compute_rr_chan_bbox(int inode);
+static void draw_build_rr_node_index();
+static std::vector<int> draw_get_rr_nodes_in_region(const t_bound_box& region);
+static bool draw_bbox_overlaps(const t_bound_box& lhs, const t_bound_box& rhs);
+static t_bound_box draw_bbox_union(const t_bound_box& lhs, const t_bound_box& rhs);
 static void draw_pin_to_chan_edge(int pin_node, int chan_node);
 static void draw_x(float x, float y, float size);
 static void draw_pin_to_pin(int opin, int ipin);
@@ -437,6 +449,9 @@ void update_screen(ScreenUpdatePriority priority, const char *msg, enum pic_type
 
     draw_state->setup_timing_info = setup_timing_info;
 
+	//Routing may have changed since the last update
+	draw_state->chan_util_valid = false;
+
 	draw_state->pic_on_screen = pic_on_screen_val;
 	update_message(msg);
 	drawscreen();
@@ -822,6 +837,10 @@ void free_draw_structs() {
 	if(draw_state != nullptr) {
 		free(draw_state->draw_rr_node);
 		draw_state->draw_rr_node = nullptr;
+
+		draw_state->rr_node_bbox.clear();
+		draw_state->rr_node_index.clear();
+		draw_state->chan_util_valid = false;
 	}
 }
 
@@ -874,6 +893,9 @@ void init_draw_coords(float width_val) {
 	/* Load coordinates of sub-blocks inside the clbs */
 	draw_internal_init_blk();
 
+	/* The routing resource geometry depends on the coordinates above */
+	draw_build_rr_node_index();
+
     //Margin beyond edge of the drawn device to extend the visible world
     //Setting this to > 0.0 means 'Zoom Fit' leave some fraction of white
     //space around the device edges
@@ -1262,7 +1284,14 @@ void draw_rr() {
 
 	setlinestyle(SOLID);
 
-	for (size_t inode = 0; inode < device_ctx.rr_nodes.size(); inode++) {
+	if (!LOD_screen_area_test_square(1., MIN_TRACK_SCREEN_AREA)) {
+		//Zoomed out too far to see individual wires
+		draw_rr_chan_util();
+		drawroute(HIGHLIGHTED);
+		return;
+	}
+
+	for (int inode : draw_get_rr_nodes_in_region(get_visible_world())) {
 		if (!draw_state->draw_rr_node[inode].node_highlighted)
 		{
 			/* If not highlighted node, assign color based on type. */
@@ -1317,6 +1346,63 @@ void draw_rr() {
 	drawroute(HIGHLIGHTED);
 }
 
+/* Draws each channel segment as a single bar coloured by its routing utilization. *
+ * Used by draw_rr() in place of the individual wires when zoomed out far.         */
+static void draw_rr_chan_util() {
+	t_draw_state* draw_state = get_draw_state_vars();
+	t_draw_coords* draw_coords = get_draw_coords_vars();
+    auto& device_ctx = g_vpr_ctx.device();
+
+	//Only recomputed when the routing may have changed, not on every pan/zoom
+	if (!draw_state->chan_util_valid) {
+		auto chanx_usage = calculate_routing_usage(CHANX);
+		auto chany_usage = calculate_routing_usage(CHANY);
+		auto chanx_avail = calculate_routing_avail(CHANX);
+		auto chany_avail = calculate_routing_avail(CHANY);
+
+		draw_state->chanx_util = vtr::Matrix<float>({device_ctx.grid.width(), device_ctx.grid.height()}, 0.);
+		draw_state->chany_util = vtr::Matrix<float>({device_ctx.grid.width(), device_ctx.grid.height()}, 0.);
+		for (size_t x = 0; x < device_ctx.grid.width(); ++x) {
+			for (size_t y = 0; y < device_ctx.grid.height(); ++y) {
+				draw_state->chanx_util[x][y] = routing_util(chanx_usage[x][y], chanx_avail[x][y]);
+				draw_state->chany_util[x][y] = routing_util(chany_usage[x][y], chany_avail[x][y]);
+			}
+		}
+		draw_state->chan_util_valid = true;
+	}
+
+	float max_util = 1.;
+	for (size_t x = 0; x < device_ctx.grid.width() - 1; ++x) {
+		for (size_t y = 0; y < device_ctx.grid.height() - 1; ++y) {
+			max_util = std::max(max_util, draw_state->chanx_util[x][y]);
+			max_util = std::max(max_util, draw_state->chany_util[x][y]);
+		}
+	}
+	std::unique_ptr<vtr::ColorMap> cmap = std::make_unique<vtr::PlasmaColorMap>(0., max_util);
+
+	float tile_width = draw_coords->get_tile_width();
+	float tile_height = draw_coords->get_tile_height();
+
+	for (size_t x = 0; x < device_ctx.grid.width() - 1; ++x) {
+		for (size_t y = 0; y < device_ctx.grid.height() - 1; ++y) {
+			if (x > 0 && device_ctx.chan_width.x_list[y] > 0) {
+				setcolor(to_t_color(cmap->color(draw_state->chanx_util[x][y])));
+				fillrect(draw_coords->tile_x[x], draw_coords->tile_y[y] + tile_height,
+						 draw_coords->tile_x[x] + tile_width, draw_coords->tile_y[y+1]);
+			}
+			if (y > 0 && device_ctx.chan_width.y_list[x] > 0) {
+				setcolor(to_t_color(cmap->color(draw_state->chany_util[x][y])));
+				fillrect(draw_coords->tile_x[x] + tile_width, draw_coords->tile_y[y],
+						 draw_coords->tile_x[x+1], draw_coords->tile_y[y] + tile_height);
+			}
+		}
+	}
+
+	if (!draw_state->color_map) {
+		draw_state->color_map = std::move(cmap);
+	}
+}
+
 static void draw_rr_chan(int inode, const t_color color) {
     auto& device_ctx = g_vpr_ctx.device();
 
@@ -1922,6 +2008,17 @@ static void draw_chany_to_chany_edge(int from_node, int to_node,
  * TODO: Fix this for global routing, currently for detailed only.
  */
 static t_bound_box draw_get_rr_chan_bbox (int inode) {
+	t_draw_state* draw_state = get_draw_state_vars();
+
+	//Use the geometry cached by init_draw_coords, if it is up to date
+	if ((size_t) inode < draw_state->rr_node_bbox.size()) {
+		return draw_state->rr_node_bbox[inode];
+	}
+
+	return draw_compute_rr_chan_bbox(inode);
+}
+
+static t_bound_box draw_compute_rr_chan_bbox(int inode) {
 	t_bound_box bound_box;
 
 	t_draw_coords* draw_coords = get_draw_coords_vars();
@@ -1959,6 +2056,88 @@ static t_bound_box draw_get_rr_chan_bbox (int inode) {
 	return bound_box;
 }
 
+/* Caches the geometry of each rr_node, and builds the spatial index used to *
+ * find the rr_nodes on screen. Each node is indexed by the area covered by  *
+ * the node and the edges draw_rr_edges() draws from it.                     */
+static void draw_build_rr_node_index() {
+	t_draw_state* draw_state = get_draw_state_vars();
+	t_draw_coords* draw_coords = get_draw_coords_vars();
+    auto& device_ctx = g_vpr_ctx.device();
+
+	draw_state->rr_node_bbox.clear();
+	draw_state->rr_node_index.clear();
+	draw_state->chan_util_valid = false;
+
+	if (device_ctx.rr_nodes.empty()) return;
+
+	std::vector<t_bound_box> rr_node_bbox(device_ctx.rr_nodes.size());
+	for (size_t inode = 0; inode < device_ctx.rr_nodes.size(); inode++) {
+		switch (device_ctx.rr_nodes[inode].type()) {
+			case CHANX:
+			case CHANY:
+				rr_node_bbox[inode] = draw_compute_rr_chan_bbox(inode);
+				break;
+			case IPIN:
+			case OPIN: {
+				float xcen, ycen;
+				draw_get_rr_pin_coords(inode, &xcen, &ycen);
+				rr_node_bbox[inode] = t_bound_box(xcen - draw_coords->pin_size, ycen - draw_coords->pin_size,
+												  xcen + draw_coords->pin_size, ycen + draw_coords->pin_size);
+				break;
+			}
+			default:
+				break; /* SOURCEs and SINKs are not drawn with the rr graph */
+		}
+	}
+
+	t_bound_box device_bbox(draw_coords->tile_x[0], draw_coords->tile_y[0],
+							draw_coords->tile_x[device_ctx.grid.width() - 1] + draw_coords->get_tile_width(),
+							draw_coords->tile_y[device_ctx.grid.height() - 1] + draw_coords->get_tile_height());
+	draw_state->rr_node_index.init(device_bbox, draw_coords->get_tile_width());
+
+	for (size_t inode = 0; inode < device_ctx.rr_nodes.size(); inode++) {
+		t_rr_type type = device_ctx.rr_nodes[inode].type();
+		if (type == SOURCE || type == SINK) continue;
+
+		t_bound_box extent = rr_node_bbox[inode];
+		if (type != IPIN) {
+			for (int iedge = 0; iedge < device_ctx.rr_nodes[inode].num_edges(); iedge++) {
+				int to_node = device_ctx.rr_nodes[inode].edge_sink_node(iedge);
+				extent = draw_bbox_union(extent, rr_node_bbox[to_node]);
+			}
+		}
+		draw_state->rr_node_index.insert(inode, extent);
+	}
+
+	draw_state->rr_node_bbox = std::move(rr_node_bbox);
+}
+
+/* Returns the rr_nodes (in increasing order) which may be drawn in region: *
+ * nodes whose geometry, or an edge drawn from them, overlaps the region.   */
+static std::vector<int> draw_get_rr_nodes_in_region(const t_bound_box& region) {
+	t_draw_state* draw_state = get_draw_state_vars();
+    auto& device_ctx = g_vpr_ctx.device();
+
+	std::vector<int> nodes;
+	if (draw_state->rr_node_bbox.size() == device_ctx.rr_nodes.size() && !draw_state->rr_node_index.empty()) {
+		draw_state->rr_node_index.query(region, nodes);
+	} else {
+		//Not indexed (yet), fall back to all the nodes
+		nodes.resize(device_ctx.rr_nodes.size());
+		std::iota(nodes.begin(), nodes.end(), 0);
+	}
+	return nodes;
+}
+
+static bool draw_bbox_overlaps(const t_bound_box& lhs, const t_bound_box& rhs) {
+	return lhs.left() <= rhs.right() && rhs.left() <= lhs.right()
+		&& lhs.bottom() <= rhs.top() && rhs.bottom() <= lhs.top();
+}
+
+static t_bound_box draw_bbox_union(const t_bound_box& lhs, const t_bound_box& rhs) {
+	return t_bound_box(std::min(lhs.left(), rhs.left()), std::min(lhs.bottom(), rhs.bottom()),
+					   std::max(lhs.right(), rhs.right()), std::max(lhs.top(), rhs.top()));
+}
 
 static void draw_rr_switch(float from_x, float from_y, float to_x, float to_y, bool buffered, bool configurable) {
 
@@ -2178,6 +2357,9 @@ void draw_partial_route(const std::vector<int>& rr_nodes_to_draw) {
 	t_draw_state* draw_state = get_draw_state_vars();
     auto& device_ctx = g_vpr_ctx.device();
 
+	t_bound_box visible_world = get_visible_world();
+	bool have_rr_node_bbox = (draw_state->rr_node_bbox.size() == device_ctx.rr_nodes.size());
+
 	static vtr::OffsetMatrix<int> chanx_track; /* [1..device_ctx.grid.width() - 2][0..device_ctx.grid.height() - 2] */
 	static vtr::OffsetMatrix<int> chany_track; /* [0..device_ctx.grid.width() - 2][1..device_ctx.grid.height() - 2] */
 	if (draw_state->draw_route_type == GLOBAL) {
@@ -2212,6 +2394,15 @@ void draw_partial_route(const std::vector<int>& rr_nodes_to_draw) {
         int iedge = find_edge(prev_node, inode);
         auto switch_type = device_ctx.rr_nodes[prev_node].edge_switch(iedge);
 
+        //Skip nodes which (with the connection to them) are off screen. With global
+        //routing every node is needed to count the tracks used, so none are skipped.
+        bool visible = !have_rr_node_bbox
+                       || draw_bbox_overlaps(visible_world, draw_bbox_union(draw_state->rr_node_bbox[inode],
+                                                                            draw_state->rr_node_bbox[prev_node]));
+        if (!visible && draw_state->draw_route_type != GLOBAL) {
+            continue;
+        }
+
         switch (rr_type) {
 
             case OPIN: {
@@ -2443,7 +2634,12 @@ static int draw_check_rr_node_hit (float click_x, float click_y) {
 	t_draw_coords* draw_coords = get_draw_coords_vars();
     auto& device_ctx = g_vpr_ctx.device();
 
-	for (size_t inode = 0; inode < device_ctx.rr_nodes.size(); inode++) {
+	// Wires are hit up to 30% of a track outside their boundary
+	const float tolerance = 0.3;
+	t_bound_box click_region(click_x - tolerance, click_y - tolerance,
+							 click_x + tolerance, click_y + tolerance);
+
+	for (int inode : draw_get_rr_nodes_in_region(click_region)) {
 		switch (device_ctx.rr_nodes[inode].type()) {
 			case IPIN:
 			case OPIN:
@@ -2481,7 +2677,6 @@ static int draw_check_rr_node_hit (float click_x, float click_y) {
 
 				// Check if we clicked on this wire, with 30%
 				// tolerance outside its boundary
-				const float tolerance = 0.3;
 				if (click_x >= bound_box.left() - tolerance &&
 					click_x <= bound_box.right() + tolerance &&
 					click_y >= bound_box.bottom() - tolerance &&
@@ -3629,11 +3824,11 @@ static void draw_routing_util() {
 
 static float get_router_rr_cost(const t_rr_node_route_inf node_inf, e_draw_router_rr_cost draw_router_rr_cost) {
     if (draw_router_rr_cost == DRAW_ROUTER_RR_COST_TOTAL) {
-        return node_inf.path_cost;
+        return node_inf.path_cost();
     } else if (draw_router_rr_cost == DRAW_ROUTER_RR_COST_KNOWN) {
-        return node_inf.backward_path_cost;
+        return node_inf.backward_path_cost();
     } else if (draw_router_rr_cost == DRAW_ROUTER_RR_COST_EXPECTED) {
-        return node_inf.path_cost - node_inf.backward_path_cost;
+        return node_inf.path_cost() - node_inf.backward_path_cost();
     }
 
     VPR_THROW(VPR_ERROR_DRAW, "Invalid Router RR cost drawing type");
@@ -3,6 +3,7 @@
 #include "globals.h"
 #include "vpr_utils.h"
 #include <utility>
+#include <algorithm>
 
 /*******************************************
  * begin t_draw_state function definitions *
@@ -17,6 +18,117 @@ void t_draw_state::reset_nets_congestion_and_rr() {
 bool t_draw_state::showing_sub_blocks() {
 	return show_blk_internal > 0;
 }
+/**********************************************
+ * begin t_draw_quadtree function definitions *
+ **********************************************/
+
+static bool bbox_contains(const t_bound_box& outer, const t_bound_box& inner) {
+	return inner.left() >= outer.left() && inner.right() <= outer.right()
+		&& inner.bottom() >= outer.bottom() && inner.top() <= outer.top();
+}
+
+static bool bbox_overlaps(const t_bound_box& lhs, const t_bound_box& rhs) {
+	return lhs.left() <= rhs.right() && rhs.left() <= lhs.right()
+		&& lhs.bottom() <= rhs.top() && rhs.bottom() <= lhs.top();
+}
+
+void t_draw_quadtree::init(const t_bound_box& bounds, float min_cell_size) {
+	clear();
+
+	t_cell root;
+	root.bounds = bounds;
+	cells_.push_back(root);
+	min_cell_size_ = min_cell_size;
+}
+
+void t_draw_quadtree::clear() {
+	cells_.clear();
+	item_bboxes_.clear();
+	num_items_ = 0;
+}
+
+bool t_draw_quadtree::empty() const {
+	return num_items_ == 0;
+}
+
+void t_draw_quadtree::insert(int item, const t_bound_box& bbox) {
+	VTR_ASSERT(!cells_.empty());
+	VTR_ASSERT(item >= 0);
+
+	if (item >= (int) item_bboxes_.size()) {
+		item_bboxes_.resize(item + 1);
+	}
+	item_bboxes_[item] = bbox;
+	++num_items_;
+
+	//Descend while the item fits entirely in one quadrant of the cell.
+	//Items which are (partly) outside the root are kept in the root.
+	int icell = 0;
+	while (true) {
+		t_bound_box cell_bounds = cells_[icell].bounds;
+		if (!bbox_contains(cell_bounds, bbox)
+			|| std::max(cell_bounds.get_width(), cell_bounds.get_height()) <= min_cell_size_) {
+			break;
+		}
+
+		t_point center = cell_bounds.get_center();
+		int quadrant = (bbox.left() >= center.x ? 1 : 0) + (bbox.bottom() >= center.y ? 2 : 0);
+		t_bound_box quadrant_bounds(
+			(quadrant & 1) ? center.x : cell_bounds.left(),
+			(quadrant & 2) ? center.y : cell_bounds.bottom(),
+			(quadrant & 1) ? cell_bounds.right() : center.x,
+			(quadrant & 2) ? cell_bounds.top() : center.y);
+		if (!bbox_contains(quadrant_bounds, bbox)) {
+			break; //Straddles the centre lines
+		}
+
+		if (cells_[icell].first_child == OPEN) {
+			//Split the cell (note this may re-allocate cells_)
+			int first_child = cells_.size();
+			for (int ichild = 0; ichild < 4; ++ichild) {
+				t_cell child;
+				child.bounds = t_bound_box(
+					(ichild & 1) ? center.x : cell_bounds.left(),
+					(ichild & 2) ? center.y : cell_bounds.bottom(),
+					(ichild & 1) ? cell_bounds.right() : center.x,
+					(ichild & 2) ? cell_bounds.top() : center.y);
+				cells_.push_back(child);
+			}
+			cells_[icell].first_child = first_child;
+		}
+		icell = cells_[icell].first_child + quadrant;
+	}
+
+	cells_[icell].items.push_back(item);
+}
+
+void t_draw_quadtree::query(const t_bound_box& region, std::vector<int>& items) const {
+	if (cells_.empty()) return;
+
+	size_t first_new_item = items.size();
+	query_cell(0, region, items);
+	std::sort(items.begin() + first_new_item, items.end());
+}
+
+void t_draw_quadtree::query_cell(int icell, const t_bound_box& region, std::vector<int>& items) const {
+	const t_cell& cell = cells_[icell];
+
+	//The root may hold items outside its bounds, so it is always searched
+	if (icell != 0 && !bbox_overlaps(cell.bounds, region)) return;
+
+	for (int item : cell.items) {
+		if (bbox_overlaps(item_bboxes_[item], region)) {
+			items.push_back(item);
+		}
+	}
+
+	if (cell.first_child != OPEN) {
+		for (int ichild = 0; ichild < 4; ++ichild) {
+			query_cell(cell.first_child + ichild, region, items);
+		}
+	}
+}
+
 /**************************************************
  * begin t_draw_pb_type_info function definitions *
  **************************************************/
@@ -25,6 +25,7 @@
 #include "vpr_types.h"
 #include "vtr_color_map.h"
 #include "vtr_vector.h"
+#include "vtr_matrix.h"
 
 enum e_draw_crit_path {
       DRAW_NO_CRIT_PATH
@@ -118,6 +119,38 @@ typedef struct {
 	bool node_highlighted;
 } t_draw_rr_node;
 
+/* A quadtree over the drawing (world) coordinates of the device, used to find
+ * the items (e.g. rr_nodes) in a region of the screen without visiting every
+ * item. Cells are split down to about the size of a grid tile, and each item is
+ * kept in the smallest cell which contains its whole bounding box.
+ */
+class t_draw_quadtree {
+public:
+	void init(const t_bound_box& bounds, float min_cell_size);
+	void clear();
+	bool empty() const;
+
+	void insert(int item, const t_bound_box& bbox);
+
+	/* Appends the items whose bounding boxes overlap region to items, in
+	 * increasing order. */
+	void query(const t_bound_box& region, std::vector<int>& items) const;
+
+private:
+	struct t_cell {
+		t_bound_box bounds;
+		int first_child = OPEN; /* Index of the first of the 4 child cells, if split */
+		std::vector<int> items;
+	};
+
+	void query_cell(int icell, const t_bound_box& region, std::vector<int>& items) const;
+
+	std::vector<t_cell> cells_; /* cells_[0] is the root */
+	std::vector<t_bound_box> item_bboxes_;
+	float min_cell_size_ = 0.;
+	size_t num_items_ = 0;
+};
+
 /* Structure used to store state variables that control drawing and
  * highlighting.
  * pic_on_screen: What to draw on the screen (PLACEMENT, ROUTING, or
@@ -146,6 +179,16 @@ typedef struct {
  *				 Used to control drawing each routing resource when
  *				 ROUTING is on screen.
  *				 [0..device_ctx.rr_nodes.size()-1]
+ * rr_node_bbox: cached drawing geometry of each routing resource (the
+ *				 wire of a CHANX/CHANY, or the square of an IPIN/OPIN).
+ *				 Set by init_draw_coords. [0..device_ctx.rr_nodes.size()-1]
+ * rr_node_index: spatial index of the routing resources, by the area
+ *				  covered by each node and the edges drawn from it. Used to
+ *				  draw (and hit test) only the nodes on screen.
+ * chanx_util, chany_util: cached routing utilization of each channel
+ *						   segment, drawn instead of the individual wires
+ *						   when zoomed out too far to tell them apart.
+ *						   Only valid if chan_util_valid.
  */
 struct t_draw_state {
 	pic_type pic_on_screen = NO_PICTURE;
@@ -167,6 +210,11 @@ struct t_draw_state {
 	vtr::vector<ClusterNetId, t_color> net_color;
 	vtr::vector<ClusterBlockId, t_color> block_color;
 	t_draw_rr_node *draw_rr_node = nullptr;
+	std::vector<t_bound_box> rr_node_bbox;
+	t_draw_quadtree rr_node_index;
+	vtr::Matrix<float> chanx_util;
+	vtr::Matrix<float> chany_util;
+	bool chan_util_valid = false;
     std::shared_ptr<const SetupTimingInfo> setup_timing_info;
     const t_arch* arch_info = nullptr;
     std::unique_ptr<const vtr::ColorMap> color_map = nullptr;
@@ -289,7 +289,8 @@ static t_molecule_stats calc_max_molecules_stats(const t_pack_molecule* molecule
 
 static std::vector<AtomBlockId> initialize_seed_atoms(const e_cluster_seed seed_type,
         const std::multimap<AtomBlockId,t_pack_molecule*>& atom_molecules,
-        const t_molecule_stats& max_molecule_stats, const vtr::vector<AtomBlockId,float>& atom_criticality);
+        const t_molecule_stats& max_molecule_stats, const vtr::vector<AtomBlockId,float>& atom_criticality,
+        const vtr::vector<AtomBlockId,int>& atom_partitions);
 
 static t_pack_molecule* get_highest_gain_seed_molecule(int* seedindex, const std::multimap<AtomBlockId,t_pack_molecule*>& atom_molecules, const std::vector<AtomBlockId> seed_atoms);
 
@@ -315,10 +316,8 @@ std::map<t_type_ptr,size_t> do_clustering(const t_packer_opts& packer_opts, cons
         const std::unordered_map<AtomBlockId,t_pb_graph_node*>& expected_lowest_cost_pb_gnode,
 		bool allow_unrelated_clustering,
 		std::vector<t_lb_type_rr_node> *lb_type_rr_graphs,
-        const t_ext_pin_util_targets& ext_pin_util_targets
-#ifdef USE_HMETIS
-		, vtr::vector<AtomBlockId, int>& partitions
-#endif
+        const t_ext_pin_util_targets& ext_pin_util_targets,
+        const vtr::vector<AtomBlockId, int>& atom_partitions
 #ifdef ENABLE_CLASSIC_VPR_STA
         , t_timing_inf timing_inf
 #endif
@@ -475,7 +474,7 @@ std::map<t_type_ptr,size_t> do_clustering(const t_packer_opts& packer_opts, cons
         }
 	}
 
-    auto seed_atoms = initialize_seed_atoms(packer_opts.cluster_seed_type, atom_molecules, max_molecule_stats, atom_criticality);
+    auto seed_atoms = initialize_seed_atoms(packer_opts.cluster_seed_type, atom_molecules, max_molecule_stats, atom_criticality, atom_partitions);
 
     istart = get_highest_gain_seed_molecule(&seedindex, atom_molecules, seed_atoms);
 
@@ -705,6 +704,8 @@ std::map<t_type_ptr,size_t> do_clustering(const t_packer_opts& packer_opts, cons
 
 	free_cluster_placement_stats(cluster_placement_stats);
 
+	free_intra_lb_route_cache();
+
 	for (auto blk_id : cluster_ctx.clb_nlist.blocks())
 		cluster_ctx.clb_nlist.remove_block(blk_id);
 
@@ -2466,7 +2467,8 @@ static t_molecule_stats calc_max_molecules_stats(const t_pack_molecule* molecule
 
 static std::vector<AtomBlockId> initialize_seed_atoms(const e_cluster_seed seed_type,
         const std::multimap<AtomBlockId,t_pack_molecule*>& atom_molecules,
-        const t_molecule_stats& max_molecule_stats, const vtr::vector<AtomBlockId,float>& atom_criticality) {
+        const t_molecule_stats& max_molecule_stats, const vtr::vector<AtomBlockId,float>& atom_criticality,
+        const vtr::vector<AtomBlockId,int>& atom_partitions) {
     std::vector<AtomBlockId> seed_atoms;
 
     //Put all atoms in seed list
@@ -2615,6 +2617,15 @@ static std::vector<AtomBlockId> initialize_seed_atoms(const e_cluster_seed seed_
     };
     std::sort(seed_atoms.begin(), seed_atoms.end(), by_descending_gain);
 
+    if (!atom_partitions.empty()) {
+        //Seed one netlist part at a time (highest gain first within each part), so that
+        //clusters grow within parts rather than across the partition cut
+        auto by_partition = [&](const AtomBlockId lhs, const AtomBlockId rhs) {
+            return atom_partitions[lhs] < atom_partitions[rhs];
+        };
+        std::stable_sort(seed_atoms.begin(), seed_atoms.end(), by_partition);
+    }
+
     if (getEchoEnabled() && isEchoFileEnabled(E_ECHO_CLUSTERING_BLOCK_CRITICALITIES)) {
         print_seed_gains(getEchoFileName(E_ECHO_CLUSTERING_BLOCK_CRITICALITIES), seed_atoms, atom_gains, atom_criticality);
     }
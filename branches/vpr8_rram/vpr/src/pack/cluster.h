@@ -18,10 +18,8 @@ std::map<t_type_ptr,size_t> do_clustering(const t_packer_opts& packer_opts, cons
         const std::unordered_map<AtomBlockId,t_pb_graph_node*>& expected_lowest_cost_pb_gnode,
 		bool allow_unrelated_clustering,
 		std::vector<t_lb_type_rr_node> *lb_type_rr_graphs,
-        const t_ext_pin_util_targets& ext_pin_util_targets
-#ifdef USE_HMETIS
-		, vtr::vector<AtomBlockId, int>& partitions
-#endif
+        const t_ext_pin_util_targets& ext_pin_util_targets,
+        const vtr::vector<AtomBlockId, int>& atom_partitions
 #ifdef ENABLE_CLASSIC_VPR_STA
         , t_timing_inf timing_inf
 #endif
@@ -15,13 +15,16 @@
 #include <cstdio>
 #include <cstring>
 #include <vector>
+#include <list>
 #include <map>
 #include <queue>
+#include <unordered_map>
 #include <cmath>
 using namespace std;
 
 #include "vtr_assert.h"
 #include "vtr_log.h"
+#include "vtr_hash.h"
 
 #include "vpr_error.h"
 #include "vpr_types.h"
@@ -36,42 +39,60 @@ using namespace std;
 
 /* #define PRINT_INTRA_LB_ROUTE */
 
+/* Maximum (estimated) memory used by the intra-logic block route cache.  Beyond this the least recently used
+   routing problems are evicted, which bounds its memory footprint on large netlists */
+#define LB_ROUTE_CACHE_MAX_BYTES (64 * 1024 * 1024)
+
 /*****************************************************************************************
 * Internal data structures
 ******************************************************************************************/
 
 enum e_commit_remove {RT_COMMIT, RT_REMOVE};
 
-// TODO: check if this hacky class memory reserve thing is still necessary, if not, then delete
-/* Packing uses a priority queue that requires a large number of elements.  This backdoor
-allows me to use a priority queue where I can pre-allocate the # of elements in the underlying container
-for efficiency reasons.  Note: Must use vector with this */
-template <class T, class U, class V>
-class reservable_pq: public priority_queue<T, U, V>
-{
-	public:
-		typedef typename priority_queue<T>::size_type size_type;
-		reservable_pq(size_type capacity = 0) {
-			reserve(capacity);
-			cur_cap = capacity;
-		};
-		void reserve(size_type capacity) {
-			this->c.reserve(capacity);
-			cur_cap = capacity;
-		}
-		void clear() {
-			this->c.clear();
-			this->c.reserve(cur_cap);
+/* The outcome of routing a cluster, and the route trees of its nets (in net order) if it routed */
+struct t_lb_route_cache_entry {
+	bool is_routed;
+	vector<t_lb_trace> rt_trees;
+	size_t num_bytes; /* Estimated memory used by this entry, including its key */
+	list<const vector<int>*>::iterator lru_position; /* Position of this entry's key in lb_route_cache_lru */
+};
+
+struct t_lb_route_key_hash {
+	size_t operator()(const vector<int>& key) const {
+		size_t seed = key.size();
+		for(int value : key) {
+			vtr::hash_combine(seed, value);
 		}
-	private:
-		size_type cur_cap;
+		return seed;
+	}
 };
 
+/*****************************************************************************************
+* Internal data
+******************************************************************************************/
+
+/* The intra-logic block router is deterministic: its result only depends on the cluster type, the modes of the
+   lb_type_rr_graph nodes and the (ordered) terminals of the nets to route.  The packer tries the same molecules
+   against identically filled clusters many times, so the results are memoized here, keyed by that signature
+   (see build_lb_route_key).  Previously rejected combinations fail without routing, and accepted ones reuse the
+   saved route trees */
+static unordered_map<vector<int>, t_lb_route_cache_entry, t_lb_route_key_hash> lb_route_cache;
+static list<const vector<int>*> lb_route_cache_lru; /* Keys of lb_route_cache, most recently used first */
+static size_t lb_route_cache_bytes = 0;
+static size_t num_lb_route_cache_hits = 0;
+static size_t num_lb_route_cache_misses = 0;
+
 /*****************************************************************************************
 * Internal functions declarations
 ******************************************************************************************/
+static bool route_intra_lb(t_lb_router_data *router_data, int verbosity);
+static vector<int> build_lb_route_key(const t_lb_router_data *router_data);
+static void load_lb_route_from_cache(t_lb_router_data *router_data, const t_lb_route_cache_entry &cache_entry);
+static void add_lb_route_to_cache(const t_lb_router_data *router_data, vector<int> &&route_key, bool is_routed);
+static void set_lb_rr_node_mode(t_lb_router_data *router_data, int inode, int mode);
 static void free_lb_net_rt(t_lb_trace *lb_trace);
-static void free_lb_trace(t_lb_trace *lb_trace);
+static int add_node_to_lb_trace(t_lb_trace *lb_trace, int parent, int rr_node);
+static int next_lb_trace_node(const t_lb_trace *lb_trace, int itrace);
 static void add_pin_to_rt_terminals(t_lb_router_data *router_data, const AtomPinId pin_id);
 static void remove_pin_from_rt_terminals(t_lb_router_data *router_data, const AtomPinId pin_id);
 
@@ -80,17 +101,16 @@ static void fix_duplicate_equivalent_pins(t_lb_router_data *router_data);
 static void commit_remove_rt(t_lb_trace *rt, t_lb_router_data *router_data, e_commit_remove op);
 static bool is_skip_route_net(t_lb_trace *rt, t_lb_router_data *router_data);
 static void add_source_to_rt(t_lb_router_data *router_data, int inet);
-static void expand_rt(t_lb_router_data *router_data, int inet, reservable_pq<t_expansion_node, vector <t_expansion_node>, compare_expansion_node> &pq, int irt_net);
-static void expand_rt_rec(t_lb_trace *rt, int prev_index, t_explored_node_tb *explored_node_tb,
-	reservable_pq<t_expansion_node, vector <t_expansion_node>, compare_expansion_node> &pq, int irt_net, int explore_id_index);
+static void expand_rt(t_lb_router_data *router_data, int inet, t_lb_expansion_pq &pq, int irt_net);
 static void expand_node(t_lb_router_data *router_data, t_expansion_node exp_node,
-	reservable_pq<t_expansion_node, vector <t_expansion_node>, compare_expansion_node> &pq, int net_fanout);
+	t_lb_expansion_pq &pq, int net_fanout);
+static void touch_explored_node(t_lb_router_data *router_data, int inode);
 static void add_to_rt(t_lb_trace *rt, int node_index, t_explored_node_tb *explored_node_tb, int irt_net);
 static bool is_route_success(t_lb_router_data *router_data);
-static t_lb_trace *find_node_in_rt(t_lb_trace *rt, int rt_index);
+static int find_node_in_rt(const t_lb_trace *rt, int rt_index);
 static void reset_explored_node_tb(t_lb_router_data *router_data);
 static void save_and_reset_lb_route(t_lb_router_data *router_data);
-static void load_trace_to_pb_route(t_pb_routes& pb_route, const int total_pins, const AtomNetId net_id, const int prev_pin_id, const t_lb_trace *trace);
+static void load_trace_to_pb_route(t_pb_routes& pb_route, const int total_pins, const AtomNetId net_id, const t_lb_trace *trace);
 
 static std::string describe_lb_type_rr_node(int inode,
                                             const t_lb_router_data* router_data);
@@ -218,13 +238,13 @@ void set_reset_pb_modes(t_lb_router_data *router_data, const t_pb *pb, const boo
 	for(int iport = 0; iport < pb_graph_node->num_input_ports; iport++) {
 		for(int ipin = 0; ipin < pb_graph_node->num_input_pins[iport]; ipin++) {
 			inode = pb_graph_node->input_pins[iport][ipin].pin_count_in_cluster;
-			router_data->lb_rr_node_stats[inode].mode = (set == true) ? mode : 0;
+			set_lb_rr_node_mode(router_data, inode, (set == true) ? mode : 0);
 		}
 	}
 	for(int iport = 0; iport < pb_graph_node->num_clock_ports; iport++) {
 		for(int ipin = 0; ipin < pb_graph_node->num_clock_pins[iport]; ipin++) {
 			inode = pb_graph_node->clock_pins[iport][ipin].pin_count_in_cluster;
-			router_data->lb_rr_node_stats[inode].mode = (set == true) ? mode : 0;
+			set_lb_rr_node_mode(router_data, inode, (set == true) ? mode : 0);
 		}
 	}
 
@@ -238,7 +258,7 @@ void set_reset_pb_modes(t_lb_router_data *router_data, const t_pb *pb, const boo
 				for(int iport = 0; iport < child_pb_graph_node->num_output_ports; iport++) {
 					for(int ipin = 0; ipin < child_pb_graph_node->num_output_pins[iport]; ipin++) {
 						inode = child_pb_graph_node->output_pins[iport][ipin].pin_count_in_cluster;
-						router_data->lb_rr_node_stats[inode].mode = (set == true) ? mode : 0;
+						set_lb_rr_node_mode(router_data, inode, (set == true) ? mode : 0);
 					}
 				}
 			}
@@ -247,10 +267,51 @@ void set_reset_pb_modes(t_lb_router_data *router_data, const t_pb *pb, const boo
 }
 
 /* Attempt to route routing driver/targets on the current architecture
-   Follows pathfinder negotiated congestion algorithm
+   Answered from the route cache if an identical cluster has been routed before, otherwise
+   routes with route_intra_lb() and records the result
 */
 bool try_intra_lb_route(t_lb_router_data *router_data,
                         int verbosity) {
+	vector<int> route_key = build_lb_route_key(router_data);
+
+	auto cache_itr = lb_route_cache.find(route_key);
+	if(cache_itr != lb_route_cache.end()) {
+		++num_lb_route_cache_hits;
+		if(verbosity > 4) {
+			VTR_LOG("\t\t\tIntra-cluster route %s (cached)\n", cache_itr->second.is_routed ? "succeeded" : "failed");
+		}
+		lb_route_cache_lru.splice(lb_route_cache_lru.begin(), lb_route_cache_lru, cache_itr->second.lru_position);
+		if(cache_itr->second.is_routed) {
+			load_lb_route_from_cache(router_data, cache_itr->second);
+		}
+		return cache_itr->second.is_routed;
+	}
+	++num_lb_route_cache_misses;
+
+	bool is_routed = route_intra_lb(router_data, verbosity);
+
+	add_lb_route_to_cache(router_data, std::move(route_key), is_routed);
+
+	return is_routed;
+}
+
+/* Free the intra-logic block route cache, reporting how effective it was */
+void free_intra_lb_route_cache() {
+	if(num_lb_route_cache_hits + num_lb_route_cache_misses > 0) {
+		VTR_LOG("Intra-cluster route cache: %zu hits, %zu misses\n", num_lb_route_cache_hits, num_lb_route_cache_misses);
+	}
+	lb_route_cache.clear();
+	lb_route_cache_lru.clear();
+	lb_route_cache_bytes = 0;
+	num_lb_route_cache_hits = 0;
+	num_lb_route_cache_misses = 0;
+}
+
+/* Route routing driver/targets on the current architecture
+   Follows pathfinder negotiated congestion algorithm
+*/
+static bool route_intra_lb(t_lb_router_data *router_data,
+                           int verbosity) {
 	vector <t_intra_lb_net> & lb_nets = *router_data->intra_lb_nets;
 	vector <t_lb_type_rr_node> & lb_type_graph = *router_data->lb_type_graph;
 	bool is_routed = false;
@@ -258,19 +319,15 @@ bool try_intra_lb_route(t_lb_router_data *router_data,
 	t_expansion_node exp_node;
 
 	/* Stores state info during route */
-	reservable_pq <t_expansion_node, vector <t_expansion_node>, compare_expansion_node> pq;
+	t_lb_expansion_pq &pq = router_data->pq;
 
+	/* Reset current routing */
 	reset_explored_node_tb(router_data);
 
-	/* Reset current routing */
 	for(unsigned int inet = 0; inet < lb_nets.size(); inet++) {
 		free_lb_net_rt(lb_nets[inet].rt_tree);
 		lb_nets[inet].rt_tree = nullptr;
 	}
-	for(unsigned int inode = 0; inode < lb_type_graph.size(); inode++) {
-		router_data->lb_rr_node_stats[inode].historical_usage = 0;
-		router_data->lb_rr_node_stats[inode].occ = 0;
-	}
 
 	/*	Iteratively remove congestion until a successful route is found.
 		Cap the total number of iterations tried so that if a solution does not exist, then the router won't run indefinately */
@@ -342,12 +399,13 @@ bool try_intra_lb_route(t_lb_router_data *router_data,
 
 				router_data->explore_id_index++;
 				if(router_data->explore_id_index > 2000000000) {
-					/* overflow protection */
+					/* overflow protection.  Membership of touched_nodes is tracked by is_touched rather than
+					   enqueue_id, so the touched nodes are neither forgotten nor recorded twice */
 					for(unsigned int id = 0; id < lb_type_graph.size(); id++) {
 						router_data->explored_node_tb[id].explored_id = OPEN;
 						router_data->explored_node_tb[id].enqueue_id = OPEN;
-						router_data->explore_id_index = 1;
 					}
+					router_data->explore_id_index = 1;
 				}
 			}
 
@@ -404,7 +462,7 @@ t_pb_routes alloc_and_load_pb_route(const vector <t_intra_lb_net> *intra_lb_nets
 	t_pb_routes pb_route;
 
 	for(int inet = 0; inet < (int)lb_nets.size(); inet++) {
-		load_trace_to_pb_route(pb_route, total_pins, lb_nets[inet].atom_net_id, OPEN, lb_nets[inet].rt_tree);
+		load_trace_to_pb_route(pb_route, total_pins, lb_nets[inet].atom_net_id, lb_nets[inet].rt_tree);
 	}
 
 	return pb_route;
@@ -435,47 +493,74 @@ void free_intra_lb_nets(vector <t_intra_lb_net> *intra_lb_nets) {
 Internal Functions
 ****************************************************************************/
 
-/* Recurse through route tree trace to populate pb pin to atom net lookup array */
-static void load_trace_to_pb_route(t_pb_routes& pb_route, const int total_pins, const AtomNetId net_id, const int prev_pin_id, const t_lb_trace *trace) {
-	int ipin = trace->current_node;
-	int driver_pb_pin_id = prev_pin_id;
-	int cur_pin_id = OPEN;
-	if(ipin < total_pins) {
-		/* This routing node corresponds with a pin.  This node is virtual (ie. sink or source node) */
-		cur_pin_id = ipin;
-		if(!pb_route.count(ipin)) {
-            pb_route.insert(std::make_pair(cur_pin_id, t_pb_route()));
-			pb_route[cur_pin_id].atom_net_id = net_id;
-			pb_route[cur_pin_id].driver_pb_pin_id = driver_pb_pin_id;
-		} else {
-			VTR_ASSERT(pb_route[cur_pin_id].atom_net_id == net_id);
+/* Walk route tree trace to populate pb pin to atom net lookup array */
+static void load_trace_to_pb_route(t_pb_routes& pb_route, const int total_pins, const AtomNetId net_id, const t_lb_trace *trace) {
+	/* Pin used by each trace node (OPEN if the node is not a pin).  Parents are stored before their children,
+	   so the driver of a node is always known by the time the node is visited */
+	vector<int> trace_pin_ids(trace->nodes.size(), OPEN);
+
+	for(int itrace = 0; itrace < (int)trace->nodes.size(); itrace++) {
+		const t_lb_trace_node &trace_node = trace->nodes[itrace];
+		int ipin = trace_node.current_node;
+		int driver_pb_pin_id = (trace_node.parent == OPEN) ? OPEN : trace_pin_ids[trace_node.parent];
+		if(ipin < total_pins) {
+			/* This routing node corresponds with a pin.  This node is virtual (ie. sink or source node) */
+			int cur_pin_id = ipin;
+			trace_pin_ids[itrace] = cur_pin_id;
+			if(!pb_route.count(ipin)) {
+				pb_route.insert(std::make_pair(cur_pin_id, t_pb_route()));
+				pb_route[cur_pin_id].atom_net_id = net_id;
+				pb_route[cur_pin_id].driver_pb_pin_id = driver_pb_pin_id;
+			} else {
+				VTR_ASSERT(pb_route[cur_pin_id].atom_net_id == net_id);
+			}
 		}
 	}
-	for(int itrace = 0; itrace< (int)trace->next_nodes.size(); itrace++) {
-		load_trace_to_pb_route(pb_route, total_pins, net_id, cur_pin_id, &trace->next_nodes[itrace]);
-	}
 }
 
 
 /* Free route tree for intra-logic block routing */
 static void free_lb_net_rt(t_lb_trace *lb_trace) {
-	if(lb_trace != nullptr) {
-		for(unsigned int i = 0; i < lb_trace->next_nodes.size(); i++) {
-			free_lb_trace(&lb_trace->next_nodes[i]);
+	delete lb_trace;
+}
+
+/* Append a new node driven by trace node parent (OPEN for the root) to the route tree, returns its index */
+static int add_node_to_lb_trace(t_lb_trace *lb_trace, int parent, int rr_node) {
+	int itrace = lb_trace->nodes.size();
+
+	t_lb_trace_node trace_node;
+	trace_node.current_node = rr_node;
+	trace_node.parent = parent;
+	trace_node.first_child = OPEN;
+	trace_node.last_child = OPEN;
+	trace_node.next_sibling = OPEN;
+	lb_trace->nodes.push_back(trace_node);
+
+	if(parent != OPEN) {
+		t_lb_trace_node &parent_node = lb_trace->nodes[parent];
+		if(parent_node.first_child == OPEN) {
+			parent_node.first_child = itrace;
+		} else {
+			lb_trace->nodes[parent_node.last_child].next_sibling = itrace;
 		}
-		lb_trace->next_nodes.clear();
-		delete lb_trace;
+		parent_node.last_child = itrace;
 	}
+
+	return itrace;
 }
 
-/* Free trace for intra-logic block routing */
-static void free_lb_trace(t_lb_trace *lb_trace) {
-	if(lb_trace != nullptr) {
-		for(unsigned int i = 0; i < lb_trace->next_nodes.size(); i++) {
-			free_lb_trace(&lb_trace->next_nodes[i]);
-		}
-		lb_trace->next_nodes.clear();
+/* Returns the trace node visited after itrace in a depth-first (pre-order) walk of the route tree, or OPEN once
+   the walk is complete.  Start the walk from the root (index 0) */
+static int next_lb_trace_node(const t_lb_trace *lb_trace, int itrace) {
+	const vector<t_lb_trace_node> &nodes = lb_trace->nodes;
+
+	if(nodes[itrace].first_child != OPEN) {
+		return nodes[itrace].first_child;
+	}
+	while(itrace != OPEN && nodes[itrace].next_sibling == OPEN) {
+		itrace = nodes[itrace].parent;
 	}
+	return (itrace == OPEN) ? OPEN : nodes[itrace].next_sibling;
 }
 
 
@@ -857,25 +942,24 @@ static void commit_remove_rt(t_lb_trace *rt, t_lb_router_data *router_data, e_co
 		return;
 	}
 
-	inode = rt->current_node;
+	/* Update every node of the route tree */
+	for(const t_lb_trace_node &trace_node : rt->nodes) {
+		inode = trace_node.current_node;
+		touch_explored_node(router_data, inode);
 
-	/* Determine if node is being used or removed */
-	if (op == RT_COMMIT) {
-		incr = 1;
-		if (lb_rr_node_stats[inode].occ >= lb_type_graph[inode].capacity) {
-			lb_rr_node_stats[inode].historical_usage += (lb_rr_node_stats[inode].occ - lb_type_graph[inode].capacity + 1); /* store historical overuse */
+		/* Determine if node is being used or removed */
+		if (op == RT_COMMIT) {
+			incr = 1;
+			if (lb_rr_node_stats[inode].occ >= lb_type_graph[inode].capacity) {
+				lb_rr_node_stats[inode].historical_usage += (lb_rr_node_stats[inode].occ - lb_type_graph[inode].capacity + 1); /* store historical overuse */
+			}
+		} else {
+			incr = -1;
+			explored_node_tb[inode].inet = OPEN;
 		}
-	} else {
-		incr = -1;
-		explored_node_tb[inode].inet = OPEN;
-	}
-
-	lb_rr_node_stats[inode].occ += incr;
-	VTR_ASSERT(lb_rr_node_stats[inode].occ >= 0);
 
-	/* Recursively update route tree */
-	for(unsigned int i = 0; i < rt->next_nodes.size(); i++) {
-		commit_remove_rt(&rt->next_nodes[i], router_data, op);
+		lb_rr_node_stats[inode].occ += incr;
+		VTR_ASSERT(lb_rr_node_stats[inode].occ >= 0);
 	}
 }
 
@@ -891,17 +975,13 @@ static bool is_skip_route_net(t_lb_trace *rt, t_lb_router_data *router_data) {
 		return false; /* Net is not routed, therefore must route net */
 	}
 
-	inode = rt->current_node;
-
-	/* Determine if node is overused */
-	if (lb_rr_node_stats[inode].occ > lb_type_graph[inode].capacity) {
-		/* Conflict between this net and another net at this node, reroute net */
-		return false;
-	}
+	/* Check that no node of the route tree has a conflict */
+	for (const t_lb_trace_node &trace_node : rt->nodes) {
+		inode = trace_node.current_node;
 
-	/* Recursively check that rest of route tree does not have a conflict */
-	for (unsigned int i = 0; i < rt->next_nodes.size(); i++) {
-		if (is_skip_route_net(&rt->next_nodes[i], router_data) == false) {
+		/* Determine if node is overused */
+		if (lb_rr_node_stats[inode].occ > lb_type_graph[inode].capacity) {
+			/* Conflict between this net and another net at this node, reroute net */
 			return false;
 		}
 	}
@@ -915,48 +995,44 @@ static bool is_skip_route_net(t_lb_trace *rt, t_lb_router_data *router_data) {
 static void add_source_to_rt(t_lb_router_data *router_data, int inet) {
 	VTR_ASSERT((*router_data->intra_lb_nets)[inet].rt_tree == nullptr);
 	(*router_data->intra_lb_nets)[inet].rt_tree = new t_lb_trace;
-	(*router_data->intra_lb_nets)[inet].rt_tree->current_node = (*router_data->intra_lb_nets)[inet].terminals[0];
+	add_node_to_lb_trace((*router_data->intra_lb_nets)[inet].rt_tree, OPEN, (*router_data->intra_lb_nets)[inet].terminals[0]);
 }
 
 /* Expand all nodes found in route tree into priority queue */
 static void expand_rt(t_lb_router_data *router_data, int inet,
-	reservable_pq<t_expansion_node, vector <t_expansion_node>, compare_expansion_node> &pq, int irt_net) {
+	t_lb_expansion_pq &pq, int irt_net) {
 
 	vector<t_intra_lb_net> &lb_nets = *router_data->intra_lb_nets;
+	const t_lb_trace *rt = lb_nets[inet].rt_tree;
+	t_explored_node_tb *explored_node_tb = router_data->explored_node_tb;
 
 	VTR_ASSERT(pq.empty());
 
-	expand_rt_rec(lb_nets[inet].rt_tree, OPEN, router_data->explored_node_tb, pq, irt_net, router_data->explore_id_index);
-}
-
-
-/* Expand all nodes found in route tree into priority queue recursively */
-static void expand_rt_rec(t_lb_trace *rt, int prev_index, t_explored_node_tb *explored_node_tb,
-	reservable_pq<t_expansion_node, vector <t_expansion_node>, compare_expansion_node> &pq, int irt_net, int explore_id_index) {
-
-	t_expansion_node enode;
-
-	/* Perhaps should use a cost other than zero */
-	enode.cost = 0;
-	enode.node_index = rt->current_node;
-	enode.prev_index = prev_index;
-	pq.push(enode);
-	explored_node_tb[enode.node_index].inet = irt_net;
-	explored_node_tb[enode.node_index].explored_id = OPEN;
-	explored_node_tb[enode.node_index].enqueue_id = explore_id_index;
-	explored_node_tb[enode.node_index].enqueue_cost = 0;
-	explored_node_tb[enode.node_index].prev_index = prev_index;
-
-
-	for(unsigned int i = 0; i < rt->next_nodes.size(); i++) {
-		expand_rt_rec(&rt->next_nodes[i], rt->current_node, explored_node_tb, pq, irt_net, explore_id_index);
+	/* Walk the route tree depth-first, so nodes are pushed in the same order as they were routed */
+	for(int itrace = 0; itrace != OPEN; itrace = next_lb_trace_node(rt, itrace)) {
+		const t_lb_trace_node &trace_node = rt->nodes[itrace];
+		int prev_index = (trace_node.parent == OPEN) ? OPEN : rt->nodes[trace_node.parent].current_node;
+
+		t_expansion_node enode;
+
+		/* Perhaps should use a cost other than zero */
+		enode.cost = 0;
+		enode.node_index = trace_node.current_node;
+		enode.prev_index = prev_index;
+		pq.push(enode);
+		touch_explored_node(router_data, enode.node_index);
+		explored_node_tb[enode.node_index].inet = irt_net;
+		explored_node_tb[enode.node_index].explored_id = OPEN;
+		explored_node_tb[enode.node_index].enqueue_id = router_data->explore_id_index;
+		explored_node_tb[enode.node_index].enqueue_cost = 0;
+		explored_node_tb[enode.node_index].prev_index = prev_index;
 	}
 }
 
 
 /* Expand all nodes found in route tree into priority queue */
 static void expand_node(t_lb_router_data *router_data, t_expansion_node exp_node,
-	reservable_pq<t_expansion_node, vector <t_expansion_node>, compare_expansion_node> &pq, int net_fanout) {
+	t_lb_expansion_pq &pq, int net_fanout) {
 
 	int cur_node;
 	float cur_cost, incr_cost;
@@ -1008,6 +1084,7 @@ static void expand_node(t_lb_router_data *router_data, t_expansion_node exp_node
 				pq.push(enode);
 			}
 		} else {
+			touch_explored_node(router_data, enode.node_index);
 			router_data->explored_node_tb[enode.node_index].enqueue_id = router_data->explore_id_index;
 			router_data->explored_node_tb[enode.node_index].enqueue_cost = enode.cost;
 			pq.push(enode);
@@ -1016,14 +1093,23 @@ static void expand_node(t_lb_router_data *router_data, t_expansion_node exp_node
 
 }
 
+/* Record that a node's explored_node_tb or lb_rr_node_stats entry is about to be modified, so it is reset
+   before the next routing attempt.  Called before a node is enqueued and before its occupancy is committed
+   or removed (which covers the sources of nets that are never expanded) */
+static void touch_explored_node(t_lb_router_data *router_data, int inode) {
+	if(!router_data->explored_node_tb[inode].is_touched) {
+		router_data->explored_node_tb[inode].is_touched = true;
+		router_data->touched_nodes.push_back(inode);
+	}
+}
+
 
 
 /* Add new path from existing route tree to target sink */
 static void add_to_rt(t_lb_trace *rt, int node_index, t_explored_node_tb *explored_node_tb, int irt_net) {
 	vector <int> trace_forward;
 	int rt_index, trace_index;
-	t_lb_trace *link_node;
-	t_lb_trace curr_node;
+	int link_node;
 
 	/* Store path all the way back to route tree */
 	rt_index = node_index;
@@ -1035,23 +1121,22 @@ static void add_to_rt(t_lb_trace *rt, int node_index, t_explored_node_tb *explor
 
 	/* Find rt_index on the route tree */
 	link_node = find_node_in_rt(rt, rt_index);
-	VTR_ASSERT(link_node != nullptr);
+	VTR_ASSERT(link_node != OPEN);
 
 	/* Add path to root tree */
 	while(!trace_forward.empty()) {
 		trace_index = trace_forward.back();
-        curr_node.current_node = trace_index;
-        link_node->next_nodes.push_back(curr_node);
-        link_node = &link_node->next_nodes.back();
+        link_node = add_node_to_lb_trace(rt, link_node, trace_index);
         trace_forward.pop_back();
 	}
 }
 
-/* Determine if a completed route is valid.  A successful route has no congestion (ie. no routing resource is used by two nets). */
+/* Determine if a completed route is valid.  A successful route has no congestion (ie. no routing resource is used by two nets).
+   Only nodes touched since the last reset can be occupied, so only those are checked */
 static bool is_route_success(t_lb_router_data *router_data) {
 	vector <t_lb_type_rr_node> & lb_type_graph = *router_data->lb_type_graph;
 
-	for(unsigned int inode = 0; inode < lb_type_graph.size(); inode++) {
+	for(int inode : router_data->touched_nodes) {
 		if(router_data->lb_rr_node_stats[inode].occ > lb_type_graph[inode].capacity) {
 			return false;
 		}
@@ -1060,20 +1145,14 @@ static bool is_route_success(t_lb_router_data *router_data) {
 	return true;
 }
 
-/* Given a route tree and an index of a node on the route tree, return a pointer to the trace corresponding to that index */
-static t_lb_trace *find_node_in_rt(t_lb_trace *rt, int rt_index) {
-	t_lb_trace *cur;
-	if(rt->current_node == rt_index) {
-		return rt;
-	} else {
-		for(unsigned int i = 0; i < rt->next_nodes.size(); i++) {
-			cur = find_node_in_rt(&rt->next_nodes[i], rt_index);
-			if(cur != nullptr) {
-				return cur;
-			}
+/* Given a route tree and an index of a node on the route tree, return the index of the trace node corresponding to that index (OPEN if not found) */
+static int find_node_in_rt(const t_lb_trace *rt, int rt_index) {
+	for(int itrace = 0; itrace < (int)rt->nodes.size(); itrace++) {
+		if(rt->nodes[itrace].current_node == rt_index) {
+			return itrace;
 		}
 	}
-	return nullptr;
+	return OPEN;
 }
 
 #ifdef PRINT_INTRA_LB_ROUTE
@@ -1108,29 +1187,110 @@ static void print_trace(FILE *fp, t_lb_trace *trace) {
 		fprintf(fp, "NULL");
 		return;
 	}
-	for(unsigned int ibranch = 0; ibranch < trace->next_nodes.size(); ibranch++) {
-		if(trace->next_nodes.size() > 1) {
-			fprintf(fp, "B(%d-->%d) ", trace->current_node, trace->next_nodes[ibranch].current_node);
+	for(int itrace = next_lb_trace_node(trace, 0); itrace != OPEN; itrace = next_lb_trace_node(trace, itrace)) {
+		const t_lb_trace_node &parent = trace->nodes[trace->nodes[itrace].parent];
+		if(parent.first_child != parent.last_child) {
+			fprintf(fp, "B(%d-->%d) ", parent.current_node, trace->nodes[itrace].current_node);
 		} else {
-			fprintf(fp, "(%d-->%d) ", trace->current_node, trace->next_nodes[ibranch].current_node);
+			fprintf(fp, "(%d-->%d) ", parent.current_node, trace->nodes[itrace].current_node);
 		}
-		print_trace(fp, &trace->next_nodes[ibranch]);
 	}
 }
 #endif
 
+/* Reset the exploration state and occupancy of the nodes touched by the previous routing attempt.
+   All other nodes are still in their reset state, so the cost is independent of the size of the lb_type_graph */
 static void reset_explored_node_tb(t_lb_router_data *router_data) {
-	vector <t_lb_type_rr_node> & lb_type_graph = *router_data->lb_type_graph;
-	for(unsigned int inode = 0; inode < lb_type_graph.size(); inode++) {
+	for(int inode : router_data->touched_nodes) {
 		router_data->explored_node_tb[inode].prev_index = OPEN;
 		router_data->explored_node_tb[inode].explored_id = OPEN;
 		router_data->explored_node_tb[inode].inet = OPEN;
 		router_data->explored_node_tb[inode].enqueue_id = OPEN;
 		router_data->explored_node_tb[inode].enqueue_cost = 0;
+		router_data->explored_node_tb[inode].is_touched = false;
+		router_data->lb_rr_node_stats[inode].historical_usage = 0;
+		router_data->lb_rr_node_stats[inode].occ = 0;
+	}
+	router_data->touched_nodes.clear();
+}
+
+
+
+/* Build the signature of the routing problem currently held by router_data.
+   It encodes everything route_intra_lb() depends on: the cluster type, the non-default
+   node modes and the terminals of every net, in routing order */
+static vector<int> build_lb_route_key(const t_lb_router_data *router_data) {
+	const vector <t_intra_lb_net> & lb_nets = *router_data->intra_lb_nets;
+	vector<int> key;
+
+	key.push_back(router_data->lb_type->index);
+
+	for(const auto &node_mode : router_data->non_default_modes) {
+		key.push_back(node_mode.first);
+		key.push_back(node_mode.second);
+	}
+	key.push_back(OPEN);
+
+	for(const t_intra_lb_net &lb_net : lb_nets) {
+		key.push_back(lb_net.terminals.size());
+		key.insert(key.end(), lb_net.terminals.begin(), lb_net.terminals.end());
+	}
+
+	return key;
+}
+
+/* Remember the outcome of routing the problem described by route_key, evicting the least recently used
+   problems if the cache grows beyond LB_ROUTE_CACHE_MAX_BYTES */
+static void add_lb_route_to_cache(const t_lb_router_data *router_data, vector<int> &&route_key, bool is_routed) {
+	size_t num_bytes = sizeof(t_lb_route_cache_entry) + sizeof(route_key) + route_key.size() * sizeof(int);
+
+	auto cache_itr = lb_route_cache.emplace(std::move(route_key), t_lb_route_cache_entry()).first;
+	t_lb_route_cache_entry &cache_entry = cache_itr->second;
+	cache_entry.is_routed = is_routed;
+	if(is_routed) {
+		cache_entry.rt_trees.reserve(router_data->saved_lb_nets->size());
+		for(const t_intra_lb_net &saved_net : *router_data->saved_lb_nets) {
+			cache_entry.rt_trees.push_back(*saved_net.rt_tree);
+			num_bytes += sizeof(t_lb_trace) + saved_net.rt_tree->nodes.size() * sizeof(t_lb_trace_node);
+		}
+	}
+	cache_entry.num_bytes = num_bytes;
+	lb_route_cache_lru.push_front(&cache_itr->first);
+	cache_entry.lru_position = lb_route_cache_lru.begin();
+	lb_route_cache_bytes += num_bytes;
+
+	/* Evict the least recently used problems (but never the one just added) */
+	while(lb_route_cache_bytes > LB_ROUTE_CACHE_MAX_BYTES && lb_route_cache_lru.size() > 1) {
+		auto evict_itr = lb_route_cache.find(*lb_route_cache_lru.back());
+		VTR_ASSERT(evict_itr != lb_route_cache.end());
+		lb_route_cache_bytes -= evict_itr->second.num_bytes;
+		lb_route_cache_lru.pop_back();
+		lb_route_cache.erase(evict_itr);
+	}
+}
+
+/* Set the mode of a lb_type_graph node, keeping track of the nodes which are not in the default mode */
+static void set_lb_rr_node_mode(t_lb_router_data *router_data, int inode, int mode) {
+	router_data->lb_rr_node_stats[inode].mode = mode;
+	if(mode != 0) {
+		router_data->non_default_modes[inode] = mode;
+	} else {
+		router_data->non_default_modes.erase(inode);
 	}
 }
 
+/* Load a cached successful route as if route_intra_lb() had just found it */
+static void load_lb_route_from_cache(t_lb_router_data *router_data, const t_lb_route_cache_entry &cache_entry) {
+	vector <t_intra_lb_net> & lb_nets = *router_data->intra_lb_nets;
+
+	VTR_ASSERT(cache_entry.rt_trees.size() == lb_nets.size());
+	for(unsigned int inet = 0; inet < lb_nets.size(); inet++) {
+		free_lb_net_rt(lb_nets[inet].rt_tree);
+		lb_nets[inet].rt_tree = new t_lb_trace(cache_entry.rt_trees[inet]);
+	}
 
+	save_and_reset_lb_route(router_data);
+}
 
 /* Save last successful intra-logic block route and reset current traceback */
 static void save_and_reset_lb_route(t_lb_router_data *router_data) {
@@ -1261,20 +1421,11 @@ static std::string describe_congested_rr_nodes(const std::vector<int>& congested
         AtomNetId atom_net = lb_nets[inet].atom_net_id;
 
         //Walk the traceback to find congested RR nodes for each net
-        std::queue<t_lb_trace> q;
-
-        if (lb_nets[inet].rt_tree) {
-            q.push(*lb_nets[inet].rt_tree);
+        if (!lb_nets[inet].rt_tree) {
+            continue;
         }
-        while (!q.empty()) {
-            t_lb_trace curr = q.front();
-            q.pop();
-
-            for (const t_lb_trace& next_trace : curr.next_nodes) {
-                q.push(next_trace);
-            }
-
-            int inode = curr.current_node;
+        for (const t_lb_trace_node& trace_node : lb_nets[inet].rt_tree->nodes) {
+            int inode = trace_node.current_node;
             const t_lb_type_rr_node& rr_node = lb_type_graph[inode];
             const t_lb_rr_node_stats& rr_node_stats = lb_rr_node_stats[inode];
 
@@ -0,0 +1,730 @@
+/* This file contains a multilevel min-cut hypergraph partitioner for the AtomNetlist, so that
+* the netlist can be partitioned without an external tool such as hMetis.
+*
+* Brief summary of the algorithm
+* ==============================
+* The netlist is split into the requested number of parts by recursive bisection (cut nets are
+* split between the two halves before recursing).  Each bisection is multilevel:
+*
+*	(1) Coarsening: each vertex is merged with the unmatched neighbour it shares the most small
+*	    nets with (heavy-edge matching), until the hypergraph stops shrinking or is small.
+*	(2) Initial bisection: the coarsest hypergraph is bisected several times by growing one
+*	    side breadth-first from a random vertex, each refined with FM; the best cut is kept.
+*	(3) Uncoarsening: the bisection is projected back through each level, rebalanced if
+*	    needed, and refined with Fiduccia-Mattheyses (FM) passes.
+*
+* Vertices are atom blocks (all of weight 1), and hyperedges are the atom nets.
+*/
+
+#include <algorithm>
+#include <array>
+#include <deque>
+#include <limits>
+#include <numeric>
+#include <queue>
+#include <vector>
+
+#include "vtr_assert.h"
+#include "vtr_log.h"
+#include "vtr_math.h"
+#include "vtr_random.h"
+#include "vtr_time.h"
+#include "vtr_util.h"
+
+#include "vpr_types.h"
+#include "globals.h"
+#include "atom_netlist.h"
+#include "hypergraph_partitioner.h"
+
+/* Hypergraphs with at most this many vertices are not coarsened any further */
+constexpr int COARSEST_NUM_VERTICES = 128;
+
+/* Coarsening stops once a level no longer shrinks the number of vertices below this fraction */
+constexpr float MIN_COARSENING_RATIO = 0.95;
+
+/* Nets with more pins than this do not attract vertices to each other during matching or
+ * initial bisection growth (they connect too many vertices to say much about any pair) */
+constexpr int MAX_MATCHING_NET_PINS = 32;
+
+/* Nets with more pins than this are ignored entirely (e.g. resets and enables) */
+constexpr size_t MAX_PARTITION_NET_PINS = 1000;
+
+/* Number of initial bisections of the coarsest hypergraph to try */
+constexpr int NUM_INITIAL_BISECTIONS = 8;
+
+/* Maximum number of FM passes at each level */
+constexpr int MAX_FM_PASSES = 8;
+
+/* An FM pass gives up after this many consecutive moves without finding a better cut */
+constexpr int MAX_FM_NON_IMPROVING_MOVES = 200;
+
+/* Fixed seed, so the same netlist is always partitioned the same way */
+constexpr vtr::RandState PARTITIONER_SEED = 1;
+
+constexpr int NO_VERTEX = -1;
+
+/* Local subroutines */
+static t_hypergraph extract_side(const t_hypergraph& hg, const std::vector<int>& sides, int side,
+		std::vector<int>& side_vertices);
+static std::vector<int> match_vertices(const t_hypergraph& hg, int max_vertex_weight, vtr::RandState& rand_state,
+		int& num_coarse_vertices);
+static t_hypergraph contract(const t_hypergraph& hg, const std::vector<int>& coarse_vertices, int num_coarse_vertices);
+static std::vector<t_side_weights> count_net_side_pins(const t_hypergraph& hg, const std::vector<int>& sides);
+static int vertex_gain(const t_hypergraph& hg, const std::vector<int>& sides,
+		const std::vector<t_side_weights>& net_side_pins, int vertex);
+static int compute_cut(const t_hypergraph& hg, const std::vector<int>& sides);
+static void rebalance(const t_hypergraph& hg, std::vector<int>& sides, const t_side_weights& max_side_weights);
+static int fm_refine(const t_hypergraph& hg, std::vector<int>& sides, const t_side_weights& max_side_weights);
+static std::vector<int> bisect(const t_hypergraph& hg, float target_fraction, float imbalance,
+		vtr::RandState& rand_state);
+static void partition_recursively(const t_hypergraph& hg, const std::vector<int>& vertices, int num_parts,
+		int first_part, float imbalance, vtr::RandState& rand_state, std::vector<int>& parts);
+static bool is_partitioned_net(const AtomNetlist& netlist, AtomNetId net_id);
+
+
+vtr::vector<AtomBlockId, int> partition_atom_netlist(const AtomNetlist& netlist, int num_parts, float imbalance) {
+	VTR_ASSERT(num_parts > 0);
+	vtr::ScopedStartFinishTimer timer(vtr::string_fmt("Partitioning atom netlist into %d parts", num_parts));
+
+	size_t num_blocks = netlist.blocks().size();
+
+	std::vector<std::vector<int>> nets;
+	for (auto net_id : netlist.nets()) {
+		if (!is_partitioned_net(netlist, net_id)) continue;
+
+		nets.emplace_back();
+		for (auto pin_id : netlist.net_pins(net_id)) {
+			nets.back().push_back(size_t(netlist.pin_block(pin_id)));
+		}
+	}
+	std::vector<int> net_weights(nets.size(), 1);
+
+	t_hypergraph hg = build_hypergraph(std::vector<int>(num_blocks, 1), nets, net_weights);
+
+	std::vector<int> vertices(num_blocks);
+	std::iota(vertices.begin(), vertices.end(), 0);
+
+	std::vector<int> parts(num_blocks, 0);
+	vtr::RandState rand_state = PARTITIONER_SEED;
+	partition_recursively(hg, vertices, num_parts, 0, imbalance, rand_state, parts);
+
+	vtr::vector<AtomBlockId, int> partitions(num_blocks, 0);
+	for (auto blk_id : netlist.blocks()) {
+		partitions[blk_id] = parts[size_t(blk_id)];
+	}
+
+	VTR_LOG("Partitioned %zu atom blocks into %d parts, cutting %zu of %zu nets\n",
+			num_blocks, num_parts, count_partition_cut_nets(netlist, partitions), netlist.nets().size());
+
+	return partitions;
+}
+
+const vtr::vector<AtomBlockId, int>& load_atom_partitions(int num_parts) {
+	auto& atom_ctx = g_vpr_ctx.mutable_atom();
+
+	if (atom_ctx.num_partitions != num_parts || atom_ctx.block_partitions.size() != atom_ctx.nlist.blocks().size()) {
+		atom_ctx.block_partitions = partition_atom_netlist(atom_ctx.nlist, num_parts);
+		atom_ctx.num_partitions = num_parts;
+	}
+
+	return atom_ctx.block_partitions;
+}
+
+size_t count_partition_cut_nets(const AtomNetlist& netlist, const vtr::vector<AtomBlockId, int>& partitions) {
+	size_t num_cut_nets = 0;
+	for (auto net_id : netlist.nets()) {
+		int net_part = OPEN;
+		for (auto pin_id : netlist.net_pins(net_id)) {
+			int part = partitions[netlist.pin_block(pin_id)];
+			if (net_part == OPEN) {
+				net_part = part;
+			} else if (part != net_part) {
+				++num_cut_nets;
+				break;
+			}
+		}
+	}
+	return num_cut_nets;
+}
+
+/* Only nets which say something about which blocks belong together are partitioned:
+*  clock and constant nets (which are routed globally or absorbed) and very high fanout
+*  nets are ignored. */
+static bool is_partitioned_net(const AtomNetlist& netlist, AtomNetId net_id) {
+	if (netlist.net_is_constant(net_id)) return false;
+
+	auto pins = netlist.net_pins(net_id);
+	if (pins.size() < 2 || pins.size() > MAX_PARTITION_NET_PINS) return false;
+
+	for (auto pin_id : pins) {
+		if (netlist.pin_port_type(pin_id) == PortType::CLOCK) return false;
+	}
+	return true;
+}
+
+/* Builds a hypergraph from its vertex weights and nets (each a list of vertices, possibly
+*  with duplicates).  Duplicate pins are removed, nets with fewer than two vertices are
+*  dropped, and identical nets are merged into a single net of their combined weight. */
+t_hypergraph build_hypergraph(std::vector<int> vertex_weights, std::vector<std::vector<int>>& nets,
+		const std::vector<int>& net_weights) {
+	t_hypergraph hg;
+	hg.vertex_weights = std::move(vertex_weights);
+	hg.total_weight = std::accumulate(hg.vertex_weights.begin(), hg.vertex_weights.end(), 0);
+
+	std::vector<int> net_order;
+	for (size_t inet = 0; inet < nets.size(); ++inet) {
+		auto& pins = nets[inet];
+		std::sort(pins.begin(), pins.end());
+		pins.erase(std::unique(pins.begin(), pins.end()), pins.end());
+		if (pins.size() >= 2) {
+			net_order.push_back(inet);
+		}
+	}
+
+	//Sort the nets so that identical nets are adjacent
+	std::stable_sort(net_order.begin(), net_order.end(), [&](int lhs, int rhs) {
+		return nets[lhs] < nets[rhs];
+	});
+
+	hg.net_pin_starts.push_back(0);
+	int prev_net = NO_VERTEX;
+	for (int inet : net_order) {
+		if (prev_net != NO_VERTEX && nets[inet] == nets[prev_net]) {
+			hg.net_weights.back() += net_weights[inet];
+			continue;
+		}
+		hg.net_weights.push_back(net_weights[inet]);
+		hg.net_pins.insert(hg.net_pins.end(), nets[inet].begin(), nets[inet].end());
+		hg.net_pin_starts.push_back(hg.net_pins.size());
+		prev_net = inet;
+	}
+
+	//Build the vertex to net incidence from the net pins
+	hg.vertex_net_starts.assign(hg.num_vertices() + 1, 0);
+	for (int vertex : hg.net_pins) {
+		++hg.vertex_net_starts[vertex + 1];
+	}
+	std::partial_sum(hg.vertex_net_starts.begin(), hg.vertex_net_starts.end(), hg.vertex_net_starts.begin());
+
+	hg.vertex_nets.resize(hg.net_pins.size());
+	std::vector<int> next_net(hg.vertex_net_starts.begin(), hg.vertex_net_starts.end() - 1);
+	for (int net = 0; net < hg.num_nets(); ++net) {
+		for (int ipin = hg.net_pin_starts[net]; ipin < hg.net_pin_starts[net + 1]; ++ipin) {
+			hg.vertex_nets[next_net[hg.net_pins[ipin]]++] = net;
+		}
+	}
+
+	return hg;
+}
+
+/* Returns the hypergraph induced by the vertices on one side of a bisection (cut nets keep
+*  only their pins on that side), and sets side_vertices to the vertex of hg each of its
+*  vertices corresponds to. */
+static t_hypergraph extract_side(const t_hypergraph& hg, const std::vector<int>& sides, int side,
+		std::vector<int>& side_vertices) {
+	std::vector<int> side_vertex_ids(hg.num_vertices(), NO_VERTEX);
+	std::vector<int> vertex_weights;
+	side_vertices.clear();
+	for (int vertex = 0; vertex < hg.num_vertices(); ++vertex) {
+		if (sides[vertex] != side) continue;
+
+		side_vertex_ids[vertex] = side_vertices.size();
+		side_vertices.push_back(vertex);
+		vertex_weights.push_back(hg.vertex_weights[vertex]);
+	}
+
+	std::vector<std::vector<int>> nets;
+	std::vector<int> net_weights;
+	for (int net = 0; net < hg.num_nets(); ++net) {
+		std::vector<int> pins;
+		for (int ipin = hg.net_pin_starts[net]; ipin < hg.net_pin_starts[net + 1]; ++ipin) {
+			int side_vertex = side_vertex_ids[hg.net_pins[ipin]];
+			if (side_vertex != NO_VERTEX) {
+				pins.push_back(side_vertex);
+			}
+		}
+		if (pins.size() >= 2) {
+			nets.push_back(std::move(pins));
+			net_weights.push_back(hg.net_weights[net]);
+		}
+	}
+
+	return build_hypergraph(std::move(vertex_weights), nets, net_weights);
+}
+
+/* Matches each vertex (in random order) with the unmatched neighbour it is most strongly
+*  connected to, where each shared net contributes its weight / (pins - 1).  Returns the
+*  coarse vertex of each vertex, and sets num_coarse_vertices. */
+static std::vector<int> match_vertices(const t_hypergraph& hg, int max_vertex_weight, vtr::RandState& rand_state,
+		int& num_coarse_vertices) {
+	std::vector<int> coarse_vertices(hg.num_vertices(), NO_VERTEX);
+
+	std::vector<int> order(hg.num_vertices());
+	std::iota(order.begin(), order.end(), 0);
+	vtr::shuffle(order.begin(), order.end(), rand_state);
+
+	std::vector<float> scores(hg.num_vertices(), 0.);
+	std::vector<int> neighbours;
+
+	num_coarse_vertices = 0;
+	for (int vertex : order) {
+		if (coarse_vertices[vertex] != NO_VERTEX) continue;
+
+		for (int inet = hg.vertex_net_starts[vertex]; inet < hg.vertex_net_starts[vertex + 1]; ++inet) {
+			int net = hg.vertex_nets[inet];
+			int num_pins = hg.num_net_pins(net);
+			if (num_pins > MAX_MATCHING_NET_PINS) continue;
+
+			float score = float(hg.net_weights[net]) / (num_pins - 1);
+			for (int ipin = hg.net_pin_starts[net]; ipin < hg.net_pin_starts[net + 1]; ++ipin) {
+				int neighbour = hg.net_pins[ipin];
+				if (neighbour == vertex || coarse_vertices[neighbour] != NO_VERTEX
+						|| hg.vertex_weights[vertex] + hg.vertex_weights[neighbour] > max_vertex_weight) {
+					continue;
+				}
+				if (scores[neighbour] == 0.) {
+					neighbours.push_back(neighbour);
+				}
+				scores[neighbour] += score;
+			}
+		}
+
+		//Prefer the strongest connection, and then the lightest neighbour
+		int best_neighbour = NO_VERTEX;
+		for (int neighbour : neighbours) {
+			if (best_neighbour == NO_VERTEX || scores[neighbour] > scores[best_neighbour]
+					|| (scores[neighbour] == scores[best_neighbour]
+						&& hg.vertex_weights[neighbour] < hg.vertex_weights[best_neighbour])) {
+				best_neighbour = neighbour;
+			}
+		}
+		for (int neighbour : neighbours) {
+			scores[neighbour] = 0.;
+		}
+		neighbours.clear();
+
+		coarse_vertices[vertex] = num_coarse_vertices;
+		if (best_neighbour != NO_VERTEX) {
+			coarse_vertices[best_neighbour] = num_coarse_vertices;
+		}
+		++num_coarse_vertices;
+	}
+
+	return coarse_vertices;
+}
+
+/* Returns the hypergraph obtained by merging the vertices of hg into their coarse vertices */
+static t_hypergraph contract(const t_hypergraph& hg, const std::vector<int>& coarse_vertices, int num_coarse_vertices) {
+	std::vector<int> vertex_weights(num_coarse_vertices, 0);
+	for (int vertex = 0; vertex < hg.num_vertices(); ++vertex) {
+		vertex_weights[coarse_vertices[vertex]] += hg.vertex_weights[vertex];
+	}
+
+	std::vector<std::vector<int>> nets(hg.num_nets());
+	for (int net = 0; net < hg.num_nets(); ++net) {
+		for (int ipin = hg.net_pin_starts[net]; ipin < hg.net_pin_starts[net + 1]; ++ipin) {
+			nets[net].push_back(coarse_vertices[hg.net_pins[ipin]]);
+		}
+	}
+
+	return build_hypergraph(std::move(vertex_weights), nets, hg.net_weights);
+}
+
+/* Bisects hg by moving vertices to side 0 in breadth-first order from a random vertex (restarting
+*  from another random vertex whenever the search runs out), until side 0 reaches target_weight. */
+std::vector<int> grow_bisection(const t_hypergraph& hg, const t_side_weights& max_side_weights,
+		int target_weight, vtr::RandState& rand_state) {
+	std::vector<int> sides(hg.num_vertices(), 1);
+	std::vector<bool> visited(hg.num_vertices(), false);
+	std::queue<int> to_visit;
+	int side0_weight = 0;
+	int num_visited = 0;
+
+	//Vertices are only assigned once they leave the queue, so keep going until it is drained
+	while (side0_weight < target_weight && (!to_visit.empty() || num_visited < hg.num_vertices())) {
+		if (to_visit.empty()) {
+			int start = vtr::irand(hg.num_vertices() - 1, rand_state);
+			while (visited[start]) {
+				start = (start + 1) % hg.num_vertices();
+			}
+			visited[start] = true;
+			++num_visited;
+			to_visit.push(start);
+		}
+
+		int vertex = to_visit.front();
+		to_visit.pop();
+		if (side0_weight + hg.vertex_weights[vertex] > max_side_weights[0]) continue;
+
+		sides[vertex] = 0;
+		side0_weight += hg.vertex_weights[vertex];
+
+		for (int inet = hg.vertex_net_starts[vertex]; inet < hg.vertex_net_starts[vertex + 1]; ++inet) {
+			int net = hg.vertex_nets[inet];
+			if (hg.num_net_pins(net) > MAX_MATCHING_NET_PINS) continue;
+
+			for (int ipin = hg.net_pin_starts[net]; ipin < hg.net_pin_starts[net + 1]; ++ipin) {
+				int neighbour = hg.net_pins[ipin];
+				if (!visited[neighbour]) {
+					visited[neighbour] = true;
+					++num_visited;
+					to_visit.push(neighbour);
+				}
+			}
+		}
+	}
+
+	return sides;
+}
+
+/* Returns the number of pins of each net on each side of the bisection */
+static std::vector<t_side_weights> count_net_side_pins(const t_hypergraph& hg, const std::vector<int>& sides) {
+	std::vector<t_side_weights> net_side_pins(hg.num_nets(), {{0, 0}});
+	for (int net = 0; net < hg.num_nets(); ++net) {
+		for (int ipin = hg.net_pin_starts[net]; ipin < hg.net_pin_starts[net + 1]; ++ipin) {
+			++net_side_pins[net][sides[hg.net_pins[ipin]]];
+		}
+	}
+	return net_side_pins;
+}
+
+/* Returns the reduction in cut from moving vertex to the other side */
+static int vertex_gain(const t_hypergraph& hg, const std::vector<int>& sides,
+		const std::vector<t_side_weights>& net_side_pins, int vertex) {
+	int from = sides[vertex];
+	int gain = 0;
+	for (int inet = hg.vertex_net_starts[vertex]; inet < hg.vertex_net_starts[vertex + 1]; ++inet) {
+		int net = hg.vertex_nets[inet];
+		if (net_side_pins[net][from] == 1) {
+			gain += hg.net_weights[net]; //Net is no longer cut
+		} else if (net_side_pins[net][1 - from] == 0) {
+			gain -= hg.net_weights[net]; //Net becomes cut
+		}
+	}
+	return gain;
+}
+
+/* Returns the total weight of the nets with vertices on both sides */
+static int compute_cut(const t_hypergraph& hg, const std::vector<int>& sides) {
+	auto net_side_pins = count_net_side_pins(hg, sides);
+
+	int cut = 0;
+	for (int net = 0; net < hg.num_nets(); ++net) {
+		if (net_side_pins[net][0] > 0 && net_side_pins[net][1] > 0) {
+			cut += hg.net_weights[net];
+		}
+	}
+	return cut;
+}
+
+/* Moves vertices off an overweight side (cheapest moves first) until both sides are within
+*  max_side_weights, or no remaining move would help. */
+static void rebalance(const t_hypergraph& hg, std::vector<int>& sides, const t_side_weights& max_side_weights) {
+	t_side_weights side_weights = {{0, 0}};
+	for (int vertex = 0; vertex < hg.num_vertices(); ++vertex) {
+		side_weights[sides[vertex]] += hg.vertex_weights[vertex];
+	}
+
+	for (int from = 0; from < 2; ++from) {
+		int to = 1 - from;
+		if (side_weights[from] <= max_side_weights[from]) continue;
+
+		auto net_side_pins = count_net_side_pins(hg, sides);
+
+		std::vector<std::pair<int, int>> moves; //(gain, vertex)
+		for (int vertex = 0; vertex < hg.num_vertices(); ++vertex) {
+			if (sides[vertex] == from) {
+				moves.emplace_back(vertex_gain(hg, sides, net_side_pins, vertex), vertex);
+			}
+		}
+		std::sort(moves.begin(), moves.end(), [](const std::pair<int, int>& lhs, const std::pair<int, int>& rhs) {
+			return lhs.first > rhs.first || (lhs.first == rhs.first && lhs.second < rhs.second);
+		});
+
+		for (const auto& move : moves) {
+			if (side_weights[from] <= max_side_weights[from]) break;
+
+			int weight = hg.vertex_weights[move.second];
+			if (side_weights[to] + weight > max_side_weights[to]) continue;
+
+			sides[move.second] = to;
+			side_weights[from] -= weight;
+			side_weights[to] += weight;
+		}
+	}
+}
+
+/* Improves the bisection with Fiduccia-Mattheyses passes, keeping the weight of each side within
+*  max_side_weights.  Each pass tentatively moves the highest gain unlocked vertex (then locks
+*  it) until it stops finding better cuts, and then rolls back to the best cut seen.
+*  Returns the final cut. */
+static int fm_refine(const t_hypergraph& hg, std::vector<int>& sides, const t_side_weights& max_side_weights) {
+	typedef std::pair<int, int> t_gain_entry; //(gain, vertex)
+
+	auto net_side_pins = count_net_side_pins(hg, sides);
+
+	t_side_weights side_weights = {{0, 0}};
+	for (int vertex = 0; vertex < hg.num_vertices(); ++vertex) {
+		side_weights[sides[vertex]] += hg.vertex_weights[vertex];
+	}
+
+	int cut = compute_cut(hg, sides);
+
+	std::vector<int> gains(hg.num_vertices());
+	std::vector<bool> locked(hg.num_vertices());
+	std::vector<int> moves;
+
+	for (int pass = 0; pass < MAX_FM_PASSES && cut > 0; ++pass) {
+		//Gain buckets, one per side the vertices would move from.  Stale entries (for vertices whose
+		//gain has since changed, or which have been locked) are skipped when they reach the top.
+		std::array<std::priority_queue<t_gain_entry>, 2> gain_heaps;
+		std::array<std::vector<t_gain_entry>, 2> deferred; //Entries which did not fit on the other side
+		std::array<int, 2> min_deferred_weight = {{std::numeric_limits<int>::max(), std::numeric_limits<int>::max()}};
+
+		for (int vertex = 0; vertex < hg.num_vertices(); ++vertex) {
+			locked[vertex] = false;
+			gains[vertex] = vertex_gain(hg, sides, net_side_pins, vertex);
+			gain_heaps[sides[vertex]].emplace(gains[vertex], vertex);
+		}
+
+		auto update_gain = [&](int vertex, int delta) {
+			gains[vertex] += delta;
+			gain_heaps[sides[vertex]].emplace(gains[vertex], vertex);
+		};
+
+		moves.clear();
+		int pass_gain = 0;
+		int best_pass_gain = 0;
+		size_t best_num_moves = 0;
+		int num_non_improving_moves = 0;
+
+		while (num_non_improving_moves < MAX_FM_NON_IMPROVING_MOVES) {
+			//Find the best legal move from each side
+			std::array<int, 2> candidates = {{NO_VERTEX, NO_VERTEX}};
+			for (int from = 0; from < 2; ++from) {
+				auto& heap = gain_heaps[from];
+				while (!heap.empty()) {
+					t_gain_entry entry = heap.top();
+					int vertex = entry.second;
+					if (locked[vertex] || sides[vertex] != from || gains[vertex] != entry.first) {
+						heap.pop();
+					} else if (side_weights[1 - from] + hg.vertex_weights[vertex] > max_side_weights[1 - from]) {
+						deferred[from].push_back(entry);
+						min_deferred_weight[from] = std::min(min_deferred_weight[from], hg.vertex_weights[vertex]);
+						heap.pop();
+					} else {
+						candidates[from] = vertex;
+						break;
+					}
+				}
+			}
+
+			int vertex = NO_VERTEX;
+			if (candidates[0] != NO_VERTEX && candidates[1] != NO_VERTEX) {
+				//Take the higher gain, or move off the heavier side on a tie
+				int gain0 = gains[candidates[0]];
+				int gain1 = gains[candidates[1]];
+				if (gain0 > gain1 || (gain0 == gain1 && side_weights[0] >= side_weights[1])) {
+					vertex = candidates[0];
+				} else {
+					vertex = candidates[1];
+				}
+			} else if (candidates[0] != NO_VERTEX) {
+				vertex = candidates[0];
+			} else {
+				vertex = candidates[1];
+			}
+			if (vertex == NO_VERTEX) break;
+
+			int from = sides[vertex];
+			int to = 1 - from;
+
+			pass_gain += gains[vertex];
+			locked[vertex] = true;
+			sides[vertex] = to;
+			side_weights[from] -= hg.vertex_weights[vertex];
+			side_weights[to] += hg.vertex_weights[vertex];
+			moves.push_back(vertex);
+
+			//Update the gains of the free vertices on the nets of the moved vertex
+			for (int inet = hg.vertex_net_starts[vertex]; inet < hg.vertex_net_starts[vertex + 1]; ++inet) {
+				int net = hg.vertex_nets[inet];
+				int weight = hg.net_weights[net];
+				auto& side_pins = net_side_pins[net];
+				int begin = hg.net_pin_starts[net];
+				int end = hg.net_pin_starts[net + 1];
+
+				if (side_pins[to] == 0) {
+					//Net becomes cut: moving any other vertex now helps it
+					for (int ipin = begin; ipin < end; ++ipin) {
+						if (!locked[hg.net_pins[ipin]]) update_gain(hg.net_pins[ipin], weight);
+					}
+				} else if (side_pins[to] == 1) {
+					//The lone vertex on the 'to' side can no longer uncut the net
+					for (int ipin = begin; ipin < end; ++ipin) {
+						int pin_vertex = hg.net_pins[ipin];
+						if (!locked[pin_vertex] && sides[pin_vertex] == to) update_gain(pin_vertex, -weight);
+					}
+				}
+
+				--side_pins[from];
+				++side_pins[to];
+
+				if (side_pins[from] == 0) {
+					//Net is now uncut: moving any other vertex would cut it
+					for (int ipin = begin; ipin < end; ++ipin) {
+						if (!locked[hg.net_pins[ipin]]) update_gain(hg.net_pins[ipin], -weight);
+					}
+				} else if (side_pins[from] == 1) {
+					//The lone vertex left on the 'from' side can now uncut the net
+					for (int ipin = begin; ipin < end; ++ipin) {
+						int pin_vertex = hg.net_pins[ipin];
+						if (!locked[pin_vertex] && sides[pin_vertex] == from) update_gain(pin_vertex, weight);
+					}
+				}
+			}
+
+			//Deferred moves off a side are only worth revisiting once the lightest of them fits on the other side
+			for (int side = 0; side < 2; ++side) {
+				if (deferred[side].empty()
+						|| side_weights[1 - side] + min_deferred_weight[side] > max_side_weights[1 - side]) {
+					continue;
+				}
+				for (const auto& entry : deferred[side]) {
+					gain_heaps[side].push(entry);
+				}
+				deferred[side].clear();
+				min_deferred_weight[side] = std::numeric_limits<int>::max();
+			}
+
+			if (pass_gain > best_pass_gain) {
+				best_pass_gain = pass_gain;
+				best_num_moves = moves.size();
+				num_non_improving_moves = 0;
+			} else {
+				++num_non_improving_moves;
+			}
+		}
+
+		//Roll back the moves made after the best cut
+		for (size_t imove = moves.size(); imove > best_num_moves; --imove) {
+			int vertex = moves[imove - 1];
+			int from = sides[vertex];
+			int to = 1 - from;
+
+			sides[vertex] = to;
+			side_weights[from] -= hg.vertex_weights[vertex];
+			side_weights[to] += hg.vertex_weights[vertex];
+			for (int inet = hg.vertex_net_starts[vertex]; inet < hg.vertex_net_starts[vertex + 1]; ++inet) {
+				int net = hg.vertex_nets[inet];
+				--net_side_pins[net][from];
+				++net_side_pins[net][to];
+			}
+		}
+
+		cut -= best_pass_gain;
+		if (best_pass_gain <= 0) break;
+	}
+
+	VTR_ASSERT_SAFE(cut == compute_cut(hg, sides));
+	return cut;
+}
+
+/* Multilevel bisection of hg.  Returns the side (0 or 1) of each vertex, with side 0 holding
+*  about target_fraction of the total vertex weight. */
+static std::vector<int> bisect(const t_hypergraph& hg, float target_fraction, float imbalance,
+		vtr::RandState& rand_state) {
+	if (hg.num_vertices() < 2) {
+		return std::vector<int>(hg.num_vertices(), 0);
+	}
+
+	//Coarsen
+	std::deque<t_hypergraph> levels; //Coarser hypergraphs, finest first
+	std::vector<std::vector<int>> coarse_vertices; //Coarse vertex of each vertex of the next finer level
+	const t_hypergraph* coarsest = &hg;
+
+	int max_vertex_weight = std::max(1, 2 * hg.total_weight / COARSEST_NUM_VERTICES);
+	while (coarsest->num_vertices() > COARSEST_NUM_VERTICES) {
+		int num_coarse_vertices = 0;
+		auto level_coarse_vertices = match_vertices(*coarsest, max_vertex_weight, rand_state, num_coarse_vertices);
+		if (num_coarse_vertices > MIN_COARSENING_RATIO * coarsest->num_vertices()) break;
+
+		levels.push_back(contract(*coarsest, level_coarse_vertices, num_coarse_vertices));
+		coarse_vertices.push_back(std::move(level_coarse_vertices));
+		coarsest = &levels.back();
+	}
+
+	int target_weight = vtr::nint(target_fraction * hg.total_weight);
+	t_side_weights target_side_weights = {{target_weight, hg.total_weight - target_weight}};
+
+	//Allow at least one (coarse) vertex of slack, so heavy coarse vertices can still move
+	auto get_max_side_weights = [&](const t_hypergraph& level) {
+		int max_level_vertex_weight = *std::max_element(level.vertex_weights.begin(), level.vertex_weights.end());
+		t_side_weights max_side_weights;
+		for (int side = 0; side < 2; ++side) {
+			max_side_weights[side] = std::max(int((1. + imbalance) * target_side_weights[side]),
+					target_side_weights[side] + max_level_vertex_weight);
+		}
+		return max_side_weights;
+	};
+
+	//Initial bisection of the coarsest level
+	t_side_weights max_side_weights = get_max_side_weights(*coarsest);
+	std::vector<int> sides;
+	int best_cut = 0;
+	for (int itry = 0; itry < NUM_INITIAL_BISECTIONS; ++itry) {
+		auto try_sides = grow_bisection(*coarsest, max_side_weights, target_weight, rand_state);
+		rebalance(*coarsest, try_sides, max_side_weights);
+		int cut = fm_refine(*coarsest, try_sides, max_side_weights);
+		if (sides.empty() || cut < best_cut) {
+			best_cut = cut;
+			sides = std::move(try_sides);
+		}
+	}
+
+	//Uncoarsen, refining at each level
+	for (size_t ilevel = coarse_vertices.size(); ilevel > 0; --ilevel) {
+		const t_hypergraph& fine = (ilevel == 1) ? hg : levels[ilevel - 2];
+		const auto& level_coarse_vertices = coarse_vertices[ilevel - 1];
+
+		std::vector<int> fine_sides(fine.num_vertices());
+		for (int vertex = 0; vertex < fine.num_vertices(); ++vertex) {
+			fine_sides[vertex] = sides[level_coarse_vertices[vertex]];
+		}
+		sides = std::move(fine_sides);
+
+		max_side_weights = get_max_side_weights(fine);
+		rebalance(fine, sides, max_side_weights);
+		fm_refine(fine, sides, max_side_weights);
+	}
+
+	return sides;
+}
+
+/* Partitions the vertices of hg into parts [first_part, first_part + num_parts) by recursive
+*  bisection.  vertices gives the original vertex of each vertex of hg, and parts is indexed
+*  by original vertex. */
+static void partition_recursively(const t_hypergraph& hg, const std::vector<int>& vertices, int num_parts,
+		int first_part, float imbalance, vtr::RandState& rand_state, std::vector<int>& parts) {
+	if (num_parts == 1 || hg.num_vertices() == 0) {
+		for (int vertex : vertices) {
+			parts[vertex] = first_part;
+		}
+		return;
+	}
+
+	std::array<int, 2> side_num_parts = {{num_parts / 2, num_parts - num_parts / 2}};
+	auto sides = bisect(hg, float(side_num_parts[0]) / num_parts, imbalance, rand_state);
+
+	int side_first_part = first_part;
+	for (int side = 0; side < 2; ++side) {
+		std::vector<int> side_vertices;
+		t_hypergraph side_hg = extract_side(hg, sides, side, side_vertices);
+		for (int& vertex : side_vertices) {
+			vertex = vertices[vertex];
+		}
+
+		partition_recursively(side_hg, side_vertices, side_num_parts[side], side_first_part, imbalance, rand_state, parts);
+		side_first_part += side_num_parts[side];
+	}
+}
@@ -0,0 +1,62 @@
+#ifndef HYPERGRAPH_PARTITIONER_H
+#define HYPERGRAPH_PARTITIONER_H
+#include <array>
+#include <vector>
+
+#include "vtr_vector.h"
+#include "vtr_random.h"
+#include "atom_netlist_fwd.h"
+
+/* Partitions the atom netlist into num_parts parts of (roughly) equal numbers of atom blocks,
+ * minimizing the number of nets cut, with a built-in multilevel hypergraph partitioner.
+ * Returns the part [0..num_parts-1] of each atom block.
+ *
+ * The parts are found by recursive bisection, and are numbered so that each bisection splits
+ * parts [first, first + k) into [first, first + k/2) and [first + k/2, first + k).  Parts with
+ * nearby numbers are therefore strongly connected, which the placer relies on when assigning
+ * the parts to regions of the device.
+ *
+ * imbalance is the allowed relative deviation of each bisection from an even split (e.g. 0.05
+ * allows a 47.5/52.5 split of two parts).  Clock, constant and very high fanout nets are ignored. */
+vtr::vector<AtomBlockId, int> partition_atom_netlist(const AtomNetlist& netlist, int num_parts, float imbalance = 0.05);
+
+/* Returns the partition of the current atom netlist into num_parts parts.  The netlist is only
+ * partitioned if it has not already been partitioned into num_parts parts; the result is kept
+ * in the atom context so the packer and placer share it. */
+const vtr::vector<AtomBlockId, int>& load_atom_partitions(int num_parts);
+
+/* Returns the number of nets of netlist connecting blocks in more than one part */
+size_t count_partition_cut_nets(const AtomNetlist& netlist, const vtr::vector<AtomBlockId, int>& partitions);
+
+/*
+ * Building blocks of the partitioner, exposed for unit testing
+ */
+
+/* A weighted hypergraph, stored in compressed sparse row form in both directions */
+struct t_hypergraph {
+	std::vector<int> vertex_weights;
+	std::vector<int> vertex_net_starts; /* [0..num_vertices()]: offsets of each vertex's nets in vertex_nets */
+	std::vector<int> vertex_nets;
+	std::vector<int> net_weights;
+	std::vector<int> net_pin_starts; /* [0..num_nets()]: offsets of each net's vertices in net_pins */
+	std::vector<int> net_pins;
+	int total_weight = 0;
+
+	int num_vertices() const { return vertex_weights.size(); }
+	int num_nets() const { return net_weights.size(); }
+	int num_net_pins(int net) const { return net_pin_starts[net + 1] - net_pin_starts[net]; }
+};
+
+typedef std::array<int, 2> t_side_weights;
+
+/* Builds a hypergraph from its vertex weights and nets (each a list of vertices, possibly
+ * with duplicates, which are removed) */
+t_hypergraph build_hypergraph(std::vector<int> vertex_weights, std::vector<std::vector<int>>& nets,
+		const std::vector<int>& net_weights);
+
+/* Returns an initial bisection (the side, 0 or 1, of each vertex) of hg, grown breadth-first
+ * until side 0 reaches target_weight without exceeding max_side_weights[0] */
+std::vector<int> grow_bisection(const t_hypergraph& hg, const t_side_weights& max_side_weights,
+		int target_weight, vtr::RandState& rand_state);
+
+#endif
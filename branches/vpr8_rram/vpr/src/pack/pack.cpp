@@ -22,6 +22,7 @@ using namespace std;
 #include "read_blif.h"
 #include "cluster.h"
 #include "SetupGrid.h"
+#include "hypergraph_partitioner.h"
 
 #ifdef USE_HMETIS
 #include "hmetis_graph_writer.h"
@@ -56,9 +57,7 @@ bool try_pack(t_packer_opts *packer_opts,
 	t_pack_patterns *list_of_packing_patterns;
 	int num_packing_patterns;
 	t_pack_molecule *list_of_pack_molecules, * cur_pack_molecule;
-#ifdef USE_HMETIS
-	vtr::vector<AtomBlockId,int> partitions;
-#endif
+	vtr::vector<AtomBlockId,int> partitions; //Part of each atom block, empty if not partitioned
 	VTR_LOG("Begin packing '%s'.\n", packer_opts->blif_file_name.c_str());
 
 	/* determine number of models in the architecture */
@@ -169,6 +168,10 @@ bool try_pack(t_packer_opts *packer_opts,
 	}
 #endif
 
+	if (partitions.empty() && packer_opts->num_partitions > 1) {
+		partitions = load_atom_partitions(packer_opts->num_partitions);
+	}
+
     t_ext_pin_util_targets target_external_pin_util = parse_target_external_pin_util(packer_opts->target_external_pin_util);
 
     VTR_LOG("Packing with pin utilization targets: %s\n", target_external_pin_util_to_string(target_external_pin_util).c_str());
@@ -191,10 +194,8 @@ bool try_pack(t_packer_opts *packer_opts,
                                     expected_lowest_cost_pb_gnode,
                                     allow_unrelated_clustering,
                                     lb_type_rr_graphs,
-                                    target_external_pin_util
-#ifdef USE_HMETIS
-                                    , partitions
-#endif
+                                    target_external_pin_util,
+                                    partitions
 #ifdef ENABLE_CLASSIC_VPR_STA
                                     , timing_inf
 #endif
@@ -7,6 +7,7 @@
  * Defines core data structures used in packing
  */
 #include <map>
+#include <queue>
 #include <vector>
 
 #include "arch_types.h"
@@ -149,15 +150,29 @@ struct t_lb_rr_node_stats {
 	}
 };
 
+/*
+  One node of the route tree of a net within one logic cluster_ctx.blocks.
+
+  Records one of the routing resource nodes used by the net.  Connections to other nodes are stored as
+  indices into the nodes of the owning t_lb_trace (OPEN if there is none).
+*/
+struct t_lb_trace_node {
+	int	current_node;					/* current t_lb_type_rr_node used by net */
+	int parent;							/* index of the trace node driving this one (OPEN for the root) */
+	int first_child;					/* index of the first trace node driven by this one */
+	int last_child;						/* index of the last trace node driven by this one */
+	int next_sibling;					/* index of the next trace node driven by the same parent */
+};
+
 /*
   Data structure forming the route tree of a net within one logic cluster_ctx.blocks.
 
-  A net is implemented using routing resource nodes.  The t_lb_trace data structure records one of the nodes used by the net and the connections
-  to other nodes
+  A net is implemented using routing resource nodes.  All the nodes of the route tree are kept in one contiguous
+  array (nodes[0] is the net source), so a route tree is built and freed with a handful of allocations and can be
+  walked without recursion.  A node is always stored after its parent.
 */
 struct t_lb_trace {
-	int	current_node;					/* current t_lb_type_rr_node used by net */
-    std::vector<t_lb_trace> next_nodes;		/* index of previous edge that drives current node */
+    std::vector<t_lb_trace_node> nodes;
 };
 
 /* Represents a net used inside a logic cluster_ctx.blocks and the physical nodes used by the net */
@@ -206,6 +221,33 @@ class compare_expansion_node {
     }
 };
 
+// TODO: check if this hacky class memory reserve thing is still necessary, if not, then delete
+/* Packing uses a priority queue that requires a large number of elements.  This backdoor
+allows me to use a priority queue where I can pre-allocate the # of elements in the underlying container
+for efficiency reasons.  Note: Must use vector with this */
+template <class T, class U, class V>
+class reservable_pq: public std::priority_queue<T, U, V>
+{
+	public:
+		typedef typename std::priority_queue<T>::size_type size_type;
+		reservable_pq(size_type capacity = 0) {
+			reserve(capacity);
+			cur_cap = capacity;
+		};
+		void reserve(size_type capacity) {
+			this->c.reserve(capacity);
+			cur_cap = capacity;
+		}
+		void clear() {
+			this->c.clear();
+			this->c.reserve(cur_cap);
+		}
+	private:
+		size_type cur_cap;
+};
+
+typedef reservable_pq<t_expansion_node, std::vector<t_expansion_node>, compare_expansion_node> t_lb_expansion_pq;
+
 /* Stores explored nodes by router */
 struct t_explored_node_tb {
 	int prev_index;			/* Prevous node that drives this one */
@@ -213,6 +255,7 @@ struct t_explored_node_tb {
 	int inet;				/* net index of route tree */
 	int enqueue_id;			/* ID used ot determine if this node has been pushed on exploration priority queue */
 	float enqueue_cost;		/* cost of node pused on exploration priority queue */
+	bool is_touched;		/* Whether this node is in t_lb_router_data::touched_nodes */
 
 	t_explored_node_tb() {
 		prev_index = OPEN;
@@ -220,6 +263,7 @@ struct t_explored_node_tb {
 		enqueue_id = OPEN;
 		inet = OPEN;
 		enqueue_cost = 0;
+		is_touched = false;
 	}
 };
 
@@ -243,6 +287,9 @@ struct t_lb_router_data {
 	/* Stores state info during Pathfinder iterative routing */
 	t_explored_node_tb *explored_node_tb; /* [0..lb_type_graph->size()-1] Stores mode exploration and traceback info for nodes */
 	int explore_id_index; /* used in conjunction with node_traceback to determine whether or not a location has been explored.  By using a unique identifier every route, I don't have to clear the previous route exploration */
+	std::map<int, int> non_default_modes; /* [inode] -> mode of every node whose mode is not 0, in node order.  Kept up to date by set_reset_pb_modes() so a route signature does not have to scan the lb_type_graph */
+	std::vector<int> touched_nodes; /* Nodes whose explored_node_tb/lb_rr_node_stats entries may differ from their reset state.  Only these need to be reset between routing attempts */
+	t_lb_expansion_pq pq; /* Exploration priority queue, kept across routing attempts so its storage is reused */
 
 	/* Current type */
 	t_type_ptr lb_type;
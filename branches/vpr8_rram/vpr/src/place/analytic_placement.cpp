@@ -0,0 +1,665 @@
+/* This file implements an analytic (quadratic) initial placement, used to seed the annealer
+* with a good placement rather than a random one.
+*
+* Brief summary of the algorithm
+* ==============================
+* The clustered netlist is modelled as a system of springs: nets with few blocks as cliques
+* (each spring of weight 1/(p-1) for a p-block net), and larger nets as stars around an extra
+* free "star" variable (each spring of weight p/(p-1)).  Minimizing the total squared spring
+* length is then a sparse symmetric positive definite linear system, which is solved for x and
+* y independently with a Jacobi-preconditioned conjugate gradient (CG) solver.  Fixed blocks
+* are constants, and all the members of a placement macro share one variable (plus their
+* offsets), so macros keep their shape.
+*
+* Quadratic placement clumps blocks together, so each solve is followed by:
+*	(1) Spreading: the blocks of each type keep their relative order in x (and in y), but are
+*	    moved to the matching quantile of the legal locations of their type.
+*	(2) Legalization: placement macros, and then the other blocks, are placed at the free
+*	    legal location closest to their spread position.
+* The next solve adds a spring pulling each block towards its last legal location, which
+* grows stronger every iteration, so the placement converges to a legal and spread out one
+* (as in SimPL).  The last legalized placement is kept.
+*
+* In the first solve, IOs which are not fixed are anchored at their current (initial)
+* locations, so the system has something to be pulled towards.
+*/
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <utility>
+#include <vector>
+
+#include "vtr_assert.h"
+#include "vtr_log.h"
+#include "vtr_time.h"
+
+#include "vpr_types.h"
+#include "vpr_error.h"
+#include "vpr_utils.h"
+#include "globals.h"
+#include "analytic_placement.h"
+
+/* Number of solve / spread / legalize iterations */
+constexpr int NUM_ANALYTIC_ITERATIONS = 6;
+
+/* Nets connecting more blocks than this are modelled as stars, rather than cliques */
+constexpr size_t MAX_CLIQUE_NET_BLOCKS = 8;
+
+/* Weight of the spring pulling each block towards its last legal location grows by this much
+ * every iteration (relative to a two-block net, of weight 1) */
+constexpr double ANCHOR_WEIGHT_STEP = 0.05;
+
+/* Weight of the springs anchoring IOs which are not fixed in the first iteration */
+constexpr double FREE_IO_ANCHOR_WEIGHT = 1.;
+
+/* Weight of the spring pulling every variable towards the centre of the device.  It only keeps
+ * the system positive definite (e.g. for blocks with no connections to anything fixed) */
+constexpr double REGULARIZATION_WEIGHT = 1e-4;
+
+constexpr int MAX_CG_ITERATIONS = 1000;
+constexpr double CG_RELATIVE_TOLERANCE = 1e-6;
+
+constexpr int FIXED_VAR = -1;
+
+/* A block's position in terms of the variables: variable var plus (x, y), or the constant
+ * location (x, y) if the block is fixed (var == FIXED_VAR) */
+struct t_ap_pin {
+	int var;
+	double x;
+	double y;
+};
+
+/* Local subroutines */
+static void multiply(const t_sparse_matrix& matrix, const std::vector<double>& x, std::vector<double>& y);
+static void add_spring(const t_ap_pin& a, const t_ap_pin& b, double weight, std::vector<t_matrix_entry>& entries,
+		std::vector<double>& rhs_x, std::vector<double>& rhs_y);
+static std::vector<std::vector<t_legal_pos>> get_type_legal_pos();
+static void spread_blocks(const std::vector<ClusterBlockId>& blocks, const std::vector<t_legal_pos>& type_legal_pos,
+		vtr::vector<ClusterBlockId, double>& block_x, vtr::vector<ClusterBlockId, double>& block_y);
+static void set_block_location(ClusterBlockId blk_id, int x, int y, int z);
+static void clear_block_location(ClusterBlockId blk_id);
+static bool try_place_macro_at(const t_pl_macro& macro, int x, int y, int z);
+static void get_ring_locs(int centre_x, int centre_y, int radius, double x, double y,
+		std::vector<std::pair<int, int>>& ring_locs);
+static bool legalize_block(ClusterBlockId blk_id, double x, double y);
+static double compute_hpwl();
+
+
+void analytic_initial_placement(const t_pl_macro* pl_macros, int num_pl_macros) {
+	vtr::ScopedStartFinishTimer timer("Analytic initial placement");
+
+	auto& cluster_ctx = g_vpr_ctx.clustering();
+	auto& place_ctx = g_vpr_ctx.placement();
+	auto& device_ctx = g_vpr_ctx.device();
+
+	double initial_hpwl = compute_hpwl();
+
+	/* Assign a variable to each macro and to each other movable block */
+	size_t num_blocks = cluster_ctx.clb_nlist.blocks().size();
+	vtr::vector<ClusterBlockId, t_ap_pin> block_pins(num_blocks, {FIXED_VAR, 0., 0.});
+	vtr::vector<ClusterBlockId, bool> in_macro(num_blocks, false);
+	int num_vars = 0;
+
+	std::vector<int> macro_order; /* Movable macros, largest first */
+	for (int imacro = 0; imacro < num_pl_macros; imacro++) {
+		const t_pl_macro& macro = pl_macros[imacro];
+
+		bool macro_fixed = false;
+		for (int imember = 0; imember < macro.num_blocks; imember++) {
+			ClusterBlockId blk_id = macro.members[imember].blk_index;
+			in_macro[blk_id] = true;
+			macro_fixed |= place_ctx.block_locs[blk_id].is_fixed;
+		}
+		if (macro_fixed) {
+			/* The whole macro stays where it is, so all its members anchor the net springs */
+			for (int imember = 0; imember < macro.num_blocks; imember++) {
+				ClusterBlockId blk_id = macro.members[imember].blk_index;
+				const t_block_loc& loc = place_ctx.block_locs[blk_id];
+				block_pins[blk_id] = {FIXED_VAR, double(loc.x), double(loc.y)};
+			}
+			continue;
+		}
+
+		for (int imember = 0; imember < macro.num_blocks; imember++) {
+			const t_pl_macro_member& member = macro.members[imember];
+			block_pins[member.blk_index] = {num_vars, double(member.x_offset), double(member.y_offset)};
+		}
+		num_vars++;
+		macro_order.push_back(imacro);
+	}
+	std::stable_sort(macro_order.begin(), macro_order.end(), [&](int lhs, int rhs) {
+		return pl_macros[lhs].num_blocks > pl_macros[rhs].num_blocks;
+	});
+
+	std::vector<ClusterBlockId> movable_blocks; /* Movable blocks outside macros */
+	for (auto blk_id : cluster_ctx.clb_nlist.blocks()) {
+		const t_block_loc& loc = place_ctx.block_locs[blk_id];
+		if (loc.is_fixed) {
+			block_pins[blk_id] = {FIXED_VAR, double(loc.x), double(loc.y)};
+		} else if (!in_macro[blk_id]) {
+			block_pins[blk_id] = {num_vars++, 0., 0.};
+			movable_blocks.push_back(blk_id);
+		}
+	}
+	int num_block_vars = num_vars;
+
+	if (num_block_vars == 0) return; /* Nothing to place */
+
+	/* Assemble the net springs */
+	std::vector<t_matrix_entry> entries;
+	std::vector<double> net_rhs_x(num_vars, 0.);
+	std::vector<double> net_rhs_y(num_vars, 0.);
+	std::vector<ClusterBlockId> net_blocks;
+	for (auto net_id : cluster_ctx.clb_nlist.nets()) {
+		if (cluster_ctx.clb_nlist.net_is_global(net_id)) continue;
+
+		net_blocks.clear();
+		for (auto pin_id : cluster_ctx.clb_nlist.net_pins(net_id)) {
+			net_blocks.push_back(cluster_ctx.clb_nlist.pin_block(pin_id));
+		}
+		std::sort(net_blocks.begin(), net_blocks.end());
+		net_blocks.erase(std::unique(net_blocks.begin(), net_blocks.end()), net_blocks.end());
+
+		size_t num_net_blocks = net_blocks.size();
+		if (num_net_blocks < 2) continue;
+
+		if (num_net_blocks <= MAX_CLIQUE_NET_BLOCKS) {
+			double weight = 1. / (num_net_blocks - 1);
+			for (size_t i = 0; i < num_net_blocks; i++) {
+				for (size_t j = i + 1; j < num_net_blocks; j++) {
+					add_spring(block_pins[net_blocks[i]], block_pins[net_blocks[j]], weight, entries, net_rhs_x, net_rhs_y);
+				}
+			}
+		} else {
+			t_ap_pin star = {num_vars++, 0., 0.};
+			net_rhs_x.push_back(0.);
+			net_rhs_y.push_back(0.);
+
+			double weight = double(num_net_blocks) / (num_net_blocks - 1);
+			for (auto blk_id : net_blocks) {
+				add_spring(block_pins[blk_id], star, weight, entries, net_rhs_x, net_rhs_y);
+			}
+		}
+	}
+	const t_sparse_matrix net_matrix = build_sparse_matrix(num_vars, entries);
+	entries.clear();
+	entries.shrink_to_fit();
+
+	/* Anchors of the first solve */
+	double centre_x = 0.5 * (device_ctx.grid.width() - 1);
+	double centre_y = 0.5 * (device_ctx.grid.height() - 1);
+	std::vector<double> anchor_weights(num_vars, REGULARIZATION_WEIGHT);
+	std::vector<double> anchor_x(num_vars, centre_x);
+	std::vector<double> anchor_y(num_vars, centre_y);
+	for (auto blk_id : movable_blocks) {
+		if (is_io_type(cluster_ctx.clb_nlist.block_type(blk_id))) {
+			int var = block_pins[blk_id].var;
+			anchor_weights[var] = FREE_IO_ANCHOR_WEIGHT;
+			anchor_x[var] = place_ctx.block_locs[blk_id].x;
+			anchor_y[var] = place_ctx.block_locs[blk_id].y;
+		}
+	}
+
+	std::vector<double> var_x(num_vars, centre_x);
+	std::vector<double> var_y(num_vars, centre_y);
+
+	auto type_legal_pos = get_type_legal_pos();
+	std::vector<std::vector<ClusterBlockId>> type_movable_blocks(device_ctx.num_block_types);
+	for (auto blk_id : movable_blocks) {
+		type_movable_blocks[cluster_ctx.clb_nlist.block_type(blk_id)->index].push_back(blk_id);
+	}
+
+	vtr::vector<ClusterBlockId, double> block_x(num_blocks, 0.);
+	vtr::vector<ClusterBlockId, double> block_y(num_blocks, 0.);
+
+	for (int iter = 0; iter < NUM_ANALYTIC_ITERATIONS; iter++) {
+		/* Solve for the unconstrained (overlapping) positions */
+		t_sparse_matrix matrix = net_matrix;
+		std::vector<double> rhs_x = net_rhs_x;
+		std::vector<double> rhs_y = net_rhs_y;
+		for (int var = 0; var < num_vars; var++) {
+			matrix.values[matrix.diag[var]] += anchor_weights[var];
+			rhs_x[var] += anchor_weights[var] * anchor_x[var];
+			rhs_y[var] += anchor_weights[var] * anchor_y[var];
+		}
+		int num_cg_iterations_x = solve_cg(matrix, rhs_x, var_x);
+		int num_cg_iterations_y = solve_cg(matrix, rhs_y, var_y);
+
+		/* Spread the blocks outside macros; macros go where they were solved */
+		for (auto blk_id : movable_blocks) {
+			block_x[blk_id] = var_x[block_pins[blk_id].var];
+			block_y[blk_id] = var_y[block_pins[blk_id].var];
+		}
+		for (int itype = 0; itype < device_ctx.num_block_types; itype++) {
+			spread_blocks(type_movable_blocks[itype], type_legal_pos[itype], block_x, block_y);
+		}
+
+		/* Legalize: lift all the movable blocks off the grid, and put them back down at
+		 * legal locations, macros first (since they are hardest to place) */
+		for (auto blk_id : cluster_ctx.clb_nlist.blocks()) {
+			if (block_pins[blk_id].var != FIXED_VAR) {
+				clear_block_location(blk_id);
+			}
+		}
+
+		for (int imacro : macro_order) {
+			const t_pl_macro& macro = pl_macros[imacro];
+			ClusterBlockId head_blk_id = macro.members[0].blk_index;
+			int var = block_pins[head_blk_id].var;
+			int itype = cluster_ctx.clb_nlist.block_type(head_blk_id)->index;
+
+			if (!legalize_macro(macro, var_x[var], var_y[var])) {
+				vpr_throw(VPR_ERROR_PLACE, __FILE__, __LINE__,
+						"Analytic initial placement failed.\n"
+						"Could not place macro length %d with head block %s (#%zu); no legal location of type %s.\n",
+						macro.num_blocks, cluster_ctx.clb_nlist.block_name(head_blk_id).c_str(), size_t(head_blk_id),
+						device_ctx.block_types[itype].name);
+			}
+
+			anchor_x[var] = place_ctx.block_locs[head_blk_id].x - macro.members[0].x_offset;
+			anchor_y[var] = place_ctx.block_locs[head_blk_id].y - macro.members[0].y_offset;
+		}
+
+		for (auto blk_id : movable_blocks) {
+			if (!legalize_block(blk_id, block_x[blk_id], block_y[blk_id])) {
+				t_type_ptr type = cluster_ctx.clb_nlist.block_type(blk_id);
+				vpr_throw(VPR_ERROR_PLACE, __FILE__, __LINE__,
+						"Analytic initial placement failed.\n"
+						"Could not place block %s (#%zu); no free locations of type %s (#%d).\n",
+						cluster_ctx.clb_nlist.block_name(blk_id).c_str(), size_t(blk_id), type->name, type->index);
+			}
+
+			int var = block_pins[blk_id].var;
+			anchor_x[var] = place_ctx.block_locs[blk_id].x;
+			anchor_y[var] = place_ctx.block_locs[blk_id].y;
+		}
+
+		/* Pull each block towards its legal location in the next solve (star variables
+		 * keep only the regularization) */
+		double anchor_weight = ANCHOR_WEIGHT_STEP * (iter + 1);
+		std::fill(anchor_weights.begin(), anchor_weights.begin() + num_block_vars, anchor_weight);
+
+		VTR_LOG("Analytic placement iteration %d: %d/%d CG iterations, legalized HPWL %g\n",
+				iter, num_cg_iterations_x, num_cg_iterations_y, compute_hpwl());
+	}
+
+	VTR_LOG("Analytic initial placement reduced HPWL from %g to %g\n", initial_hpwl, compute_hpwl());
+}
+
+/* Builds a num_rows x num_rows sparse matrix from entries (entries for the same row and column
+*  are summed).  Every row gets a diagonal entry, even if zero. */
+t_sparse_matrix build_sparse_matrix(int num_rows, std::vector<t_matrix_entry>& entries) {
+	for (int row = 0; row < num_rows; row++) {
+		entries.push_back({row, row, 0.});
+	}
+	std::sort(entries.begin(), entries.end(), [](const t_matrix_entry& lhs, const t_matrix_entry& rhs) {
+		return lhs.row < rhs.row || (lhs.row == rhs.row && lhs.col < rhs.col);
+	});
+
+	t_sparse_matrix matrix;
+	matrix.row_starts.assign(num_rows + 1, 0);
+	matrix.diag.assign(num_rows, OPEN);
+	for (size_t i = 0; i < entries.size(); ) {
+		const t_matrix_entry& entry = entries[i];
+		double value = 0.;
+		for (; i < entries.size() && entries[i].row == entry.row && entries[i].col == entry.col; i++) {
+			value += entries[i].value;
+		}
+
+		if (entry.row == entry.col) {
+			matrix.diag[entry.row] = matrix.values.size();
+		}
+		matrix.cols.push_back(entry.col);
+		matrix.values.push_back(value);
+		matrix.row_starts[entry.row + 1] = matrix.values.size();
+	}
+
+	return matrix;
+}
+
+/* y = matrix * x */
+static void multiply(const t_sparse_matrix& matrix, const std::vector<double>& x, std::vector<double>& y) {
+	for (int row = 0; row < matrix.num_rows(); row++) {
+		double sum = 0.;
+		for (int i = matrix.row_starts[row]; i < matrix.row_starts[row + 1]; i++) {
+			sum += matrix.values[i] * x[matrix.cols[i]];
+		}
+		y[row] = sum;
+	}
+}
+
+/* Solves matrix * x = b with the Jacobi-preconditioned conjugate gradient method, starting
+*  from the initial guess in x.  Returns the number of iterations taken. */
+int solve_cg(const t_sparse_matrix& matrix, const std::vector<double>& b, std::vector<double>& x) {
+	int num_rows = matrix.num_rows();
+
+	std::vector<double> r(num_rows);
+	std::vector<double> z(num_rows);
+	std::vector<double> p(num_rows);
+	std::vector<double> q(num_rows);
+
+	multiply(matrix, x, r);
+	double b_norm2 = 0.;
+	for (int i = 0; i < num_rows; i++) {
+		r[i] = b[i] - r[i];
+		b_norm2 += b[i] * b[i];
+	}
+	double tolerance2 = CG_RELATIVE_TOLERANCE * CG_RELATIVE_TOLERANCE * std::max(b_norm2, 1.);
+
+	double rz = 0.;
+	for (int i = 0; i < num_rows; i++) {
+		z[i] = r[i] / matrix.values[matrix.diag[i]];
+		p[i] = z[i];
+		rz += r[i] * z[i];
+	}
+
+	int iter;
+	for (iter = 0; iter < MAX_CG_ITERATIONS; iter++) {
+		double r_norm2 = 0.;
+		for (int i = 0; i < num_rows; i++) {
+			r_norm2 += r[i] * r[i];
+		}
+		if (r_norm2 <= tolerance2) break;
+
+		multiply(matrix, p, q);
+		double pq = 0.;
+		for (int i = 0; i < num_rows; i++) {
+			pq += p[i] * q[i];
+		}
+		double alpha = rz / pq;
+
+		double new_rz = 0.;
+		for (int i = 0; i < num_rows; i++) {
+			x[i] += alpha * p[i];
+			r[i] -= alpha * q[i];
+			z[i] = r[i] / matrix.values[matrix.diag[i]];
+			new_rz += r[i] * z[i];
+		}
+
+		double beta = new_rz / rz;
+		rz = new_rz;
+		for (int i = 0; i < num_rows; i++) {
+			p[i] = z[i] + beta * p[i];
+		}
+	}
+
+	return iter;
+}
+
+/* Adds a spring of the given weight between two blocks to the system (a spring between two
+*  fixed blocks is a constant, and is left out) */
+static void add_spring(const t_ap_pin& a, const t_ap_pin& b, double weight, std::vector<t_matrix_entry>& entries,
+		std::vector<double>& rhs_x, std::vector<double>& rhs_y) {
+	if (a.var == FIXED_VAR && b.var == FIXED_VAR) return;
+
+	if (a.var != FIXED_VAR && b.var != FIXED_VAR) {
+		if (a.var == b.var) return; /* Members of the same macro */
+
+		/* weight * (x_a + a.x - x_b - b.x)^2 */
+		entries.push_back({a.var, a.var, weight});
+		entries.push_back({b.var, b.var, weight});
+		entries.push_back({a.var, b.var, -weight});
+		entries.push_back({b.var, a.var, -weight});
+
+		rhs_x[a.var] -= weight * (a.x - b.x);
+		rhs_x[b.var] += weight * (a.x - b.x);
+		rhs_y[a.var] -= weight * (a.y - b.y);
+		rhs_y[b.var] += weight * (a.y - b.y);
+	} else {
+		/* weight * (x_free + free_pin.x - fixed_pin.x)^2 */
+		const t_ap_pin& free_pin = (a.var != FIXED_VAR) ? a : b;
+		const t_ap_pin& fixed_pin = (a.var != FIXED_VAR) ? b : a;
+
+		entries.push_back({free_pin.var, free_pin.var, weight});
+		rhs_x[free_pin.var] += weight * (fixed_pin.x - free_pin.x);
+		rhs_y[free_pin.var] += weight * (fixed_pin.y - free_pin.y);
+	}
+}
+
+/* Returns every legal location (including each z) of each block type */
+static std::vector<std::vector<t_legal_pos>> get_type_legal_pos() {
+	auto& device_ctx = g_vpr_ctx.device();
+	auto& place_ctx = g_vpr_ctx.placement();
+
+	std::vector<std::vector<t_legal_pos>> type_legal_pos(device_ctx.num_block_types);
+	for (size_t x = 0; x < device_ctx.grid.width(); x++) {
+		for (size_t y = 0; y < device_ctx.grid.height(); y++) {
+			const t_grid_tile& tile = device_ctx.grid[x][y];
+			if (tile.width_offset != 0 || tile.height_offset != 0) continue;
+
+			for (int z = 0; z < tile.type->capacity; z++) {
+				if (place_ctx.grid_blocks[x][y].blocks[z] != INVALID_BLOCK_ID) {
+					type_legal_pos[tile.type->index].push_back({int(x), int(y), z});
+				}
+			}
+		}
+	}
+	return type_legal_pos;
+}
+
+/* Spreads blocks (all of one type) over the legal locations of their type: the block ranked r
+*  of n in x is moved to the x of the legal location ranked (r + 0.5) * P / n of P in x, and
+*  likewise in y.  The blocks keep their relative order in each dimension. */
+static void spread_blocks(const std::vector<ClusterBlockId>& blocks, const std::vector<t_legal_pos>& type_legal_pos,
+		vtr::vector<ClusterBlockId, double>& block_x, vtr::vector<ClusterBlockId, double>& block_y) {
+	if (blocks.empty() || type_legal_pos.empty()) return;
+
+	std::vector<int> legal_xs;
+	std::vector<int> legal_ys;
+	for (const t_legal_pos& pos : type_legal_pos) {
+		legal_xs.push_back(pos.x);
+		legal_ys.push_back(pos.y);
+	}
+	std::sort(legal_xs.begin(), legal_xs.end());
+	std::sort(legal_ys.begin(), legal_ys.end());
+
+	std::vector<ClusterBlockId> sorted_blocks(blocks);
+	double scale = double(type_legal_pos.size()) / blocks.size();
+
+	std::stable_sort(sorted_blocks.begin(), sorted_blocks.end(), [&](ClusterBlockId lhs, ClusterBlockId rhs) {
+		return block_x[lhs] < block_x[rhs];
+	});
+	for (size_t rank = 0; rank < sorted_blocks.size(); rank++) {
+		size_t ipos = std::min(size_t((rank + 0.5) * scale), legal_xs.size() - 1);
+		block_x[sorted_blocks[rank]] = legal_xs[ipos];
+	}
+
+	std::stable_sort(sorted_blocks.begin(), sorted_blocks.end(), [&](ClusterBlockId lhs, ClusterBlockId rhs) {
+		return block_y[lhs] < block_y[rhs];
+	});
+	for (size_t rank = 0; rank < sorted_blocks.size(); rank++) {
+		size_t ipos = std::min(size_t((rank + 0.5) * scale), legal_ys.size() - 1);
+		block_y[sorted_blocks[rank]] = legal_ys[ipos];
+	}
+}
+
+static void set_block_location(ClusterBlockId blk_id, int x, int y, int z) {
+	auto& place_ctx = g_vpr_ctx.mutable_placement();
+
+	VTR_ASSERT(place_ctx.grid_blocks[x][y].blocks[z] == EMPTY_BLOCK_ID);
+	place_ctx.grid_blocks[x][y].blocks[z] = blk_id;
+	place_ctx.grid_blocks[x][y].usage++;
+
+	place_ctx.block_locs[blk_id].x = x;
+	place_ctx.block_locs[blk_id].y = y;
+	place_ctx.block_locs[blk_id].z = z;
+}
+
+static void clear_block_location(ClusterBlockId blk_id) {
+	auto& place_ctx = g_vpr_ctx.mutable_placement();
+
+	t_block_loc& loc = place_ctx.block_locs[blk_id];
+	if (loc.x == OPEN) return;
+
+	VTR_ASSERT(place_ctx.grid_blocks[loc.x][loc.y].blocks[loc.z] == blk_id);
+	place_ctx.grid_blocks[loc.x][loc.y].blocks[loc.z] = EMPTY_BLOCK_ID;
+	place_ctx.grid_blocks[loc.x][loc.y].usage--;
+
+	loc.x = OPEN;
+	loc.y = OPEN;
+	loc.z = OPEN;
+}
+
+/* Places macro with its head at (x, y, z) if all its members fit there; returns whether it did */
+static bool try_place_macro_at(const t_pl_macro& macro, int x, int y, int z) {
+	auto& device_ctx = g_vpr_ctx.device();
+	auto& place_ctx = g_vpr_ctx.placement();
+	auto& cluster_ctx = g_vpr_ctx.clustering();
+
+	t_type_ptr head_type = cluster_ctx.clb_nlist.block_type(macro.members[0].blk_index);
+
+	for (int imember = 0; imember < macro.num_blocks; imember++) {
+		const t_pl_macro_member& member = macro.members[imember];
+		int member_x = x + member.x_offset - macro.members[0].x_offset;
+		int member_y = y + member.y_offset - macro.members[0].y_offset;
+		int member_z = z + member.z_offset - macro.members[0].z_offset;
+
+		if (member_x < 0 || member_y < 0 || member_x >= int(device_ctx.grid.width()) || member_y >= int(device_ctx.grid.height())
+				|| device_ctx.grid[member_x][member_y].type != head_type
+				|| member_z < 0 || member_z >= head_type->capacity
+				|| place_ctx.grid_blocks[member_x][member_y].blocks[member_z] != EMPTY_BLOCK_ID) {
+			return false;
+		}
+	}
+
+	for (int imember = 0; imember < macro.num_blocks; imember++) {
+		const t_pl_macro_member& member = macro.members[imember];
+		set_block_location(member.blk_index,
+				x + member.x_offset - macro.members[0].x_offset,
+				y + member.y_offset - macro.members[0].y_offset,
+				z + member.z_offset - macro.members[0].z_offset);
+	}
+	return true;
+}
+
+/* Returns the locations of the grid on the square ring at radius around (centre_x, centre_y),
+*  closest to (x, y) first */
+static void get_ring_locs(int centre_x, int centre_y, int radius, double x, double y,
+		std::vector<std::pair<int, int>>& ring_locs) {
+	auto& device_ctx = g_vpr_ctx.device();
+	int width = device_ctx.grid.width();
+	int height = device_ctx.grid.height();
+
+	ring_locs.clear();
+	auto add = [&](int loc_x, int loc_y) {
+		if (loc_x < 0 || loc_y < 0 || loc_x >= width || loc_y >= height) return;
+		ring_locs.emplace_back(loc_x, loc_y);
+	};
+
+	if (radius == 0) {
+		add(centre_x, centre_y);
+	} else {
+		for (int dx = -radius; dx <= radius; dx++) {
+			add(centre_x + dx, centre_y - radius);
+			add(centre_x + dx, centre_y + radius);
+		}
+		for (int dy = -radius + 1; dy <= radius - 1; dy++) {
+			add(centre_x - radius, centre_y + dy);
+			add(centre_x + radius, centre_y + dy);
+		}
+	}
+
+	std::stable_sort(ring_locs.begin(), ring_locs.end(), [&](const std::pair<int, int>& lhs, const std::pair<int, int>& rhs) {
+		return std::abs(lhs.first - x) + std::abs(lhs.second - y) < std::abs(rhs.first - x) + std::abs(rhs.second - y);
+	});
+}
+
+/* Places macro with its head at a legal location near where (x, y) puts it, searching rings of
+*  locations around it */
+bool legalize_macro(const t_pl_macro& macro, double x, double y) {
+	auto& device_ctx = g_vpr_ctx.device();
+	auto& cluster_ctx = g_vpr_ctx.clustering();
+
+	t_type_ptr head_type = cluster_ctx.clb_nlist.block_type(macro.members[0].blk_index);
+	int width = device_ctx.grid.width();
+	int height = device_ctx.grid.height();
+	double head_x = x + macro.members[0].x_offset;
+	double head_y = y + macro.members[0].y_offset;
+	int centre_x = std::min(std::max(int(std::round(head_x)), 0), width - 1);
+	int centre_y = std::min(std::max(int(std::round(head_y)), 0), height - 1);
+
+	std::vector<std::pair<int, int>> ring_locs;
+	int max_radius = std::max(width, height);
+	for (int radius = 0; radius <= max_radius; radius++) {
+		get_ring_locs(centre_x, centre_y, radius, head_x, head_y, ring_locs);
+		for (const auto& loc : ring_locs) {
+			const t_grid_tile& tile = device_ctx.grid[loc.first][loc.second];
+			if (tile.type != head_type || tile.width_offset != 0 || tile.height_offset != 0) continue;
+
+			for (int z = 0; z < head_type->capacity; z++) {
+				if (try_place_macro_at(macro, loc.first, loc.second, z)) {
+					return true;
+				}
+			}
+		}
+	}
+	return false;
+}
+
+/* Places blk_id at a free legal location near (x, y), searching rings of locations around it */
+static bool legalize_block(ClusterBlockId blk_id, double x, double y) {
+	auto& device_ctx = g_vpr_ctx.device();
+	auto& place_ctx = g_vpr_ctx.placement();
+	auto& cluster_ctx = g_vpr_ctx.clustering();
+
+	t_type_ptr type = cluster_ctx.clb_nlist.block_type(blk_id);
+	int width = device_ctx.grid.width();
+	int height = device_ctx.grid.height();
+	int centre_x = std::min(std::max(int(std::round(x)), 0), width - 1);
+	int centre_y = std::min(std::max(int(std::round(y)), 0), height - 1);
+
+	/* Returns the first free z at (loc_x, loc_y) for type, or OPEN */
+	auto free_z = [&](int loc_x, int loc_y) {
+		const t_grid_tile& tile = device_ctx.grid[loc_x][loc_y];
+		if (tile.type != type || tile.width_offset != 0 || tile.height_offset != 0) return int(OPEN);
+
+		for (int z = 0; z < type->capacity; z++) {
+			if (place_ctx.grid_blocks[loc_x][loc_y].blocks[z] == EMPTY_BLOCK_ID) return z;
+		}
+		return int(OPEN);
+	};
+
+	std::vector<std::pair<int, int>> ring_locs;
+	int max_radius = std::max(width, height);
+	for (int radius = 0; radius <= max_radius; radius++) {
+		get_ring_locs(centre_x, centre_y, radius, x, y, ring_locs);
+		for (const auto& loc : ring_locs) {
+			int z = free_z(loc.first, loc.second);
+			if (z != OPEN) {
+				set_block_location(blk_id, loc.first, loc.second, z);
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
+/* Returns the total half-perimeter wirelength of the (non-global) nets */
+static double compute_hpwl() {
+	auto& cluster_ctx = g_vpr_ctx.clustering();
+	auto& place_ctx = g_vpr_ctx.placement();
+
+	double hpwl = 0.;
+	for (auto net_id : cluster_ctx.clb_nlist.nets()) {
+		if (cluster_ctx.clb_nlist.net_is_global(net_id)) continue;
+
+		int xmin = 0, xmax = 0, ymin = 0, ymax = 0;
+		bool first = true;
+		for (auto pin_id : cluster_ctx.clb_nlist.net_pins(net_id)) {
+			const t_block_loc& loc = place_ctx.block_locs[cluster_ctx.clb_nlist.pin_block(pin_id)];
+			if (first) {
+				xmin = xmax = loc.x;
+				ymin = ymax = loc.y;
+				first = false;
+			} else {
+				xmin = std::min(xmin, loc.x);
+				xmax = std::max(xmax, loc.x);
+				ymin = std::min(ymin, loc.y);
+				ymax = std::max(ymax, loc.y);
+			}
+		}
+		hpwl += (xmax - xmin) + (ymax - ymin);
+	}
+	return hpwl;
+}
@@ -0,0 +1,44 @@
+#ifndef ANALYTIC_PLACEMENT_H
+#define ANALYTIC_PLACEMENT_H
+
+#include <vector>
+
+#include "vpr_types.h"
+#include "place_macro.h"
+
+/* Replaces the (legal) placement in the placement context with an analytic one: a quadratic
+ * wirelength-driven global placement (solved with conjugate gradients) followed by legalization
+ * onto the device grid.  Fixed blocks are not moved, and the members of each placement macro
+ * keep their relative positions.  The resulting placement is legal.                          */
+void analytic_initial_placement(const t_pl_macro* pl_macros, int num_pl_macros);
+
+/* Building blocks of the analytic placer, exposed for unit testing */
+struct t_matrix_entry {
+	int row;
+	int col;
+	double value;
+};
+
+/* Sparse symmetric matrix, in compressed sparse row form */
+struct t_sparse_matrix {
+	std::vector<int> row_starts; /* [0..num_rows()]: offsets of each row's entries */
+	std::vector<int> cols;
+	std::vector<double> values;
+	std::vector<int> diag; /* Index of each row's diagonal entry in values */
+
+	int num_rows() const { return diag.size(); }
+};
+
+/* Builds a num_rows x num_rows sparse matrix from entries (entries for the same row and column
+ * are summed).  Every row gets a diagonal entry, even if zero. */
+t_sparse_matrix build_sparse_matrix(int num_rows, std::vector<t_matrix_entry>& entries);
+
+/* Solves matrix * x = b with the Jacobi-preconditioned conjugate gradient method, starting
+ * from the initial guess in x.  Returns the number of iterations taken. */
+int solve_cg(const t_sparse_matrix& matrix, const std::vector<double>& b, std::vector<double>& x);
+
+/* Places macro (which must be off the grid) with its head at a free legal location near where
+ * the macro variable (x, y) puts it, keeping its members' offsets.  Returns whether it did. */
+bool legalize_macro(const t_pl_macro& macro, double x, double y);
+
+#endif
@@ -7,8 +7,10 @@ using namespace std;
 #include "vtr_assert.h"
 #include "vtr_log.h"
 #include "vtr_util.h"
+#include "vtr_math.h"
 #include "vtr_random.h"
 #include "vtr_matrix.h"
+#include "vtr_time.h"
 
 #include "vpr_types.h"
 #include "vpr_error.h"
@@ -30,6 +32,8 @@ using namespace std;
 #include "histogram.h"
 #include "place_util.h"
 #include "place_delay_model.h"
+#include "hypergraph_partitioner.h"
+#include "analytic_placement.h"
 
 #include "PlacementDelayCalculator.h"
 #include "VprTimingGraphResolver.h"
@@ -59,6 +63,12 @@ using namespace std;
  * legal position and place it during initial placement.                  */
 #define MAX_NUM_TRIES_TO_PLACE_MACROS_RANDOMLY 4
 
+/* When annealing an analytic initial placement, the range limit starts at this fraction of  *
+ * the device size, and the (automatic) starting temperature is scaled by this factor, so    *
+ * the anneal refines the initial placement rather than scrambling it.                       */
+#define ANALYTIC_INIT_RLIM_FRACTION 0.1
+#define ANALYTIC_INIT_T_FRACTION 0.05
+
 /* Flags for the states of the bounding box.                              *
  * Stored as char for memory efficiency.                                  */
 #define NOT_UPDATED_YET 'N'
@@ -109,6 +119,11 @@ large enough to be on the order of timing costs for normal constraints. */
 /* Cost of a net, and a temporary cost of a net used during move assessment. */
 static vtr::vector<ClusterNetId, float> net_cost, temp_net_cost;
 
+/* [0..cluster_ctx.clb_nlist.nets().size()-1]. The expected "crossing count" *
+ * of each net (see cross_count below). It only depends on the number of   *
+ * pins on the net, so it is computed once instead of on every cost update. */
+static vtr::vector<ClusterNetId, float> net_crossing;
+
 static t_legal_pos **legal_pos = nullptr; /* [0..device_ctx.num_block_types-1][0..type_tsize - 1] */
 static int *num_legal_pos = nullptr; /* [0..num_legal_pos-1] */
 
@@ -172,6 +187,21 @@ static float** chany_place_cost_fac; //[0...device_ctx.grid.height()-2]
 static vtr::vector<ClusterNetId, t_bb> ts_bb_coord_new, ts_bb_edge_new;
 static std::vector<ClusterNetId> ts_nets_to_update;
 
+/* Structure-of-arrays scratch space used to evaluate the bounding box      *
+ * costs of all the nets affected by a move in one batch. Entry i holds the *
+ * data of ts_nets_to_update[i]. Keeping each field contiguous lets the     *
+ * cost loop in comp_affected_net_bb_costs() be vectorized by the compiler. *
+ * [0...cluster_ctx.clb_nlist.nets().size()-1]                              */
+struct t_bb_cost_batch {
+    std::vector<int> xspan;
+    std::vector<int> yspan;
+    std::vector<float> crossing;
+    std::vector<float> chanx_fac;
+    std::vector<float> chany_fac;
+    std::vector<float> cost;
+};
+static t_bb_cost_batch ts_bb_cost_batch;
+
 /* The pl_macros array stores all the carry chains placement macros.   *
  * [0...num_pl_macros-1]                                               */
 static t_pl_macro * pl_macros = nullptr;
@@ -233,8 +263,13 @@ static void initial_placement_blocks(int * free_locations, enum e_pad_loc_type p
 static void initial_placement_location(int * free_locations, ClusterBlockId blk_id,
 		int *pipos, int *px, int *py, int *pz);
 
-static void initial_placement(enum e_pad_loc_type pad_loc_type,
-		const char *pad_loc_file);
+static void load_partition_regions(const t_bb& region, int num_parts, int first_part, std::vector<t_bb>& regions);
+static vtr::vector<ClusterBlockId, int> get_cluster_partitions(const vtr::vector<AtomBlockId, int>& atom_partitions);
+static void initial_placement_partitioned_blocks(int * free_locations, enum e_pad_loc_type pad_loc_type,
+		int num_partitions);
+static void remove_occupied_free_locations(int * free_locations);
+
+static void initial_placement(const t_placer_opts& placer_opts);
 
 static float comp_bb_cost(e_cost_methods method);
 
@@ -261,6 +296,9 @@ static float starting_t(t_placer_costs* costs,
         const PlaceDelayModel& delay_model,
 		enum e_place_algorithm place_algorithm, float timing_tradeoff);
 
+static void recompute_placement_costs(const t_placer_opts& placer_opts, const PlaceDelayModel* delay_model,
+		t_placer_costs* costs, t_placer_prev_inverse_costs* prev_inverse_costs);
+
 static void update_t(float *t, float rlim, float success_rat,
 		t_annealing_sched annealing_sched);
 
@@ -308,6 +346,9 @@ static void update_td_delta_costs(const PlaceDelayModel& delay_model, const Clus
 
 static float get_net_cost(ClusterNetId net_id, t_bb *bb_ptr);
 
+static float comp_affected_net_bb_costs(int num_affected_nets);
+
+
 static void get_bb_from_scratch(ClusterNetId net_id, t_bb *coords,
 		t_bb *num_on_edges);
 
@@ -428,7 +469,7 @@ void try_place(t_placer_opts placer_opts,
 	alloc_and_load_placement_structs(placer_opts.place_cost_exp, placer_opts,
 			directs, num_directs);
 
-	initial_placement(placer_opts.pad_loc_type, placer_opts.pad_loc_file.c_str());
+	initial_placement(placer_opts);
 	init_draw_coords((float) width_fac);
 
     //Enables fast look-up of atom pins connect to CLB pins
@@ -601,10 +642,39 @@ void try_place(t_placer_opts placer_opts,
 	final_rlim = 1;
 	inverse_delta_rlim = 1 / (first_rlim - final_rlim);
 
-	t = starting_t(&costs, &prev_inverse_costs,
-			annealing_sched, move_lim, rlim,
-            *place_delay_model,
-			placer_opts.place_algorithm, placer_opts.timing_tradeoff);
+	/* The exponent schedule still spans the whole device (update_rlim() may grow rlim back to it) */
+	if (placer_opts.analytic_initial_placement) {
+		rlim = max(ANALYTIC_INIT_RLIM_FRACTION * rlim, 1.);
+	}
+
+	if (placer_opts.analytic_initial_placement) {
+		/* starting_t() keeps the moves it probes (at an infinite temperature), which would scramble the  *
+		 * analytic placement before annealing starts, so the placement and its costs are restored after. */
+		auto& place_ctx = g_vpr_ctx.mutable_placement();
+		vtr::vector_map<ClusterBlockId, t_block_loc> initial_block_locs = g_vpr_ctx.placement().block_locs;
+		vtr::Matrix<t_grid_blocks> initial_grid_blocks = g_vpr_ctx.placement().grid_blocks;
+
+		t = starting_t(&costs, &prev_inverse_costs,
+				annealing_sched, move_lim, rlim,
+				*place_delay_model,
+				placer_opts.place_algorithm, placer_opts.timing_tradeoff);
+		if (annealing_sched.type == AUTO_SCHED) {
+			t *= ANALYTIC_INIT_T_FRACTION;
+		}
+
+		place_ctx.block_locs = initial_block_locs;
+		place_ctx.grid_blocks = initial_grid_blocks;
+		recompute_placement_costs(placer_opts, place_delay_model.get(), &costs, &prev_inverse_costs);
+	} else {
+		t = starting_t(&costs, &prev_inverse_costs,
+				annealing_sched, move_lim, rlim,
+				*place_delay_model,
+				placer_opts.place_algorithm, placer_opts.timing_tradeoff);
+	}
+
+	/* Used to report the annealer's swap throughput, excluding the swaps probed by starting_t() */
+	vtr::Timer anneal_timer;
+	int num_ts_before_anneal = num_ts_called;
 
 	tot_iter = 0;
 	moves_since_cost_recompute = 0;
@@ -729,6 +799,9 @@ void try_place(t_placer_opts placer_opts,
             *place_delay_model,
             *timing_info);
 
+	float anneal_sec = anneal_timer.elapsed_sec();
+	int num_anneal_swaps = num_ts_called - num_ts_before_anneal;
+
 	tot_iter += move_lim;
     calc_placer_stats(stats, success_rat, std_dev, costs, move_lim);
 
@@ -765,6 +838,7 @@ void try_place(t_placer_opts placer_opts,
     //Some stats
     VTR_LOG("\n");
     VTR_LOG("Swaps called: %d\n", num_ts_called);
+    VTR_LOG("Swap rate: %.4g swaps/sec\n", num_anneal_swaps / std::max(anneal_sec, 1e-6f));
 
 	if (placer_opts.enable_timing_computations
 			&& placer_opts.place_algorithm == BOUNDING_BOX_PLACE) {
@@ -1212,6 +1286,25 @@ static float starting_t(t_placer_costs* costs,
 	return (20. * std_dev);
 }
 
+/* Recomputes the bounding boxes, point to point delays and costs from scratch (as for the initial *
+ * placement), after the placement has been replaced wholesale.                                   */
+static void recompute_placement_costs(const t_placer_opts& placer_opts, const PlaceDelayModel* delay_model,
+		t_placer_costs* costs, t_placer_prev_inverse_costs* prev_inverse_costs) {
+
+	costs->bb_cost = comp_bb_cost(NORMAL);
+
+	if (placer_opts.place_algorithm == PATH_TIMING_DRIVEN_PLACE || placer_opts.enable_timing_computations) {
+		VTR_ASSERT(delay_model);
+		comp_td_point_to_point_delays(*delay_model);
+		comp_td_costs(*delay_model, &costs->timing_cost, &costs->delay_cost);
+
+		prev_inverse_costs->timing_cost = 1 / costs->timing_cost;
+		prev_inverse_costs->bb_cost = 1 / costs->bb_cost;
+		costs->cost = 1;
+	} else {
+		costs->cost = costs->bb_cost;
+	}
+}
 
 static int setup_blocks_affected(ClusterBlockId b_from, int x_to, int y_to, int z_to) {
 
@@ -1639,14 +1732,54 @@ static int find_affected_nets_and_update_costs(e_place_algorithm place_algorithm
     /* Now update the bounding box costs (since the net bounding boxes are up-to-date).
      * The cost is only updated once per net.
      */
+    bb_delta_c = comp_affected_net_bb_costs(num_affected_nets);
+
+	return num_affected_nets;
+}
+
+//Computes the new bounding box cost (temp_net_cost) of every net recorded in
+//ts_nets_to_update, and returns the resulting change in bounding box cost.
+//
+//This is equivalent to calling get_net_cost() on each affected net, but is
+//split into a gather pass (which does all the irregular memory accesses), a
+//branch-free arithmetic pass over contiguous arrays, and a scatter pass.
+static float comp_affected_net_bb_costs(int num_affected_nets) {
+    t_bb_cost_batch& batch = ts_bb_cost_batch;
+
+    //Gather
     for (int inet_affected = 0; inet_affected < num_affected_nets; inet_affected++) {
         ClusterNetId net_id = ts_nets_to_update[inet_affected];
+        const t_bb& bb = ts_bb_coord_new[net_id];
+
+        batch.xspan[inet_affected] = bb.xmax - bb.xmin + 1;
+        batch.yspan[inet_affected] = bb.ymax - bb.ymin + 1;
+        batch.crossing[inet_affected] = net_crossing[net_id];
+        batch.chanx_fac[inet_affected] = chanx_place_cost_fac[bb.ymax][bb.ymin - 1];
+        batch.chany_fac[inet_affected] = chany_place_cost_fac[bb.xmax][bb.xmin - 1];
+    }
 
-        temp_net_cost[net_id] = get_net_cost(net_id, &ts_bb_coord_new[net_id]);
+    //Evaluate (same operation order as get_net_cost() so results are bit-identical)
+    const int* xspan = batch.xspan.data();
+    const int* yspan = batch.yspan.data();
+    const float* crossing = batch.crossing.data();
+    const float* chanx_fac = batch.chanx_fac.data();
+    const float* chany_fac = batch.chany_fac.data();
+    float* cost = batch.cost.data();
+    for (int i = 0; i < num_affected_nets; i++) {
+        cost[i] = xspan[i] * crossing[i] * chanx_fac[i]
+                + yspan[i] * crossing[i] * chany_fac[i];
+    }
+
+    //Scatter
+    float bb_delta_c = 0.;
+    for (int inet_affected = 0; inet_affected < num_affected_nets; inet_affected++) {
+        ClusterNetId net_id = ts_nets_to_update[inet_affected];
+
+        temp_net_cost[net_id] = cost[inet_affected];
         bb_delta_c += temp_net_cost[net_id] - net_cost[net_id];
     }
 
-	return num_affected_nets;
+    return bb_delta_c;
 }
 
 static void record_affected_net(const ClusterNetId net, int& num_affected_nets) {
@@ -2190,6 +2323,11 @@ static void alloc_and_load_placement_structs(
 
     net_cost.resize(num_nets, -1.);
     temp_net_cost.resize(num_nets, -1.);
+
+    net_crossing.resize(num_nets, 0.);
+    for (auto net_id : cluster_ctx.clb_nlist.nets()) {
+        net_crossing[net_id] = get_net_crossing(cluster_ctx.clb_nlist.net_pins(net_id).size());
+    }
     bb_coords.resize(num_nets, t_bb());
     bb_num_on_edges.resize(num_nets, t_bb());
 
@@ -2252,6 +2390,13 @@ static void alloc_and_load_try_swap_structs() {
     ts_bb_edge_new.resize(num_nets, t_bb());
     ts_nets_to_update.resize(num_nets, ClusterNetId::INVALID());
 
+    ts_bb_cost_batch.xspan.resize(num_nets);
+    ts_bb_cost_batch.yspan.resize(num_nets);
+    ts_bb_cost_batch.crossing.resize(num_nets);
+    ts_bb_cost_batch.chanx_fac.resize(num_nets);
+    ts_bb_cost_batch.chany_fac.resize(num_nets);
+    ts_bb_cost_batch.cost.resize(num_nets);
+
 	/* Allocate with size cluster_ctx.clb_nlist.blocks().size() for any number of moved blocks. */
 	blocks_affected.moved_blocks = (t_pl_moved_block*) vtr::calloc((int) cluster_ctx.clb_nlist.blocks().size(), sizeof(t_pl_moved_block));
 	blocks_affected.num_moved_blocks = 0;
@@ -2385,24 +2530,31 @@ static double get_net_wirelength_estimate(ClusterNetId net_id, t_bb *bbptr) {
 	return (ncost);
 }
 
-static float get_net_cost(ClusterNetId net_id, t_bb *bbptr) {
-
-	/* Finds the cost due to one net by looking at its coordinate bounding  *
-	 * box.                                                                 */
-
-	float ncost, crossing;
-    auto& cluster_ctx = g_vpr_ctx.clustering();
+float get_net_crossing(size_t num_pins) {
 
 	/* Get the expected "crossing count" of a net, based on its number *
 	 * of pins.  Extrapolate for very large nets.                      */
 
-	if ((cluster_ctx.clb_nlist.net_pins(net_id).size()) > 50) {
-		crossing = 2.7933 + 0.02616 * ((cluster_ctx.clb_nlist.net_pins(net_id).size()) - 50);
+	float crossing;
+
+	if (num_pins > 50) {
+		crossing = 2.7933 + 0.02616 * (num_pins - 50);
 		/*    crossing = 3.0;    Old value  */
 	} else {
-		crossing = cross_count[(cluster_ctx.clb_nlist.net_pins(net_id).size()) - 1];
+		crossing = cross_count[num_pins - 1];
 	}
 
+	return (crossing);
+}
+
+static float get_net_cost(ClusterNetId net_id, t_bb *bbptr) {
+
+	/* Finds the cost due to one net by looking at its coordinate bounding  *
+	 * box.                                                                 */
+
+	float ncost;
+	float crossing = net_crossing[net_id];
+
 	/* Could insert a check for xmin == xmax.  In that case, assume  *
 	 * connection will be made with no bends and hence no x-cost.    *
 	 * Same thing for y-cost.                                        */
@@ -2968,15 +3120,171 @@ static void initial_placement_location(int * free_locations, ClusterBlockId blk_
 	*pz_to = legal_pos[itype][*pipos].z;
 }
 
-static void initial_placement(enum e_pad_loc_type pad_loc_type,
-		const char *pad_loc_file) {
+/* Splits region between parts [first_part, first_part + num_parts) the same way the
+ * partitioner splits the netlist: recursively in two, across the longer side, in
+ * proportion to the number of parts on each side.                                 */
+static void load_partition_regions(const t_bb& region, int num_parts, int first_part, std::vector<t_bb>& regions) {
+	if (num_parts == 1) {
+		regions[first_part] = region;
+		return;
+	}
+
+	int num_parts0 = num_parts / 2;
+	float fraction0 = float(num_parts0) / num_parts;
+
+	t_bb region0 = region;
+	t_bb region1 = region;
+	int width = region.xmax - region.xmin + 1;
+	int height = region.ymax - region.ymin + 1;
+	if (width >= height && width > 1) {
+		region0.xmax = region.xmin + std::min(std::max(vtr::nint(fraction0 * width), 1), width - 1) - 1;
+		region1.xmin = region0.xmax + 1;
+	} else if (height > 1) {
+		region0.ymax = region.ymin + std::min(std::max(vtr::nint(fraction0 * height), 1), height - 1) - 1;
+		region1.ymin = region0.ymax + 1;
+	} /* else a single location, which both halves share */
+
+	load_partition_regions(region0, num_parts0, first_part, regions);
+	load_partition_regions(region1, num_parts - num_parts0, first_part + num_parts0, regions);
+}
+
+/* Returns the part of each cluster: the part most of its atoms belong to */
+static vtr::vector<ClusterBlockId, int> get_cluster_partitions(const vtr::vector<AtomBlockId, int>& atom_partitions) {
+	auto& atom_ctx = g_vpr_ctx.atom();
+	auto& cluster_ctx = g_vpr_ctx.clustering();
+
+	std::vector<std::pair<ClusterBlockId, int>> cluster_atom_parts;
+	for (auto atom_blk_id : atom_ctx.nlist.blocks()) {
+		ClusterBlockId clb_index = atom_ctx.lookup.atom_clb(atom_blk_id);
+		if (clb_index != ClusterBlockId::INVALID()) {
+			cluster_atom_parts.emplace_back(clb_index, atom_partitions[atom_blk_id]);
+		}
+	}
+	std::sort(cluster_atom_parts.begin(), cluster_atom_parts.end());
+
+	/* Each run of equal entries counts the atoms of one cluster in one part */
+	vtr::vector<ClusterBlockId, int> cluster_partitions(cluster_ctx.clb_nlist.blocks().size(), OPEN);
+	size_t best_count = 0;
+	for (size_t irun = 0; irun < cluster_atom_parts.size(); ) {
+		size_t run_end = irun;
+		while (run_end < cluster_atom_parts.size() && cluster_atom_parts[run_end] == cluster_atom_parts[irun]) {
+			++run_end;
+		}
+
+		ClusterBlockId clb_index = cluster_atom_parts[irun].first;
+		if (cluster_partitions[clb_index] == OPEN || run_end - irun > best_count) {
+			cluster_partitions[clb_index] = cluster_atom_parts[irun].second;
+			best_count = run_end - irun;
+		}
+		irun = run_end;
+	}
+
+	return cluster_partitions;
+}
+
+/* Place blocks that are NOT part of any macro within the region of the device assigned to
+ * their netlist part, at random free locations of the region.  Blocks whose region has no
+ * free location left of their type are left for initial_placement_blocks(). */
+static void initial_placement_partitioned_blocks(int * free_locations, enum e_pad_loc_type pad_loc_type,
+		int num_partitions) {
+    auto& cluster_ctx = g_vpr_ctx.clustering();
+    auto& place_ctx = g_vpr_ctx.mutable_placement();
+    auto& device_ctx = g_vpr_ctx.device();
+
+	vtr::vector<ClusterBlockId, int> cluster_partitions = get_cluster_partitions(load_atom_partitions(num_partitions));
+
+	std::vector<t_bb> regions(num_partitions);
+	t_bb device_region = {0, int(device_ctx.grid.width()) - 1, 0, int(device_ctx.grid.height()) - 1};
+	load_partition_regions(device_region, num_partitions, 0, regions);
+
+	/* Split the free locations of each type by region: region_free_pos[itype][part] */
+	std::vector<std::vector<std::vector<t_legal_pos>>> region_free_pos(device_ctx.num_block_types,
+			std::vector<std::vector<t_legal_pos>>(num_partitions));
+	for (int itype = 0; itype < device_ctx.num_block_types; itype++) {
+		for (int ipos = 0; ipos < free_locations[itype]; ipos++) {
+			const t_legal_pos& pos = legal_pos[itype][ipos];
+			for (int part = 0; part < num_partitions; part++) {
+				const t_bb& region = regions[part];
+				if (pos.x >= region.xmin && pos.x <= region.xmax && pos.y >= region.ymin && pos.y <= region.ymax) {
+					region_free_pos[itype][part].push_back(pos);
+					break;
+				}
+			}
+		}
+	}
+
+	size_t num_region_placed = 0;
+	for (auto blk_id : cluster_ctx.clb_nlist.blocks()) {
+		if (place_ctx.block_locs[blk_id].x != OPEN) continue; /* Placed macro member */
+
+		/* IOs fixed by the user or at random locations are handled by initial_placement_blocks() */
+		t_type_ptr type = cluster_ctx.clb_nlist.block_type(blk_id);
+		if (is_io_type(type) && pad_loc_type != FREE) continue;
+
+		int part = cluster_partitions[blk_id];
+		if (part == OPEN) continue;
+
+		auto& free_pos = region_free_pos[type->index][part];
+		if (free_pos.empty()) continue;
+
+		int ipos = vtr::irand(free_pos.size() - 1);
+		t_legal_pos pos = free_pos[ipos];
+		free_pos[ipos] = free_pos.back();
+		free_pos.pop_back();
+
+		VTR_ASSERT(place_ctx.grid_blocks[pos.x][pos.y].blocks[pos.z] == EMPTY_BLOCK_ID);
+
+		place_ctx.grid_blocks[pos.x][pos.y].blocks[pos.z] = blk_id;
+		place_ctx.grid_blocks[pos.x][pos.y].usage++;
+
+		place_ctx.block_locs[blk_id].x = pos.x;
+		place_ctx.block_locs[blk_id].y = pos.y;
+		place_ctx.block_locs[blk_id].z = pos.z;
+
+		num_region_placed++;
+	}
+
+	VTR_LOG("Initially placed %zu of %zu blocks in the regions of their %d netlist parts\n",
+			num_region_placed, cluster_ctx.clb_nlist.blocks().size(), num_partitions);
+}
+
+/* Removes the now occupied locations from the free part of legal_pos[][] */
+static void remove_occupied_free_locations(int * free_locations) {
+    auto& device_ctx = g_vpr_ctx.device();
+    auto& place_ctx = g_vpr_ctx.placement();
+
+	for (int itype = 0; itype < device_ctx.num_block_types; itype++) {
+		VTR_ASSERT(free_locations[itype] >= 0);
+		for (int ipos = 0; ipos < free_locations[itype]; ipos++) {
+			int x = legal_pos[itype][ipos].x;
+			int y = legal_pos[itype][ipos].y;
+			int z = legal_pos[itype][ipos].z;
+
+			// Check if that location is occupied.  If it is, remove from legal_pos
+			if (place_ctx.grid_blocks[x][y].blocks[z] != EMPTY_BLOCK_ID && place_ctx.grid_blocks[x][y].blocks[z] != INVALID_BLOCK_ID) {
+				legal_pos[itype][ipos] = legal_pos[itype][free_locations[itype] - 1];
+				free_locations[itype]--;
+
+				// After the move, I need to check this particular entry again
+				ipos--;
+				continue;
+			}
+		}
+	}
+}
+
+static void initial_placement(const t_placer_opts& placer_opts) {
 
 	/* Randomly places the blocks to create an initial placement. We rely on
 	 * the legal_pos array already being loaded.  That legal_pos[itype] is an
 	 * array that gives every legal value of (x,y,z) that can accomodate a block.
 	 * The number of such locations is given by num_legal_pos[itype].
+	 * If placer_opts.num_partitions > 1, blocks are first placed at random within
+	 * the device regions assigned to their netlist parts (as far as the regions
+	 * have room). With placer_opts.analytic_initial_placement, the resulting
+	 * placement is then replaced by an analytic one.
 	 */
-	int itype, x, y, z, ipos;
+	int itype;
 	int *free_locations; /* [0..device_ctx.num_block_types-1].
 						  * Stores how many locations there are for this type that *might* still be free.
 						  * That is, this stores the number of entries in legal_pos[itype] that are worth considering
@@ -3016,29 +3324,21 @@ static void initial_placement(enum e_pad_loc_type pad_loc_type,
 	initial_placement_pl_macros(MAX_NUM_TRIES_TO_PLACE_MACROS_RANDOMLY, free_locations);
 
 	// All the macros are placed, update the legal_pos[][] array
-	for (itype = 0; itype < device_ctx.num_block_types; itype++) {
-		VTR_ASSERT(free_locations[itype] >= 0);
-		for (ipos = 0; ipos < free_locations[itype]; ipos++) {
-			x = legal_pos[itype][ipos].x;
-			y = legal_pos[itype][ipos].y;
-			z = legal_pos[itype][ipos].z;
+	remove_occupied_free_locations(free_locations);
 
-			// Check if that location is occupied.  If it is, remove from legal_pos
-			if (place_ctx.grid_blocks[x][y].blocks[z] != EMPTY_BLOCK_ID && place_ctx.grid_blocks[x][y].blocks[z] != INVALID_BLOCK_ID) {
-				legal_pos[itype][ipos] = legal_pos[itype][free_locations[itype] - 1];
-				free_locations[itype]--;
+	if (placer_opts.num_partitions > 1) {
+		initial_placement_partitioned_blocks(free_locations, placer_opts.pad_loc_type, placer_opts.num_partitions);
+		remove_occupied_free_locations(free_locations);
+	}
 
-				// After the move, I need to check this particular entry again
-				ipos--;
-				continue;
-			}
-		}
-	} // Finish updating the legal_pos[][] and free_locations[] array
+	initial_placement_blocks(free_locations, placer_opts.pad_loc_type);
 
-	initial_placement_blocks(free_locations, pad_loc_type);
+	if (placer_opts.pad_loc_type == USER) {
+		read_user_pad_loc(placer_opts.pad_loc_file.c_str());
+	}
 
-	if (pad_loc_type == USER) {
-		read_user_pad_loc(pad_loc_file);
+	if (placer_opts.analytic_initial_placement) {
+		analytic_initial_placement(pl_macros, num_pl_macros);
 	}
 
 	/* Restore legal_pos */
@@ -3316,6 +3616,8 @@ static void print_clb_placement(const char *fname) {
 #endif
 
 static void free_try_swap_arrays() {
+	ts_bb_cost_batch = t_bb_cost_batch();
+
 	if(blocks_affected.moved_blocks != nullptr) {
 		free(blocks_affected.moved_blocks);
 
@@ -13,4 +13,8 @@ void try_place(t_placer_opts placer_opts,
 #endif
         t_direct_inf *directs, int num_directs);
 
+/* Returns the expected number of times a net with num_pins pins crosses each *
+ * channel of its bounding box (its wiring is this times its bounding box).   */
+float get_net_crossing(size_t num_pins);
+
 #endif
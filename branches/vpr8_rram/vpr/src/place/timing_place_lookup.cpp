@@ -30,7 +30,7 @@ using namespace std;
 #include "atom_netlist.h"
 #include "rr_graph2.h"
 #include "place_util.h"
-// all functions in profiling:: namespace, which are only activated if PROFILE is defined
+// all functions in profiling:: namespace, gathering router telemetry
 #include "route_profiling.h"
 #include "router_delay_profiling.h"
 #include "place_delay_model.h"
@@ -27,8 +27,14 @@
 #include <ctime>
 #include <cmath>
 #include <ctype.h>
+#include <unordered_map>
+#include <vector>
 using namespace std;
 
+#if defined(TATUM_USE_TBB)
+# include <tbb/parallel_for.h>
+#endif
+
 #include "vtr_util.h"
 #include "vtr_path.h"
 #include "vtr_log.h"
@@ -47,11 +53,15 @@ using namespace std;
 #include "globals.h"
 #include "rr_graph.h"
 #include "vpr_utils.h"
+#include "read_activity.h"
 
 /************************* DEFINES **********************************/
 #define CONVERT_NM_PER_M 1000000000
 #define CONVERT_UM_PER_M 1000000
 
+/* Number of rr nodes in each (possibly parallel) unit of work of power_usage_routing */
+#define POWER_RR_NODES_PER_PARTIAL 4096
+
 /************************* ENUMS ************************************/
 typedef enum {
 	POWER_BREAKDOWN_ENTRY_TYPE_TITLE = 0,
@@ -62,18 +72,69 @@ typedef enum {
 	POWER_BREAKDOWN_ENTRY_TYPE_BUFS_WIRES
 } e_power_breakdown_entry_type;
 
+/************************* STRUCTS **********************************/
+/**
+ * Power accumulated by one unit of work of power_usage_blocks() or
+ * power_usage_routing().  Units of work may run in parallel, each into its
+ * own partial; the partials are then merged into the global totals in a
+ * fixed order, so the results do not depend on the number of threads.
+ */
+struct t_power_partial {
+	t_power_usage total;
+
+	/* Usage by component type [0..POWER_COMPONENT_MAX_NUM-1] */
+	std::vector<t_power_usage> components;
+
+	/* Usage to add to pb_type, mode and interconnect totals, keyed by
+	 * the total it is to be added to */
+	std::unordered_map<t_power_usage *, t_power_usage> pb_usage;
+
+	/* Routing statistics */
+	int num_sb_buffers;
+	float total_sb_buffer_size;
+	int num_cb_buffers;
+	float total_cb_buffer_size;
+
+	t_power_deferred_logs logs;
+
+	t_power_partial() :
+			components(POWER_COMPONENT_MAX_NUM), num_sb_buffers(0), total_sb_buffer_size(
+					0.), num_cb_buffers(0), total_cb_buffer_size(0.) {
+		power_zero_usage(&total);
+		for (t_power_usage& component : components) {
+			power_zero_usage(&component);
+		}
+	}
+};
+
+/* Power of a batch of activity profiles, for the combined report */
+struct t_power_profile_result {
+	std::string activity_file;
+	e_power_ret_code ret_code;
+	t_power_usage total;
+	t_power_usage routing;
+	t_power_usage clock;
+	t_power_usage pb;
+};
+
 /************************* File Scope **********************************/
 static t_rr_node_power * rr_node_power;
 
+/* Power of an unused instance of each block type [0..num_block_types-1].
+ * It does not depend on the net activities, so it is only calculated once,
+ * and re-used by every call to power_total(). */
+static std::vector<t_power_partial> f_empty_block_power;
+
 /************************* Function Declarations ********************/
 /* Routing */
-static void power_usage_routing(t_power_usage * power_usage,
-		const t_det_routing_arch * routing_arch, t_segment_inf * segment_inf);
+static void power_usage_routing(t_power_usage * power_usage);
+static void power_usage_rr_node(t_power_partial * partial, int rr_node_idx);
 
 /* Tiles */
 static void power_usage_blocks(t_power_usage * power_usage);
-static void power_usage_pb(t_power_usage * power_usage, t_pb * pb,
-		t_pb_graph_node * pb_node, ClusterBlockId iblk);
+static void power_usage_pb(t_power_partial * partial,
+		t_power_usage * power_usage, t_pb * pb, t_pb_graph_node * pb_node,
+		ClusterBlockId iblk);
 static void power_usage_primitive(t_power_usage * power_usage, t_pb * pb,
 	t_pb_graph_node * pb_graph_node, ClusterBlockId iblk);
 static void power_reset_tile_usage();
@@ -88,6 +149,19 @@ static void power_usage_clock_single(t_power_usage * power_usage,
 		t_clock_network * clock_inf);
 
 /* Init/Uninit */
+static void power_partial_add_component(t_power_partial * partial,
+		t_power_usage * power_usage, e_power_component_type component_idx);
+static void power_partial_add_pb_usage(t_power_partial * partial,
+		t_power_usage * pb_usage, t_power_usage * power_usage);
+static void power_partial_add(t_power_partial * partial,
+		const t_power_partial& other);
+static void power_calc_empty_block_power();
+static void power_partial_merge(t_power_usage * power_usage,
+		t_power_partial * partial);
+template<typename Fn>
+static void power_for_each_partial(std::vector<t_power_partial>& partials,
+		const Fn& fn);
+static void power_reserve_local_mux_archs(t_pb_type * pb_type);
 static void dealloc_mux_graph(t_mux_node * node);
 static void dealloc_mux_graph_rec(t_mux_node * node);
 
@@ -103,6 +177,8 @@ static void power_print_breakdown_entry(FILE * fp, int indent,
 static void power_print_breakdown_component(FILE * fp, const char * name,
 		e_power_component_type type, int indent_level);
 static void power_print_breakdown_pb(FILE * fp);
+static void power_print_activity_profiles(FILE * fp,
+		const std::vector<t_power_profile_result>& results);
 
 static const char * power_estimation_method_name(
 		e_power_estimation_method power_method);
@@ -117,7 +193,9 @@ void power_init_pb_pins_rec(t_pb_graph_node * pb_node);
 void power_uninit_pb_pins_rec(t_pb_graph_node * pb_node);
 void power_pb_pins_init();
 void power_pb_pins_uninit();
-void power_routing_init(const t_det_routing_arch * routing_arch);
+void power_routing_init(const t_det_routing_arch * routing_arch,
+		t_segment_inf * segment_inf);
+void power_load_net_activity();
 
 /************************* FUNCTION DEFINITIONS *********************/
 /**
@@ -306,8 +384,9 @@ static void power_usage_local_buffers_and_wires(t_power_usage * power_usage,
  * - Call recursively for children
  * - If no children, must be a primitive.  Call primitive hander.
  */
-static void power_usage_pb(t_power_usage * power_usage, t_pb * pb,
-		t_pb_graph_node * pb_node, ClusterBlockId iblk) {
+static void power_usage_pb(t_power_partial * partial,
+		t_power_usage * power_usage, t_pb * pb, t_pb_graph_node * pb_node,
+		ClusterBlockId iblk) {
 
 	t_power_usage power_usage_bufs_wires;
 	t_power_usage power_usage_local_muxes;
@@ -356,7 +435,7 @@ static void power_usage_pb(t_power_usage * power_usage, t_pb * pb,
 
 	case POWER_METHOD_ABSOLUTE:
 		power_add_usage(power_usage, &pb_power->absolute_power_per_instance);
-		power_component_add_usage(&pb_power->absolute_power_per_instance,
+		power_partial_add_component(partial, &pb_power->absolute_power_per_instance,
 				POWER_COMPONENT_PB_OTHER);
 		break;
 
@@ -391,7 +470,7 @@ static void power_usage_pb(t_power_usage * power_usage, t_pb * pb,
 		power_add_usage(power_usage, &power_usage_sub);
 
 		// Add to component type
-		power_component_add_usage(&power_usage_sub, POWER_COMPONENT_PB_OTHER);
+		power_partial_add_component(partial, &power_usage_sub, POWER_COMPONENT_PB_OTHER);
 		break;
 
 	case POWER_METHOD_TOGGLE_PINS:
@@ -438,7 +517,7 @@ static void power_usage_pb(t_power_usage * power_usage, t_pb * pb,
 		power_add_usage(power_usage, &power_usage_pin_toggle);
 
 		// Add to component type power
-		power_component_add_usage(&power_usage_pin_toggle,
+		power_partial_add_component(partial, &power_usage_pin_toggle,
 				POWER_COMPONENT_PB_OTHER);
 		break;
 	case POWER_METHOD_SPECIFY_SIZES:
@@ -477,7 +556,7 @@ static void power_usage_pb(t_power_usage * power_usage, t_pb * pb,
 			power_add_usage(power_usage, &power_usage_sub);
 
 			// Add to power of component type
-			power_component_add_usage(&power_usage_sub,
+			power_partial_add_component(partial, &power_usage_sub,
 					POWER_COMPONENT_PB_PRIMITIVES);
 
 		}
@@ -493,9 +572,9 @@ static void power_usage_pb(t_power_usage * power_usage, t_pb * pb,
 			/* Check pins of all interconnect */
 			power_usage_local_buffers_and_wires(&power_usage_bufs_wires, pb,
 					pb_node, iblk);
-			power_component_add_usage(&power_usage_bufs_wires,
+			power_partial_add_component(partial, &power_usage_bufs_wires,
 					POWER_COMPONENT_PB_BUFS_WIRE);
-			power_add_usage(
+			power_partial_add_pb_usage(partial,
 					&pb_node->pb_type->pb_type_power->power_usage_bufs_wires,
 					&power_usage_bufs_wires);
 			power_add_usage(power_usage, &power_usage_bufs_wires);
@@ -511,16 +590,21 @@ static void power_usage_pb(t_power_usage * power_usage, t_pb * pb,
 						&pb_node->interconnect_pins[pb_mode][interc_idx], iblk);
 				power_add_usage(&power_usage_local_muxes, &power_usage_sub);
 
+				// Add to power of this interconnect
+				power_partial_add_pb_usage(partial,
+						&pb_node->interconnect_pins[pb_mode][interc_idx].interconnect->interconnect_power->power_usage,
+						&power_usage_sub);
+
 			}
 			// Add to power of this PB
 			power_add_usage(power_usage, &power_usage_local_muxes);
 
 			// Add to component type power
-			power_component_add_usage(&power_usage_local_muxes,
+			power_partial_add_component(partial, &power_usage_local_muxes,
 					POWER_COMPONENT_PB_INTERC_MUXES);
 
 			// Add to power of this mode
-			power_add_usage(
+			power_partial_add_pb_usage(partial,
 					&pb_node->pb_type->modes[pb_mode].mode_power->power_usage,
 					&power_usage_local_muxes);
 		}
@@ -546,7 +630,7 @@ static void power_usage_pb(t_power_usage * power_usage, t_pb * pb,
 					child_pb_graph_node =
 							&pb_node->child_pb_graph_nodes[pb_mode][pb_type_idx][pb_idx];
 
-					power_usage_pb(&power_usage_sub, child_pb,
+					power_usage_pb(partial, &power_usage_sub, child_pb,
 							child_pb_graph_node, iblk);
 					power_add_usage(&power_usage_children, &power_usage_sub);
 				}
@@ -555,13 +639,14 @@ static void power_usage_pb(t_power_usage * power_usage, t_pb * pb,
 			power_add_usage(power_usage, &power_usage_children);
 
 			// Add to power of this mode
-			power_add_usage(
+			power_partial_add_pb_usage(partial,
 					&pb_node->pb_type->modes[pb_mode].mode_power->power_usage,
 					&power_usage_children);
 		}
 	}
 
-	power_add_usage(&pb_node->pb_type->pb_type_power->power_usage, power_usage);
+	power_partial_add_pb_usage(partial,
+			&pb_node->pb_type->pb_type_power->power_usage, power_usage);
 }
 
 /* Resets the power stats for all physical blocks */
@@ -607,7 +692,8 @@ static void power_reset_tile_usage() {
 }
 
 /*
- * Calcultes the power usage of all tiles in the FPGA
+ * Calcultes the power usage of all tiles in the FPGA.
+ * Each column of the grid is a separate unit of work, which may run in parallel.
  */
 static void power_usage_blocks(t_power_usage * power_usage) {
     auto& device_ctx = g_vpr_ctx.device();
@@ -618,8 +704,24 @@ static void power_usage_blocks(t_power_usage * power_usage) {
 
 	power_reset_tile_usage();
 
+	/* Make sure all local interconnect multiplexers are built up-front,
+	 * as they can not be built while the columns are processed */
+	for (int type_idx = 0; type_idx < device_ctx.num_block_types; type_idx++) {
+		if (device_ctx.block_types[type_idx].pb_type) {
+			power_reserve_local_mux_archs(device_ctx.block_types[type_idx].pb_type);
+		}
+	}
+
+	if (f_empty_block_power.empty()) {
+		power_calc_empty_block_power();
+	}
+
+	std::vector<t_power_partial> partials(device_ctx.grid.width());
+
 	/* Loop through all grid locations */
-	for (size_t x = 0; x < device_ctx.grid.width(); x++) {
+	power_for_each_partial(partials, [&](size_t x) {
+		t_power_partial * partial = &partials[x];
+
 		for (size_t y = 0; y < device_ctx.grid.height(); y++) {
 
 			if ((device_ctx.grid[x][y].width_offset != 0)
@@ -637,15 +739,191 @@ static void power_usage_blocks(t_power_usage * power_usage) {
 				if (iblk != EMPTY_BLOCK_ID && iblk != INVALID_BLOCK_ID)
 					pb = cluster_ctx.clb_nlist.block_pb(iblk);
 
+				if (!pb) {
+					/* Unused block, re-use its cached power */
+					power_partial_add(partial,
+							f_empty_block_power[device_ctx.grid[x][y].type->index]);
+					continue;
+				}
+
 				/* Calculate power of this CLB */
-				power_usage_pb(&pb_power, pb, device_ctx.grid[x][y].type->pb_graph_head, iblk);
-				power_add_usage(power_usage, &pb_power);
+				power_usage_pb(partial, &pb_power, pb, device_ctx.grid[x][y].type->pb_graph_head, iblk);
+				power_add_usage(&partial->total, &pb_power);
 			}
 		}
+	});
+
+	for (t_power_partial& partial : partials) {
+		power_partial_merge(power_usage, &partial);
 	}
 	return;
 }
 
+/**
+ * Calculates the power of an unused instance of each block type.  An unused
+ * block only leaks (its pins are assumed static, pulled up), so its power
+ * does not depend on the activity of the nets.
+ */
+static void power_calc_empty_block_power() {
+    auto& device_ctx = g_vpr_ctx.device();
+
+	f_empty_block_power.clear();
+	f_empty_block_power.resize(device_ctx.num_block_types);
+
+	for (int type_idx = 0; type_idx < device_ctx.num_block_types; type_idx++) {
+		t_type_ptr type = &device_ctx.block_types[type_idx];
+		t_power_partial * partial = &f_empty_block_power[type_idx];
+
+		if (!type->pb_graph_head) {
+			continue;
+		}
+
+		power_log_defer(&partial->logs);
+		power_usage_pb(partial, &partial->total, nullptr, type->pb_graph_head,
+				ClusterBlockId::INVALID());
+		power_log_defer(nullptr);
+	}
+}
+
+/**
+ * Builds the multiplexer architectures used by the local interconnect of
+ * a pb_type (and its children), so that power_get_mux_arch() does not modify
+ * them while blocks are processed in parallel.
+ */
+static void power_reserve_local_mux_archs(t_pb_type * pb_type) {
+	auto& power_ctx = g_vpr_ctx.power();
+
+	for (int mode_idx = 0; mode_idx < pb_type->num_modes; mode_idx++) {
+		t_mode * mode = &pb_type->modes[mode_idx];
+
+		for (int interc_idx = 0; interc_idx < mode->num_interconnect;
+				interc_idx++) {
+			t_interconnect * interc = &mode->interconnect[interc_idx];
+			t_interconnect_power * interc_power = interc->interconnect_power;
+			if ((interc->type == MUX_INTERC || interc->type == COMPLETE_INTERC)
+					&& interc_power && interc_power->port_info_initialized) {
+				power_get_mux_arch(interc_power->num_input_ports,
+						power_ctx.arch->mux_transistor_size);
+			}
+		}
+
+		for (int child_idx = 0; child_idx < mode->num_pb_type_children;
+				child_idx++) {
+			power_reserve_local_mux_archs(&mode->pb_type_children[child_idx]);
+		}
+	}
+}
+
+/**
+ * Adds power usage for a component to a partial
+ * - partial: The partial to add to
+ * - power_usage: Power usage to add
+ * - component_idx: Type of component
+ */
+static void power_partial_add_component(t_power_partial * partial,
+		t_power_usage * power_usage, e_power_component_type component_idx) {
+	power_add_usage(&partial->components[component_idx], power_usage);
+}
+
+/**
+ * Adds power usage of a pb_type, mode or interconnect to a partial
+ * - partial: The partial to add to
+ * - pb_usage: The pb_type, mode or interconnect total that it belongs to
+ * - power_usage: Power usage to add
+ */
+static void power_partial_add_pb_usage(t_power_partial * partial,
+		t_power_usage * pb_usage, t_power_usage * power_usage) {
+	auto result = partial->pb_usage.emplace(pb_usage, *power_usage);
+	if (!result.second) {
+		power_add_usage(&result.first->second, power_usage);
+	}
+}
+
+/**
+ * Adds all power usage of one partial to another
+ * - partial: The partial to add to
+ * - other: The partial to add
+ */
+static void power_partial_add(t_power_partial * partial,
+		const t_power_partial& other) {
+	power_add_usage(&partial->total, &other.total);
+
+	for (int component_idx = 0; component_idx < POWER_COMPONENT_MAX_NUM;
+			component_idx++) {
+		power_add_usage(&partial->components[component_idx],
+				&other.components[component_idx]);
+	}
+
+	for (auto& pb_usage : other.pb_usage) {
+		t_power_usage usage = pb_usage.second;
+		power_partial_add_pb_usage(partial, pb_usage.first, &usage);
+	}
+
+	partial->num_sb_buffers += other.num_sb_buffers;
+	partial->total_sb_buffer_size += other.total_sb_buffer_size;
+	partial->num_cb_buffers += other.num_cb_buffers;
+	partial->total_cb_buffer_size += other.total_cb_buffer_size;
+
+	partial->logs.insert(partial->logs.end(), other.logs.begin(),
+			other.logs.end());
+}
+
+/**
+ * Merges a partial into the global totals
+ * - power_usage: (Return value) The total to add the partial's total to
+ * - partial: The partial to merge
+ */
+static void power_partial_merge(t_power_usage * power_usage,
+		t_power_partial * partial) {
+    auto& power_ctx = g_vpr_ctx.power();
+
+	power_add_usage(power_usage, &partial->total);
+
+	for (int component_idx = 0; component_idx < POWER_COMPONENT_MAX_NUM;
+			component_idx++) {
+		power_component_add_usage(&partial->components[component_idx],
+				(e_power_component_type) component_idx);
+	}
+
+	/* Each total only receives the usage from this partial, so the order
+	 * totals are visited in does not affect the results */
+	for (auto& pb_usage : partial->pb_usage) {
+		power_add_usage(pb_usage.first, &pb_usage.second);
+	}
+
+	power_ctx.commonly_used->num_sb_buffers += partial->num_sb_buffers;
+	power_ctx.commonly_used->total_sb_buffer_size +=
+			partial->total_sb_buffer_size;
+	power_ctx.commonly_used->num_cb_buffers += partial->num_cb_buffers;
+	power_ctx.commonly_used->total_cb_buffer_size +=
+			partial->total_cb_buffer_size;
+
+	power_log_replay(partial->logs);
+}
+
+/**
+ * Calls fn(partial_idx) for each partial, in parallel if VPR is built with
+ * TBB (using the worker threads set up by --num_workers).  Messages logged
+ * by fn are deferred into the partial's logs.
+ */
+template<typename Fn>
+static void power_for_each_partial(std::vector<t_power_partial>& partials,
+		const Fn& fn) {
+	auto run_partial = [&](size_t partial_idx) {
+		power_log_defer(&partials[partial_idx].logs);
+		fn(partial_idx);
+		power_log_defer(nullptr);
+	};
+
+#if defined(TATUM_USE_TBB)
+	tbb::parallel_for(size_t(0), partials.size(), run_partial);
+#else
+	for (size_t partial_idx = 0; partial_idx < partials.size(); partial_idx++) {
+		run_partial(partial_idx);
+	}
+#endif
+}
+
 /**
  * Calculates the total power usage from the clock network
  */
@@ -788,8 +1066,7 @@ static void dealloc_mux_graph_rec(t_mux_node * node) {
 /**
  * Calculates the power of the entire routing fabric (not local routing
  */
-static void power_usage_routing(t_power_usage * power_usage,
-		const t_det_routing_arch * routing_arch, t_segment_inf * segment_inf) {
+static void power_usage_routing(t_power_usage * power_usage) {
 	int edge_idx;
     auto& power_ctx = g_vpr_ctx.power();
     auto& cluster_ctx = g_vpr_ctx.clustering();
@@ -865,185 +1142,159 @@ static void power_usage_routing(t_power_usage * power_usage,
 		}
 	}
 
-	/* Calculate power of all routing entities */
+	/* Make sure all routing multiplexers are built up-front, as they can not
+	 * be built while the rr nodes are processed */
+	int max_fan_in = 0;
 	for (size_t rr_node_idx = 0; rr_node_idx < device_ctx.rr_nodes.size(); rr_node_idx++) {
-		t_power_usage sub_power_usage;
 		auto node = &device_ctx.rr_nodes[rr_node_idx];
-		t_rr_node_power * node_power = &rr_node_power[rr_node_idx];
-		float C_wire;
-		float buffer_size;
-		int switch_idx;
-		int connectionbox_fanout;
-		int switchbox_fanout;
-		//float C_per_seg_split;
-		int wire_length;
+		if (node->type() == CHANX || node->type() == CHANY || node->type() == IPIN) {
+			max_fan_in = max(max_fan_in, (int) node->fan_in());
+		}
+	}
+	if (max_fan_in > 0) {
+		power_get_mux_arch(max_fan_in, power_ctx.arch->mux_transistor_size);
+	}
 
-		switch (node->type()) {
-		case SOURCE:
-		case SINK:
-		case OPIN:
-			/* No power usage for these types */
-			break;
-		case IPIN:
-			/* This is part of the connectionbox.  The connection box is comprised of:
-			 *  - Driver (accounted for at end of CHANX/Y - see below)
-			 *  - Multiplexor */
+	/* Calculate power of all routing entities, in (possibly parallel) chunks of rr nodes */
+	size_t num_rr_nodes = device_ctx.rr_nodes.size();
+	std::vector<t_power_partial> partials(
+			(num_rr_nodes + POWER_RR_NODES_PER_PARTIAL - 1)
+					/ POWER_RR_NODES_PER_PARTIAL);
 
-			if (node->fan_in()) {
-				VTR_ASSERT(node_power->in_dens);
-				VTR_ASSERT(node_power->in_prob);
-
-				/* Multiplexor */
-				power_usage_mux_multilevel(&sub_power_usage,
-						power_get_mux_arch(node->fan_in(),
-								power_ctx.arch->mux_transistor_size),
-						node_power->in_prob, node_power->in_dens,
-						node_power->selected_input, true,
-						power_ctx.solution_inf.T_crit);
-				power_add_usage(power_usage, &sub_power_usage);
-				power_component_add_usage(&sub_power_usage,
-						POWER_COMPONENT_ROUTE_CB);
-			}
-			break;
-		case CHANX:
-		case CHANY:
-			/* This is a wire driven by a switchbox, which includes:
-			 * 	- The Multiplexor at the beginning of the wire
-			 * 	- A buffer, after the mux to drive the wire
-			 * 	- The wire itself
-			 * 	- A buffer at the end of the wire, going to switchbox/connectionbox */
+	power_for_each_partial(partials, [&](size_t partial_idx) {
+		size_t first_node = partial_idx * POWER_RR_NODES_PER_PARTIAL;
+		size_t last_node = min(first_node + POWER_RR_NODES_PER_PARTIAL, num_rr_nodes);
+
+		for (size_t rr_node_idx = first_node; rr_node_idx < last_node; rr_node_idx++) {
+			power_usage_rr_node(&partials[partial_idx], rr_node_idx);
+		}
+	});
+
+	for (t_power_partial& partial : partials) {
+		power_partial_merge(power_usage, &partial);
+	}
+}
+
+/**
+ * Calculates the power of a single routing resource
+ * - partial: (Return value) The partial to add the power to
+ * - rr_node_idx: The routing resource
+ */
+static void power_usage_rr_node(t_power_partial * partial, int rr_node_idx) {
+	t_power_usage sub_power_usage;
+    auto& power_ctx = g_vpr_ctx.power();
+    auto& device_ctx = g_vpr_ctx.device();
+
+	auto node = &device_ctx.rr_nodes[rr_node_idx];
+	t_rr_node_power * node_power = &rr_node_power[rr_node_idx];
+
+	switch (node->type()) {
+	case SOURCE:
+	case SINK:
+	case OPIN:
+		/* No power usage for these types */
+		break;
+	case IPIN:
+		/* This is part of the connectionbox.  The connection box is comprised of:
+		 *  - Driver (accounted for at end of CHANX/Y - see below)
+		 *  - Multiplexor */
+
+		if (node->fan_in()) {
 			VTR_ASSERT(node_power->in_dens);
 			VTR_ASSERT(node_power->in_prob);
 
-			wire_length = 0;
-			if (node->type() == CHANX) {
-				wire_length = node->xhigh() - node->xlow() + 1;
-			} else if (node->type() == CHANY) {
-				wire_length = node->yhigh() - node->ylow() + 1;
-			}
-			C_wire =
-					wire_length
-							* segment_inf[device_ctx.rr_indexed_data[node->cost_index()].seg_index].Cmetal;
-			//(double)power_ctx.commonly_used->tile_length);
-			VTR_ASSERT(node_power->selected_input < node->fan_in());
-
 			/* Multiplexor */
 			power_usage_mux_multilevel(&sub_power_usage,
 					power_get_mux_arch(node->fan_in(),
 							power_ctx.arch->mux_transistor_size),
 					node_power->in_prob, node_power->in_dens,
-					node_power->selected_input, true, power_ctx.solution_inf.T_crit);
-			power_add_usage(power_usage, &sub_power_usage);
-			power_component_add_usage(&sub_power_usage,
-					POWER_COMPONENT_ROUTE_SB);
-
-			/* Buffer Size */
-			switch (device_ctx.rr_switch_inf[node_power->driver_switch_type].power_buffer_type) {
-			case POWER_BUFFER_TYPE_AUTO:
-				/*
-				 C_per_seg_split = ((float) node->num_edges
-				 * power_ctx.commonly_used->INV_1X_C_in + C_wire);
-				 // / (float) power_ctx.arch->seg_buffer_split;
-				 buffer_size = power_buffer_size_from_logical_effort(
-				 C_per_seg_split);
-				 buffer_size = max(buffer_size, 1.0F);
-				 */
-				buffer_size = power_calc_buffer_size_from_Cout(
-						device_ctx.rr_switch_inf[node_power->driver_switch_type].Cout);
-				break;
-			case POWER_BUFFER_TYPE_ABSOLUTE_SIZE:
-				buffer_size =
-						device_ctx.rr_switch_inf[node_power->driver_switch_type].power_buffer_size;
-				buffer_size = max(buffer_size, 1.0F);
-				break;
-			case POWER_BUFFER_TYPE_NONE:
-				buffer_size = 0.;
-				break;
-			default:
-				buffer_size = 0.;
-				VTR_ASSERT(0);
-				break;
-			}
-
-			power_ctx.commonly_used->num_sb_buffers++;
-			power_ctx.commonly_used->total_sb_buffer_size += buffer_size;
+					node_power->selected_input, true,
+					power_ctx.solution_inf.T_crit);
+			power_add_usage(&partial->total, &sub_power_usage);
+			power_partial_add_component(partial, &sub_power_usage,
+					POWER_COMPONENT_ROUTE_CB);
+		}
+		break;
+	case CHANX:
+	case CHANY:
+		/* This is a wire driven by a switchbox, which includes:
+		 * 	- The Multiplexor at the beginning of the wire
+		 * 	- A buffer, after the mux to drive the wire
+		 * 	- The wire itself
+		 * 	- A buffer at the end of the wire, going to switchbox/connectionbox */
+		VTR_ASSERT(node_power->in_dens);
+		VTR_ASSERT(node_power->in_prob);
+
+		VTR_ASSERT(node_power->selected_input < node->fan_in());
+
+		/* Multiplexor */
+		power_usage_mux_multilevel(&sub_power_usage,
+				power_get_mux_arch(node->fan_in(),
+						power_ctx.arch->mux_transistor_size),
+				node_power->in_prob, node_power->in_dens,
+				node_power->selected_input, true, power_ctx.solution_inf.T_crit);
+		power_add_usage(&partial->total, &sub_power_usage);
+		power_partial_add_component(partial, &sub_power_usage,
+				POWER_COMPONENT_ROUTE_SB);
+
+		partial->num_sb_buffers++;
+		partial->total_sb_buffer_size += node_power->driver_buffer_size;
 
-			/*
-			 power_ctx.commonly_used->num_sb_buffers +=
-			 power_ctx.arch->seg_buffer_split;
-			 power_ctx.commonly_used->total_sb_buffer_size += buffer_size
-			 * power_ctx.arch->seg_buffer_split;
-			 */
+		/*
+		 power_ctx.commonly_used->num_sb_buffers +=
+		 power_ctx.arch->seg_buffer_split;
+		 power_ctx.commonly_used->total_sb_buffer_size += buffer_size
+		 * power_ctx.arch->seg_buffer_split;
+		 */
 
-			/* Buffer */
-			power_usage_buffer(&sub_power_usage, buffer_size,
-					node_power->in_prob[node_power->selected_input],
-					node_power->in_dens[node_power->selected_input], true,
+		/* Buffer */
+		power_usage_buffer(&sub_power_usage, node_power->driver_buffer_size,
+				node_power->in_prob[node_power->selected_input],
+				node_power->in_dens[node_power->selected_input], true,
+				power_ctx.solution_inf.T_crit);
+		power_add_usage(&partial->total, &sub_power_usage);
+		power_partial_add_component(partial, &sub_power_usage,
+				POWER_COMPONENT_ROUTE_SB);
+
+		/* Wire Capacitance */
+		power_usage_wire(&sub_power_usage, node_power->C_wire,
+				clb_net_density(node_power->net_num), power_ctx.solution_inf.T_crit);
+		power_add_usage(&partial->total, &sub_power_usage);
+		power_partial_add_component(partial, &sub_power_usage,
+				POWER_COMPONENT_ROUTE_GLB_WIRE);
+
+		/* Buffer to next Switchbox */
+		if (node_power->drives_sb) {
+			power_usage_buffer(&sub_power_usage, node_power->sb_buffer_size,
+					1 - node_power->in_prob[node_power->selected_input],
+					node_power->in_dens[node_power->selected_input], false,
 					power_ctx.solution_inf.T_crit);
-			power_add_usage(power_usage, &sub_power_usage);
-			power_component_add_usage(&sub_power_usage,
+			power_add_usage(&partial->total, &sub_power_usage);
+			power_partial_add_component(partial, &sub_power_usage,
 					POWER_COMPONENT_ROUTE_SB);
+		}
 
-			/* Wire Capacitance */
-			power_usage_wire(&sub_power_usage, C_wire,
-					clb_net_density(node_power->net_num), power_ctx.solution_inf.T_crit);
-			power_add_usage(power_usage, &sub_power_usage);
-			power_component_add_usage(&sub_power_usage,
-					POWER_COMPONENT_ROUTE_GLB_WIRE);
-
-			/* Determine types of switches that this wire drives */
-			connectionbox_fanout = 0;
-			switchbox_fanout = 0;
-			for (switch_idx = 0; switch_idx < node->num_edges(); switch_idx++) {
-				if (node->edge_switch(switch_idx) == routing_arch->wire_to_rr_ipin_switch) {
-					connectionbox_fanout++;
-				} else if (node->edge_switch(switch_idx) == routing_arch->delayless_switch) {
-					/* Do nothing */
-				} else {
-					switchbox_fanout++;
-				}
-			}
-
-			/* Buffer to next Switchbox */
-			if (switchbox_fanout) {
-				buffer_size = power_buffer_size_from_logical_effort(
-						switchbox_fanout * power_ctx.commonly_used->NMOS_1X_C_d);
-				power_usage_buffer(&sub_power_usage, buffer_size,
-						1 - node_power->in_prob[node_power->selected_input],
-						node_power->in_dens[node_power->selected_input], false,
-						power_ctx.solution_inf.T_crit);
-				power_add_usage(power_usage, &sub_power_usage);
-				power_component_add_usage(&sub_power_usage,
-						POWER_COMPONENT_ROUTE_SB);
-			}
-
-			/* Driver for ConnectionBox */
-			if (connectionbox_fanout) {
-
-				buffer_size = power_buffer_size_from_logical_effort(
-						connectionbox_fanout
-								* power_ctx.commonly_used->NMOS_1X_C_d);
-
-				power_usage_buffer(&sub_power_usage, buffer_size,
-						1 - node_power->in_prob[node_power->selected_input],
-						node_power->in_dens[node_power->selected_input],
-						false, power_ctx.solution_inf.T_crit);
-				power_add_usage(power_usage, &sub_power_usage);
-				power_component_add_usage(&sub_power_usage,
-						POWER_COMPONENT_ROUTE_CB);
-
-				power_ctx.commonly_used->num_cb_buffers++;
-				power_ctx.commonly_used->total_cb_buffer_size += buffer_size;
-			}
-			break;
-		case INTRA_CLUSTER_EDGE:
-			VTR_ASSERT(0);
-			break;
-		default:
-			power_log_msg(POWER_LOG_WARNING,
-					"The global routing-resource graph contains an unknown node type.");
-			break;
+		/* Driver for ConnectionBox */
+		if (node_power->drives_cb) {
+			power_usage_buffer(&sub_power_usage, node_power->cb_buffer_size,
+					1 - node_power->in_prob[node_power->selected_input],
+					node_power->in_dens[node_power->selected_input],
+					false, power_ctx.solution_inf.T_crit);
+			power_add_usage(&partial->total, &sub_power_usage);
+			power_partial_add_component(partial, &sub_power_usage,
+					POWER_COMPONENT_ROUTE_CB);
+
+			partial->num_cb_buffers++;
+			partial->total_cb_buffer_size += node_power->cb_buffer_size;
 		}
+		break;
+	case INTRA_CLUSTER_EDGE:
+		VTR_ASSERT(0);
+		break;
+	default:
+		power_log_msg(POWER_LOG_WARNING,
+				"The global routing-resource graph contains an unknown node type.");
+		break;
 	}
 }
 
@@ -1200,18 +1451,14 @@ void power_pb_pins_uninit() {
 	}
 }
 
-void power_routing_init(const t_det_routing_arch * routing_arch) {
-	int max_fanin;
-	int max_IPIN_fanin;
-	int max_seg_to_IPIN_fanout;
-	int max_seg_to_seg_fanout;
-	int max_seg_fanout;
+/**
+ * Copies the probability/density of the atom nets to the clustered nets
+ */
+void power_load_net_activity() {
     auto& power_ctx = g_vpr_ctx.mutable_power();
-    auto& device_ctx = g_vpr_ctx.device();
     auto& cluster_ctx = g_vpr_ctx.clustering();
     auto& atom_ctx = g_vpr_ctx.atom();
 
-	/* Copy probability/density values to new netlist */
 	if (power_ctx.clb_net_power.size() == 0) {
 		power_ctx.clb_net_power.resize(cluster_ctx.clb_nlist.nets().size());
 	}
@@ -1219,6 +1466,20 @@ void power_routing_init(const t_det_routing_arch * routing_arch) {
 		power_ctx.clb_net_power[net_id].probability = power_ctx.atom_net_power[atom_ctx.lookup.atom_net(net_id)].probability;
 		power_ctx.clb_net_power[net_id].density = power_ctx.atom_net_power[atom_ctx.lookup.atom_net(net_id)].density;
 	}
+}
+
+void power_routing_init(const t_det_routing_arch * routing_arch,
+		t_segment_inf * segment_inf) {
+	int max_fanin;
+	int max_IPIN_fanin;
+	int max_seg_to_IPIN_fanout;
+	int max_seg_to_seg_fanout;
+	int max_seg_fanout;
+    auto& power_ctx = g_vpr_ctx.mutable_power();
+    auto& device_ctx = g_vpr_ctx.device();
+
+	/* Copy probability/density values to new netlist */
+	power_load_net_activity();
 
 	/* Initialize RR Graph Structures */
 	rr_node_power = (t_rr_node_power*) vtr::calloc(device_ctx.rr_nodes.size(),
@@ -1319,6 +1580,84 @@ void power_routing_init(const t_det_routing_arch * routing_arch) {
 		}
 	}
 	power_ctx.commonly_used->max_seg_fanout = max_seg_fanout;
+
+	/* Wire capacitances and buffer sizes do not depend on the net activities,
+	 * so they are found once here rather than each time power is estimated */
+	for (size_t rr_node_idx = 0; rr_node_idx < device_ctx.rr_nodes.size(); rr_node_idx++) {
+		auto node = &device_ctx.rr_nodes[rr_node_idx];
+		t_rr_node_power * node_power = &rr_node_power[rr_node_idx];
+		int wire_length;
+		int switchbox_fanout = 0;
+		int connectionbox_fanout = 0;
+		float buffer_size;
+
+		if (node->type() != CHANX && node->type() != CHANY) {
+			continue;
+		}
+
+		/* Wire Capacitance */
+		if (node->type() == CHANX) {
+			wire_length = node->xhigh() - node->xlow() + 1;
+		} else {
+			wire_length = node->yhigh() - node->ylow() + 1;
+		}
+		node_power->C_wire =
+				wire_length
+						* segment_inf[device_ctx.rr_indexed_data[node->cost_index()].seg_index].Cmetal;
+
+		/* Buffer after the switchbox mux */
+		if (node_power->driver_switch_type == OPEN) {
+			/* Undriven wire, never selected by a route */
+			buffer_size = 0.;
+		} else {
+			switch (device_ctx.rr_switch_inf[node_power->driver_switch_type].power_buffer_type) {
+			case POWER_BUFFER_TYPE_AUTO:
+				buffer_size = power_calc_buffer_size_from_Cout(
+						device_ctx.rr_switch_inf[node_power->driver_switch_type].Cout);
+				break;
+			case POWER_BUFFER_TYPE_ABSOLUTE_SIZE:
+				buffer_size =
+						device_ctx.rr_switch_inf[node_power->driver_switch_type].power_buffer_size;
+				buffer_size = max(buffer_size, 1.0F);
+				break;
+			case POWER_BUFFER_TYPE_NONE:
+				buffer_size = 0.;
+				break;
+			default:
+				buffer_size = 0.;
+				VTR_ASSERT(0);
+				break;
+			}
+		}
+		node_power->driver_buffer_size = buffer_size;
+
+		/* Determine types of switches that this wire drives */
+		for (int switch_idx = 0; switch_idx < node->num_edges(); switch_idx++) {
+			if (node->edge_switch(switch_idx) == routing_arch->wire_to_rr_ipin_switch) {
+				connectionbox_fanout++;
+			} else if (node->edge_switch(switch_idx) == routing_arch->delayless_switch) {
+				/* Do nothing */
+			} else {
+				switchbox_fanout++;
+			}
+		}
+
+		/* Buffer to next Switchbox */
+		node_power->drives_sb = (switchbox_fanout > 0);
+		node_power->sb_buffer_size = 0.;
+		if (node_power->drives_sb) {
+			node_power->sb_buffer_size = power_buffer_size_from_logical_effort(
+					switchbox_fanout * power_ctx.commonly_used->NMOS_1X_C_d);
+		}
+
+		/* Driver for ConnectionBox */
+		node_power->drives_cb = (connectionbox_fanout > 0);
+		node_power->cb_buffer_size = 0.;
+		if (node_power->drives_cb) {
+			node_power->cb_buffer_size = power_buffer_size_from_logical_effort(
+					connectionbox_fanout * power_ctx.commonly_used->NMOS_1X_C_d);
+		}
+	}
 }
 
 /**
@@ -1360,12 +1699,13 @@ bool power_init(const char * power_out_filepath,
 
 	/* Initialize sub-modules */
 	power_components_init();
+	f_empty_block_power.clear();
 
 	/* Perform callibration */
 	power_callibrate();
 
 	/* Initialize routing information */
-	power_routing_init(routing_arch);
+	power_routing_init(routing_arch, arch->Segments);
 
     // Allocates power structures for each pb pin
 	power_pb_pins_init();
@@ -1409,6 +1749,7 @@ bool power_uninit() {
 		}
 	}
 	free(rr_node_power);
+	f_empty_block_power.clear();
 
 	/* Free mux architectures */
 	for (std::map<float, t_power_mux_info*>::iterator it =
@@ -1767,7 +2108,7 @@ e_power_ret_code power_total(float * run_time_s, const t_vpr_setup& vpr_setup,
 
 	/* Calculate Power */
 	/* Routing */
-	power_usage_routing(&sub_power_usage, routing_arch, arch->Segments);
+	power_usage_routing(&sub_power_usage);
 	power_add_usage(&total_power, &sub_power_usage);
 	power_component_add_usage(&sub_power_usage, POWER_COMPONENT_ROUTING);
 
@@ -1816,6 +2157,103 @@ e_power_ret_code power_total(float * run_time_s, const t_vpr_setup& vpr_setup,
 	}
 }
 
+/*
+ * Top-level function for the power module, for several activity profiles
+ * (for example, the workloads of a design) of the same implementation.
+ * The power for each activity file is calculated and reported as by
+ * power_total(), re-using everything that does not depend on the net
+ * activities, followed by a combined summary of all profiles.
+ * - run_time_s: (Return value) The total runtime in seconds (us accuracy)
+ * - activity_files: The activity files, in the order they are reported
+ */
+e_power_ret_code power_total_activity_profiles(float * run_time_s,
+		const t_vpr_setup& vpr_setup, const t_arch * arch,
+		const t_det_routing_arch * routing_arch,
+		const std::vector<std::string>& activity_files) {
+	std::vector<t_power_profile_result> results;
+	e_power_ret_code ret_code = POWER_RET_CODE_SUCCESS;
+	clock_t t_start;
+	clock_t t_end;
+    auto& power_ctx = g_vpr_ctx.mutable_power();
+    auto& atom_ctx = g_vpr_ctx.atom();
+
+	t_start = clock();
+
+	for (const std::string& activity_file : activity_files) {
+		t_power_profile_result result;
+		float profile_run_time_s;
+
+		power_ctx.atom_net_power = read_activity(atom_ctx.nlist,
+				activity_file.c_str());
+		power_load_net_activity();
+
+		/* Each profile is reported on its own */
+		power_components_reset();
+		power_log_clear();
+
+		std::string title = "Activity Profile: " + activity_file;
+		power_print_title(power_ctx.output->out, title.c_str());
+		fprintf(power_ctx.output->out, "\n");
+
+		result.activity_file = activity_file;
+		result.ret_code = power_total(&profile_run_time_s, vpr_setup, arch,
+				routing_arch);
+		result.total = power_ctx.by_component.components[POWER_COMPONENT_TOTAL];
+		result.routing =
+				power_ctx.by_component.components[POWER_COMPONENT_ROUTING];
+		result.clock = power_ctx.by_component.components[POWER_COMPONENT_CLOCK];
+		result.pb = power_ctx.by_component.components[POWER_COMPONENT_PB];
+		results.push_back(result);
+
+		/* Errors take precedence over warnings */
+		if (result.ret_code == POWER_RET_CODE_ERRORS
+				|| (result.ret_code == POWER_RET_CODE_WARNINGS
+						&& ret_code == POWER_RET_CODE_SUCCESS)) {
+			ret_code = result.ret_code;
+		}
+	}
+
+	power_print_title(power_ctx.output->out, "Activity Profile Summary");
+	power_print_activity_profiles(power_ctx.output->out, results);
+
+	t_end = clock();
+
+	*run_time_s = (float) (t_end - t_start) / CLOCKS_PER_SEC;
+
+	return ret_code;
+}
+
+/**
+ * Prints the power of each activity profile, side by side
+ * - fp: File descripter to print out to
+ * - results: The power of each activity profile
+ */
+static void power_print_activity_profiles(FILE * fp,
+		const std::vector<t_power_profile_result>& results) {
+	const int name_width = 32;
+
+	fprintf(fp, "%-*s%-12s%-12s%-12s%-12s%-12s%-12s\n\n", name_width,
+			"Activity File", "Total (W)", "Dynamic (W)", "Leakage (W)",
+			"Routing (W)", "PB (W)", "Clock (W)");
+
+	for (const t_power_profile_result& result : results) {
+		std::string name = vtr::basename(result.activity_file);
+		t_power_usage total = result.total;
+		t_power_usage routing = result.routing;
+		t_power_usage pb = result.pb;
+		t_power_usage clock = result.clock;
+
+		if (result.ret_code == POWER_RET_CODE_ERRORS) {
+			name += " (errors)";
+		}
+		fprintf(fp, "%-*s%-12.4g%-12.4g%-12.4g%-12.4g%-12.4g%-12.4g\n",
+				name_width, name.c_str(), power_sum_usage(&total),
+				total.dynamic, total.leakage, power_sum_usage(&routing),
+				power_sum_usage(&pb), power_sum_usage(&clock));
+	}
+	fprintf(fp, "\n");
+}
+
 /**
  * Prints the power usage for all components
  * - fp: File descripter to print out to
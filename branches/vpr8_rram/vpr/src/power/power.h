@@ -24,6 +24,8 @@
 
 /************************* INCLUDES *********************************/
 #include <list>
+#include <string>
+#include <vector>
 
 #include "vpr_types.h"
 #include "PowerSpicedComponent.h"
@@ -77,6 +79,7 @@ struct t_solution_inf;
 struct t_power_nmos_mux_inf;
 struct t_power_nmos_leakage_inf;
 struct t_power_mux_info;
+struct t_power_bracket_index;
 
 /* Information on the solution obtained by VPR */
 struct t_solution_inf {
@@ -105,6 +108,20 @@ struct t_transistor_size_inf {
 	float C_d;
 };
 
+/**
+ * Uniform grid over the keys of a sorted table (transistor sizes, voltages),
+ * built once the technology file is loaded.  Each cell records the last
+ * table entry lying in an earlier cell, so the entry bracketing a key is
+ * found by indexing the grid and stepping over the few entries sharing its
+ * cell, rather than by a binary search.
+ */
+struct t_power_bracket_index {
+	float min_key;
+	float inv_cell_width;
+	int num_cells;
+	int * cell_start;
+};
+
 /**
  * Transistor information
  */
@@ -112,6 +129,7 @@ struct t_transistor_inf {
 	int num_size_entries;
 	t_transistor_size_inf * size_inf; /* Array of transistor sizes */
 	t_transistor_size_inf * long_trans_inf; /* Long transistor (W=1,L=2) */
+	t_power_bracket_index size_index; /* Lookup index over size_inf */
 };
 
 struct t_power_nmos_mux_inf {
@@ -124,6 +142,7 @@ struct t_power_nmos_leakage_inf {
 	float nmos_size;
 	int num_leakage_pairs;
 	t_power_nmos_leakage_pair * leakage_pairs;
+	t_power_bracket_index v_ds_index; /* Lookup index over leakage_pairs */
 };
 
 /* CMOS technology properties, populated from data in xml file */
@@ -160,6 +179,7 @@ struct t_power_buffer_size_inf {
 struct t_power_mux_volt_inf {
 	int num_voltage_pairs;
 	t_power_mux_volt_pair * mux_voltage_pairs;
+	t_power_bracket_index v_in_index; /* Lookup index over mux_voltage_pairs */
 };
 
 /* Single I/O voltage for a single-level multiplexer */
@@ -272,6 +292,14 @@ struct t_rr_node_power {
 	short selected_input; /* Input index that is selected */
 	short driver_switch_type; /* Switch type that drives this resource */
 	bool visited; /* When traversing netlist, need to track whether the node has been processed */
+
+	/* Activity-independent properties of CHANX/CHANY wires, computed once by power_routing_init */
+	float C_wire; /* Wire capacitance */
+	float driver_buffer_size; /* Size of the buffer after the switchbox mux */
+	float sb_buffer_size; /* Size of the buffer to the next switchboxes (if drives_sb) */
+	float cb_buffer_size; /* Size of the buffer to the connection boxes (if drives_cb) */
+	bool drives_sb; /* Whether the wire drives any switchbox */
+	bool drives_cb; /* Whether the wire drives any connection box */
 };
 
 /* Architecture information for a multiplexer.
@@ -310,4 +338,10 @@ bool power_uninit();
 e_power_ret_code power_total(float * run_time_s, const t_vpr_setup& vpr_setup,
 		const t_arch * arch, const t_det_routing_arch * routing_arch);
 
+/* Top-Level Function, for several activity profiles of the same implementation */
+e_power_ret_code power_total_activity_profiles(float * run_time_s,
+		const t_vpr_setup& vpr_setup, const t_arch * arch,
+		const t_det_routing_arch * routing_arch,
+		const std::vector<std::string>& activity_files);
+
 #endif /* __POWER_H__ */
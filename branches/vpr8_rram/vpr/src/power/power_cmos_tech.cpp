@@ -24,6 +24,7 @@
 
 /************************* INCLUDES *********************************/
 #include <cstring>
+#include <algorithm>
 #include "vtr_assert.h"
 
 #include "pugixml.hpp"
@@ -46,11 +47,9 @@
 using namespace std;
 using namespace pugiutil;
 
-/************************* FILE SCOPE **********************************/
-static t_transistor_inf * f_transistor_last_searched;
-static t_power_buffer_strength_inf * f_buffer_strength_last_searched;
-static t_power_mux_volt_inf * f_mux_volt_last_searched;
-static t_power_nmos_leakage_inf * f_power_searching_nmos_leakage_info;
+/************************* DEFINES **********************************/
+/* Number of grid cells per table entry in a t_power_bracket_index */
+#define POWER_BRACKET_CELLS_PER_ENTRY 4
 
 /************************* FUNCTION DECLARATIONS ********************/
 
@@ -58,12 +57,14 @@ static void power_tech_load_xml_file(const char * cmos_tech_behavior_filepath);
 static void process_tech_xml_load_transistor_info(pugi::xml_node parent, const pugiutil::loc_data& loc_data);
 static void power_tech_xml_load_multiplexer_info(pugi::xml_node parent, const pugiutil::loc_data& loc_data);
 static void power_tech_xml_load_nmos_st_leakages(pugi::xml_node parent, const pugiutil::loc_data& loc_data);
-static int power_compare_transistor_size(const void * key_void, const void * elem_void);
-static int power_compare_voltage_pair(const void * key_void, const void * elem_void);
-static int power_compare_leakage_pair(const void * key_void, const void * elem_void);
 //static void power_tech_xml_load_sc(pugi::xml_node parent, const pugiutil::loc_data& loc_data);
-static int power_compare_buffer_strength(const void * key_void, const void * elem_void);
-static int power_compare_buffer_sc_levr(const void * key_void, const void * elem_void);
+static void power_tech_build_lookup_indices();
+template<typename T, typename KeyFn>
+static void power_bracket_index_build(t_power_bracket_index * index,
+		const T * entries, int num_entries, KeyFn key_of);
+template<typename T, typename KeyFn>
+static int power_bracket_find(const t_power_bracket_index * index,
+		const T * entries, int num_entries, KeyFn key_of, float key);
 static void power_tech_xml_load_components(pugi::xml_node parent, const pugiutil::loc_data& loc_data);
 static void power_tech_xml_load_component(pugi::xml_node parent, const pugiutil::loc_data& loc_data,
 		PowerSpicedComponent ** component, const char * name,
@@ -72,6 +73,7 @@ static void power_tech_xml_load_component(pugi::xml_node parent, const pugiutil:
 
 void power_tech_init(const char * cmos_tech_behavior_filepath) {
 	power_tech_load_xml_file(cmos_tech_behavior_filepath);
+	power_tech_build_lookup_indices();
 }
 
 /**
@@ -372,6 +374,127 @@ static void process_tech_xml_load_transistor_info(pugi::xml_node parent, const p
 	}
 }
 
+/**
+ * Builds the lookup indices over the transistor, leakage and multiplexer
+ * voltage tables, so that the power_find_* functions below do not need to
+ * binary search them on every call.
+ */
+static void power_tech_build_lookup_indices() {
+	auto& power_ctx = g_vpr_ctx.power();
+	t_transistor_inf * trans_infs[] = { &power_ctx.tech->NMOS_inf,
+			&power_ctx.tech->PMOS_inf };
+
+	for (t_transistor_inf * trans_inf : trans_infs) {
+		power_bracket_index_build(&trans_inf->size_index, trans_inf->size_inf,
+				trans_inf->num_size_entries,
+				[](const t_transistor_size_inf& e) {return e.size;});
+	}
+
+	for (int nmos_idx = 0; nmos_idx < power_ctx.tech->num_nmos_leakage_info;
+			nmos_idx++) {
+		t_power_nmos_leakage_inf * nmos_info =
+				&power_ctx.tech->nmos_leakage_info[nmos_idx];
+		power_bracket_index_build(&nmos_info->v_ds_index,
+				nmos_info->leakage_pairs, nmos_info->num_leakage_pairs,
+				[](const t_power_nmos_leakage_pair& e) {return e.v_ds;});
+	}
+
+	for (int nmos_idx = 0; nmos_idx < power_ctx.tech->num_nmos_mux_info;
+			nmos_idx++) {
+		t_power_nmos_mux_inf * nmos_inf = &power_ctx.tech->nmos_mux_info[nmos_idx];
+		for (int mux_size = 0; mux_size <= nmos_inf->max_mux_sl_size;
+				mux_size++) {
+			t_power_mux_volt_inf * volt_inf = &nmos_inf->mux_voltage_inf[mux_size];
+			power_bracket_index_build(&volt_inf->v_in_index,
+					volt_inf->mux_voltage_pairs, volt_inf->num_voltage_pairs,
+					[](const t_power_mux_volt_pair& e) {return e.v_in;});
+		}
+	}
+}
+
+/**
+ * Builds a uniform grid over the (sorted) keys of a table
+ * - index: (Return value) The index to build
+ * - entries: The table to index, sorted by increasing key
+ * - num_entries: Number of entries in the table
+ * - key_of: Returns the key of a table entry
+ */
+template<typename T, typename KeyFn>
+static void power_bracket_index_build(t_power_bracket_index * index,
+		const T * entries, int num_entries, KeyFn key_of) {
+	int entry_idx;
+	int cell;
+
+	index->cell_start = nullptr;
+	index->num_cells = 0;
+
+	if (num_entries <= 0 || entries == nullptr) {
+		return;
+	}
+
+	float min_key = key_of(entries[0]);
+	float max_key = key_of(entries[num_entries - 1]);
+
+	index->min_key = min_key;
+	index->num_cells = POWER_BRACKET_CELLS_PER_ENTRY * num_entries;
+	if (max_key > min_key) {
+		index->inv_cell_width = index->num_cells / (max_key - min_key);
+	} else {
+		index->inv_cell_width = 0.;
+	}
+	index->cell_start = (int*) vtr::malloc(index->num_cells * sizeof(int));
+
+	/* The cell of each entry is computed exactly as power_bracket_find computes
+	 * the cell of a key, so that every entry recorded for a cell is known to
+	 * have a key no larger than any key falling into that cell. */
+	entry_idx = -1;
+	for (cell = 0; cell < index->num_cells; cell++) {
+		while (entry_idx + 1 < num_entries) {
+			float next_key = key_of(entries[entry_idx + 1]);
+			int next_cell = (int) ((next_key - min_key) * index->inv_cell_width);
+			if (next_cell >= cell) {
+				break;
+			}
+			entry_idx++;
+		}
+		index->cell_start[cell] = entry_idx;
+	}
+}
+
+/**
+ * Finds the last table entry whose key is <= the given key, or -1 if the key
+ * is smaller than all keys in the table.
+ * - index: Index built over the table by power_bracket_index_build, or an
+ *   empty index (the table is then scanned from its first entry)
+ * - entries: The table, sorted by increasing key
+ * - num_entries: Number of entries in the table
+ * - key_of: Returns the key of a table entry
+ * - key: The key to search for
+ */
+template<typename T, typename KeyFn>
+static int power_bracket_find(const t_power_bracket_index * index,
+		const T * entries, int num_entries, KeyFn key_of, float key) {
+	int found = -1;
+
+	if (index->cell_start) {
+		float pos = (key - index->min_key) * index->inv_cell_width;
+		int cell;
+		if (pos <= 0.) {
+			cell = 0;
+		} else if (pos >= index->num_cells - 1) {
+			cell = index->num_cells - 1;
+		} else {
+			cell = (int) pos;
+		}
+		found = index->cell_start[cell];
+	}
+
+	while (found + 1 < num_entries && key_of(entries[found + 1]) <= key) {
+		found++;
+	}
+	return found;
+}
+
 /**
  * This function searches for a transistor by size
  * - lower: (Return value) The lower-bound matching transistor
@@ -382,15 +505,12 @@ static void process_tech_xml_load_transistor_info(pugi::xml_node parent, const p
 bool power_find_transistor_info(t_transistor_size_inf ** lower,
 		t_transistor_size_inf ** upper, e_tx_type type, float size) {
 	char msg[1024];
-	t_transistor_size_inf key;
-	t_transistor_size_inf * found;
 	t_transistor_inf * trans_info;
 	float min_size, max_size;
+	int found;
 	bool error = false;
     auto& power_ctx = g_vpr_ctx.power();
 
-	key.size = size;
-
 	/* Find the appropriate global transistor records */
 	trans_info = nullptr;
 	if (type == NMOS) {
@@ -409,40 +529,37 @@ bool power_find_transistor_info(t_transistor_size_inf ** lower,
 		return error;
 	}
 
-	/* Make note of the transistor record we are searching in, and the bounds */
-	f_transistor_last_searched = trans_info;
 	min_size = trans_info->size_inf[0].size;
 	max_size = trans_info->size_inf[trans_info->num_size_entries - 1].size;
 
-	found = (t_transistor_size_inf*) bsearch(&key, trans_info->size_inf,
-			trans_info->num_size_entries, sizeof(t_transistor_size_inf),
-			&power_compare_transistor_size);
-	VTR_ASSERT(found);
-
 	if (size < min_size) {
 		/* Too small */
-		VTR_ASSERT(found == &trans_info->size_inf[0]);
 		sprintf(msg,
 				"Using %s transistor of size '%f', which is smaller than the smallest modeled transistor (%f) in the technology behavior file.",
 				transistor_type_name(type), size, min_size);
 		power_log_msg(POWER_LOG_WARNING, msg);
 		*lower = nullptr;
-		*upper = found;
+		*upper = &trans_info->size_inf[0];
 	} else if (size > max_size) {
 		/* Too large */
-		VTR_ASSERT(
-				found
-						== &trans_info->size_inf[trans_info->num_size_entries
-								- 1]);
 		sprintf(msg,
 				"Using %s transistor of size '%f', which is larger than the largest modeled transistor (%f) in the technology behavior file.",
 				transistor_type_name(type), size, max_size);
 		power_log_msg(POWER_LOG_WARNING, msg);
-		*lower = found;
+		*lower = &trans_info->size_inf[trans_info->num_size_entries - 1];
+		*upper = nullptr;
+	} else if (trans_info->num_size_entries == 1) {
+		/* Exactly the only modeled size */
+		*lower = &trans_info->size_inf[0];
 		*upper = nullptr;
 	} else {
-		*lower = found;
-		*upper = found + 1;
+		/* Bracket the size, keeping the upper bound within the table */
+		found = power_bracket_find(&trans_info->size_index, trans_info->size_inf,
+				trans_info->num_size_entries,
+				[](const t_transistor_size_inf& e) {return e.size;}, size);
+		found = std::min(found, trans_info->num_size_entries - 2);
+		*lower = &trans_info->size_inf[found];
+		*upper = &trans_info->size_inf[found + 1];
 	}
 
 	return error;
@@ -458,26 +575,21 @@ bool power_find_transistor_info(t_transistor_size_inf ** lower,
 void power_find_nmos_leakage(t_power_nmos_leakage_inf * nmos_leakage_info,
 		t_power_nmos_leakage_pair ** lower, t_power_nmos_leakage_pair ** upper,
 		float v_ds) {
-	t_power_nmos_leakage_pair key;
-	t_power_nmos_leakage_pair * found;
+	int found;
 
-	key.v_ds = v_ds;
-
-	f_power_searching_nmos_leakage_info = nmos_leakage_info;
-
-	found = (t_power_nmos_leakage_pair*) bsearch(&key,
+	found = power_bracket_find(&nmos_leakage_info->v_ds_index,
 			nmos_leakage_info->leakage_pairs,
 			nmos_leakage_info->num_leakage_pairs,
-			sizeof(t_power_nmos_leakage_pair), power_compare_leakage_pair);
-	VTR_ASSERT(found);
+			[](const t_power_nmos_leakage_pair& e) {return e.v_ds;}, v_ds);
+	VTR_ASSERT(found >= 0);
 
-	if (found == &nmos_leakage_info->leakage_pairs[nmos_leakage_info->num_leakage_pairs - 1]) {
+	if (found == nmos_leakage_info->num_leakage_pairs - 1) {
 		/* The results equal to the max voltage (Vdd) */
-		*lower = found;
+		*lower = &nmos_leakage_info->leakage_pairs[found];
 		*upper = nullptr;
 	} else {
-		*lower = found;
-		*upper = found + 1;
+		*lower = &nmos_leakage_info->leakage_pairs[found];
+		*upper = &nmos_leakage_info->leakage_pairs[found + 1];
 	}
 }
 
@@ -490,8 +602,8 @@ void power_find_nmos_leakage(t_power_nmos_leakage_inf * nmos_leakage_info,
 void power_find_buffer_strength_inf(t_power_buffer_strength_inf ** lower,
 		t_power_buffer_strength_inf ** upper,
 		t_power_buffer_size_inf * size_inf, float stage_gain) {
-	t_power_buffer_strength_inf key;
-	t_power_buffer_strength_inf * found;
+	t_power_bracket_index no_index = t_power_bracket_index();
+	int found;
 
 	float min_size;
 	float max_size;
@@ -501,18 +613,19 @@ void power_find_buffer_strength_inf(t_power_buffer_strength_inf ** lower,
 
 	VTR_ASSERT(stage_gain >= min_size && stage_gain <= max_size);
 
-	key.stage_gain = stage_gain;
-
-	found = (t_power_buffer_strength_inf*) bsearch(&key, size_inf->strength_inf,
-			size_inf->num_strengths, sizeof(t_power_buffer_strength_inf),
-			power_compare_buffer_strength);
+	/* Buffer strengths are not read from the technology file (see
+	 * power_tech_xml_load_sc), so there is no index to use */
+	found = power_bracket_find(&no_index, size_inf->strength_inf,
+			size_inf->num_strengths,
+			[](const t_power_buffer_strength_inf& e) {return e.stage_gain;},
+			stage_gain);
 
 	if (stage_gain == max_size) {
-		*lower = found;
+		*lower = &size_inf->strength_inf[size_inf->num_strengths - 1];
 		*upper = nullptr;
 	} else {
-		*lower = found;
-		*upper = found + 1;
+		*lower = &size_inf->strength_inf[found];
+		*upper = &size_inf->strength_inf[found + 1];
 	}
 }
 
@@ -527,66 +640,34 @@ void power_find_buffer_strength_inf(t_power_buffer_strength_inf ** lower,
 void power_find_buffer_sc_levr(t_power_buffer_sc_levr_inf ** lower,
 		t_power_buffer_sc_levr_inf ** upper,
 		t_power_buffer_strength_inf * buffer_strength, int input_mux_size) {
-	t_power_buffer_sc_levr_inf key;
-	t_power_buffer_sc_levr_inf * found;
+	t_power_bracket_index no_index = t_power_bracket_index();
 	char msg[1024];
 	int max_size;
+	int found;
 
 	VTR_ASSERT(input_mux_size >= 1);
 
-	key.mux_size = input_mux_size;
-
-	f_buffer_strength_last_searched = buffer_strength;
-	found = (t_power_buffer_sc_levr_inf*) bsearch(&key,
-			buffer_strength->sc_levr_inf, buffer_strength->num_levr_entries,
-			sizeof(t_power_buffer_sc_levr_inf), power_compare_buffer_sc_levr);
-
 	max_size = buffer_strength->sc_levr_inf[buffer_strength->num_levr_entries
 			- 1].mux_size;
 	if (input_mux_size > max_size) {
 		/* Input mux too large */
-		VTR_ASSERT(
-				found
-						== &buffer_strength->sc_levr_inf[buffer_strength->num_levr_entries
-								- 1]);
 		sprintf(msg,
 				"Using buffer driven by mux of size '%d', which is larger than the largest modeled size (%d) in the technology behavior file.",
 				input_mux_size, max_size);
 		power_log_msg(POWER_LOG_WARNING, msg);
-		*lower = found;
+		*lower = &buffer_strength->sc_levr_inf[buffer_strength->num_levr_entries - 1];
 		*upper = nullptr;
 	} else {
-		*lower = found;
-		*upper = found + 1;
-	}
-}
-
-/**
- * Comparison function, used by power_find_nmos_leakage
- */
-static int power_compare_leakage_pair(const void * key_void, const void * elem_void) {
-	const t_power_nmos_leakage_pair * key = (const t_power_nmos_leakage_pair*) key_void;
-	const t_power_nmos_leakage_pair * elem = (const t_power_nmos_leakage_pair*) elem_void;
-	const t_power_nmos_leakage_pair * next = (const t_power_nmos_leakage_pair*) elem + 1;
-
-	/* Compare against last? */
-	if (elem == &f_power_searching_nmos_leakage_info->leakage_pairs[f_power_searching_nmos_leakage_info->num_leakage_pairs - 1]) {
-		if (key->v_ds >= elem->v_ds) {
-			return 0;
-		} else {
-			return -1;
-		}
-	}
-
-	/* Check for exact match to Vdd (upper end) */
-	if (key->v_ds == elem->v_ds) {
-		return 0;
-	} else if (key->v_ds < elem->v_ds) {
-		return -1;
-	} else if (key->v_ds > next->v_ds) {
-		return 1;
-	} else {
-		return 0;
+		/* Bracket the size (extrapolating from the first two records if it is
+		 * smaller than the smallest), keeping the upper bound within the table */
+		found = power_bracket_find(&no_index, buffer_strength->sc_levr_inf,
+				buffer_strength->num_levr_entries,
+				[](const t_power_buffer_sc_levr_inf& e) {return (float) e.mux_size;},
+				(float) input_mux_size);
+		found = std::max(0,
+				std::min(found, buffer_strength->num_levr_entries - 2));
+		*lower = &buffer_strength->sc_levr_inf[found];
+		*upper = &buffer_strength->sc_levr_inf[found + 1];
 	}
 }
 
@@ -600,165 +681,18 @@ static int power_compare_leakage_pair(const void * key_void, const void * elem_v
 void power_find_mux_volt_inf(t_power_mux_volt_pair ** lower,
 		t_power_mux_volt_pair ** upper, t_power_mux_volt_inf * volt_inf,
 		float v_in) {
-	t_power_mux_volt_pair key;
-	t_power_mux_volt_pair * found;
+	int found;
 
-	key.v_in = v_in;
+	found = power_bracket_find(&volt_inf->v_in_index,
+			volt_inf->mux_voltage_pairs, volt_inf->num_voltage_pairs,
+			[](const t_power_mux_volt_pair& e) {return e.v_in;}, v_in);
+	VTR_ASSERT(found >= 0);
 
-	f_mux_volt_last_searched = volt_inf;
-	found = (t_power_mux_volt_pair*) bsearch(&key, volt_inf->mux_voltage_pairs,
-			volt_inf->num_voltage_pairs, sizeof(t_power_mux_volt_pair),
-			power_compare_voltage_pair);
-	VTR_ASSERT(found);
-
-	if (found
-			== &volt_inf->mux_voltage_pairs[volt_inf->num_voltage_pairs - 1]) {
-		*lower = found;
+	if (found == volt_inf->num_voltage_pairs - 1) {
+		*lower = &volt_inf->mux_voltage_pairs[found];
 		*upper = nullptr;
 	} else {
-		*lower = found;
-		*upper = found + 1;
-	}
-}
-
-/**
- * Comparison function, used by power_find_buffer_sc_levr
- */
-static int power_compare_buffer_sc_levr(const void * key_void,
-		const void * elem_void) {
-	const t_power_buffer_sc_levr_inf * key =
-			(const t_power_buffer_sc_levr_inf*) key_void;
-	const t_power_buffer_sc_levr_inf * elem =
-			(const t_power_buffer_sc_levr_inf*) elem_void;
-	const t_power_buffer_sc_levr_inf * next;
-
-	/* Compare against last? */
-	if (elem
-			== &f_buffer_strength_last_searched->sc_levr_inf[f_buffer_strength_last_searched->num_levr_entries
-					- 1]) {
-		if (key->mux_size >= elem->mux_size) {
-			return 0;
-		} else {
-			return -1;
-		}
-	}
-
-	/* Compare against first? */
-	if (elem == &f_buffer_strength_last_searched->sc_levr_inf[0]) {
-		if (key->mux_size < elem->mux_size) {
-			return 0;
-		}
-	}
-
-	/* Check if the key is between elem and the next element */
-	next = elem + 1;
-	if (key->mux_size > next->mux_size) {
-		return 1;
-	} else if (key->mux_size < elem->mux_size) {
-		return -1;
-	} else {
-		return 0;
-	}
-}
-
-/**
- * Comparison function, used by power_find_buffer_strength_inf
- */
-static int power_compare_buffer_strength(const void * key_void,
-		const void * elem_void) {
-	const t_power_buffer_strength_inf * key =
-			(const t_power_buffer_strength_inf*) key_void;
-	const t_power_buffer_strength_inf * elem =
-			(const t_power_buffer_strength_inf*) elem_void;
-	const t_power_buffer_strength_inf * next =
-			(const t_power_buffer_strength_inf*) elem + 1;
-
-	/* Check for exact match */
-	if (key->stage_gain == elem->stage_gain) {
-		return 0;
-	} else if (key->stage_gain < elem->stage_gain) {
-		return -1;
-	} else if (key->stage_gain > next->stage_gain) {
-		return 1;
-	} else {
-		return 0;
-	}
-}
-
-/**
- * Comparison function, used by power_find_transistor_info
- */
-static int power_compare_transistor_size(const void * key_void,
-		const void * elem_void) {
-	const t_transistor_size_inf * key = (const t_transistor_size_inf*) key_void;
-	const t_transistor_size_inf * elem =
-			(const t_transistor_size_inf*) elem_void;
-	const t_transistor_size_inf * next;
-
-	/* Check if we are comparing against the last element */
-	if (elem
-			== &f_transistor_last_searched->size_inf[f_transistor_last_searched->num_size_entries
-					- 1]) {
-		/* Match if the desired value is larger than the largest item in the list */
-		if (key->size >= elem->size) {
-			return 0;
-		} else {
-			return -1;
-		}
-	}
-
-	/* Check if we are comparing against the first element */
-	if (elem == &f_transistor_last_searched->size_inf[0]) {
-		/* Match the smallest if it is smaller than the smallest */
-		if (key->size < elem->size) {
-			return 0;
-		}
-	}
-
-	/* Check if the key is between elem and the next element */
-	next = elem + 1;
-	if (key->size > next->size) {
-		return 1;
-	} else if (key->size < elem->size) {
-		return -1;
-	} else {
-		return 0;
-	}
-
-}
-
-/**
- * Comparison function, used by power_find_mux_volt_inf
- */
-static int power_compare_voltage_pair(const void * key_void,
-		const void * elem_void) {
-	const t_power_mux_volt_pair * key = (const t_power_mux_volt_pair *) key_void;
-	const t_power_mux_volt_pair * elem =
-			(const t_power_mux_volt_pair *) elem_void;
-	const t_power_mux_volt_pair * next = (const t_power_mux_volt_pair *) elem
-			+ 1;
-
-	/* Check if we are comparing against the last element */
-	if (elem
-			== &f_mux_volt_last_searched->mux_voltage_pairs[f_mux_volt_last_searched->num_voltage_pairs
-					- 1]) {
-		/* Match if the desired value is larger than the largest item in the list */
-		if (key->v_in >= elem->v_in) {
-			return 0;
-		} else {
-			return -1;
-		}
-	}
-
-	/* Check for exact match to Vdd (upper end) */
-	if (key->v_in == elem->v_in) {
-		return 0;
-	} else if (key->v_in < elem->v_in) {
-		return -1;
-	} else if (key->v_in > next->v_in) {
-		return 1;
-	} else {
-		return 0;
+		*lower = &volt_inf->mux_voltage_pairs[found];
+		*upper = &volt_inf->mux_voltage_pairs[found + 1];
 	}
 }
-
@@ -68,6 +68,16 @@ void power_components_uninit() {
 	free(power_ctx.by_component.components);
 }
 
+/**
+ * Zeroes the power usage of all components, before power is estimated again
+ */
+void power_components_reset() {
+    auto& power_ctx = g_vpr_ctx.power();
+	for (int i = 0; i < POWER_COMPONENT_MAX_NUM; i++) {
+		power_zero_usage(&power_ctx.by_component.components[i]);
+	}
+}
+
 /**
  * Adds power usage for a component to the global component tracker
  * - power_usage: Power usage to add
@@ -402,7 +412,8 @@ void power_usage_lut(t_power_usage * power_usage, int lut_size,
 }
 
 /**
- * This function calculates power of a local interconnect structure
+ * This function calculates power of a local interconnect structure.
+ * The caller is responsible for adding it to the interconnect's power usage.
  * - power_usage: (Return value) Power usage of the structure
  * - pb: The physical block to which this interconnect belongs
  * - interc_pins: The interconnect input/ouput pin information
@@ -521,9 +532,6 @@ void power_usage_local_interc_mux(t_power_usage * power_usage, t_pb * pb,
 	default:
 		VTR_ASSERT(0);
 	}
-
-	power_add_usage(&interc_pins->interconnect->interconnect_power->power_usage,
-			power_usage);
 }
 
 /**
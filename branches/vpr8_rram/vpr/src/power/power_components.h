@@ -75,6 +75,7 @@ typedef t_power_breakdown t_power_components;
 
 void power_components_init();
 void power_components_uninit();
+void power_components_reset();
 void power_component_get_usage(t_power_usage * power_usage,
 		e_power_component_type component_idx);
 void power_component_add_usage(t_power_usage * power_usage,
@@ -21,6 +21,10 @@
  */
 
 /************************* INCLUDES *********************************/
+#include <functional>
+#include <unordered_map>
+#include <utility>
+
 #include "vtr_assert.h"
 
 #include "power_lowlevel.h"
@@ -28,7 +32,41 @@
 #include "power_cmos_tech.h"
 #include "globals.h"
 
+/************************* STRUCTS **********************************/
+/* The technology records bracketing a given NMOS transistor size, and the
+ * weight of the upper record.  upper is nullptr when the size is at or
+ * beyond the largest modeled size. */
+template<typename T>
+struct t_nmos_size_bracket {
+	T * lower;
+	T * upper;
+	float perc_upper;
+};
+
+struct t_mux_size_key_hash {
+	size_t operator()(const std::pair<int, float>& key) const noexcept {
+		return std::hash<float>()(key.second) * 31 + std::hash<int>()(key.first);
+	}
+};
+
+/* Memoized per-transistor-size (and per-mux-size) brackets; these only depend
+ * on the technology file, so are looked up once rather than for every mux.
+ * Kept per thread, so that power can be estimated in parallel. */
+struct t_nmos_size_bracket_memo {
+	const t_power_tech * tech = nullptr;
+	std::unordered_map<float, t_nmos_size_bracket<t_power_nmos_leakage_inf>> leakage;
+	std::unordered_map<std::pair<int, float>, t_nmos_size_bracket<t_power_mux_volt_inf>, t_mux_size_key_hash> mux_volt;
+};
+
+/************************* FILE SCOPE *******************************/
+static thread_local t_nmos_size_bracket_memo f_bracket_memo;
+
 /************************* FUNCTION DECLARATIONS ********************/
+static t_nmos_size_bracket_memo& power_get_bracket_memo();
+static const t_nmos_size_bracket<t_power_nmos_leakage_inf>& power_find_leakage_bracket(
+		float size);
+static const t_nmos_size_bracket<t_power_mux_volt_inf>& power_find_mux_volt_bracket(
+		int num_inputs, float transistor_size);
 static float power_calc_node_switching_v(float capacitance, float density,
 		float period, float voltage);
 static void power_calc_transistor_capacitance(float *C_d, float *C_s,
@@ -359,15 +397,74 @@ static float power_calc_leakage_gate(e_tx_type transistor_type, float size) {
  * - v_ds: Drain-source voltage
  */
 static float power_calc_leakage_st_pass_transistor(float size, float v_ds) {
-	t_power_nmos_leakage_inf * nmos_low = nullptr;
-	t_power_nmos_leakage_inf * nmos_high = nullptr;
-
 	t_power_nmos_leakage_pair * lower;
 	t_power_nmos_leakage_pair * upper;
 	float i_ds;
 	float power_low;
 	float power_high;
-	bool over_range = false;
+
+    auto& power_ctx = g_vpr_ctx.power();
+
+	const t_nmos_size_bracket<t_power_nmos_leakage_inf>& bracket =
+			power_find_leakage_bracket(size);
+
+	power_find_nmos_leakage(bracket.lower, &lower, &upper, v_ds);
+	if (lower->v_ds == v_ds || !upper) {
+		i_ds = lower->i_ds;
+	} else {
+		float perc_upper = (v_ds - lower->v_ds) / (upper->v_ds - lower->v_ds);
+		i_ds = (1 - perc_upper) * lower->i_ds + perc_upper * upper->i_ds;
+	}
+	power_low = i_ds * power_ctx.tech->Vdd;
+
+    if (!bracket.upper) {
+        return power_low;
+    } else {
+		power_find_nmos_leakage(bracket.upper, &lower, &upper, v_ds);
+		if (lower->v_ds == v_ds || !upper) {
+			i_ds = lower->i_ds;
+		} else {
+			float perc_upper = (v_ds - lower->v_ds)
+					/ (upper->v_ds - lower->v_ds);
+			i_ds = (1 - perc_upper) * lower->i_ds + perc_upper * upper->i_ds;
+		}
+		power_high = i_ds * power_ctx.tech->Vdd;
+
+		return power_high * bracket.perc_upper
+				+ power_low * (1 - bracket.perc_upper);
+	}
+}
+
+/**
+ * Returns the calling thread's bracket memo, emptied if the technology
+ * has been (re)loaded since it was filled
+ */
+static t_nmos_size_bracket_memo& power_get_bracket_memo() {
+    auto& power_ctx = g_vpr_ctx.power();
+
+	if (f_bracket_memo.tech != power_ctx.tech) {
+		f_bracket_memo.leakage.clear();
+		f_bracket_memo.mux_volt.clear();
+		f_bracket_memo.tech = power_ctx.tech;
+	}
+	return f_bracket_memo;
+}
+
+/**
+ * Returns the <nmos_leakages> records bracketing a pass-transistor size,
+ * memoized per size
+ * - size: (W/L) size of transistor
+ */
+static const t_nmos_size_bracket<t_power_nmos_leakage_inf>& power_find_leakage_bracket(
+		float size) {
+	t_nmos_size_bracket_memo& memo = power_get_bracket_memo();
+	auto iter = memo.leakage.find(size);
+	if (iter != memo.leakage.end()) {
+		return iter->second;
+	}
+
+	t_nmos_size_bracket<t_power_nmos_leakage_inf> bracket = { nullptr, nullptr,
+			0. };
 
 	VTR_ASSERT(size >= 1.0);
 
@@ -375,13 +472,12 @@ static float power_calc_leakage_st_pass_transistor(float size, float v_ds) {
 
 	// Check if nmos size is beyond range
 	if (size >= power_ctx.tech->nmos_leakage_info[power_ctx.tech->num_nmos_leakage_info - 1].nmos_size) {
-		nmos_low = &power_ctx.tech->nmos_leakage_info[power_ctx.tech->num_nmos_leakage_info - 1];
-		over_range = true;
+		bracket.lower = &power_ctx.tech->nmos_leakage_info[power_ctx.tech->num_nmos_leakage_info - 1];
 	} else {
 		for (int i = 1; i < power_ctx.tech->num_nmos_leakage_info; i++) {
 			if (size < power_ctx.tech->nmos_leakage_info[i].nmos_size) {
-				nmos_low = &power_ctx.tech->nmos_leakage_info[i - 1];
-				nmos_high = &power_ctx.tech->nmos_leakage_info[i];
+				bracket.lower = &power_ctx.tech->nmos_leakage_info[i - 1];
+				bracket.upper = &power_ctx.tech->nmos_leakage_info[i];
 				break;
 			}
 		}
@@ -396,34 +492,13 @@ static float power_calc_leakage_st_pass_transistor(float size, float v_ds) {
 				section of the technology file.");
 	}
 
-	VTR_ASSERT(nmos_low != nullptr);
-	power_find_nmos_leakage(nmos_low, &lower, &upper, v_ds);
-	if (lower->v_ds == v_ds || !upper) {
-		i_ds = lower->i_ds;
-	} else {
-		float perc_upper = (v_ds - lower->v_ds) / (upper->v_ds - lower->v_ds);
-		i_ds = (1 - perc_upper) * lower->i_ds + perc_upper * upper->i_ds;
+	VTR_ASSERT(bracket.lower != nullptr);
+	if (bracket.upper) {
+		bracket.perc_upper = (size - bracket.lower->nmos_size)
+				/ (bracket.upper->nmos_size - bracket.lower->nmos_size);
 	}
-	power_low = i_ds * power_ctx.tech->Vdd;
 
-    if (over_range) {
-        return power_low;
-    } else {
-		VTR_ASSERT(nmos_high != nullptr);
-		power_find_nmos_leakage(nmos_high, &lower, &upper, v_ds);
-		if (lower->v_ds == v_ds || !upper) {
-			i_ds = lower->i_ds;
-		} else {
-			float perc_upper = (v_ds - lower->v_ds)
-					/ (upper->v_ds - lower->v_ds);
-			i_ds = (1 - perc_upper) * lower->i_ds + perc_upper * upper->i_ds;
-		}
-		power_high = i_ds * power_ctx.tech->Vdd;
-
-		float perc_upper = (size - nmos_low->nmos_size)
-				/ (nmos_high->nmos_size - nmos_low->nmos_size);
-		return power_high * perc_upper + power_low * (1 - perc_upper);
-	}
+	return memo.leakage[size] = bracket;
 }
 
 /**
@@ -591,14 +666,68 @@ void power_usage_mux_singlelevel_static(t_power_usage * power_usage,
  */
 float power_calc_mux_v_out(int num_inputs, float transistor_size, float v_in,
 		float in_prob_avg) {
-	t_power_mux_volt_inf * mux_volt_inf_low;
-	t_power_mux_volt_inf * mux_volt_inf_high;
 	t_power_mux_volt_pair * lower;
 	t_power_mux_volt_pair * upper;
 	float v_out_min, v_out_max;
 	float v_out_low;
 	float v_out_high;
-	bool over_range = false;
+
+	const t_nmos_size_bracket<t_power_mux_volt_inf>& bracket =
+			power_find_mux_volt_bracket(num_inputs, transistor_size);
+
+	power_find_mux_volt_inf(&lower, &upper, bracket.lower, v_in);
+	if (lower->v_in == v_in || !upper) {
+		v_out_min = lower->v_out_min;
+		v_out_max = lower->v_out_max;
+	} else {
+		float perc_upper = (v_in - lower->v_in) / (upper->v_in - lower->v_in);
+		v_out_min = (1 - perc_upper) * lower->v_out_min
+				+ perc_upper * upper->v_out_min;
+		v_out_max = (1 - perc_upper) * lower->v_out_max
+				+ perc_upper * upper->v_out_max;
+	}
+	v_out_low = in_prob_avg * v_out_max + (1 - in_prob_avg) * v_out_min;
+
+    if (!bracket.upper) {
+        return v_out_low;
+    } else {
+		power_find_mux_volt_inf(&lower, &upper, bracket.upper, v_in);
+		if (lower->v_in == v_in || !upper) {
+			v_out_min = lower->v_out_min;
+			v_out_max = lower->v_out_max;
+		} else {
+			float perc_upper = (v_in - lower->v_in)
+					/ (upper->v_in - lower->v_in);
+			v_out_min = (1 - perc_upper) * lower->v_out_min
+					+ perc_upper * upper->v_out_min;
+			v_out_max = (1 - perc_upper) * lower->v_out_max
+					+ perc_upper * upper->v_out_max;
+		}
+		v_out_high = in_prob_avg * v_out_max + (1 - in_prob_avg) * v_out_min;
+
+		return v_out_high * bracket.perc_upper
+				+ (1 - bracket.perc_upper) * v_out_low;
+	}
+}
+
+/**
+ * Returns the <multiplexers> voltage records of a single-level mux size,
+ * for the modeled NMOS sizes bracketing a transistor size, memoized per
+ * (mux size, transistor size)
+ * - num_inputs: Number of inputs of the multiplexer
+ * - transistor_size: The size of the NMOS transistors
+ */
+static const t_nmos_size_bracket<t_power_mux_volt_inf>& power_find_mux_volt_bracket(
+		int num_inputs, float transistor_size) {
+	std::pair<int, float> key(num_inputs, transistor_size);
+	t_nmos_size_bracket_memo& memo = power_get_bracket_memo();
+	auto iter = memo.mux_volt.find(key);
+	if (iter != memo.mux_volt.end()) {
+		return iter->second;
+	}
+
+	t_nmos_size_bracket<t_power_mux_volt_inf> bracket = { nullptr, nullptr,
+			0. };
 
 	VTR_ASSERT(transistor_size >= 1.0);
 
@@ -612,7 +741,6 @@ float power_calc_mux_v_out(int num_inputs, float transistor_size, float v_in,
 			>= power_ctx.tech->nmos_mux_info[power_ctx.tech->num_nmos_mux_info - 1].nmos_size) {
 		mux_nmos_inf_lower =
 				&power_ctx.tech->nmos_mux_info[power_ctx.tech->num_nmos_mux_info - 1];
-		over_range = true;
 	} else {
 		for (int i = 1; i < power_ctx.tech->num_nmos_mux_info; i++) {
 			if (transistor_size < power_ctx.tech->nmos_mux_info[i].nmos_size) {
@@ -634,53 +762,21 @@ float power_calc_mux_v_out(int num_inputs, float transistor_size, float v_in,
 	}
 
 	if (num_inputs > mux_nmos_inf_lower->max_mux_sl_size
-			|| (!over_range && mux_nmos_inf_upper && num_inputs > mux_nmos_inf_upper->max_mux_sl_size)) {
+			|| (mux_nmos_inf_upper && num_inputs > mux_nmos_inf_upper->max_mux_sl_size)) {
 		power_log_msg(POWER_LOG_ERROR,
 				"The circuit contains a single-level mux larger than \
 				what is defined in the <multiplexers> section of the \
 				technology file.");
 	}
 
-	mux_volt_inf_low = &mux_nmos_inf_lower->mux_voltage_inf[num_inputs];
-
-	power_find_mux_volt_inf(&lower, &upper, mux_volt_inf_low, v_in);
-	if (lower->v_in == v_in || !upper) {
-		v_out_min = lower->v_out_min;
-		v_out_max = lower->v_out_max;
-	} else {
-		float perc_upper = (v_in - lower->v_in) / (upper->v_in - lower->v_in);
-		v_out_min = (1 - perc_upper) * lower->v_out_min
-				+ perc_upper * upper->v_out_min;
-		v_out_max = (1 - perc_upper) * lower->v_out_max
-				+ perc_upper * upper->v_out_max;
+	bracket.lower = &mux_nmos_inf_lower->mux_voltage_inf[num_inputs];
+	if (mux_nmos_inf_upper) {
+		bracket.upper = &mux_nmos_inf_upper->mux_voltage_inf[num_inputs];
+		bracket.perc_upper = (transistor_size - mux_nmos_inf_lower->nmos_size)
+				/ (mux_nmos_inf_upper->nmos_size - mux_nmos_inf_lower->nmos_size);
 	}
-	v_out_low = in_prob_avg * v_out_max + (1 - in_prob_avg) * v_out_min;
 
-    if (over_range) {
-        return v_out_low;
-    } else {
-        VTR_ASSERT(mux_nmos_inf_upper);
-		mux_volt_inf_high = &mux_nmos_inf_upper->mux_voltage_inf[num_inputs];
-		power_find_mux_volt_inf(&lower, &upper, mux_volt_inf_high, v_in);
-		if (lower->v_in == v_in || !upper) {
-			v_out_min = lower->v_out_min;
-			v_out_max = lower->v_out_max;
-		} else {
-			float perc_upper = (v_in - lower->v_in)
-					/ (upper->v_in - lower->v_in);
-			v_out_min = (1 - perc_upper) * lower->v_out_min
-					+ perc_upper * upper->v_out_min;
-			v_out_max = (1 - perc_upper) * lower->v_out_max
-					+ perc_upper * upper->v_out_max;
-		}
-		v_out_high = in_prob_avg * v_out_max + (1 - in_prob_avg) * v_out_min;
-
-		float perc_upper =
-				(transistor_size - mux_nmos_inf_lower->nmos_size)
-						/ (mux_nmos_inf_upper->nmos_size
-								- mux_nmos_inf_lower->nmos_size);
-		return v_out_high * perc_upper + (1 - perc_upper) * v_out_low;
-	}
+	return memo.mux_volt[key] = bracket;
 }
 
 /** This function calculates the power of a single-level multiplexer, where the
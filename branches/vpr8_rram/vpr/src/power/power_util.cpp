@@ -37,6 +37,9 @@ using namespace std;
 
 /************************* GLOBALS **********************************/
 
+/************************* FILE SCOPE **********************************/
+static thread_local t_power_deferred_logs * f_deferred_logs = nullptr;
+
 /************************* FUNCTION DECLARATIONS*********************/
 static void log_msg(t_log * log_ptr, const char * msg);
 static void init_mux_arch_default(t_mux_arch * mux_arch, int levels,
@@ -70,10 +73,51 @@ float power_perc_dynamic(t_power_usage * power_usage) {
 }
 
 void power_log_msg(e_power_log_type log_type, const char * msg) {
+	if (f_deferred_logs) {
+		f_deferred_logs->emplace_back(log_type, msg);
+		return;
+	}
+
     auto& power_ctx = g_vpr_ctx.power();
 	log_msg(&power_ctx.output->logs[log_type], msg);
 }
 
+/**
+ * Holds back the messages logged by the calling thread in deferred_logs,
+ * rather than adding them to the global logs, until called with nullptr.
+ * Used so that parallel work can log without sharing the global logs, and
+ * its messages can later be replayed in a deterministic order.
+ */
+void power_log_defer(t_power_deferred_logs * deferred_logs) {
+	f_deferred_logs = deferred_logs;
+}
+
+/**
+ * Removes all messages from the global logs
+ */
+void power_log_clear() {
+    auto& power_ctx = g_vpr_ctx.power();
+
+	for (int log_idx = 0; log_idx < power_ctx.output->num_logs; log_idx++) {
+		t_log * log_ptr = &power_ctx.output->logs[log_idx];
+		for (int msg_idx = 0; msg_idx < log_ptr->num_messages; msg_idx++) {
+			free(log_ptr->messages[msg_idx]);
+		}
+		free(log_ptr->messages);
+		log_ptr->messages = nullptr;
+		log_ptr->num_messages = 0;
+	}
+}
+
+/**
+ * Adds messages held back by power_log_defer to the global logs
+ */
+void power_log_replay(const t_power_deferred_logs& deferred_logs) {
+	for (const auto& log : deferred_logs) {
+		power_log_msg(log.first, log.second.c_str());
+	}
+}
+
 const char * transistor_type_name(e_tx_type type) {
 	if (type == NMOS) {
 		return "NMOS";
@@ -88,12 +132,14 @@ float pin_dens(t_pb * pb, t_pb_graph_pin * pin, ClusterBlockId iblk) {
 	float density = 0.;
 
     auto& cluster_ctx = g_vpr_ctx.clustering();
-    auto& power_ctx = g_vpr_ctx.mutable_power();
+    auto& power_ctx = g_vpr_ctx.power();
 
 	if (pb) {
 		if (cluster_ctx.clb_nlist.block_pb(iblk)->pb_route.count(pin->pin_count_in_cluster)) {
             AtomNetId net_id = cluster_ctx.clb_nlist.block_pb(iblk)->pb_route[pin->pin_count_in_cluster].atom_net_id;
-			density = power_ctx.atom_net_power[net_id].density;
+			/* Nets without activity are 0 (as a default-constructed entry would be) */
+			auto iter = power_ctx.atom_net_power.find(net_id);
+			density = (iter == power_ctx.atom_net_power.end()) ? 0. : iter->second.density;
 		}
 	}
 
@@ -105,12 +151,14 @@ float pin_prob(t_pb * pb, t_pb_graph_pin * pin, ClusterBlockId iblk) {
 	float prob = 1.;
 
     auto& cluster_ctx = g_vpr_ctx.clustering();
-    auto& power_ctx = g_vpr_ctx.mutable_power();
+    auto& power_ctx = g_vpr_ctx.power();
 
 	if (pb) {
 		if (cluster_ctx.clb_nlist.block_pb(iblk)->pb_route.count(pin->pin_count_in_cluster)) {
             AtomNetId net_id = cluster_ctx.clb_nlist.block_pb(iblk)->pb_route[pin->pin_count_in_cluster].atom_net_id;
-			prob = power_ctx.atom_net_power[net_id].probability;
+			/* Nets without activity are 0 (as a default-constructed entry would be) */
+			auto iter = power_ctx.atom_net_power.find(net_id);
+			prob = (iter == power_ctx.atom_net_power.end()) ? 0. : iter->second.probability;
 		}
 	}
 
@@ -23,11 +23,20 @@
 #define __POWER_UTIL_H__
 
 /************************* INCLUDES *********************************/
+#include <string>
+#include <utility>
+#include <vector>
+
 #include "power.h"
 #include "power_components.h"
 #include "atom_netlist.h"
 #include "clustered_netlist.h"
 
+/************************* TYPEDEFS *********************************/
+/* Log messages held back by a (possibly parallel) unit of work, in the
+ * order they were logged */
+typedef std::vector<std::pair<e_power_log_type, std::string>> t_power_deferred_logs;
+
 /************************* FUNCTION DECLARATIONS ********************/
 
 /* Pins */
@@ -46,6 +55,9 @@ float power_perc_dynamic(t_power_usage * power_usage);
 
 /* Message Logger */
 void power_log_msg(e_power_log_type log_type, const char * msg);
+void power_log_defer(t_power_deferred_logs * deferred_logs);
+void power_log_replay(const t_power_deferred_logs& deferred_logs);
+void power_log_clear();
 
 /* Buffers */
 int power_calc_buffer_num_stages(float final_stage_size, float desired_stage_effort);
@@ -133,6 +133,7 @@ that formulas are evaluated in 'parse_switchblocks.c'):
 #include "vtr_assert.h"
 #include "vtr_memory.h"
 #include "vtr_log.h"
+#include "vtr_time.h"
 
 #include "vpr_error.h"
 
@@ -179,11 +180,35 @@ struct t_wire_switchpoint {
     int switchpoint;    //Switchpoint of the wire
 };
 
+/* Variable slots of the compiled permutation formulas */
+enum e_sb_perm_var {
+    SB_PERM_VAR_W = 0,  //Size of the destination wire set
+    SB_PERM_VAR_T,      //Index of the source wire in its set
+    SB_PERM_NUM_VARS
+};
+
+/* Variable slots of the compiled num_conns formulas */
+enum e_sb_num_conns_var {
+    SB_NUM_CONNS_VAR_FROM = 0,  //Size of the source wire set
+    SB_NUM_CONNS_VAR_TO,        //Size of the destination wire set
+    SB_NUM_CONNS_NUM_VARS
+};
+
+/* The formulas of a switchblock, each parsed once up-front rather than at every
+   switchblock location and source wire */
+struct t_compiled_switchblock {
+    map<SB_Side_Connection, vector<CompiledFormula>> permutation_map;
+    vector<CompiledFormula> num_conns_formulas; //[0..wireconns.size()-1]
+};
+
 /************ Typedefs ************/
 /* Used to get info about a given wire type based on the name */
 typedef map< string, Wire_Info > t_wire_type_sizes;
 
 /************ Function Declarations ************/
+/* Parses the permutation and num_conns formulas of the specified switchblock */
+static t_compiled_switchblock compile_switchblock_formulas(const t_switchblock_inf& sb);
+
 /* Counts the number of wires in each wire type in the specified channel */
 static void count_wire_type_sizes(const t_chan_seg_details *channel, int nodes_per_chan,
 			t_wire_type_sizes *wire_type_sizes);
@@ -194,17 +219,17 @@ static void count_wire_type_sizes(const t_chan_seg_details *channel, int nodes_p
 static int get_max_lcm(vector<t_switchblock_inf> *switchblocks, t_wire_type_sizes *wire_type_sizes);
 
 /* compute all the switchblocks around the perimeter of the FPGA for the given switchblock and wireconn */
-static void compute_perimeter_switchblocks(t_chan_details *chan_details_x, t_chan_details *chan_details_y,
+static void compute_perimeter_switchblocks(const t_chan_details& chan_details_x, const t_chan_details& chan_details_y,
 		vector<t_switchblock_inf> *switchblocks, const DeviceGrid& grid, int nodes_per_chan,
 		t_wire_type_sizes *wire_type_sizes, e_directionality directionality,
-		t_sb_connection_map *sb_conns);
+		t_sb_connection_map *sb_conns, vtr::RandState& rand_state);
 
 /* computes a horizontal line of switchblocks of size sb_row_size (or of grid.width()-4, whichever is smaller), starting
    at coordinate (1,1) */
-static void compute_switchblock_row(int sb_row_size, t_chan_details *chan_details_x, t_chan_details *chan_details_y,
+static void compute_switchblock_row(int sb_row_size, const t_chan_details& chan_details_x, const t_chan_details& chan_details_y,
 		vector<t_switchblock_inf> *switchblocks, const DeviceGrid& grid, int nodes_per_chan,
 		t_wire_type_sizes *wire_type_sizes, e_directionality directionality,
-		t_sb_connection_map *sb_row);
+		t_sb_connection_map *sb_row, vtr::RandState& rand_state);
 
 /* stamp out a line of horizontal switchblocks starting at coordinates (ref_x, ref_y) and
    continuing on for sb_row_size */
@@ -221,7 +246,7 @@ static void stampout_switchblocks_from_row( int sb_row_size,
 static void compute_wire_connections(int x_coord, int y_coord,
             enum e_side from_side, enum e_side to_side,
             const t_chan_details& chan_details_x, const t_chan_details& chan_details_y,
-            t_switchblock_inf *sb,
+            t_switchblock_inf *sb, const t_compiled_switchblock& compiled_sb,
             const DeviceGrid& grid,
 			t_wire_type_sizes *wire_type_sizes, e_directionality directionality,
 			t_sb_connection_map *sb_conns,
@@ -231,10 +256,11 @@ static void compute_wire_connections(int x_coord, int y_coord,
 static void compute_wireconn_connections(const DeviceGrid& grid, e_directionality directionality,
 		const t_chan_details& from_chan_details, const t_chan_details& to_chan_details, Switchblock_Lookup sb_conn,
 		int from_x, int from_y, int to_x, int to_y, t_rr_type from_chan_type, t_rr_type to_chan_type,
-		t_wire_type_sizes *wire_type_sizes, t_switchblock_inf *sb,
-		t_wireconn_inf *wireconn_ptr, t_sb_connection_map *sb_conns, vtr::RandState& rand_state);
+		t_wire_type_sizes *wire_type_sizes, t_wireconn_inf *wireconn_ptr,
+		const CompiledFormula& num_conns_formula, const vector<CompiledFormula>& permutations,
+		t_sb_connection_map *sb_conns, vtr::RandState& rand_state);
 
-static int evaluate_num_conns_formula(std::string num_conns_formula, int from_wire_count, int to_wire_count);
+static int evaluate_num_conns_formula(const CompiledFormula& num_conns_formula, int from_wire_count, int to_wire_count);
 
 /* returns the wire indices belonging to the types in 'wire_type_vec' and switchpoints in 'points' at the given channel segment */
 static std::vector<t_wire_switchpoint> get_switchpoint_wires(const DeviceGrid& grid, const t_chan_seg_details* chan_details,
@@ -287,6 +313,8 @@ t_sb_connection_map * alloc_and_load_switchblock_permutations(
 				t_chan_width *nodes_per_chan, e_directionality directionality,
                 vtr::RandState& rand_state){
 
+    vtr::ScopedStartFinishTimer timer("Build switch block permutations");
+
 	/* get a single number for channel width */
 	int channel_width = nodes_per_chan->max;
 	if (nodes_per_chan->max != nodes_per_chan->x_min || nodes_per_chan->max != nodes_per_chan->y_min){
@@ -310,11 +338,11 @@ t_sb_connection_map * alloc_and_load_switchblock_permutations(
 	/* compute the perimeter switchblocks. unfortunately we can't just compute corners and stamp out the rest because
 	   for a unidirectional architecture corners AND perimeter switchblocks require special treatment */
 	compute_perimeter_switchblocks( chan_details_x, chan_details_y, &switchblocks,
-			grid, channel_width, &wire_type_sizes, directionality, sb_conns);
+			grid, channel_width, &wire_type_sizes, directionality, sb_conns, rand_state);
 
 	/* compute the switchblock row */
 	compute_switchblock_row( max_lcm, chan_details_x, chan_details_y, &switchblocks,
-			grid, channel_width, &wire_type_sizes, directionality, &sb_row );
+			grid, channel_width, &wire_type_sizes, directionality, &sb_row, rand_state );
 
 	/* stamp-out the switchblock row throughout the rest of the FPGA */
 	stampout_switchblocks_from_row( max_lcm, channel_width,
@@ -330,6 +358,10 @@ t_sb_connection_map * alloc_and_load_switchblock_permutations(
 		if (directionality != sb.directionality){
 			vpr_throw(VPR_ERROR_ARCH, __FILE__, __LINE__, "alloc_and_load_switchblock_connections: Switchblock %s does not match directionality of architecture\n", sb.name.c_str());
 		}
+
+		/* parse the switchblock's formulas once, rather than for every location and wire */
+		t_compiled_switchblock compiled_sb = compile_switchblock_formulas(sb);
+
 		/* Iterate over the x,y coordinates spanning the FPGA. */
 		for (size_t x_coord = 0; x_coord < grid.width(); x_coord++){
 			for (size_t y_coord = 0; y_coord <= grid.height(); y_coord++){
@@ -343,7 +375,7 @@ t_sb_connection_map * alloc_and_load_switchblock_permutations(
                         /* Fill appropriate entry of the sb_conns map with vector specifying the wires
                            the current wire will connect to */
                         compute_wire_connections(x_coord, y_coord, from_side, to_side,
-                                chan_details_x, chan_details_y, &sb, grid,
+                                chan_details_x, chan_details_y, &sb, compiled_sb, grid,
                                 &wire_type_sizes, directionality, sb_conns, rand_state);
 
                     }
@@ -357,6 +389,29 @@ t_sb_connection_map * alloc_and_load_switchblock_permutations(
 }
 
 
+/* parses the permutation and num_conns formulas of the specified switchblock */
+static t_compiled_switchblock compile_switchblock_formulas(const t_switchblock_inf& sb){
+	const vector<string> perm_vars = {"W", "t"};
+	const vector<string> num_conns_vars = {"from", "to"};
+	VTR_ASSERT(perm_vars.size() == SB_PERM_NUM_VARS);
+	VTR_ASSERT(num_conns_vars.size() == SB_NUM_CONNS_NUM_VARS);
+
+	t_compiled_switchblock compiled_sb;
+	for (const auto& kv : sb.permutation_map){
+		vector<CompiledFormula>& compiled_perms = compiled_sb.permutation_map[kv.first];
+		for (const string& perm : kv.second){
+			compiled_perms.emplace_back(perm, perm_vars);
+		}
+	}
+
+	for (const t_wireconn_inf& wireconn : sb.wireconns){
+		compiled_sb.num_conns_formulas.emplace_back(wireconn.num_conns_formula, num_conns_vars);
+	}
+
+	return compiled_sb;
+}
+
+
 /* deallocates switch block connections sparse array */
 void free_switchblock_permutations(t_sb_connection_map *sb_conns){
 	sb_conns->clear();
@@ -411,14 +466,15 @@ static int get_max_lcm( vector<t_switchblock_inf> *switchblocks, t_wire_type_siz
 
 /* computes a horizontal row of switchblocks of size sb_row_size (or of grid.width()-4, whichever is smaller), starting
    at coordinate (1,1) */
-static void compute_switchblock_row(int sb_row_size, t_chan_details *chan_details_x, t_chan_details *chan_details_y,
+static void compute_switchblock_row(int sb_row_size, const t_chan_details& chan_details_x, const t_chan_details& chan_details_y,
 		vector<t_switchblock_inf> *switchblocks, const DeviceGrid& grid, int nodes_per_chan,
 		t_wire_type_sizes *wire_type_sizes, e_directionality directionality,
-		t_sb_connection_map *sb_row){
+		t_sb_connection_map *sb_row, vtr::RandState& rand_state){
 
 	int y = 1;
 	for (int isb = 0; isb < (int)switchblocks->size(); isb++){
 		t_switchblock_inf *sb = &(switchblocks->at(isb));
+		t_compiled_switchblock compiled_sb = compile_switchblock_formulas(*sb);
 		for (int x = 1; x < 1 + sb_row_size; x++){
 			if (sb_not_here(grid, x, y, sb->location)){
 				continue;
@@ -430,8 +486,8 @@ static void compute_switchblock_row(int sb_row_size, t_chan_details *chan_detail
                     /* Fill appropriate entry of the sb_conns map with vector specifying the wires
                        the current wire will connect to */
                     compute_wire_connections(x, y, from_side, to_side,
-                            chan_details_x, chan_details_y, sb, grid,
-                            wire_type_sizes, directionality, sb_row);
+                            chan_details_x, chan_details_y, sb, compiled_sb, grid,
+                            wire_type_sizes, directionality, sb_row, rand_state);
                 }
             }
 		}
@@ -494,16 +550,17 @@ static void stampout_switchblocks_from_row( int sb_row_size,
 
 
 /* compute all the switchblocks around the perimeter of the FPGA for the given switchblock and wireconn */
-static void compute_perimeter_switchblocks(t_chan_details *chan_details_x, t_chan_details *chan_details_y,
+static void compute_perimeter_switchblocks(const t_chan_details& chan_details_x, const t_chan_details& chan_details_y,
 		vector<t_switchblock_inf> *switchblocks, const DeviceGrid& grid, int nodes_per_chan,
 		t_wire_type_sizes *wire_type_sizes, e_directionality directionality,
-		t_sb_connection_map *sb_conns){
+		t_sb_connection_map *sb_conns, vtr::RandState& rand_state){
 	int x, y;
 
 	for (int isb = 0; isb < (int)switchblocks->size(); isb++){
 		/* along left and right edge */
 		x = 0;
 		t_switchblock_inf *sb = &(switchblocks->at(isb));
+		t_compiled_switchblock compiled_sb = compile_switchblock_formulas(*sb);
 		for (int i = 0; i < 2; i++){				//TODO: can use i+=grid.width()-2 to make more explicit what the ranges of the loop are
 			for (y = 0; y < grid.height(); y++){
 				if (sb_not_here(grid, x, y, sb->location)){
@@ -516,8 +573,8 @@ static void compute_perimeter_switchblocks(t_chan_details *chan_details_x, t_cha
                         /* Fill appropriate entry of the sb_conns map with vector specifying the wires
                            the current wire will connect to */
                         compute_wire_connections(x, y, from_side, to_side,
-                                chan_details_x, chan_details_y, sb, grid,
-                                wire_type_sizes, directionality, sb_conns);
+                                chan_details_x, chan_details_y, sb, compiled_sb, grid,
+                                wire_type_sizes, directionality, sb_conns, rand_state);
                     }
                 }
 			}
@@ -529,6 +586,7 @@ static void compute_perimeter_switchblocks(t_chan_details *chan_details_x, t_cha
 		/* along bottom and top edge */
 		y = 0;
 		t_switchblock_inf *sb = &(switchblocks->at(isb));
+		t_compiled_switchblock compiled_sb = compile_switchblock_formulas(*sb);
 		for (int i = 0; i < 2; i++){
 			for (x = 0; x < grid.width(); x++){
 				if (sb_not_here(grid, x, y, sb->location)){
@@ -541,8 +599,8 @@ static void compute_perimeter_switchblocks(t_chan_details *chan_details_x, t_cha
                         /* Fill appropriate entry of the sb_conns map with vector specifying the wires
                            the current wire will connect to */
                         compute_wire_connections(x, y, from_side, to_side,
-                                chan_details_x, chan_details_y, sb, grid,
-                                wire_type_sizes, directionality, sb_conns);
+                                chan_details_x, chan_details_y, sb, compiled_sb, grid,
+                                wire_type_sizes, directionality, sb_conns, rand_state);
                     }
                 }
 			}
@@ -746,7 +804,7 @@ static std::vector<t_wire_switchpoint> get_switchpoint_wires(const DeviceGrid& g
 static void compute_wire_connections(int x_coord, int y_coord,
             enum e_side from_side, enum e_side to_side,
             const t_chan_details& chan_details_x, const t_chan_details& chan_details_y,
-            t_switchblock_inf* sb,
+            t_switchblock_inf* sb, const t_compiled_switchblock& compiled_sb,
 			const DeviceGrid& grid,
 			t_wire_type_sizes *wire_type_sizes,
             e_directionality directionality,
@@ -766,7 +824,8 @@ static void compute_wire_connections(int x_coord, int y_coord,
 		return;
 	}
 	/* check that the permutation map has an entry for this side combination */
-	if (sb->permutation_map.count(side_conn) == 0){
+	auto perm_iter = compiled_sb.permutation_map.find(side_conn);
+	if (perm_iter == compiled_sb.permutation_map.end()){
 		/* the specified switchblock does not have any permutation funcs for this side1->side2 connection */
 		return;
 	}
@@ -797,7 +856,8 @@ static void compute_wire_connections(int x_coord, int y_coord,
 		   current wireconn */
 		compute_wireconn_connections(grid, directionality, from_chan_details, to_chan_details,
 						sb_conn, from_x, from_y, to_x, to_y, from_chan_type, to_chan_type, wire_type_sizes,
-						sb, wireconn_ptr, sb_conns, rand_state);
+						wireconn_ptr, compiled_sb.num_conns_formulas[iconn], perm_iter->second,
+						sb_conns, rand_state);
 	}
 
 	return;
@@ -811,9 +871,9 @@ static void compute_wire_connections(int x_coord, int y_coord,
 static void compute_wireconn_connections(const DeviceGrid& grid, e_directionality directionality,
 		const t_chan_details& from_chan_details, const t_chan_details& to_chan_details, Switchblock_Lookup sb_conn,
 		int from_x, int from_y, int to_x, int to_y, t_rr_type from_chan_type, t_rr_type to_chan_type,
-		t_wire_type_sizes *wire_type_sizes, t_switchblock_inf *sb,
-		t_wireconn_inf *wireconn_ptr, t_sb_connection_map *sb_conns,
-        vtr::RandState& rand_state){
+		t_wire_type_sizes *wire_type_sizes, t_wireconn_inf *wireconn_ptr,
+		const CompiledFormula& num_conns_formula, const vector<CompiledFormula>& permutations,
+		t_sb_connection_map *sb_conns, vtr::RandState& rand_state){
 
     constexpr bool verbose = false;
 
@@ -875,7 +935,7 @@ static void compute_wireconn_connections(const DeviceGrid& grid, e_directionalit
     //      * interleave (to ensure good diversity)
 
     //Determine how many connections to make
-    size_t num_conns = evaluate_num_conns_formula(wireconn_ptr->num_conns_formula, potential_src_wires.size(), potential_dest_wires.size());
+    size_t num_conns = evaluate_num_conns_formula(num_conns_formula, potential_src_wires.size(), potential_dest_wires.size());
 
     VTR_LOGV(verbose, "  num_conns: %zu\n", num_conns);
 
@@ -906,18 +966,16 @@ static void compute_wireconn_connections(const DeviceGrid& grid, e_directionalit
         }
 
         //Evaluate permutation functions for the from_wire
-        SB_Side_Connection side_conn(sb_conn.from_side, sb_conn.to_side);
-        vector<string> &permutations_ref = sb->permutation_map[side_conn];
-        for (int iperm = 0; iperm < (int)permutations_ref.size(); iperm++){
+        int perm_vars[SB_PERM_NUM_VARS];
+        perm_vars[SB_PERM_VAR_W] = dest_W;
+        perm_vars[SB_PERM_VAR_T] = src_wire_ind;
+        for (const CompiledFormula& permutation : permutations){
             /* Convert the symbolic permutation formula to a number */
-            t_formula_data formula_data;
-            formula_data.set_var_value("W", dest_W);
-            formula_data.set_var_value("t", src_wire_ind);
-            int raw_dest_wire_ind = get_sb_formula_raw_result(permutations_ref[iperm].c_str(), formula_data);
+            int raw_dest_wire_ind = permutation.evaluate(perm_vars);
             int dest_wire_ind = adjust_formula_result(raw_dest_wire_ind, src_W, dest_W, iconn);
 
             if(dest_wire_ind < 0){
-                vpr_throw(VPR_ERROR_ARCH, __FILE__, __LINE__, "Got a negative wire from switch block formula %s", permutations_ref[iperm].c_str());
+                vpr_throw(VPR_ERROR_ARCH, __FILE__, __LINE__, "Got a negative wire from switch block formula %s", permutation.formula().c_str());
             }
 
             int to_wire = potential_dest_wires[dest_wire_ind].wire; //Index in channel
@@ -948,13 +1006,13 @@ static void compute_wireconn_connections(const DeviceGrid& grid, e_directionalit
     }
 }
 
-static int evaluate_num_conns_formula(std::string num_conns_formula, int from_wire_count, int to_wire_count) {
-    t_formula_data vars;
+static int evaluate_num_conns_formula(const CompiledFormula& num_conns_formula, int from_wire_count, int to_wire_count) {
+    int vars[SB_NUM_CONNS_NUM_VARS];
 
-    vars.set_var_value("from", from_wire_count);
-    vars.set_var_value("to", to_wire_count);
+    vars[SB_NUM_CONNS_VAR_FROM] = from_wire_count;
+    vars[SB_NUM_CONNS_VAR_TO] = to_wire_count;
 
-    return parse_formula(num_conns_formula, vars);
+    return num_conns_formula.evaluate(vars);
 }
 
 /* Here we find the correct channel (x or y), and the coordinates to index into it based on the
@@ -73,6 +73,16 @@ template< typename T > bool set_has_element( const T elem, const std::set< T > *
 }
 
 
+/**** Structs ****/
+/* a proposed annealer move: the switch of the pin at 'pin_index' on 'side' moves from 'old_track' to 'new_track' */
+struct t_cb_move{
+	int side;
+	int pin_index;
+	int old_track;
+	int new_track;
+};
+
+
 /**** Function Declarations ****/
 /* goes through each pin of pin_type and determines which side of the block it comes out on. results are stored in
    the 'pin_locations' 2d-vector */
@@ -89,20 +99,26 @@ static void init_cb_structs( const t_type_ptr block_type, int *****tracks_connec
 
 /* given a set of tracks connected to a pin, we'd like to find which of these tracks are connected to a number of switches
    greater than 'criteria'. The resulting set of tracks is passed back in the 'result' vector */
-static void find_tracks_with_more_switches_than( const set<int> *pin_tracks, const t_vec_vec_set *track_to_pins, const int side,
+static void find_tracks_with_more_switches_than( const Dense_Int_Set *pin_tracks, const t_vec_vec_set *track_to_pins, const int side,
 		const bool both_sides, const int criteria, vector<int> *result );
 /* given a pin on some side of a block, we'd like to find the set of tracks that is NOT connected to that pin on that side. This set of tracks
    is passed back in the 'result' vector */
-static void find_tracks_unconnected_to_pin( const set<int> *pin_tracks, const vector< set<int> > *track_to_pins, vector<int> *result );
+static void find_tracks_unconnected_to_pin( const Dense_Int_Set *pin_tracks, const vector< Dense_Int_Set > *track_to_pins, vector<int> *result );
 
-/* iterates through the elements of set 1 and returns the number of elements in set1 that are
+/* returns the number of elements in set1 that are
    also in set2 (in terms of bit vectors, this looks for the number of positions where both bit vectors
    have a value of 1; values of 0 not counted... so, not quite true hamming proximity). Analogously, if we
    wanted the hamming distance of these two sets, (in terms of bit vectors, the number of bit positions that are
    different... i.e. the actual definition of hamming disatnce) that would be 2(set_size - returned_value) */
-static int hamming_proximity_of_two_sets(const set<int> *set1, const set<int> *set2);
+static int hamming_proximity_of_two_sets(const Dense_Int_Set *set1, const Dense_Int_Set *set2);
+/* returns how much a pin connecting 'count' times to one wire type contributes to that pin's diversity */
+static float get_pin_diversity_term(const int count, const float mean, const int num_wire_types);
 /* returns the pin diversity metric of a block */
 static float get_pin_diversity(const int Fc, const int num_pin_type_pins, const Conn_Block_Metrics *cb_metrics);
+/* computes the mean track usage, the number of unconnected tracks and the normalization factor used by the
+   wire homogeneity metric for a channel segment that sees 'total_pins_on_side' pins */
+static void get_wire_homogeneity_params(const int Fc, const int nodes_per_chan, const int total_pins_on_side, const int exponent,
+		float *mean, int *unconnected_wires, float *normalization);
 /* Returns the wire homogeneity of a block's connection to tracks */
 static float get_wire_homogeneity(const int Fc, const int nodes_per_chan,
 		const int num_pin_type_pins, const int exponent, const bool both_sides, const Conn_Block_Metrics *cb_metrics);
@@ -111,6 +127,19 @@ static float get_hamming_proximity(const int Fc, const int num_pin_type_pins, co
 /* Returns Lemieux's cost function for sparse crossbars (see his 2001 book) applied here to the connection block */
 static float get_lemieux_cost_func(const int exponent, const bool both_sides, const Conn_Block_Metrics *cb_metrics);
 
+/* returns whether the CB metrics of this block/pin type should account for pins on both sides of a channel segment */
+static bool metrics_use_both_sides(const t_type_ptr block_type, const e_pin_type pin_type);
+/* computes all the metrics from scratch and stores them in cb_metrics */
+static void compute_cb_metrics(const int Fc, const int nodes_per_chan, const int num_pin_type_pins, const bool both_sides,
+		Conn_Block_Metrics *cb_metrics);
+/* returns the stored value of the specified metric */
+static float get_cb_metric(const e_metric metric, const Conn_Block_Metrics *cb_metrics);
+/* returns the value the specified metric takes after 'move', which must already have been applied to the lookups in
+   cb_metrics. only the terms involving the moved pin or its two tracks are evaluated; the rest of the metric is carried
+   over from the value stored before the move */
+static float get_cb_metric_after_move(const e_metric metric, const int Fc, const int nodes_per_chan, const int num_pin_type_pins,
+		const bool both_sides, const t_cb_move &move, const Conn_Block_Metrics *cb_metrics);
+
 /* this annealer is used to adjust a desired wire or pin metric while keeping the other type of metric
    relatively constant */
 static bool annealer(const e_metric metric, const int nodes_per_chan, const t_type_ptr block_type,
@@ -222,6 +251,14 @@ void get_conn_block_metrics(const t_type_ptr block_type, int *****tracks_connect
 
 	/* check based on block type whether we should account for pins on both sides of a channel when computing the relevant CB metrics
 	  (i.e. from a block on the left and from a block on the right for a vertical channel, for instance) */
+	bool both_sides = metrics_use_both_sides(block_type, pin_type);
+
+	/* get the metrics */
+	compute_cb_metrics(Fc, nodes_per_chan, num_pin_type_pins, both_sides, cb_metrics);
+}
+
+/* returns whether the CB metrics of this block/pin type should account for pins on both sides of a channel segment */
+static bool metrics_use_both_sides(const t_type_ptr block_type, const e_pin_type pin_type){
 	bool both_sides = false;
 	if (0 == strcmp("clb", block_type->name) && DRIVER == pin_type){
 		/* many CLBs are adjacent to eachother, so connections from one CLB
@@ -232,8 +269,13 @@ void get_conn_block_metrics(const t_type_ptr block_type, int *****tracks_connect
 		/* other blocks (i.e. IO, RAM, etc) are not as frequent as CLBs */
 		both_sides = false;
 	}
+	return both_sides;
+}
+
+/* computes all the metrics from scratch and stores them in cb_metrics */
+static void compute_cb_metrics(const int Fc, const int nodes_per_chan, const int num_pin_type_pins, const bool both_sides,
+		Conn_Block_Metrics *cb_metrics){
 
-	/* get the metrics */
 	cb_metrics->wire_homogeneity = get_wire_homogeneity(Fc, nodes_per_chan, num_pin_type_pins, 2, both_sides, cb_metrics);
 
 	cb_metrics->hamming_proximity = get_hamming_proximity(Fc, num_pin_type_pins, 2, both_sides, cb_metrics);
@@ -260,14 +302,14 @@ static void init_cb_structs(const t_type_ptr block_type, int *****tracks_connect
 
 	/* allocate the multi-dimensional vectors used for conveniently calculating CB metrics */
 	for (int iside = 0; iside < 4; iside++){
-		cb_metrics->track_to_pins.push_back( vector< set<int> >() );
-		cb_metrics->pin_to_tracks.push_back( vector< set<int> >() );
+		cb_metrics->track_to_pins.push_back( vector< Dense_Int_Set >() );
+		cb_metrics->pin_to_tracks.push_back( vector< Dense_Int_Set >() );
 		cb_metrics->wire_types_used_count.push_back( vector< vector<int> >() );
 		for (int i = 0; i < nodes_per_chan; i++){
-			cb_metrics->track_to_pins.at(iside).push_back( set<int>() );
+			cb_metrics->track_to_pins.at(iside).push_back( Dense_Int_Set(block_type->num_pins) );
 		}
 		for (int ipin = 0; ipin < (int)cb_metrics->pin_locations.at(iside).size(); ipin++){
-			cb_metrics->pin_to_tracks.at(iside).push_back( set<int>() );
+			cb_metrics->pin_to_tracks.at(iside).push_back( Dense_Int_Set(nodes_per_chan) );
 			cb_metrics->wire_types_used_count.at(iside).push_back( vector<int>() );
 			for (int itype = 0; itype < num_wire_types; itype++){
 				cb_metrics->wire_types_used_count.at(iside).at(ipin).push_back(0);
@@ -306,15 +348,13 @@ static void init_cb_structs(const t_type_ptr block_type, int *****tracks_connect
 							break;
 						}
 
-						pair< set<int>::iterator, bool > result1 = cb_metrics->pin_to_tracks.at(iside).at(ipin).insert( track );
-						if (!result1.second){
+						if (!cb_metrics->pin_to_tracks.at(iside).at(ipin).insert( track )){
 							/* this track should not already be a part of the set */
 							vpr_throw(VPR_ERROR_ROUTE, __FILE__, __LINE__, "Attempted to insert element into pin_to_tracks set which already exists there\n");
 						}
 
 						/* insert the current pin into the corresponding tracks_to_pin entry */
-						pair< set<int>::iterator, bool > result2 = cb_metrics->track_to_pins.at(iside).at(track).insert( pin );
-						if (!result2.second){
+						if (!cb_metrics->track_to_pins.at(iside).at(track).insert( pin )){
 							/* this pin should not already be a part of the set */
 							vpr_throw(VPR_ERROR_ROUTE, __FILE__, __LINE__, "Attempted to insert element into track_to_pins set which already exists there\n");
 						}
@@ -371,7 +411,6 @@ int get_max_Fc(const int *Fc_array, const t_type_ptr block_type, const e_pin_typ
 static float get_pin_diversity(const int Fc, const int num_pin_type_pins, const Conn_Block_Metrics *cb_metrics){
 
 	float total_pin_diversity = 0;
-	float exp_factor = 3.3;
 	int num_wire_types = cb_metrics->num_wire_types;
 
 	/* Determine the diversity of each pin. The concept of this function is that	*
@@ -384,8 +423,7 @@ static float get_pin_diversity(const int Fc, const int num_pin_type_pins, const
 		for (int ipin = 0; ipin < (int)cb_metrics->pin_locations.at(iside).size(); ipin++){
 			float pin_diversity = 0;
 			for (int i = 0; i < num_wire_types; i++){
-				pin_diversity += (1 / (float)num_wire_types) *
-					      (1 - exp(-exp_factor * (float)cb_metrics->wire_types_used_count.at(iside).at(ipin).at(i) / mean));
+				pin_diversity += get_pin_diversity_term(cb_metrics->wire_types_used_count.at(iside).at(ipin).at(i), mean, num_wire_types);
 			}
 			total_pin_diversity += pin_diversity;
 		}
@@ -394,6 +432,12 @@ static float get_pin_diversity(const int Fc, const int num_pin_type_pins, const
 	return total_pin_diversity;
 }
 
+/* returns how much a pin connecting 'count' times to one wire type contributes to that pin's diversity */
+static float get_pin_diversity_term(const int count, const float mean, const int num_wire_types){
+	float exp_factor = 3.3;
+	return (1 / (float)num_wire_types) * (1 - exp(-exp_factor * (float)count / mean));
+}
+
 /* Returns Lemieux's cost function for sparse crossbars (see his 2001 book) applied here to the connection block */
 static float get_lemieux_cost_func(const int exponent, const bool both_sides, const Conn_Block_Metrics *cb_metrics){
 
@@ -429,7 +473,7 @@ static float get_lemieux_cost_func(const int exponent, const bool both_sides, co
 			if (both_sides){
 				if (ipin >= (int)pin_locations->at(iside).size()){
 					pin_side += 2;
-					pin_ind = pin_ind % pin_locations->at(iside).size();
+					pin_ind -= (int)pin_locations->at(iside).size();
 				}
 			}
 			float pin_lcf = 0;
@@ -440,7 +484,7 @@ static float get_lemieux_cost_func(const int exponent, const bool both_sides, co
 				if (both_sides){
 					if (icomp >= (int)pin_locations->at(iside).size()){
 						comp_side += 2;
-						comp_pin_ind = comp_pin_ind % pin_locations->at(iside).size();
+						comp_pin_ind -= (int)pin_locations->at(iside).size();
 					}
 				}
 				pin_comparisons++;
@@ -497,7 +541,7 @@ static float get_hamming_proximity(const int Fc, const int num_pin_type_pins, co
 			if (both_sides){
 				if (ipin >= (int)pin_locations->at(iside).size()){
 					pin_side += 2;
-					pin_ind = pin_ind % pin_locations->at(iside).size();
+					pin_ind -= (int)pin_locations->at(iside).size();
 				}
 			}
 			float pin_hp = 0;
@@ -508,7 +552,7 @@ static float get_hamming_proximity(const int Fc, const int num_pin_type_pins, co
 				if (both_sides){
 					if (icomp >= (int)pin_locations->at(iside).size()){
 						comp_side += 2;
-						comp_pin_ind = comp_pin_ind % pin_locations->at(iside).size();
+						comp_pin_ind -= (int)pin_locations->at(iside).size();
 					}
 				}
 				pin_comparisons++;
@@ -526,22 +570,13 @@ static float get_hamming_proximity(const int Fc, const int num_pin_type_pins, co
 	return hamming_proximity;
 }
 
-/* iterates through the elements of set 1 and returns the number of elements in set1 that are
+/* returns the number of elements in set1 that are
    also in set2 (in terms of bit vectors, this looks for the number of positions where both bit vectors
    have a value of 1; values of 0 not counted... so, not quite true hamming proximity). Analogously, if we
    wanted the hamming distance of these two sets, (in terms of bit vectors, the number of bit positions that are
    different... i.e. the actual definition of hamming disatnce) that would be 2(set_size - returned_value) */
-static int hamming_proximity_of_two_sets(const set<int> *set1, const set<int> *set2){
-	int result = 0;
-
-	set<int>::const_iterator it;
-	for (it = set1->begin(); it != set1->end(); it++){
-		int element = *it;
-		if ( set_has_element(element, set2) ){
-			result++;
-		}
-	}
-	return result;
+static int hamming_proximity_of_two_sets(const Dense_Int_Set *set1, const Dense_Int_Set *set2){
+	return set1->intersection_size(*set2);
 }
 
 /* Returns the wire homogeneity of a block's connection to tracks */
@@ -558,7 +593,6 @@ static float get_wire_homogeneity(const int Fc, const int nodes_per_chan, const
 	}
 
 	int unconnected_wires = 0;
-	int total_conns = 0;
 	int total_pins_on_side = 0;
 	float mean = 0;
 	float wire_homogeneity_temp = 0;
@@ -570,7 +604,7 @@ static float get_wire_homogeneity(const int Fc, const int nodes_per_chan, const
 	for (int side = 0; side < (4 / mult); side++){
 		mean = 0;
 		unconnected_wires = 0;
-		total_conns = total_pins_on_side = 0;
+		total_pins_on_side = 0;
 		for (int i = 0; i < mult; i++){
 			total_pins_on_side += counted_pins_per_side[side + mult*i];
 		}
@@ -579,9 +613,8 @@ static float get_wire_homogeneity(const int Fc, const int nodes_per_chan, const
 			continue;
 		}
 
-		total_conns = total_pins_on_side * Fc;
-		unconnected_wires = (total_conns) ? max(0, nodes_per_chan - total_conns)  :  0 ;
-		mean = (float)total_conns / (float)(nodes_per_chan - unconnected_wires);
+		float normalization = 0;
+		get_wire_homogeneity_params(Fc, nodes_per_chan, total_pins_on_side, exponent, &mean, &unconnected_wires, &normalization);
 		wire_homogeneity[side] = 0;
 		for (int track = 0; track < nodes_per_chan; track++){
 			wire_homogeneity_temp = 0;
@@ -593,7 +626,6 @@ static float get_wire_homogeneity(const int Fc, const int nodes_per_chan, const
 			}
 			wire_homogeneity[side] += pow(fabs(wire_homogeneity_temp - mean), exponent);
 		}
-		float normalization = ((float)Fc*pow(((float)total_pins_on_side - mean),exponent) + (float)(nodes_per_chan - Fc)*pow(mean,exponent)) / (float)total_pins_on_side;
 		wire_homogeneity[side] -= unconnected_wires * mean;
 		wire_homogeneity[side] /= normalization;
 		total_wire_homogeneity += wire_homogeneity[side];
@@ -603,6 +635,17 @@ static float get_wire_homogeneity(const int Fc, const int nodes_per_chan, const
 	return total_wire_homogeneity;
 }
 
+/* computes the mean track usage, the number of unconnected tracks and the normalization factor used by the
+   wire homogeneity metric for a channel segment that sees 'total_pins_on_side' pins */
+static void get_wire_homogeneity_params(const int Fc, const int nodes_per_chan, const int total_pins_on_side, const int exponent,
+		float *mean, int *unconnected_wires, float *normalization){
+
+	int total_conns = total_pins_on_side * Fc;
+	*unconnected_wires = (total_conns) ? max(0, nodes_per_chan - total_conns)  :  0 ;
+	*mean = (float)total_conns / (float)(nodes_per_chan - *unconnected_wires);
+	*normalization = ((float)Fc*pow(((float)total_pins_on_side - *mean),exponent) + (float)(nodes_per_chan - Fc)*pow(*mean,exponent)) / (float)total_pins_on_side;
+}
+
 /* goes through each pin of pin_type and determines which side of the block it comes out on. results are stored in
    the 'pin_locations' 2d-vector */
 static void get_pin_locations(const t_type_ptr block_type, const e_pin_type pin_type, const int num_pin_type_pins, int *****tracks_connected_to_pin, t_2d_int_vec *pin_locations){
@@ -648,7 +691,7 @@ static void get_pin_locations(const t_type_ptr block_type, const e_pin_type pin_
 
 /* given a set of tracks connected to a pin, we'd like to find which of these tracks are connected to a number of switches
    greater than 'criteria'. The resulting set of tracks is passed back in the 'result' vector */
-static void find_tracks_with_more_switches_than( const set<int> *pin_tracks, const t_vec_vec_set *track_to_pins, const int side,
+static void find_tracks_with_more_switches_than( const Dense_Int_Set *pin_tracks, const t_vec_vec_set *track_to_pins, const int side,
 		const bool both_sides, const int criteria, vector<int> *result ){
 	result->clear();
 
@@ -657,9 +700,7 @@ static void find_tracks_with_more_switches_than( const set<int> *pin_tracks, con
 	}
 
 	/* for each track connected to the pin */
-	set<int>::const_iterator it;
-	for (it = pin_tracks->begin(); it != pin_tracks->end(); it++){
-		int track = *it;
+	for (int track = pin_tracks->next(0); track >= 0; track = pin_tracks->next(track+1)){
 
 		int num_switches = 0;
 		if (both_sides){
@@ -675,19 +716,153 @@ static void find_tracks_with_more_switches_than( const set<int> *pin_tracks, con
 
 /* given a pin on some side of a block, we'd like to find the set of tracks that is NOT connected to that pin on that side. This set of tracks
    is passed back in the 'result' vector */
-static void find_tracks_unconnected_to_pin( const set<int> *pin_tracks, const vector< set<int> > *track_to_pins, vector<int> *result ){
+static void find_tracks_unconnected_to_pin( const Dense_Int_Set *pin_tracks, const vector< Dense_Int_Set > *track_to_pins, vector<int> *result ){
 	result->clear();
 	/* for each track in the channel segment */
 	for (int itrack = 0; itrack < (int)track_to_pins->size(); itrack++){
 		/* check if this track is not connected to the pin */
-		if ( !set_has_element(itrack, pin_tracks) ){
+		if ( !pin_tracks->contains(itrack) ){
 			result->push_back(itrack);
 		}
 	}
 }
 
+/* returns the stored value of the specified metric */
+static float get_cb_metric(const e_metric metric, const Conn_Block_Metrics *cb_metrics){
+	float value = 0;
+	switch(metric){
+		case WIRE_HOMOGENEITY:
+			value = cb_metrics->wire_homogeneity;
+			break;
+		case HAMMING_PROXIMITY:
+			value = cb_metrics->hamming_proximity;
+			break;
+		case LEMIEUX_COST_FUNC:
+			value = cb_metrics->lemieux_cost_func;
+			break;
+		case PIN_DIVERSITY:
+			value = cb_metrics->pin_diversity;
+			break;
+		default:
+			vpr_throw(VPR_ERROR_ROUTE, __FILE__, __LINE__, "get_cb_metric: illegal CB metric: %d\n", (int)metric);
+			break;
+	}
+	return value;
+}
+
+/* returns the value the specified metric takes after 'move', which must already have been applied to the lookups in
+   cb_metrics. only the terms involving the moved pin or its two tracks are evaluated; the rest of the metric is carried
+   over from the value stored before the move */
+static float get_cb_metric_after_move(const e_metric metric, const int Fc, const int nodes_per_chan, const int num_pin_type_pins,
+		const bool both_sides, const t_cb_move &move, const Conn_Block_Metrics *cb_metrics){
+
+	const int exponent = 2;
+	const t_2d_int_vec *pin_locations = &cb_metrics->pin_locations;
+	const t_vec_vec_set *pin_to_tracks = &cb_metrics->pin_to_tracks;
+	const t_vec_vec_set *track_to_pins = &cb_metrics->track_to_pins;
+
+	/* the wire metrics are computed over groups of sides: a single side, or a side together with its opposite side
+	   if pins on both sides of the channel are accounted for. 'group_side' is the first side of the moved pin's group */
+	int mult = (both_sides) ? 2 : 1;
+	int group_side = move.side % (4 / mult);
+	int num_pins = 0;
+	for (int i = 0; i < mult; i++){
+		num_pins += (int)pin_locations->at(group_side + 2*i).size();
+	}
+
+	double delta = 0;
+	switch(metric){
+		case WIRE_HOMOGENEITY:{
+			/* only the usage of the old and the new track has changed */
+			float mean, normalization;
+			int unconnected_wires;
+			get_wire_homogeneity_params(Fc, nodes_per_chan, num_pins, exponent, &mean, &unconnected_wires, &normalization);
+
+			int old_usage = 0;
+			int new_usage = 0;
+			for (int i = 0; i < mult; i++){
+				int side = group_side + 2*i;
+				if (pin_locations->at(side).size() > 0){
+					old_usage += track_to_pins->at(side).at(move.old_track).size();
+					new_usage += track_to_pins->at(side).at(move.new_track).size();
+				}
+			}
+			delta += pow(fabs((float)old_usage - mean), exponent) - pow(fabs((float)(old_usage + 1) - mean), exponent);
+			delta += pow(fabs((float)new_usage - mean), exponent) - pow(fabs((float)(new_usage - 1) - mean), exponent);
+			delta /= normalization;
+			delta /= num_pin_type_pins;
+			break;
+		}
+		case HAMMING_PROXIMITY:
+		case LEMIEUX_COST_FUNC:{
+			/* only the comparisons between the moved pin and the other pins of its group have changed. the overlap with
+			   each of those pins changed by one for each of the two tracks the other pin connects to */
+			const Dense_Int_Set *moved_tracks = &pin_to_tracks->at(move.side).at(move.pin_index);
+			int moved_order = move.pin_index + ((move.side != group_side) ? (int)pin_locations->at(group_side).size() : 0);
+			int comp_order = 0;
+			for (int i = 0; i < mult; i++){
+				int side = group_side + 2*i;
+				for (int ipin = 0; ipin < (int)pin_locations->at(side).size(); ipin++, comp_order++){
+					if (comp_order == moved_order){
+						continue;
+					}
+					const Dense_Int_Set *comp_tracks = &pin_to_tracks->at(side).at(ipin);
+					int new_overlap = hamming_proximity_of_two_sets(moved_tracks, comp_tracks);
+					int old_overlap = new_overlap + (int)comp_tracks->contains(move.old_track) - (int)comp_tracks->contains(move.new_track);
+
+					if (HAMMING_PROXIMITY == metric){
+						delta += pow((float)new_overlap, exponent) - pow((float)old_overlap, exponent);
+					} else {
+						/* the hamming distance is taken relative to the pin that comes first in the comparison order.
+						   the move does not change the number of tracks a pin connects to */
+						int first_size = (moved_order < comp_order) ? moved_tracks->size() : comp_tracks->size();
+						float new_dist = 2*(first_size - new_overlap);
+						float old_dist = 2*(first_size - old_overlap);
+						if (0 == new_dist){
+							new_dist = 1;
+						}
+						if (0 == old_dist){
+							old_dist = 1;
+						}
+						delta += pow(1.0 / new_dist, exponent) - pow(1.0 / old_dist, exponent);
+					}
+				}
+			}
+			if (HAMMING_PROXIMITY == metric){
+				delta *= 2.0 / (float)((num_pins-1) * pow(Fc, exponent));
+				delta /= num_pin_type_pins;
+			} else {
+				delta /= (0.5*num_pins*(num_pins-1));
+				delta /= (4.0 / (both_sides ? 2.0 : 1.0));
+			}
+			break;
+		}
+		case PIN_DIVERSITY:{
+			/* only the moved pin's use of the old and the new track's wire types has changed */
+			int num_wire_types = cb_metrics->num_wire_types;
+			int old_type = move.old_track % num_wire_types;
+			int new_type = move.new_track % num_wire_types;
+			if (old_type != new_type){
+				const vector<int> *types_used = &cb_metrics->wire_types_used_count.at(move.side).at(move.pin_index);
+				float mean = (float)Fc / (float)(num_wire_types);
+				delta += get_pin_diversity_term(types_used->at(old_type), mean, num_wire_types)
+				       - get_pin_diversity_term(types_used->at(old_type) + 1, mean, num_wire_types);
+				delta += get_pin_diversity_term(types_used->at(new_type), mean, num_wire_types)
+				       - get_pin_diversity_term(types_used->at(new_type) - 1, mean, num_wire_types);
+				delta /= num_pin_type_pins;
+			}
+			break;
+		}
+		default:
+			vpr_throw(VPR_ERROR_ROUTE, __FILE__, __LINE__, "get_cb_metric_after_move: illegal CB metric: %d\n", (int)metric);
+			break;
+	}
+
+	return get_cb_metric(metric, cb_metrics) + delta;
+}
+
 /* this function simply moves a switch from one track to another track (with an empty slot). The switch stays on the
-   same pin as before. */
+   same pin as before. The metrics are updated incrementally from the terms the move affects */
 static double try_move(const e_metric metric, const int nodes_per_chan, const float initial_orthogonal_metric,
 		const float orthogonal_metric_tolerance, const t_type_ptr block_type, const e_pin_type pin_type, const int Fc,
 		const int num_pin_type_pins, const double cost, const double temp, const float target_metric,
@@ -710,16 +885,7 @@ static double try_move(const e_metric metric, const int nodes_per_chan, const fl
 
 	/* for the CLB block types it is appropriate to account for pins on both sides of a channel segment when
 	   calculating a CB metric (because CLBs are often found side by side) */
-	bool both_sides = false;
-	if (0 == strcmp("clb", block_type->name) && DRIVER == pin_type){
-		/* many CLBs are adjacent to eachother, so connections from one CLB
-		*  will share the channel segment with its neighbor. We'd like to take this into
-		*  account for the applicable metrics. */
-		both_sides = true;
-	} else {
-		/* other blocks (i.e. IO, RAM, etc) are not as frequent as CLBs */
-		both_sides = false;
-	}
+	bool both_sides = metrics_use_both_sides(block_type, pin_type);
 
 	static vector<int> set_of_tracks;
 	/* the set_of_tracks vector is used to find sets of tracks satisfying some criteria that we want. we reserve memory for it, which
@@ -731,7 +897,7 @@ static double try_move(const e_metric metric, const int nodes_per_chan, const fl
 	int rand_side = vtr::irand(3);
 	int rand_pin_index = vtr::irand( cb_metrics->pin_locations.at(rand_side).size()-1 );
 	int rand_pin = cb_metrics->pin_locations.at(rand_side).at(rand_pin_index);
-	set<int> *tracks_connected_to_pin = &pin_to_tracks->at(rand_side).at(rand_pin_index);
+	Dense_Int_Set *tracks_connected_to_pin = &pin_to_tracks->at(rand_side).at(rand_pin_index);
 
 	/* If the pin is unconnected, return. */
 	if (0 == tracks_connected_to_pin->size()){
@@ -778,14 +944,22 @@ static double try_move(const e_metric metric, const int nodes_per_chan, const fl
 			wire_types_used_count->at(rand_side).at(rand_pin_index).at(old_track % num_wire_types)--;
 			wire_types_used_count->at(rand_side).at(rand_pin_index).at(new_track % num_wire_types)++;
 
+			t_cb_move move;
+			move.side = rand_side;
+			move.pin_index = rand_pin_index;
+			move.old_track = old_track;
+			move.new_track = new_track;
+
 			/* the orthogonal metric needs to stay within some tolerance of its initial value. here we get the
 			   orthogonal metric after the above move */
 			if (metric < NUM_WIRE_METRICS){
 				/* get the new pin diversity cost */
-				new_orthogonal_metric = get_pin_diversity(Fc, num_pin_type_pins, cb_metrics);
+				new_orthogonal_metric = get_cb_metric_after_move(PIN_DIVERSITY, Fc, nodes_per_chan, num_pin_type_pins,
+						both_sides, move, cb_metrics);
 			} else {
 				/* get the new wire homogeneity cost */
-				new_orthogonal_metric = get_wire_homogeneity(Fc, nodes_per_chan, num_pin_type_pins, 2, both_sides, cb_metrics);
+				new_orthogonal_metric = get_cb_metric_after_move(WIRE_HOMOGENEITY, Fc, nodes_per_chan, num_pin_type_pins,
+						both_sides, move, cb_metrics);
 			}
 
 			/* check if the orthogonal metric has remained within tolerance */
@@ -794,26 +968,8 @@ static double try_move(const e_metric metric, const int nodes_per_chan, const fl
 				/* The orthogonal metric is within tolerance. Can proceed */
 
 				/* get the new metric */
-				new_metric = 0;
-
 				double delta_cost;
-				switch(metric){
-					case WIRE_HOMOGENEITY:
-						new_metric = get_wire_homogeneity(Fc, nodes_per_chan, num_pin_type_pins, 2, both_sides, cb_metrics);
-						break;
-					case HAMMING_PROXIMITY:
-						new_metric = get_hamming_proximity(Fc, num_pin_type_pins, 2, both_sides, cb_metrics);
-						break;
-					case LEMIEUX_COST_FUNC:
-						new_metric = get_lemieux_cost_func(2, both_sides, cb_metrics);
-						break;
-					case PIN_DIVERSITY:
-						new_metric = get_pin_diversity(Fc, num_pin_type_pins, cb_metrics);
-						break;
-					default:
-						vpr_throw(VPR_ERROR_ROUTE, __FILE__, __LINE__, "try_move: illegal CB metric being adjusted: %d\n", (int)metric);
-						break;
-				}
+				new_metric = get_cb_metric_after_move(metric, Fc, nodes_per_chan, num_pin_type_pins, both_sides, move, cb_metrics);
 				new_cost = fabs(target_metric - new_metric);
 				delta_cost = new_cost - cost;
 				if (!accept_move(delta_cost, temp)){
@@ -890,6 +1046,8 @@ static bool annealer(const e_metric metric, const int nodes_per_chan, const t_ty
 	float initial_orthogonal_metric;
 	float orthogonal_metric_tolerance;
 
+	bool both_sides = metrics_use_both_sides(block_type, pin_type);
+
 	/* get initial metrics and cost */
 	double cost = 0;
 	orthogonal_metric_tolerance = 0.05;
@@ -936,6 +1094,12 @@ static bool annealer(const e_metric metric, const int nodes_per_chan, const t_ty
 			}
 		}
 
+		/* try_move updates the metrics incrementally. periodically recompute them so round-off does not accumulate */
+		if ((i_outer + 1) % METRIC_RESYNC_PERIOD == 0){
+			compute_cb_metrics(Fc, nodes_per_chan, num_pin_type_pins, both_sides, cb_metrics);
+			cost = fabs(get_cb_metric(metric, cb_metrics) - target_metric);
+		}
+
 		temp = update_temp(temp);
 
 		/* stop if temperature has decreased to 0 */
@@ -949,6 +1113,9 @@ static bool annealer(const e_metric metric, const int nodes_per_chan, const t_ty
 		}
 	}
 
+	compute_cb_metrics(Fc, nodes_per_chan, num_pin_type_pins, both_sides, cb_metrics);
+	cost = fabs(get_cb_metric(metric, cb_metrics) - target_metric);
+
 	if (cost <= target_metric_tolerance){
 		success = true;
 	} else {
@@ -3,12 +3,18 @@
 
 #include <vector>
 #include <set>
+#include <bitset>
+#include <cstdint>
+#include <algorithm>
 
 #define MAX_OUTER_ITERATIONS 100000
 #define MAX_INNER_ITERATIONS 10
 #define INITIAL_TEMP 1
 #define LOWEST_TEMP 0.00001
 #define TEMP_DECREASE_FAC 0.999
+/* the annealer updates metrics incrementally after each move; every this many outer iterations they are recomputed
+   from scratch so that floating point round-off can not accumulate */
+#define METRIC_RESYNC_PERIOD 1000
 
 
 /**** Enums ****/
@@ -28,11 +34,94 @@ enum e_metric{
 typedef std::vector< std::vector<int> > t_2d_int_vec;
 /* 3D vector of integers */
 typedef std::vector< std::vector< std::vector<int> > > t_3d_int_vec;
-/* a vector of vectors of integer sets. used for pin-to-track and track-to-pin lookups */
-typedef std::vector< std::vector< std::set<int> > > t_vec_vec_set;
 
 
 /**** Classes ****/
+/* A set of small non-negative integers (tracks or pins) stored as a dense bit vector. The number of members is cached
+   so that size() is constant time, and the overlap of two sets is computed a word at a time with a population count */
+class Dense_Int_Set{
+public:
+	Dense_Int_Set() = default;
+	explicit Dense_Int_Set(const int universe_size){
+		words_.assign((universe_size + 63) / 64, 0);
+	}
+
+	/* inserts 'elem'. returns false if it was already a member */
+	bool insert(const int elem){
+		uint64_t mask = bit(elem);
+		uint64_t &word = words_.at(elem / 64);
+		if (word & mask){
+			return false;
+		}
+		word |= mask;
+		num_members_++;
+		return true;
+	}
+	/* removes 'elem'. returns false if it was not a member */
+	bool erase(const int elem){
+		uint64_t mask = bit(elem);
+		uint64_t &word = words_.at(elem / 64);
+		if (!(word & mask)){
+			return false;
+		}
+		word &= ~mask;
+		num_members_--;
+		return true;
+	}
+	bool contains(const int elem) const{
+		return (words_[elem / 64] & bit(elem)) != 0;
+	}
+	int size() const{
+		return num_members_;
+	}
+	/* the largest element this set can hold, plus one */
+	int universe_size() const{
+		return (int)words_.size() * 64;
+	}
+
+	/* returns the smallest member that is >= 'elem', or -1 if there is none. lets callers walk the members in order:
+	   for (int i = set.next(0); i >= 0; i = set.next(i+1)) */
+	int next(const int elem) const{
+		int iword = elem / 64;
+		if (iword >= (int)words_.size()){
+			return -1;
+		}
+		uint64_t word = words_[iword] & (~(uint64_t)0 << (elem % 64));
+		while (word == 0){
+			if (++iword == (int)words_.size()){
+				return -1;
+			}
+			word = words_[iword];
+		}
+		return iword * 64 + count_trailing_zeros(word);
+	}
+
+	/* the number of members shared with 'other' */
+	int intersection_size(const Dense_Int_Set &other) const{
+		int result = 0;
+		int num_words = std::min(words_.size(), other.words_.size());
+		for (int i = 0; i < num_words; i++){
+			result += (int)std::bitset<64>(words_[i] & other.words_[i]).count();
+		}
+		return result;
+	}
+
+private:
+	static uint64_t bit(const int elem){
+		return (uint64_t)1 << (elem % 64);
+	}
+	static int count_trailing_zeros(const uint64_t word){
+		/* isolate the lowest set bit; the population count of the bits below it is its index */
+		return (int)std::bitset<64>((word & (~word + 1)) - 1).count();
+	}
+
+	std::vector<uint64_t> words_;
+	int num_members_ = 0;
+};
+
+/* a vector of vectors of dense integer sets. used for pin-to-track and track-to-pin lookups */
+typedef std::vector< std::vector< Dense_Int_Set > > t_vec_vec_set;
+
 /* Contains various useful structures to calculate connection block metrics, and is used to
    hold the CB metrics themselves */
 class Conn_Block_Metrics{
@@ -1,4 +1,7 @@
 #include <cstdio>
+#include <memory>
+#include <unordered_map>
+#include <unordered_set>
 using namespace std;
 
 #include "vtr_assert.h"
@@ -13,8 +16,18 @@ using namespace std;
 #include "check_route.h"
 #include "rr_graph.h"
 #include "check_rr_graph.h"
+#include "range_checks.h"
 #include "read_xml_arch_file.h"
 
+#if defined(TATUM_USE_TBB)
+# include <tbb/parallel_for.h>
+#endif
+
+/* Number of nets checked together by one task */
+constexpr size_t NET_CHECK_RANGE_SIZE = 64;
+/* Number of rr_nodes expanded together by one task when collecting non-configurable sets */
+constexpr size_t RR_NODE_EXPAND_RANGE_SIZE = 4096;
+
 struct t_node_edge {
     t_node_edge(int fnode, int tnode) {
         from_node = fnode;
@@ -32,21 +45,36 @@ struct t_node_edge {
 
 struct t_non_configurable_rr_sets {
 
-    std::set<std::set<int>> node_sets;
-    std::set<std::set<t_node_edge>> edge_sets;
+    std::vector<std::set<int>> node_sets;
+    std::vector<std::set<t_node_edge>> edge_sets;
+
+    //Lookups from an RR node to the node sets containing it, and to the
+    //edge sets containing an edge leaving it. Only the sets touched by a
+    //net's routing need to be checked against it.
+    std::unordered_map<int,std::vector<int>> node_to_node_sets;
+    std::unordered_map<int,std::vector<int>> node_to_edge_sets;
 };
 
+/* The non-configurable sets only depend on the rr graph, so they are collected once per rr graph *
+ * (rather than on every, possibly incremental, check) and freed with it (see free_rr_graph()).   */
+static std::unique_ptr<t_non_configurable_rr_sets> non_configurable_rr_sets_cache;
+
 /******************** Subroutines local to this module **********************/
-static void check_node_and_range(int inode, enum e_route_type route_type);
+static void check_node_and_range(int inode, enum e_route_type route_type, std::vector<std::string>* warnings);
 static void check_source(int inode, ClusterNetId net_id);
-static void check_sink(int inode, ClusterNetId net_id, bool * pin_done);
+static void check_sink(int inode, ClusterNetId net_id, std::vector<bool>& pin_done);
 static void check_switch(t_trace *tptr, int num_switch);
 static bool check_adjacent(int from_node, int to_node);
 static int chanx_chany_adjacent(int chanx_node, int chany_node);
-static void reset_flags(ClusterNetId inet, bool * connected_to_route);
+static void check_net_routes(const std::vector<ClusterNetId>& nets, enum e_route_type route_type, int num_switches);
+static void check_net_route(ClusterNetId net_id, enum e_route_type route_type, int num_switches,
+		const t_non_configurable_rr_sets& non_configurable_rr_sets,
+		std::unordered_set<int>& connected_to_route, std::vector<bool>& pin_done,
+		std::vector<std::string>& warnings);
 static void check_locally_used_clb_opins(const t_clb_opins_used&  clb_opins_used_locally,
 		enum e_route_type route_type);
 
+static const t_non_configurable_rr_sets& get_non_configurable_rr_sets();
 static t_non_configurable_rr_sets identify_non_configurable_rr_sets();
 static void expand_non_configurable(int inode, std::set<t_node_edge>& edge_set);
 static bool check_non_configurable_edges(ClusterNetId net, const t_non_configurable_rr_sets& non_configurable_rr_sets);
@@ -61,14 +89,8 @@ void check_route(enum e_route_type route_type, int num_switches) {
 	 * oversubscribed (the occupancy of everything is recomputed from        *
 	 * scratch).                                                             */
 
-	int max_pins, inode, prev_node;
-	unsigned int ipin;
-	bool valid, connects;
-	bool * connected_to_route; /* [0 .. device_ctx.rr_nodes.size()-1] */
-	t_trace *tptr;
-	bool * pin_done;
+	bool valid;
 
-    auto& device_ctx = g_vpr_ctx.device();
     auto& cluster_ctx = g_vpr_ctx.clustering();
     auto& route_ctx = g_vpr_ctx.routing();
 
@@ -88,110 +110,158 @@ void check_route(enum e_route_type route_type, int num_switches) {
 
 	check_locally_used_clb_opins(route_ctx.clb_opins_used_locally, route_type);
 
-    auto non_configurable_rr_sets = identify_non_configurable_rr_sets();
+	/* Now check that all nets are indeed connected. */
+	auto nets = cluster_ctx.clb_nlist.nets();
+	check_net_routes(std::vector<ClusterNetId>(nets.begin(), nets.end()), route_type, num_switches);
 
-	connected_to_route = (bool *) vtr::calloc(device_ctx.rr_nodes.size(), sizeof(bool));
+	VTR_LOG("Completed routing consistency check successfully.\n");
+	VTR_LOG("\n");
+}
 
-	max_pins = 0;
-	for (auto net_id : cluster_ctx.clb_nlist.nets())
-		max_pins = max(max_pins, (int)cluster_ctx.clb_nlist.net_pins(net_id).size());
+void check_route_incremental(enum e_route_type route_type, int num_switches) {
 
-	pin_done = (bool *) vtr::malloc(max_pins * sizeof(bool));
+	/* Checks the connectivity of only those nets whose routing has changed *
+	 * since they were last checked (see t_net_routing_status::is_checked).  *
+	 * Occupancy is not checked, so this may be used on a routing which is   *
+	 * not yet legal, e.g. between routing iterations.                       */
 
-	/* Now check that all nets are indeed connected. */
+    auto& cluster_ctx = g_vpr_ctx.clustering();
+    auto& route_ctx = g_vpr_ctx.routing();
+
+	std::vector<ClusterNetId> nets;
 	for (auto net_id : cluster_ctx.clb_nlist.nets()) {
-		if (cluster_ctx.clb_nlist.net_is_global(net_id) || cluster_ctx.clb_nlist.net_sinks(net_id).size() == 0) /* Skip global nets. */
-			continue;
+		if (!route_ctx.net_status[net_id].is_checked) {
+			nets.push_back(net_id);
+		}
+	}
 
-		for (ipin = 0; ipin < cluster_ctx.clb_nlist.net_pins(net_id).size(); ipin++)
-			pin_done[ipin] = false;
+	check_net_routes(nets, route_type, num_switches);
+}
 
-		/* Check the SOURCE of the net. */
-		tptr = route_ctx.trace[net_id].head;
-		if (tptr == nullptr) {
-			vpr_throw(VPR_ERROR_ROUTE, __FILE__, __LINE__,
-				"in check_route: net %d has no routing.\n", size_t(net_id));
-		}
+/* Checks the routing of each of nets (in parallel when built with TBB), and marks them *
+ * as checked. Errors are reported for the first illegal net in the order given.        */
+static void check_net_routes(const std::vector<ClusterNetId>& nets, enum e_route_type route_type, int num_switches) {
 
-		inode = tptr->index;
-		check_node_and_range(inode, route_type);
-		check_switch(tptr, num_switches);
-		connected_to_route[inode] = true; /* Mark as in path. */
+	if (nets.empty()) {
+		return;
+	}
 
-		check_source(inode, net_id);
-		pin_done[0] = true;
+    const auto& non_configurable_rr_sets = get_non_configurable_rr_sets();
 
-		prev_node = inode;
-        int prev_switch = tptr->iswitch;
-		tptr = tptr->next;
+	run_range_checks(nets.size(), NET_CHECK_RANGE_SIZE,
+		[&](size_t begin, size_t end, std::vector<std::string>& warnings) {
+			std::unordered_set<int> connected_to_route;
+			std::vector<bool> pin_done;
+			for (size_t inet = begin; inet < end; inet++) {
+				check_net_route(nets[inet], route_type, num_switches, non_configurable_rr_sets,
+						connected_to_route, pin_done, warnings);
+			}
+		});
 
-		/* Check the rest of the net */
-        size_t num_sinks = 0;
-		while (tptr != nullptr) {
-			inode = tptr->index;
-			check_node_and_range(inode, route_type);
-			check_switch(tptr, num_switches);
+    auto& route_ctx = g_vpr_ctx.mutable_routing();
+	for (auto net_id : nets) {
+		route_ctx.net_status[net_id].is_checked = true;
+	}
+}
 
-			if (prev_switch == OPEN) { //Start of a new branch
-				if (connected_to_route[inode] == false) {
-					vpr_throw(VPR_ERROR_ROUTE, __FILE__, __LINE__,
-						"in check_route: node %d does not link into existing routing for net %d.\n", inode, size_t(net_id));
-				}
-			} else { //Continuing along existing branch
-				connects = check_adjacent(prev_node, inode);
-				if (!connects) {
-					vpr_throw(VPR_ERROR_ROUTE, __FILE__, __LINE__,
-						"in check_route: found non-adjacent segments in traceback while checking net %d:\n"
-                        "  %s\n"
-                        "  %s\n",
-                        size_t(net_id),
-                        describe_rr_node(prev_node).c_str(),
-                        describe_rr_node(inode).c_str());
-				}
+/* Checks that the routing of net_id is a properly connected path, which connects *
+ * all of the net's pins. connected_to_route and pin_done are scratch space.     */
+static void check_net_route(ClusterNetId net_id, enum e_route_type route_type, int num_switches,
+		const t_non_configurable_rr_sets& non_configurable_rr_sets,
+		std::unordered_set<int>& connected_to_route, std::vector<bool>& pin_done,
+		std::vector<std::string>& warnings) {
 
-				connected_to_route[inode] = true; /* Mark as in path. */
+	int inode, prev_node;
+	bool connects;
+	t_trace *tptr;
 
-				if (device_ctx.rr_nodes[inode].type() == SINK) {
-					check_sink(inode, net_id, pin_done);
-                    num_sinks += 1;
-                }
+    auto& device_ctx = g_vpr_ctx.device();
+    auto& cluster_ctx = g_vpr_ctx.clustering();
+    auto& route_ctx = g_vpr_ctx.routing();
 
-			} /* End of prev_node type != SINK */
-			prev_node = inode;
-            prev_switch = tptr->iswitch;
-			tptr = tptr->next;
-		} /* End while */
+	if (cluster_ctx.clb_nlist.net_is_global(net_id) || cluster_ctx.clb_nlist.net_sinks(net_id).size() == 0) /* Skip global nets. */
+		return;
 
-		if (num_sinks != cluster_ctx.clb_nlist.net_sinks(net_id).size()) {
-			vpr_throw(VPR_ERROR_ROUTE, __FILE__, __LINE__,
-				"in check_route: net %zu (%s) has %zu SINKs (expected %zu).\n",
-                size_t(net_id), cluster_ctx.clb_nlist.net_name(net_id).c_str(),
-                num_sinks, cluster_ctx.clb_nlist.net_sinks(net_id).size());
-		}
+	connected_to_route.clear();
+	pin_done.assign(cluster_ctx.clb_nlist.net_pins(net_id).size(), false);
+
+	/* Check the SOURCE of the net. */
+	tptr = route_ctx.trace[net_id].head;
+	if (tptr == nullptr) {
+		vpr_throw(VPR_ERROR_ROUTE, __FILE__, __LINE__,
+			"in check_route: net %d has no routing.\n", size_t(net_id));
+	}
+
+	inode = tptr->index;
+	check_node_and_range(inode, route_type, &warnings);
+	check_switch(tptr, num_switches);
+	connected_to_route.insert(inode); /* Mark as in path. */
+
+	check_source(inode, net_id);
+	pin_done[0] = true;
+
+	prev_node = inode;
+    int prev_switch = tptr->iswitch;
+	tptr = tptr->next;
+
+	/* Check the rest of the net */
+    size_t num_sinks = 0;
+	while (tptr != nullptr) {
+		inode = tptr->index;
+		check_node_and_range(inode, route_type, &warnings);
+		check_switch(tptr, num_switches);
 
-		for (ipin = 0; ipin < cluster_ctx.clb_nlist.net_pins(net_id).size(); ipin++) {
-			if (pin_done[ipin] == false) {
+		if (prev_switch == OPEN) { //Start of a new branch
+			if (connected_to_route.count(inode) == 0) {
 				vpr_throw(VPR_ERROR_ROUTE, __FILE__, __LINE__,
-					"in check_route: net %zu does not connect to pin %d.\n", size_t(net_id), ipin);
+					"in check_route: node %d does not link into existing routing for net %d.\n", inode, size_t(net_id));
+			}
+		} else { //Continuing along existing branch
+			connects = check_adjacent(prev_node, inode);
+			if (!connects) {
+				vpr_throw(VPR_ERROR_ROUTE, __FILE__, __LINE__,
+					"in check_route: found non-adjacent segments in traceback while checking net %d:\n"
+                    "  %s\n"
+                    "  %s\n",
+                    size_t(net_id),
+                    describe_rr_node(prev_node).c_str(),
+                    describe_rr_node(inode).c_str());
 			}
-		}
 
-        check_non_configurable_edges(net_id, non_configurable_rr_sets);
+			connected_to_route.insert(inode); /* Mark as in path. */
 
-		reset_flags(net_id, connected_to_route);
+			if (device_ctx.rr_nodes[inode].type() == SINK) {
+				check_sink(inode, net_id, pin_done);
+                num_sinks += 1;
+            }
 
-	} /* End for each net */
+		} /* End of prev_node type != SINK */
+		prev_node = inode;
+        prev_switch = tptr->iswitch;
+		tptr = tptr->next;
+	} /* End while */
 
-	free(pin_done);
-	free(connected_to_route);
-	VTR_LOG("Completed routing consistency check successfully.\n");
-	VTR_LOG("\n");
+	if (num_sinks != cluster_ctx.clb_nlist.net_sinks(net_id).size()) {
+		vpr_throw(VPR_ERROR_ROUTE, __FILE__, __LINE__,
+			"in check_route: net %zu (%s) has %zu SINKs (expected %zu).\n",
+            size_t(net_id), cluster_ctx.clb_nlist.net_name(net_id).c_str(),
+            num_sinks, cluster_ctx.clb_nlist.net_sinks(net_id).size());
+	}
+
+	for (size_t ipin = 0; ipin < cluster_ctx.clb_nlist.net_pins(net_id).size(); ipin++) {
+		if (pin_done[ipin] == false) {
+			vpr_throw(VPR_ERROR_ROUTE, __FILE__, __LINE__,
+				"in check_route: net %zu does not connect to pin %zu.\n", size_t(net_id), ipin);
+		}
+	}
+
+    check_non_configurable_edges(net_id, non_configurable_rr_sets);
 }
 
 
 /* Checks that this SINK node is one of the terminals of inet, and marks   *
 * the appropriate pin as being reached.                                   */
-static void check_sink(int inode, ClusterNetId net_id, bool * pin_done) {
+static void check_sink(int inode, ClusterNetId net_id, std::vector<bool>& pin_done) {
 
 	int i, j, ifound, ptc_num, iclass, iblk, pin_index;
 	ClusterBlockId bnum;
@@ -314,27 +384,6 @@ static void check_switch(t_trace *tptr, int num_switch) {
 	}
 }
 
-static void reset_flags(ClusterNetId inet, bool * connected_to_route) {
-
-	/* This routine resets the flags of all the channel segments contained *
-	 * in the traceback of net inet to 0.  This allows us to check the     *
-	 * next net for connectivity (and the default state of the flags       *
-	 * should always be zero after they have been used).                   */
-
-	t_trace *tptr;
-	int inode;
-
-    auto& route_ctx = g_vpr_ctx.routing();
-
-	tptr = route_ctx.trace[inet].head;
-
-	while (tptr != nullptr) {
-		inode = tptr->index;
-		connected_to_route[inode] = false; /* Not in routed path now. */
-		tptr = tptr->next;
-	}
-}
-
 static bool check_adjacent(int from_node, int to_node) {
 
 	/* This routine checks if the rr_node to_node is reachable from from_node.   *
@@ -624,7 +673,7 @@ static void check_locally_used_clb_opins(const t_clb_opins_used& clb_opins_used_
 
 			for (ipin = 0; ipin < num_local_opins; ipin++) {
 				inode = clb_opins_used_locally[blk_id][iclass][ipin];
-				check_node_and_range(inode, route_type); /* Node makes sense? */
+				check_node_and_range(inode, route_type, nullptr); /* Node makes sense? */
 
 				/* Now check that node is an OPIN of the right type. */
 
@@ -648,10 +697,11 @@ static void check_locally_used_clb_opins(const t_clb_opins_used& clb_opins_used_
 	}
 }
 
-static void check_node_and_range(int inode, enum e_route_type route_type) {
+static void check_node_and_range(int inode, enum e_route_type route_type, std::vector<std::string>* warnings) {
 
 	/* Checks that inode is within the legal range, then calls check_node to    *
-	 * check that everything else about the node is OK.                         */
+	 * check that everything else about the node is OK. Any warnings are        *
+	 * appended to warnings if it is non-null, and logged otherwise.            */
 
     auto& device_ctx = g_vpr_ctx.device();
 
@@ -659,23 +709,56 @@ static void check_node_and_range(int inode, enum e_route_type route_type) {
 			vpr_throw(VPR_ERROR_ROUTE, __FILE__, __LINE__,
 				"in check_node_and_range: rr_node #%d is out of legal, range (0 to %d).\n", inode, device_ctx.rr_nodes.size() - 1);
 	}
-	check_rr_node(inode, route_type, device_ctx);
+	check_rr_node(inode, route_type, device_ctx, warnings);
+}
+
+void free_route_check_structs() {
+    non_configurable_rr_sets_cache.reset();
+}
+
+//Returns the non-configurable sets of the current RR graph, collecting them if needed
+static const t_non_configurable_rr_sets& get_non_configurable_rr_sets() {
+    if (!non_configurable_rr_sets_cache) {
+        non_configurable_rr_sets_cache.reset(new t_non_configurable_rr_sets(identify_non_configurable_rr_sets()));
+    }
+    return *non_configurable_rr_sets_cache;
 }
 
 //Collects the sets of connected non-configurable edges in the RR graph
 static t_non_configurable_rr_sets identify_non_configurable_rr_sets() {
-    std::set<std::set<t_node_edge>> edge_sets;
-
     //Walk through the RR graph and recursively expand non-configurable edges
-    //to collect the sets of non-configurably connected nodes
+    //to collect the sets of non-configurably connected nodes. Each node is
+    //expanded independently (in parallel when built with TBB)
     auto& device_ctx = g_vpr_ctx.device();
-    for (size_t inode = 0; inode < device_ctx.rr_nodes.size(); ++inode) {
-        std::set<t_node_edge> edge_set;
+    size_t num_nodes = device_ctx.rr_nodes.size();
+    size_t num_ranges = (num_nodes + RR_NODE_EXPAND_RANGE_SIZE - 1) / RR_NODE_EXPAND_RANGE_SIZE;
+    std::vector<std::vector<std::set<t_node_edge>>> range_edge_sets(num_ranges);
 
-        expand_non_configurable(inode, edge_set);
+    auto expand_range = [&](size_t irange) {
+        size_t end = std::min((irange + 1) * RR_NODE_EXPAND_RANGE_SIZE, num_nodes);
+        for (size_t inode = irange * RR_NODE_EXPAND_RANGE_SIZE; inode < end; ++inode) {
+            std::set<t_node_edge> edge_set;
 
-        if (!edge_set.empty()) {
-            edge_sets.insert(edge_set);
+            expand_non_configurable(inode, edge_set);
+
+            if (!edge_set.empty()) {
+                range_edge_sets[irange].push_back(std::move(edge_set));
+            }
+        }
+    };
+
+#if defined(TATUM_USE_TBB)
+    tbb::parallel_for(size_t(0), num_ranges, expand_range);
+#else
+    for (size_t irange = 0; irange < num_ranges; ++irange) {
+        expand_range(irange);
+    }
+#endif
+
+    std::set<std::set<t_node_edge>> edge_sets;
+    for (auto& edge_sets_in_range : range_edge_sets) {
+        for (auto& edge_set : edge_sets_in_range) {
+            edge_sets.insert(std::move(edge_set));
         }
     }
 
@@ -694,8 +777,23 @@ static t_non_configurable_rr_sets identify_non_configurable_rr_sets() {
     }
 
     t_non_configurable_rr_sets non_configurable_rr_sets;
-    non_configurable_rr_sets.edge_sets = edge_sets;
-    non_configurable_rr_sets.node_sets = node_sets;
+    non_configurable_rr_sets.edge_sets.assign(edge_sets.begin(), edge_sets.end());
+    non_configurable_rr_sets.node_sets.assign(node_sets.begin(), node_sets.end());
+
+    for (size_t iset = 0; iset < non_configurable_rr_sets.node_sets.size(); ++iset) {
+        for (int inode : non_configurable_rr_sets.node_sets[iset]) {
+            non_configurable_rr_sets.node_to_node_sets[inode].push_back(iset);
+        }
+    }
+
+    for (size_t iset = 0; iset < non_configurable_rr_sets.edge_sets.size(); ++iset) {
+        for (const auto& edge : non_configurable_rr_sets.edge_sets[iset]) {
+            auto& sets = non_configurable_rr_sets.node_to_edge_sets[edge.from_node];
+            if (sets.empty() || sets.back() != int(iset)) {
+                sets.push_back(iset);
+            }
+        }
+    }
 
     return non_configurable_rr_sets;
 }
@@ -731,6 +829,10 @@ static bool check_non_configurable_edges(ClusterNetId net, const t_non_configura
     auto& route_ctx = g_vpr_ctx.routing();
     auto& cluster_ctx = g_vpr_ctx.clustering();
 
+    if (non_configurable_rr_sets.node_sets.empty()) {
+        return true; //No non-configurable edges in the RR graph
+    }
+
     t_trace* head = route_ctx.trace[net].head;
 
     //Collect all the edges used by this net's routing
@@ -762,9 +864,26 @@ static bool check_non_configurable_edges(ClusterNetId net, const t_non_configura
     //routing (to be legal, by definition, they must be connected by
     //non-configurable routing).
 
+    //Only the non-configurable sets which include one of the routing's nodes can
+    //intersect the routing
+    std::set<int> touched_node_sets;
+    std::set<int> touched_edge_sets;
+    for (int inode : routing_nodes) {
+        auto iter = non_configurable_rr_sets.node_to_node_sets.find(inode);
+        if (iter != non_configurable_rr_sets.node_to_node_sets.end()) {
+            touched_node_sets.insert(iter->second.begin(), iter->second.end());
+        }
+
+        iter = non_configurable_rr_sets.node_to_edge_sets.find(inode);
+        if (iter != non_configurable_rr_sets.node_to_edge_sets.end()) {
+            touched_edge_sets.insert(iter->second.begin(), iter->second.end());
+        }
+    }
+
     //Check that all nodes in each non-configurable set are full included if any element
     //within a set is used by the routing
-    for (const auto& rr_nodes : non_configurable_rr_sets.node_sets) {
+    for (int iset : touched_node_sets) {
+        const auto& rr_nodes = non_configurable_rr_sets.node_sets[iset];
 
         //Compute the intersection of the routing and current non-configurable nodes set
         std::vector<int> intersection;
@@ -804,7 +923,8 @@ static bool check_non_configurable_edges(ClusterNetId net, const t_non_configura
 
     //Check that any sets of non-configurable RR graph edges are fully included
     //in the routing, if any of a set's edges are used
-    for (const auto& rr_edges : non_configurable_rr_sets.edge_sets) {
+    for (int iset : touched_edge_sets) {
+        const auto& rr_edges = non_configurable_rr_sets.edge_sets[iset];
 
         //Compute the intersection of the routing and current non-configurable edge set
         std::vector<t_node_edge> intersection;
@@ -5,6 +5,14 @@
 
 void check_route(enum e_route_type route_type, int num_switches);
 
+//Checks the connectivity of only the nets re-routed since they were last checked.
+//Occupancy is not checked, so this may be called between routing iterations.
+void check_route_incremental(enum e_route_type route_type, int num_switches);
+
 void recompute_occupancy_from_scratch();
 
+//Frees the data the routing checks keep about the rr graph. Must be called whenever the rr graph
+//is freed or rebuilt
+void free_route_check_structs();
+
 #endif
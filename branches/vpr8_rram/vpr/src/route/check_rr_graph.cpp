@@ -7,11 +7,20 @@
 #include "globals.h"
 #include "rr_graph.h"
 #include "check_rr_graph.h"
+#include "range_checks.h"
+
+/* Number of rr_nodes checked together by one task */
+constexpr size_t RR_NODE_CHECK_RANGE_SIZE = 4096;
 
 /*********************** Subroutines local to this module *******************/
 
 static bool rr_node_is_global_clb_ipin(int inode);
 
+static bool rr_node_is_uninitialized(int inode);
+
+static void check_rr_graph_node(int inode, e_route_type route_type, int num_rr_switches,
+        std::vector<std::string>& warnings);
+
 static void check_unbuffered_edges(int from_node);
 
 static bool has_adjacent_channel(const t_rr_node& node, const DeviceGrid& grid);
@@ -31,115 +40,24 @@ void check_rr_graph(const t_graph_type graph_type,
 
     auto& device_ctx = g_vpr_ctx.device();
 
-    auto total_edges_to_node = std::vector<int>(device_ctx.rr_nodes.size());
-    auto switch_types_from_current_to_node = std::vector<unsigned char>(device_ctx.rr_nodes.size());
+    /* The nodes are checked independently (in parallel when built with TBB), then *
+     * the edges to each node are counted for the fan-in checks below.              */
+    run_range_checks(device_ctx.rr_nodes.size(), RR_NODE_CHECK_RANGE_SIZE,
+            [&](size_t begin, size_t end, std::vector<std::string>& warnings) {
+                for (size_t inode = begin; inode < end; inode++) {
+                    check_rr_graph_node(inode, route_type, num_rr_switches, warnings);
+                }
+            });
 
+    auto total_edges_to_node = std::vector<int>(device_ctx.rr_nodes.size());
     for (size_t inode = 0; inode < device_ctx.rr_nodes.size(); inode++) {
-
-        device_ctx.rr_nodes[inode].validate();
-
-        /* Ignore any uninitialized rr_graph nodes */
-        if ((device_ctx.rr_nodes[inode].type() == SOURCE)
-                && (device_ctx.rr_nodes[inode].xlow() == 0) && (device_ctx.rr_nodes[inode].ylow() == 0)
-                && (device_ctx.rr_nodes[inode].xhigh() == 0) && (device_ctx.rr_nodes[inode].yhigh() == 0)) {
+        if (rr_node_is_uninitialized(inode)) {
             continue;
         }
-
-        t_rr_type rr_type = device_ctx.rr_nodes[inode].type();
-        int num_edges = device_ctx.rr_nodes[inode].num_edges();
-
-        check_rr_node(inode, route_type, device_ctx);
-
-        /* Check all the connectivity (edges, etc.) information.                    */
-
-        std::map<int,std::vector<int>> edges_from_current_to_node;
-        for (int iedge = 0; iedge < num_edges; iedge++) {
-            int to_node = device_ctx.rr_nodes[inode].edge_sink_node(iedge);
-
-            check_rr_edge(inode, iedge, to_node);
-
-            if (to_node < 0 || to_node >= (int) device_ctx.rr_nodes.size()) {
-                vpr_throw(VPR_ERROR_ROUTE, __FILE__, __LINE__,
-                        "in check_rr_graph: node %d has an edge %d.\n"
-                        "\tEdge is out of range.\n", inode, to_node);
-            }
-
-            edges_from_current_to_node[to_node].push_back(iedge);
-            total_edges_to_node[to_node]++;
-
-            auto switch_type = device_ctx.rr_nodes[inode].edge_switch(iedge);
-
-            if (switch_type < 0 || switch_type >= num_rr_switches) {
-                vpr_throw(VPR_ERROR_ROUTE, __FILE__, __LINE__,
-                        "in check_rr_graph: node %d has a switch type %d.\n"
-                        "\tSwitch type is out of range.\n",
-                        inode, switch_type);
-            }
-        } /* End for all edges of node. */
-
-        //Check that multiple edges between the same from/to nodes make sense
-        for (int iedge = 0; iedge < num_edges; iedge++) {
-            int to_node = device_ctx.rr_nodes[inode].edge_sink_node(iedge);
-
-            if (edges_from_current_to_node[to_node].size() == 1) continue; //Single edges are always OK
-
-            VTR_ASSERT_MSG(edges_from_current_to_node[to_node].size() > 1, "Expect multiple edges");
-
-            t_rr_type to_rr_type = device_ctx.rr_nodes[to_node].type();
-
-            //Only expect chan <-> chan connections to have multiple edges
-            if ((to_rr_type != CHANX && to_rr_type != CHANY)
-                || (rr_type != CHANX && rr_type != CHANY)) {
-                vpr_throw(VPR_ERROR_ROUTE, __FILE__, __LINE__,
-                        "in check_rr_graph: node %d (%s) connects to node %d (%s) %zu times - multi-connections only expected for CHAN->CHAN.\n",
-                        inode, rr_node_typename[rr_type], to_node, rr_node_typename[to_rr_type], edges_from_current_to_node[to_node].size());
-            }
-
-            //Between two wire segments
-            VTR_ASSERT_MSG(to_rr_type == CHANX || to_rr_type == CHANY, "Expect channel type");
-            VTR_ASSERT_MSG(rr_type == CHANX || rr_type == CHANY, "Expect channel type");
-
-            //While multiple connections between the same wires can be electrically legal,
-            //they are redundant if they are of the same switch type.
-            //
-            //Identify any such edges with identical switches
-            std::map<short,int> switch_counts;
-            for (auto edge : edges_from_current_to_node[to_node]) {
-                auto edge_switch = device_ctx.rr_nodes[inode].edge_switch(edge);
-
-                switch_counts[edge_switch]++;
-            }
-
-            //Tell the user about any redundant edges
-            for (auto kv : switch_counts) {
-                if (kv.second <= 1) continue;
-
-                auto switch_type = device_ctx.rr_switch_inf[kv.first].type();
-
-                VPR_THROW(VPR_ERROR_ROUTE, "in check_rr_graph: node %d has %d redundant connections to node %d of switch type %d (%s)", 
-                          inode, kv.second, to_node, kv.first, SWITCH_TYPE_STRINGS[size_t(switch_type)]);
-            }
+        for (int iedge = 0; iedge < device_ctx.rr_nodes[inode].num_edges(); iedge++) {
+            total_edges_to_node[device_ctx.rr_nodes[inode].edge_sink_node(iedge)]++;
         }
-
-        /* Slow test could leave commented out most of the time. */
-        check_unbuffered_edges(inode);
-
-        //Check that all config/non-config edges are appropriately organized
-        for (auto edge : device_ctx.rr_nodes[inode].configurable_edges()) {
-            if (!device_ctx.rr_nodes[inode].edge_is_configurable(edge)) {
-                VPR_THROW(VPR_ERROR_ROUTE, "in check_rr_graph: node %d edge %d is non-configurable, but in configurable edges",
-                        inode, edge);
-            }
-        }
-
-        for (auto edge : device_ctx.rr_nodes[inode].non_configurable_edges()) {
-            if (device_ctx.rr_nodes[inode].edge_is_configurable(edge)) {
-                VPR_THROW(VPR_ERROR_ROUTE, "in check_rr_graph: node %d edge %d is configurable, but in non-configurable edges",
-                        inode, edge);
-            }
-        }
-
-    } /* End for all rr_nodes */
+    }
 
     /* I built a list of how many edges went to everything in the code above -- *
      * now I check that everything is reachable.                                */
@@ -206,6 +124,125 @@ void check_rr_graph(const t_graph_type graph_type,
     }
 }
 
+static bool rr_node_is_uninitialized(int inode) {
+
+    /* Returns true if inode was never initialized (left as a SOURCE at the origin). */
+
+    auto& device_ctx = g_vpr_ctx.device();
+
+    return (device_ctx.rr_nodes[inode].type() == SOURCE)
+            && (device_ctx.rr_nodes[inode].xlow() == 0) && (device_ctx.rr_nodes[inode].ylow() == 0)
+            && (device_ctx.rr_nodes[inode].xhigh() == 0) && (device_ctx.rr_nodes[inode].yhigh() == 0);
+}
+
+static void check_rr_graph_node(int inode, e_route_type route_type, int num_rr_switches,
+        std::vector<std::string>& warnings) {
+
+    /* Checks a single rr_node and its out-going edges. */
+
+    auto& device_ctx = g_vpr_ctx.device();
+
+    device_ctx.rr_nodes[inode].validate();
+
+    /* Ignore any uninitialized rr_graph nodes */
+    if (rr_node_is_uninitialized(inode)) {
+        return;
+    }
+
+    t_rr_type rr_type = device_ctx.rr_nodes[inode].type();
+    int num_edges = device_ctx.rr_nodes[inode].num_edges();
+
+    check_rr_node(inode, route_type, device_ctx, &warnings);
+
+    /* Check all the connectivity (edges, etc.) information.                    */
+
+    std::map<int,std::vector<int>> edges_from_current_to_node;
+    for (int iedge = 0; iedge < num_edges; iedge++) {
+        int to_node = device_ctx.rr_nodes[inode].edge_sink_node(iedge);
+
+        check_rr_edge(inode, iedge, to_node);
+
+        if (to_node < 0 || to_node >= (int) device_ctx.rr_nodes.size()) {
+            vpr_throw(VPR_ERROR_ROUTE, __FILE__, __LINE__,
+                    "in check_rr_graph: node %d has an edge %d.\n"
+                    "\tEdge is out of range.\n", inode, to_node);
+        }
+
+        edges_from_current_to_node[to_node].push_back(iedge);
+
+        auto switch_type = device_ctx.rr_nodes[inode].edge_switch(iedge);
+
+        if (switch_type < 0 || switch_type >= num_rr_switches) {
+            vpr_throw(VPR_ERROR_ROUTE, __FILE__, __LINE__,
+                    "in check_rr_graph: node %d has a switch type %d.\n"
+                    "\tSwitch type is out of range.\n",
+                    inode, switch_type);
+        }
+    } /* End for all edges of node. */
+
+    //Check that multiple edges between the same from/to nodes make sense
+    for (int iedge = 0; iedge < num_edges; iedge++) {
+        int to_node = device_ctx.rr_nodes[inode].edge_sink_node(iedge);
+
+        if (edges_from_current_to_node[to_node].size() == 1) continue; //Single edges are always OK
+
+        VTR_ASSERT_MSG(edges_from_current_to_node[to_node].size() > 1, "Expect multiple edges");
+
+        t_rr_type to_rr_type = device_ctx.rr_nodes[to_node].type();
+
+        //Only expect chan <-> chan connections to have multiple edges
+        if ((to_rr_type != CHANX && to_rr_type != CHANY)
+            || (rr_type != CHANX && rr_type != CHANY)) {
+            vpr_throw(VPR_ERROR_ROUTE, __FILE__, __LINE__,
+                    "in check_rr_graph: node %d (%s) connects to node %d (%s) %zu times - multi-connections only expected for CHAN->CHAN.\n",
+                    inode, rr_node_typename[rr_type], to_node, rr_node_typename[to_rr_type], edges_from_current_to_node[to_node].size());
+        }
+
+        //Between two wire segments
+        VTR_ASSERT_MSG(to_rr_type == CHANX || to_rr_type == CHANY, "Expect channel type");
+        VTR_ASSERT_MSG(rr_type == CHANX || rr_type == CHANY, "Expect channel type");
+
+        //While multiple connections between the same wires can be electrically legal,
+        //they are redundant if they are of the same switch type.
+        //
+        //Identify any such edges with identical switches
+        std::map<short,int> switch_counts;
+        for (auto edge : edges_from_current_to_node[to_node]) {
+            auto edge_switch = device_ctx.rr_nodes[inode].edge_switch(edge);
+
+            switch_counts[edge_switch]++;
+        }
+
+        //Tell the user about any redundant edges
+        for (auto kv : switch_counts) {
+            if (kv.second <= 1) continue;
+
+            auto switch_type = device_ctx.rr_switch_inf[kv.first].type();
+
+            VPR_THROW(VPR_ERROR_ROUTE, "in check_rr_graph: node %d has %d redundant connections to node %d of switch type %d (%s)", 
+                      inode, kv.second, to_node, kv.first, SWITCH_TYPE_STRINGS[size_t(switch_type)]);
+        }
+    }
+
+    /* Slow test could leave commented out most of the time. */
+    check_unbuffered_edges(inode);
+
+    //Check that all config/non-config edges are appropriately organized
+    for (auto edge : device_ctx.rr_nodes[inode].configurable_edges()) {
+        if (!device_ctx.rr_nodes[inode].edge_is_configurable(edge)) {
+            VPR_THROW(VPR_ERROR_ROUTE, "in check_rr_graph: node %d edge %d is non-configurable, but in configurable edges",
+                    inode, edge);
+        }
+    }
+
+    for (auto edge : device_ctx.rr_nodes[inode].non_configurable_edges()) {
+        if (device_ctx.rr_nodes[inode].edge_is_configurable(edge)) {
+            VPR_THROW(VPR_ERROR_ROUTE, "in check_rr_graph: node %d edge %d is configurable, but in non-configurable edges",
+                    inode, edge);
+        }
+    }
+}
+
 static bool rr_node_is_global_clb_ipin(int inode) {
 
     /* Returns true if inode refers to a global CLB input pin node.   */
@@ -225,7 +262,8 @@ static bool rr_node_is_global_clb_ipin(int inode) {
     return type->is_global_pin[ipin];
 }
 
-void check_rr_node(int inode, enum e_route_type route_type, const DeviceContext& device_ctx) {
+void check_rr_node(int inode, enum e_route_type route_type, const DeviceContext& device_ctx,
+        std::vector<std::string>* warnings) {
 
     /* This routine checks that the rr_node is inside the grid and has a valid
      * pin number, etc.
@@ -441,7 +479,11 @@ void check_rr_node(int inode, enum e_route_type route_type, const DeviceContext&
 
             if (check_for_out_edges) {
                 std::string info = describe_rr_node(inode);
-                VTR_LOG_WARN( "in check_rr_node: %s has no out-going edges.\n", info.c_str());
+                if (warnings) {
+                    warnings->push_back(vtr::string_fmt("in check_rr_node: %s has no out-going edges.\n", info.c_str()));
+                } else {
+                    VTR_LOG_WARN( "in check_rr_node: %s has no out-going edges.\n", info.c_str());
+                }
             }
         }
     }
@@ -1,12 +1,17 @@
 #ifndef CHECK_RR_GRAPH_H
 #define CHECK_RR_GRAPH_H
+#include <string>
+#include <vector>
+
 #include "physical_types.h"
 
 void check_rr_graph(const t_graph_type graph_type,
         const DeviceGrid& grid,
         const int num_rr_switches, const t_type_ptr types);
 
-void check_rr_node(int inode, enum e_route_type route_type, const DeviceContext& device_ctx);
+/* Checks a single rr_node. If warnings is non-null, warnings are appended to it instead of being logged */
+void check_rr_node(int inode, enum e_route_type route_type, const DeviceContext& device_ctx,
+        std::vector<std::string>* warnings = nullptr);
 
 #endif
 
@@ -0,0 +1,620 @@
+/* Writes congestion reports: per-channel-segment grids of routing demand, capacity
+ * and overuse, as JSON, and heat maps of the utilization as SVG and PNG images.
+ *
+ * Channel segments are indexed like the rr graph: chanx (x, y) is the horizontal
+ * channel segment above tile (x, y), and chany (x, y) the vertical one to the right
+ * of it. In the JSON file each grid is a list of rows, i.e. grid[y][x], covering the
+ * whole device (segments which do not exist are 0).
+ *
+ * The images lay the device out as a (2 * width - 1) x (2 * height - 1) array of
+ * cells, alternating tiles (grey, or white if empty) with channel segments and
+ * switch blocks, which are coloured by utilization (switch blocks by the average of
+ * the adjacent channel segments), as in the 'Routing Util' view of the graphics.
+ * The PNG encoder is self-contained (fixed-Huffman deflate with run matches along
+ * and across rows) so no image library is needed.
+ */
+#include <cstdio>
+#include <cstdint>
+#include <algorithm>
+#include <array>
+#include <tuple>
+#include <vector>
+
+#include "vtr_assert.h"
+#include "vtr_log.h"
+#include "vtr_time.h"
+#include "vtr_util.h"
+#include "vtr_matrix.h"
+#include "vtr_color_map.h"
+
+#include "vpr_types.h"
+#include "vpr_error.h"
+#include "globals.h"
+#include "place.h"
+#include "route_util.h"
+#include "congestion_report.h"
+
+//Size of each device cell in the images, in pixels
+constexpr int CONGESTION_IMAGE_CELL_PIXELS = 4;
+
+//Longest and furthest matches allowed by deflate
+constexpr size_t DEFLATE_MAX_MATCH = 258;
+constexpr size_t DEFLATE_MAX_DISTANCE = 32768;
+
+typedef vtr::Color<uint8_t> t_rgb;
+
+struct t_congestion_map {
+    const char* stage;
+    const char* demand_type;
+
+    //[0..device_ctx.grid.width()-1][0..device_ctx.grid.height()-1]
+    vtr::Matrix<float> chanx_demand;
+    vtr::Matrix<float> chany_demand;
+    vtr::Matrix<float> chanx_capacity; //All zero if the channel widths are unknown
+    vtr::Matrix<float> chany_capacity;
+    vtr::Matrix<float> chanx_overuse; //Empty if not known (i.e. before routing)
+    vtr::Matrix<float> chany_overuse;
+};
+
+struct t_congestion_summary {
+    bool have_capacity = false;
+    float max_util = 0.;
+    size_t max_util_x = 0;
+    size_t max_util_y = 0;
+    t_rr_type max_util_chan = CHANX;
+    double total_util = 0.;
+    size_t num_segments = 0;
+    size_t num_over_capacity_segments = 0;
+    float total_overuse = 0.;
+};
+
+/******************** Subroutines local to this module ************************/
+static bool chan_segment_exists(t_rr_type chan_type, size_t x, size_t y);
+static float segment_util(const t_congestion_map& map, const t_congestion_summary& summary, t_rr_type chan_type, size_t x, size_t y);
+static t_congestion_summary summarize_congestion(const t_congestion_map& map);
+static void write_congestion_report(const std::string& prefix, const t_congestion_map& map);
+
+static void write_congestion_json(const std::string& filename, const t_congestion_map& map, const t_congestion_summary& summary);
+static void write_json_grid(FILE* fp, const char* name, const vtr::Matrix<float>& grid, bool last);
+static vtr::Matrix<t_rgb> render_congestion_cells(const t_congestion_map& map, const t_congestion_summary& summary);
+static void write_congestion_svg(const std::string& filename, const vtr::Matrix<t_rgb>& cells);
+static void write_congestion_png(const std::string& filename, const vtr::Matrix<t_rgb>& cells);
+
+static std::vector<uint8_t> zlib_compress(const std::vector<uint8_t>& data, size_t row_stride);
+static void write_png_chunk(FILE* fp, const char* type, const std::vector<uint8_t>& data);
+static uint32_t png_crc32(const uint8_t* data, size_t size, uint32_t crc);
+static void append_be32(std::vector<uint8_t>& data, uint32_t value);
+
+/************************* Subroutine definitions *****************************/
+
+void write_placement_congestion_report(const std::string& prefix) {
+    auto& device_ctx = g_vpr_ctx.device();
+    auto& cluster_ctx = g_vpr_ctx.clustering();
+    auto& place_ctx = g_vpr_ctx.placement();
+
+    size_t width = device_ctx.grid.width();
+    size_t height = device_ctx.grid.height();
+
+    t_congestion_map map;
+    map.stage = "place";
+    map.demand_type = "estimated_tracks";
+
+    //Each net's expected wiring (as in the placer's bounding box cost) is spread
+    //uniformly over the channel segments bordering its bounding box. The per-net
+    //rectangles are accumulated in 2D difference arrays, so each net costs O(1).
+    vtr::Matrix<double> chanx_diff({{width + 1, height + 1}}, 0.);
+    vtr::Matrix<double> chany_diff({{width + 1, height + 1}}, 0.);
+    auto add_rect = [](vtr::Matrix<double>& diff, int xlow, int xhigh, int ylow, int yhigh, double value) {
+        diff[xlow][ylow] += value;
+        diff[xhigh + 1][ylow] -= value;
+        diff[xlow][yhigh + 1] -= value;
+        diff[xhigh + 1][yhigh + 1] += value;
+    };
+
+    for (auto net_id : cluster_ctx.clb_nlist.nets()) {
+        if (cluster_ctx.clb_nlist.net_is_global(net_id)) continue;
+
+        size_t num_pins = cluster_ctx.clb_nlist.net_pins(net_id).size();
+        if (num_pins < 2) continue;
+
+        //Bounding box, restricted to the tiles with routing on all sides (as in the placer)
+        int xmin = width, xmax = 0, ymin = height, ymax = 0;
+        for (size_t ipin = 0; ipin < num_pins; ++ipin) {
+            ClusterBlockId blk_id = cluster_ctx.clb_nlist.net_pin_block(net_id, ipin);
+            int pnum = cluster_ctx.clb_nlist.net_pin_physical_index(net_id, ipin);
+            t_type_ptr type = cluster_ctx.clb_nlist.block_type(blk_id);
+
+            int x = place_ctx.block_locs[blk_id].x + type->pin_width_offset[pnum];
+            int y = place_ctx.block_locs[blk_id].y + type->pin_height_offset[pnum];
+            x = std::max(std::min<int>(x, width - 2), 1);
+            y = std::max(std::min<int>(y, height - 2), 1);
+
+            xmin = std::min(xmin, x);
+            xmax = std::max(xmax, x);
+            ymin = std::min(ymin, y);
+            ymax = std::max(ymax, y);
+        }
+
+        double crossing = get_net_crossing(num_pins);
+
+        //Horizontal wiring: crossing * bb width tracks, over the rows of channels bordering the bb
+        int chanx_ylow = std::max(ymin - 1, 0);
+        int chanx_yhigh = std::min<int>(ymax, height - 2);
+        add_rect(chanx_diff, xmin, xmax, chanx_ylow, chanx_yhigh, crossing / (chanx_yhigh - chanx_ylow + 1));
+
+        //Vertical wiring: crossing * bb height tracks, over the columns of channels bordering the bb
+        int chany_xlow = std::max(xmin - 1, 0);
+        int chany_xhigh = std::min<int>(xmax, width - 2);
+        add_rect(chany_diff, chany_xlow, chany_xhigh, ymin, ymax, crossing / (chany_xhigh - chany_xlow + 1));
+    }
+
+    map.chanx_demand = vtr::Matrix<float>({{width, height}}, 0.);
+    map.chany_demand = vtr::Matrix<float>({{width, height}}, 0.);
+    map.chanx_capacity = vtr::Matrix<float>({{width, height}}, 0.);
+    map.chany_capacity = vtr::Matrix<float>({{width, height}}, 0.);
+
+    //The channel widths are only known once an rr graph has been built
+    bool have_chan_width = device_ctx.chan_width.x_list.size() == height
+                           && device_ctx.chan_width.y_list.size() == width;
+
+    //Integrate the difference arrays
+    for (size_t x = 0; x < width; ++x) {
+        for (size_t y = 0; y < height; ++y) {
+            if (x > 0) {
+                chanx_diff[x][y] += chanx_diff[x - 1][y];
+                chany_diff[x][y] += chany_diff[x - 1][y];
+            }
+            if (y > 0) {
+                chanx_diff[x][y] += chanx_diff[x][y - 1];
+                chany_diff[x][y] += chany_diff[x][y - 1];
+            }
+            if (x > 0 && y > 0) {
+                chanx_diff[x][y] -= chanx_diff[x - 1][y - 1];
+                chany_diff[x][y] -= chany_diff[x - 1][y - 1];
+            }
+
+            if (chan_segment_exists(CHANX, x, y)) {
+                map.chanx_demand[x][y] = chanx_diff[x][y];
+                if (have_chan_width) map.chanx_capacity[x][y] = device_ctx.chan_width.x_list[y];
+            }
+            if (chan_segment_exists(CHANY, x, y)) {
+                map.chany_demand[x][y] = chany_diff[x][y];
+                if (have_chan_width) map.chany_capacity[x][y] = device_ctx.chan_width.y_list[x];
+            }
+        }
+    }
+
+    write_congestion_report(prefix, map);
+}
+
+void write_routing_congestion_report(const std::string& prefix) {
+    auto& device_ctx = g_vpr_ctx.device();
+    auto& route_ctx = g_vpr_ctx.routing();
+
+    t_congestion_map map;
+    map.stage = "route";
+    map.demand_type = "occupancy";
+
+    map.chanx_demand = calculate_routing_usage(CHANX);
+    map.chany_demand = calculate_routing_usage(CHANY);
+    map.chanx_capacity = calculate_routing_avail(CHANX);
+    map.chany_capacity = calculate_routing_avail(CHANY);
+
+    map.chanx_overuse = vtr::Matrix<float>({{device_ctx.grid.width(), device_ctx.grid.height()}}, 0.);
+    map.chany_overuse = vtr::Matrix<float>({{device_ctx.grid.width(), device_ctx.grid.height()}}, 0.);
+    for (size_t inode = 0; inode < device_ctx.rr_nodes.size(); ++inode) {
+        const t_rr_node& node = device_ctx.rr_nodes[inode];
+        int overuse = route_ctx.rr_node_route_inf[inode].occ() - node.capacity();
+        if (overuse <= 0) continue;
+
+        if (node.type() == CHANX) {
+            for (int x = node.xlow(); x <= node.xhigh(); ++x) {
+                map.chanx_overuse[x][node.ylow()] += overuse;
+            }
+        } else if (node.type() == CHANY) {
+            for (int y = node.ylow(); y <= node.yhigh(); ++y) {
+                map.chany_overuse[node.xlow()][y] += overuse;
+            }
+        }
+    }
+
+    write_congestion_report(prefix, map);
+}
+
+static bool chan_segment_exists(t_rr_type chan_type, size_t x, size_t y) {
+    auto& grid = g_vpr_ctx.device().grid;
+
+    if (chan_type == CHANX) {
+        return x >= 1 && x <= grid.width() - 2 && y <= grid.height() - 2;
+    } else {
+        VTR_ASSERT(chan_type == CHANY);
+        return x <= grid.width() - 2 && y >= 1 && y <= grid.height() - 2;
+    }
+}
+
+//Returns the utilization (demand / capacity) of a channel segment. If the capacities
+//are unknown, the demand relative to the maximum demand is returned instead.
+static float segment_util(const t_congestion_map& map, const t_congestion_summary& summary, t_rr_type chan_type, size_t x, size_t y) {
+    const vtr::Matrix<float>& demand = (chan_type == CHANX) ? map.chanx_demand : map.chany_demand;
+    const vtr::Matrix<float>& capacity = (chan_type == CHANX) ? map.chanx_capacity : map.chany_capacity;
+
+    if (summary.have_capacity) {
+        return demand[x][y] / std::max(capacity[x][y], 1.f);
+    }
+
+    return demand[x][y];
+}
+
+static t_congestion_summary summarize_congestion(const t_congestion_map& map) {
+    auto& grid = g_vpr_ctx.device().grid;
+
+    t_congestion_summary summary;
+    for (size_t x = 0; x < grid.width(); ++x) {
+        for (size_t y = 0; y < grid.height(); ++y) {
+            if (map.chanx_capacity[x][y] > 0. || map.chany_capacity[x][y] > 0.) {
+                summary.have_capacity = true;
+            }
+        }
+    }
+
+    for (t_rr_type chan_type : {CHANX, CHANY}) {
+        for (size_t x = 0; x < grid.width(); ++x) {
+            for (size_t y = 0; y < grid.height(); ++y) {
+                if (!chan_segment_exists(chan_type, x, y)) continue;
+
+                float util = segment_util(map, summary, chan_type, x, y);
+                if (util > summary.max_util) {
+                    summary.max_util = util;
+                    summary.max_util_x = x;
+                    summary.max_util_y = y;
+                    summary.max_util_chan = chan_type;
+                }
+                summary.total_util += util;
+                ++summary.num_segments;
+                if (summary.have_capacity && util > 1.) {
+                    ++summary.num_over_capacity_segments;
+                }
+
+                const vtr::Matrix<float>& overuse = (chan_type == CHANX) ? map.chanx_overuse : map.chany_overuse;
+                if (!overuse.empty()) {
+                    summary.total_overuse += overuse[x][y];
+                }
+            }
+        }
+    }
+
+    return summary;
+}
+
+static void write_congestion_report(const std::string& prefix, const t_congestion_map& map) {
+    vtr::ScopedStartFinishTimer timer(vtr::string_fmt("Writing %s congestion report", map.stage));
+
+    t_congestion_summary summary = summarize_congestion(map);
+
+    std::string basename = prefix + "." + map.stage;
+    write_congestion_json(basename + ".json", map, summary);
+
+    vtr::Matrix<t_rgb> cells = render_congestion_cells(map, summary);
+    write_congestion_svg(basename + ".svg", cells);
+    write_congestion_png(basename + ".png", cells);
+
+    if (summary.have_capacity) {
+        VTR_LOG("Peak %s channel utilization %.3g at %s (%zu,%zu); %zu of %zu channel segments over capacity\n",
+                map.stage, summary.max_util, (summary.max_util_chan == CHANX) ? "chanx" : "chany",
+                summary.max_util_x, summary.max_util_y, summary.num_over_capacity_segments, summary.num_segments);
+    }
+}
+
+static void write_congestion_json(const std::string& filename, const t_congestion_map& map, const t_congestion_summary& summary) {
+    auto& grid = g_vpr_ctx.device().grid;
+
+    FILE* fp = vtr::fopen(filename.c_str(), "w");
+
+    fprintf(fp, "{\n");
+    fprintf(fp, "\"stage\": \"%s\",\n", map.stage);
+    fprintf(fp, "\"width\": %zu,\n", grid.width());
+    fprintf(fp, "\"height\": %zu,\n", grid.height());
+    fprintf(fp, "\"demand_type\": \"%s\",\n", map.demand_type);
+
+    bool have_overuse = !map.chanx_overuse.empty();
+    for (t_rr_type chan_type : {CHANX, CHANY}) {
+        bool chanx = (chan_type == CHANX);
+        fprintf(fp, "\"%s\": {\n", chanx ? "chanx" : "chany");
+        write_json_grid(fp, "demand", chanx ? map.chanx_demand : map.chany_demand, false);
+        write_json_grid(fp, "capacity", chanx ? map.chanx_capacity : map.chany_capacity, !have_overuse);
+        if (have_overuse) {
+            write_json_grid(fp, "overuse", chanx ? map.chanx_overuse : map.chany_overuse, true);
+        }
+        fprintf(fp, "},\n");
+    }
+
+    fprintf(fp, "\"summary\": {\n");
+    if (summary.have_capacity) {
+        fprintf(fp, "  \"max_util\": %g,\n", summary.max_util);
+        fprintf(fp, "  \"max_util_location\": {\"chan\": \"%s\", \"x\": %zu, \"y\": %zu},\n",
+                (summary.max_util_chan == CHANX) ? "chanx" : "chany", summary.max_util_x, summary.max_util_y);
+        fprintf(fp, "  \"avg_util\": %g,\n", summary.num_segments ? summary.total_util / summary.num_segments : 0.);
+        fprintf(fp, "  \"num_over_capacity_segments\": %zu,\n", summary.num_over_capacity_segments);
+    }
+    if (have_overuse) {
+        fprintf(fp, "  \"total_overuse\": %g,\n", summary.total_overuse);
+    }
+    fprintf(fp, "  \"num_segments\": %zu\n", summary.num_segments);
+    fprintf(fp, "}\n");
+    fprintf(fp, "}\n");
+
+    vtr::fclose(fp);
+}
+
+static void write_json_grid(FILE* fp, const char* name, const vtr::Matrix<float>& grid, bool last) {
+    fprintf(fp, "  \"%s\": [", name);
+    for (size_t y = 0; y < grid.dim_size(1); ++y) {
+        fprintf(fp, "%s\n    [", (y > 0) ? "," : "");
+        for (size_t x = 0; x < grid.dim_size(0); ++x) {
+            fprintf(fp, "%s%g", (x > 0) ? "," : "", grid[x][y]);
+        }
+        fprintf(fp, "]");
+    }
+    fprintf(fp, "\n  ]%s\n", last ? "" : ",");
+}
+
+//Returns the colour of each device cell, [0..2*width-2][0..2*height-2], with y increasing upwards
+static vtr::Matrix<t_rgb> render_congestion_cells(const t_congestion_map& map, const t_congestion_summary& summary) {
+    auto& device_ctx = g_vpr_ctx.device();
+    auto& grid = device_ctx.grid;
+
+    const t_rgb white = {255, 255, 255};
+    const t_rgb tile_grey = {211, 211, 211};
+
+    float max_util = summary.have_capacity ? std::max(summary.max_util, 1.f) : std::max(summary.max_util, 1e-6f);
+    vtr::PlasmaColorMap cmap(0., max_util);
+    auto heat_color = [&](float util) {
+        vtr::Color<float> color = cmap.color(std::min(util, max_util));
+        return t_rgb{uint8_t(color.r * 255), uint8_t(color.g * 255), uint8_t(color.b * 255)};
+    };
+
+    vtr::Matrix<t_rgb> cells({{2 * grid.width() - 1, 2 * grid.height() - 1}}, white);
+    for (size_t x = 0; x < grid.width(); ++x) {
+        for (size_t y = 0; y < grid.height(); ++y) {
+            if (grid[x][y].type != device_ctx.EMPTY_TYPE) {
+                cells[2 * x][2 * y] = tile_grey;
+            }
+
+            if (chan_segment_exists(CHANX, x, y)) {
+                cells[2 * x][2 * y + 1] = heat_color(segment_util(map, summary, CHANX, x, y));
+            }
+            if (chan_segment_exists(CHANY, x, y)) {
+                cells[2 * x + 1][2 * y] = heat_color(segment_util(map, summary, CHANY, x, y));
+            }
+
+            //Switch blocks show the average of the adjacent channel segments
+            if (x + 1 < grid.width() && y + 1 < grid.height()) {
+                float util_sum = 0.;
+                int num_adjacent = 0;
+                for (auto seg : {std::make_tuple(CHANX, x, y), std::make_tuple(CHANX, x + 1, y),
+                                 std::make_tuple(CHANY, x, y), std::make_tuple(CHANY, x, y + 1)}) {
+                    if (chan_segment_exists(std::get<0>(seg), std::get<1>(seg), std::get<2>(seg))) {
+                        util_sum += std::min(segment_util(map, summary, std::get<0>(seg), std::get<1>(seg), std::get<2>(seg)), max_util);
+                        ++num_adjacent;
+                    }
+                }
+                if (num_adjacent > 0) {
+                    cells[2 * x + 1][2 * y + 1] = heat_color(util_sum / num_adjacent);
+                }
+            }
+        }
+    }
+
+    return cells;
+}
+
+static void write_congestion_svg(const std::string& filename, const vtr::Matrix<t_rgb>& cells) {
+    size_t num_cols = cells.dim_size(0);
+    size_t num_rows = cells.dim_size(1);
+
+    FILE* fp = vtr::fopen(filename.c_str(), "w");
+
+    fprintf(fp, "<svg xmlns=\"http://www.w3.org/2000/svg\" width=\"%zu\" height=\"%zu\" viewBox=\"0 0 %zu %zu\" shape-rendering=\"crispEdges\">\n",
+            num_cols * CONGESTION_IMAGE_CELL_PIXELS, num_rows * CONGESTION_IMAGE_CELL_PIXELS, num_cols, num_rows);
+    fprintf(fp, "<rect width=\"%zu\" height=\"%zu\" fill=\"#ffffff\"/>\n", num_cols, num_rows);
+
+    //One rectangle per horizontal run of equally coloured (non-white) cells
+    for (size_t row = 0; row < num_rows; ++row) {
+        size_t y = num_rows - 1 - row; //SVG y increases downwards
+        for (size_t x = 0; x < num_cols; ) {
+            t_rgb color = cells[x][y];
+            size_t run = 1;
+            while (x + run < num_cols && cells[x + run][y].r == color.r
+                   && cells[x + run][y].g == color.g && cells[x + run][y].b == color.b) {
+                ++run;
+            }
+
+            if (color.r != 255 || color.g != 255 || color.b != 255) {
+                fprintf(fp, "<rect x=\"%zu\" y=\"%zu\" width=\"%zu\" height=\"1\" fill=\"#%02x%02x%02x\"/>\n",
+                        x, row, run, color.r, color.g, color.b);
+            }
+            x += run;
+        }
+    }
+
+    fprintf(fp, "</svg>\n");
+    vtr::fclose(fp);
+}
+
+static void write_congestion_png(const std::string& filename, const vtr::Matrix<t_rgb>& cells) {
+    size_t width = cells.dim_size(0) * CONGESTION_IMAGE_CELL_PIXELS;
+    size_t height = cells.dim_size(1) * CONGESTION_IMAGE_CELL_PIXELS;
+
+    //Raw image data: each row is a filter type byte (0: none) followed by RGB pixels
+    size_t row_stride = 1 + 3 * width;
+    std::vector<uint8_t> raw;
+    raw.reserve(row_stride * height);
+    for (size_t row = 0; row < height; ++row) {
+        size_t y = cells.dim_size(1) - 1 - row / CONGESTION_IMAGE_CELL_PIXELS; //PNG rows go downwards
+        raw.push_back(0);
+        for (size_t col = 0; col < width; ++col) {
+            const t_rgb& color = cells[col / CONGESTION_IMAGE_CELL_PIXELS][y];
+            raw.push_back(color.r);
+            raw.push_back(color.g);
+            raw.push_back(color.b);
+        }
+    }
+
+    std::vector<uint8_t> header;
+    append_be32(header, width);
+    append_be32(header, height);
+    header.push_back(8); //Bit depth
+    header.push_back(2); //Colour type: RGB
+    header.push_back(0); //Compression: deflate
+    header.push_back(0); //Filter method
+    header.push_back(0); //No interlacing
+
+    FILE* fp = vtr::fopen(filename.c_str(), "wb");
+
+    const uint8_t signature[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n'};
+    fwrite(signature, 1, sizeof(signature), fp);
+    write_png_chunk(fp, "IHDR", header);
+    write_png_chunk(fp, "IDAT", zlib_compress(raw, row_stride));
+    write_png_chunk(fp, "IEND", std::vector<uint8_t>());
+
+    vtr::fclose(fp);
+}
+
+/* Compresses data into a zlib stream made of a single fixed-Huffman deflate block.
+ * The images are made of solid runs, so only matches with the previous pixel or
+ * the previous row (row_stride back) are looked for, which is fast and compresses
+ * them well. */
+static std::vector<uint8_t> zlib_compress(const std::vector<uint8_t>& data, size_t row_stride) {
+    static const int length_base[29] = {3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+                                        35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+    static const int length_extra[29] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+                                         3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+    static const int dist_base[30] = {1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+                                      257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577};
+    static const int dist_extra[30] = {0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+                                       7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+
+    std::vector<uint8_t> out = {0x78, 0x01}; //zlib header: deflate, 32K window, no dictionary
+
+    uint32_t bit_buffer = 0;
+    int num_bits = 0;
+    auto put_bits = [&](uint32_t value, int count) { //Least significant bit first
+        bit_buffer |= value << num_bits;
+        num_bits += count;
+        while (num_bits >= 8) {
+            out.push_back(bit_buffer & 0xff);
+            bit_buffer >>= 8;
+            num_bits -= 8;
+        }
+    };
+    auto put_code = [&](uint32_t code, int length) { //Huffman codes go most significant bit first
+        uint32_t reversed = 0;
+        for (int i = 0; i < length; ++i) {
+            reversed = (reversed << 1) | ((code >> i) & 1);
+        }
+        put_bits(reversed, length);
+    };
+    auto put_symbol = [&](int symbol) { //Fixed literal/length code
+        if (symbol < 144) {
+            put_code(0x30 + symbol, 8);
+        } else if (symbol < 256) {
+            put_code(0x190 + symbol - 144, 9);
+        } else if (symbol < 280) {
+            put_code(symbol - 256, 7);
+        } else {
+            put_code(0xc0 + symbol - 280, 8);
+        }
+    };
+
+    put_bits(1, 1); //Final block
+    put_bits(1, 2); //Fixed Huffman codes
+
+    size_t size = data.size();
+    for (size_t i = 0; i < size; ) {
+        size_t best_length = 0;
+        size_t best_distance = 0;
+        for (size_t distance : {size_t(3), row_stride}) {
+            if (distance > i || distance > DEFLATE_MAX_DISTANCE) continue;
+
+            size_t length = 0;
+            size_t max_length = std::min(DEFLATE_MAX_MATCH, size - i);
+            while (length < max_length && data[i + length] == data[i + length - distance]) {
+                ++length;
+            }
+            if (length > best_length) {
+                best_length = length;
+                best_distance = distance;
+            }
+        }
+
+        if (best_length < 3) {
+            put_symbol(data[i]);
+            ++i;
+            continue;
+        }
+
+        int length_code = std::upper_bound(length_base, length_base + 29, int(best_length)) - length_base - 1;
+        put_symbol(257 + length_code);
+        put_bits(best_length - length_base[length_code], length_extra[length_code]);
+
+        int dist_code = std::upper_bound(dist_base, dist_base + 30, int(best_distance)) - dist_base - 1;
+        put_code(dist_code, 5);
+        put_bits(best_distance - dist_base[dist_code], dist_extra[dist_code]);
+
+        i += best_length;
+    }
+
+    put_symbol(256); //End of block
+    if (num_bits > 0) {
+        put_bits(0, 8 - num_bits); //Flush the last partial byte
+    }
+
+    //Adler-32 checksum of the uncompressed data
+    uint32_t a = 1, b = 0;
+    for (uint8_t byte : data) {
+        a = (a + byte) % 65521;
+        b = (b + a) % 65521;
+    }
+    append_be32(out, (b << 16) | a);
+
+    return out;
+}
+
+static void write_png_chunk(FILE* fp, const char* type, const std::vector<uint8_t>& data) {
+    std::vector<uint8_t> chunk;
+    append_be32(chunk, data.size());
+    chunk.insert(chunk.end(), type, type + 4);
+    chunk.insert(chunk.end(), data.begin(), data.end());
+
+    //The CRC covers the chunk type and data
+    append_be32(chunk, png_crc32(chunk.data() + 4, chunk.size() - 4, 0));
+
+    fwrite(chunk.data(), 1, chunk.size(), fp);
+}
+
+static uint32_t png_crc32(const uint8_t* data, size_t size, uint32_t crc) {
+    static std::array<uint32_t, 256> table = [] {
+        std::array<uint32_t, 256> crc_table;
+        for (uint32_t n = 0; n < 256; ++n) {
+            uint32_t c = n;
+            for (int k = 0; k < 8; ++k) {
+                c = (c & 1) ? (0xedb88320u ^ (c >> 1)) : (c >> 1);
+            }
+            crc_table[n] = c;
+        }
+        return crc_table;
+    }();
+
+    crc = ~crc;
+    for (size_t i = 0; i < size; ++i) {
+        crc = table[(crc ^ data[i]) & 0xff] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+static void append_be32(std::vector<uint8_t>& data, uint32_t value) {
+    data.push_back((value >> 24) & 0xff);
+    data.push_back((value >> 16) & 0xff);
+    data.push_back((value >> 8) & 0xff);
+    data.push_back(value & 0xff);
+}
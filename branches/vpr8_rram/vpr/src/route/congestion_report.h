@@ -0,0 +1,19 @@
+#ifndef VPR_CONGESTION_REPORT_H
+#define VPR_CONGESTION_REPORT_H
+#include <string>
+
+/* Congestion reports are written without the graphics, so they can be produced by
+ * batch (e.g. regression) runs. Each report is a JSON file of per-channel-segment
+ * grids, plus SVG and PNG heat maps of the utilization laid out like the device
+ * (in the style of the 'Routing Util' view of the graphics). */
+
+//Writes the routing congestion estimated from the placement (a RUDY-style estimate
+//spreading each net's expected wiring uniformly over its bounding box) to
+//<prefix>.place.json, <prefix>.place.svg and <prefix>.place.png
+void write_placement_congestion_report(const std::string& prefix);
+
+//Writes the routing channel utilization and the overuse of the routing resources to
+//<prefix>.route.json, <prefix>.route.svg and <prefix>.route.png
+void write_routing_congestion_report(const std::string& prefix);
+
+#endif
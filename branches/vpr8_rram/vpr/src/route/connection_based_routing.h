@@ -1,4 +1,5 @@
 #pragma once
+#include <iosfwd>
 #include <vector>
 #include <unordered_map>
 #include "route_tree_type.h"
@@ -125,6 +126,9 @@ public:
             const ClusteredPinAtomPinsLookup& netlist_pin_lookup,
             vtr::vector<ClusterNetId, float *> &net_delay);
 
+	// save/restore the state that evolves over routing iterations (see route_checkpoint.h)
+	void write_checkpoint(std::ostream& os) const;
+	void read_checkpoint(std::istream& is);
 };
 
 using CBRR = Connection_based_routing_resources;	// shorthand
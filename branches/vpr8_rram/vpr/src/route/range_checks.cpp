@@ -0,0 +1,52 @@
+#include <algorithm>
+#include <exception>
+
+#include "vtr_log.h"
+
+#include "range_checks.h"
+
+#if defined(TATUM_USE_TBB)
+# include <tbb/parallel_for.h>
+#endif
+
+void run_range_checks(size_t num_items, size_t range_size,
+        const std::function<void(size_t, size_t, std::vector<std::string>&)>& check_range) {
+
+    struct t_range_result {
+        std::vector<std::string> warnings;
+        std::exception_ptr error;
+    };
+
+    size_t num_ranges = (num_items + range_size - 1) / range_size;
+    std::vector<t_range_result> results(num_ranges);
+
+    /* Any exception (not only VPR errors, but also e.g. std::bad_alloc) is captured, so it is *
+     * reported in item order rather than escaping from whichever task happened to throw it.   */
+    auto run_range = [&](size_t irange) {
+        size_t begin = irange * range_size;
+        size_t end = std::min(begin + range_size, num_items);
+        try {
+            check_range(begin, end, results[irange].warnings);
+        } catch (...) {
+            results[irange].error = std::current_exception();
+        }
+    };
+
+#if defined(TATUM_USE_TBB)
+    tbb::parallel_for(size_t(0), num_ranges, run_range);
+#else
+    for (size_t irange = 0; irange < num_ranges; irange++) {
+        run_range(irange);
+    }
+#endif
+
+    /* Report in item order: every warning before the first error, then the error */
+    for (const t_range_result& result : results) {
+        for (const std::string& warning : result.warnings) {
+            VTR_LOG_WARN("%s", warning.c_str());
+        }
+        if (result.error) {
+            std::rethrow_exception(result.error);
+        }
+    }
+}
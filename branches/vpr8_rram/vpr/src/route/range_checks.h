@@ -0,0 +1,16 @@
+#ifndef VPR_RANGE_CHECKS_H
+#define VPR_RANGE_CHECKS_H
+#include <functional>
+#include <string>
+#include <vector>
+
+/* Runs check_range(begin, end, warnings) over consecutive ranges of [0, num_items), in parallel when
+ * built with TBB. A check reports an error by throwing, and a warning by appending it to warnings;
+ * each range stops at its first error. Once all ranges are done, the warnings and the first error
+ * are reported in item order, exactly as if the items had been checked one after another.
+ *
+ * Shared by the rr graph and routing checks (check_rr_graph() and check_route()).                */
+void run_range_checks(size_t num_items, size_t range_size,
+        const std::function<void(size_t, size_t, std::vector<std::string>&)>& check_range);
+
+#endif
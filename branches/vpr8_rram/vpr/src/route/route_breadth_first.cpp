@@ -17,8 +17,7 @@ using namespace std;
 static bool breadth_first_route_net(ClusterNetId net_id, float bend_cost);
 
 static void breadth_first_expand_trace_segment(t_trace *start_ptr,
-		int remaining_connections_to_sink,
-        std::vector<int>& modified_rr_node_inf);
+		int remaining_connections_to_sink);
 
 static void breadth_first_expand_neighbours(int inode, float pcost,
 	ClusterNetId net_id, float bend_cost);
@@ -174,11 +173,9 @@ static bool breadth_first_route_net(ClusterNetId net_id, float bend_cost) {
 
     auto src_pin_id = cluster_ctx.clb_nlist.net_driver(net_id);
 
-    std::vector<int> modified_rr_node_inf; //RR node indicies with modified rr_node_route_inf
-
 	for (auto pin_id : cluster_ctx.clb_nlist.net_sinks(net_id)) { /* Need n-1 wires to connect n pins */
 
-		breadth_first_expand_trace_segment(tptr, remaining_connections_to_sink, modified_rr_node_inf);
+		breadth_first_expand_trace_segment(tptr, remaining_connections_to_sink);
 		current = get_heap_head();
 
 		if (current == nullptr) { /* Infeasible routing.  No possible path for net. */
@@ -186,7 +183,7 @@ static bool breadth_first_route_net(ClusterNetId net_id, float bend_cost) {
 					size_t(net_id), cluster_ctx.clb_nlist.net_name(net_id).c_str(),
                     cluster_ctx.clb_nlist.pin_name(src_pin_id).c_str(),
                     cluster_ctx.clb_nlist.pin_name(pin_id).c_str());
-			reset_path_costs(modified_rr_node_inf); /* Clean up before leaving. */
+			reset_path_costs(); /* Clean up before leaving. */
 			return (false);
 		}
 
@@ -197,7 +194,7 @@ static bool breadth_first_route_net(ClusterNetId net_id, float bend_cost) {
 #endif
 
 		while (route_ctx.rr_node_route_inf[inode].target_flag == 0) {
-			pcost = route_ctx.rr_node_route_inf[inode].path_cost;
+			pcost = route_ctx.rr_node_route_inf[inode].path_cost();
 			new_pcost = current->cost;
 			if (pcost > new_pcost) { /* New path is lowest cost. */
 #ifdef ROUTER_DEBUG
@@ -208,11 +205,8 @@ static bool breadth_first_route_net(ClusterNetId net_id, float bend_cost) {
 #ifdef ROUTER_DEBUG
                     VTR_LOG("    Setting routing paths for associated node %d\n", prev.to_node);
 #endif
-                    add_to_mod_list(prev.to_node, modified_rr_node_inf);
-
-                    route_ctx.rr_node_route_inf[prev.to_node].path_cost = new_pcost;
-                    route_ctx.rr_node_route_inf[prev.to_node].prev_node = prev.from_node;
-                    route_ctx.rr_node_route_inf[prev.to_node].prev_edge = prev.from_edge;
+                    route_ctx.rr_node_route_inf[prev.to_node].set_path_cost(new_pcost);
+                    route_ctx.rr_node_route_inf[prev.to_node].set_prev(prev.from_node, prev.from_edge);
 
                 }
 
@@ -229,7 +223,7 @@ static bool breadth_first_route_net(ClusterNetId net_id, float bend_cost) {
                 VTR_LOG("Cannot route net #%zu (%s) from (%s) to sink pin (%s) -- no possible path.\n",
                         size_t(net_id), cluster_ctx.clb_nlist.net_name(net_id).c_str(),
                         cluster_ctx.clb_nlist.pin_name(src_pin_id).c_str(), cluster_ctx.clb_nlist.pin_name(pin_id).c_str());
-				reset_path_costs(modified_rr_node_inf);
+				reset_path_costs();
 				return (false);
 			}
 
@@ -255,13 +249,12 @@ static bool breadth_first_route_net(ClusterNetId net_id, float bend_cost) {
 #endif
 
 	empty_heap();
-	reset_path_costs(modified_rr_node_inf);
+	reset_path_costs();
 	return (true);
 }
 
 static void breadth_first_expand_trace_segment(t_trace *start_ptr,
-		int remaining_connections_to_sink,
-        std::vector<int>& modified_rr_node_inf) {
+		int remaining_connections_to_sink) {
 
 	/* Adds all the rr_nodes in the traceback segment starting at tptr (and     *
 	 * continuing to the end of the traceback) to the heap with a cost of zero. *
@@ -337,15 +330,13 @@ static void breadth_first_expand_trace_segment(t_trace *start_ptr,
 		 * doglegs are allowed in the graph, we won't be able to use this IPIN to   *
 		 * do a dogleg, since it won't be re-expanded.  Shouldn't be a big problem. */
 
-        add_to_mod_list(last_ipin_node, modified_rr_node_inf);
-		route_ctx.rr_node_route_inf[last_ipin_node].path_cost = -HUGE_POSITIVE_FLOAT;
+		route_ctx.rr_node_route_inf[last_ipin_node].set_path_cost(-HUGE_POSITIVE_FLOAT);
 
 		/* Also need to mark the SINK as having high cost, so another connection can *
 		 * be made to it.                                                            */
 
 		sink_node = tptr->index;
-        add_to_mod_list(sink_node, modified_rr_node_inf);
-		route_ctx.rr_node_route_inf[sink_node].path_cost = HUGE_POSITIVE_FLOAT;
+		route_ctx.rr_node_route_inf[sink_node].set_path_cost(HUGE_POSITIVE_FLOAT);
 
 		/* Finally, I need to remove any pending connections to this SINK via the    *
 		 * IPIN I just used (since they would result in congestion).  Scan through   *
@@ -0,0 +1,420 @@
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+#include "vtr_assert.h"
+#include "vtr_log.h"
+
+#include "vpr_error.h"
+#include "globals.h"
+#include "route_common.h"
+#include "route_checkpoint.h"
+
+/* File layout:
+ *   magic, version
+ *   fingerprint: #rr nodes, #clb nets, #clb blocks, channel width
+ *   router loop state (t_routing_checkpoint scalars)
+ *   current routing: tracebacks, route_bb, clb_opins_used_locally
+ *   rr node acc_cost
+ *   routing predictor history
+ *   connection based routing (CBRR) state
+ *   best routing: tracebacks, clb_opins_used_locally  (only if routing_is_successful)
+ *   end marker
+ */
+
+constexpr char ROUTING_CHECKPOINT_MAGIC[8] = {'V', 'P', 'R', 'R', 'C', 'K', 'P', 'T'};
+constexpr uint32_t ROUTING_CHECKPOINT_VERSION = 1;
+constexpr uint32_t ROUTING_CHECKPOINT_END = 0x454e4421; //"END!"
+
+static void write_traceback(std::ostream& os, const t_traceback& traceback);
+static t_traceback read_traceback(std::istream& is);
+
+static void write_clb_opins_used(std::ostream& os, const t_clb_opins_used& opins_used);
+static t_clb_opins_used read_clb_opins_used(std::istream& is);
+
+static void check_checkpoint_stream(const std::istream& is, const std::string& filename, const char* section);
+
+void write_routing_checkpoint(const std::string& filename,
+                              const t_routing_checkpoint& checkpoint,
+                              const CBRR& connections_inf,
+                              const RoutingPredictor& routing_predictor) {
+    auto& device_ctx = g_vpr_ctx.device();
+    auto& cluster_ctx = g_vpr_ctx.clustering();
+    auto& route_ctx = g_vpr_ctx.routing();
+
+    std::string tmp_filename = filename + ".tmp";
+    std::ofstream os(tmp_filename, std::ios::binary | std::ios::trunc);
+    if (!os) {
+        vpr_throw(VPR_ERROR_ROUTE, __FILE__, __LINE__,
+                  "Failed to open routing checkpoint file '%s' for writing\n", tmp_filename.c_str());
+    }
+
+    os.write(ROUTING_CHECKPOINT_MAGIC, sizeof(ROUTING_CHECKPOINT_MAGIC));
+    write_checkpoint_value<uint32_t>(os, ROUTING_CHECKPOINT_VERSION);
+
+    //Fingerprint
+    write_checkpoint_value<uint64_t>(os, device_ctx.rr_nodes.size());
+    write_checkpoint_value<uint64_t>(os, cluster_ctx.clb_nlist.nets().size());
+    write_checkpoint_value<uint64_t>(os, cluster_ctx.clb_nlist.blocks().size());
+    write_checkpoint_value<int32_t>(os, device_ctx.chan_width.max);
+
+    //Router loop state
+    write_checkpoint_value<int32_t>(os, checkpoint.itry);
+    write_checkpoint_value<float>(os, checkpoint.pres_fac);
+    write_checkpoint_value<int32_t>(os, checkpoint.bb_fac);
+    write_checkpoint_value<int32_t>(os, checkpoint.itry_conflicted_mode);
+    write_checkpoint_value<uint8_t>(os, checkpoint.conflicted_mode);
+    write_checkpoint_value<int32_t>(os, checkpoint.legal_convergence_count);
+    write_checkpoint_value<int32_t>(os, checkpoint.itry_since_last_convergence);
+    write_checkpoint_value<uint8_t>(os, checkpoint.routing_is_successful);
+    write_checkpoint_value<uint64_t>(os, checkpoint.best_used_wirelength);
+    write_checkpoint_value<float>(os, checkpoint.best_sWNS);
+    write_checkpoint_value<float>(os, checkpoint.best_sTNS);
+    write_checkpoint_value<float>(os, checkpoint.best_hWNS);
+    write_checkpoint_value<float>(os, checkpoint.best_hTNS);
+    write_checkpoint_value<float>(os, checkpoint.best_critical_path_delay);
+    write_checkpoint_value<float>(os, checkpoint.best_critical_path_slack);
+
+    //Current routing
+    for (auto net_id : cluster_ctx.clb_nlist.nets()) {
+        write_traceback(os, route_ctx.trace[net_id]);
+    }
+    for (auto net_id : cluster_ctx.clb_nlist.nets()) {
+        write_checkpoint_value<t_bb>(os, route_ctx.route_bb[net_id]);
+    }
+    write_clb_opins_used(os, route_ctx.clb_opins_used_locally);
+
+    //Congestion history
+    for (size_t inode = 0; inode < device_ctx.rr_nodes.size(); ++inode) {
+        write_checkpoint_value<float>(os, route_ctx.rr_node_route_inf[inode].acc_cost);
+    }
+
+    //Routing predictor history
+    const auto& iterations = routing_predictor.iterations();
+    const auto& overused_counts = routing_predictor.iteration_overused_rr_node_counts();
+    VTR_ASSERT(iterations.size() == overused_counts.size());
+    write_checkpoint_value<uint64_t>(os, iterations.size());
+    for (size_t i = 0; i < iterations.size(); ++i) {
+        write_checkpoint_value<uint64_t>(os, iterations[i]);
+        write_checkpoint_value<uint64_t>(os, overused_counts[i]);
+    }
+
+    connections_inf.write_checkpoint(os);
+
+    //Best routing
+    if (checkpoint.routing_is_successful) {
+        for (auto net_id : cluster_ctx.clb_nlist.nets()) {
+            write_traceback(os, checkpoint.best_routing[net_id]);
+        }
+        write_clb_opins_used(os, checkpoint.best_clb_opins_used_locally);
+    }
+
+    write_checkpoint_value<uint32_t>(os, ROUTING_CHECKPOINT_END);
+
+    os.close();
+    if (!os) {
+        vpr_throw(VPR_ERROR_ROUTE, __FILE__, __LINE__,
+                  "Failed to write routing checkpoint file '%s'\n", tmp_filename.c_str());
+    }
+
+    if (std::rename(tmp_filename.c_str(), filename.c_str()) != 0) {
+        vpr_throw(VPR_ERROR_ROUTE, __FILE__, __LINE__,
+                  "Failed to rename routing checkpoint file '%s' to '%s'\n", tmp_filename.c_str(), filename.c_str());
+    }
+}
+
+bool read_routing_checkpoint(const std::string& filename,
+                             t_routing_checkpoint& checkpoint,
+                             CBRR& connections_inf,
+                             RoutingPredictor& routing_predictor) {
+    auto& device_ctx = g_vpr_ctx.device();
+    auto& cluster_ctx = g_vpr_ctx.clustering();
+    auto& route_ctx = g_vpr_ctx.mutable_routing();
+
+    std::ifstream is(filename, std::ios::binary);
+    if (!is) {
+        vpr_throw(VPR_ERROR_ROUTE, __FILE__, __LINE__,
+                  "Failed to open routing checkpoint file '%s'\n", filename.c_str());
+    }
+
+    char magic[sizeof(ROUTING_CHECKPOINT_MAGIC)];
+    is.read(magic, sizeof(magic));
+    if (!is || std::memcmp(magic, ROUTING_CHECKPOINT_MAGIC, sizeof(magic)) != 0) {
+        vpr_throw(VPR_ERROR_ROUTE, __FILE__, __LINE__,
+                  "'%s' is not a routing checkpoint file\n", filename.c_str());
+    }
+
+    uint32_t version = read_checkpoint_value<uint32_t>(is);
+    if (version != ROUTING_CHECKPOINT_VERSION) {
+        vpr_throw(VPR_ERROR_ROUTE, __FILE__, __LINE__,
+                  "Routing checkpoint '%s' has unsupported version %u (expected %u)\n",
+                  filename.c_str(), version, ROUTING_CHECKPOINT_VERSION);
+    }
+
+    //Fingerprint
+    uint64_t num_rr_nodes = read_checkpoint_value<uint64_t>(is);
+    uint64_t num_nets = read_checkpoint_value<uint64_t>(is);
+    uint64_t num_blocks = read_checkpoint_value<uint64_t>(is);
+    int32_t chan_width = read_checkpoint_value<int32_t>(is);
+    check_checkpoint_stream(is, filename, "header");
+
+    if (num_rr_nodes != device_ctx.rr_nodes.size()
+        || num_nets != cluster_ctx.clb_nlist.nets().size()
+        || num_blocks != cluster_ctx.clb_nlist.blocks().size()
+        || chan_width != device_ctx.chan_width.max) {
+        VTR_LOG_WARN("Not resuming from routing checkpoint '%s', it does not match the current implementation"
+                     " (checkpoint: %zu rr nodes, %zu nets, %zu blocks, channel width %d;"
+                     " current: %zu rr nodes, %zu nets, %zu blocks, channel width %d)\n",
+                     filename.c_str(),
+                     size_t(num_rr_nodes), size_t(num_nets), size_t(num_blocks), chan_width,
+                     device_ctx.rr_nodes.size(), cluster_ctx.clb_nlist.nets().size(), cluster_ctx.clb_nlist.blocks().size(), device_ctx.chan_width.max);
+        return false;
+    }
+
+    //Router loop state
+    checkpoint.itry = read_checkpoint_value<int32_t>(is);
+    checkpoint.pres_fac = read_checkpoint_value<float>(is);
+    checkpoint.bb_fac = read_checkpoint_value<int32_t>(is);
+    checkpoint.itry_conflicted_mode = read_checkpoint_value<int32_t>(is);
+    checkpoint.conflicted_mode = read_checkpoint_value<uint8_t>(is);
+    checkpoint.legal_convergence_count = read_checkpoint_value<int32_t>(is);
+    checkpoint.itry_since_last_convergence = read_checkpoint_value<int32_t>(is);
+    checkpoint.routing_is_successful = read_checkpoint_value<uint8_t>(is);
+    checkpoint.best_used_wirelength = read_checkpoint_value<uint64_t>(is);
+    checkpoint.best_sWNS = read_checkpoint_value<float>(is);
+    checkpoint.best_sTNS = read_checkpoint_value<float>(is);
+    checkpoint.best_hWNS = read_checkpoint_value<float>(is);
+    checkpoint.best_hTNS = read_checkpoint_value<float>(is);
+    checkpoint.best_critical_path_delay = read_checkpoint_value<float>(is);
+    checkpoint.best_critical_path_slack = read_checkpoint_value<float>(is);
+    check_checkpoint_stream(is, filename, "router state");
+
+    //Current routing, replacing whatever is there
+    for (auto net_id : cluster_ctx.clb_nlist.nets()) {
+        pathfinder_update_path_cost(route_ctx.trace[net_id].head, -1, checkpoint.pres_fac);
+        free_traceback(net_id);
+
+        route_ctx.trace[net_id] = read_traceback(is);
+        route_ctx.net_status[net_id].is_checked = false;
+        check_checkpoint_stream(is, filename, "routing");
+
+        route_ctx.trace_nodes[net_id].clear();
+        for (t_trace* tptr = route_ctx.trace[net_id].head; tptr != nullptr; tptr = tptr->next) {
+            route_ctx.trace_nodes[net_id].insert(tptr->index);
+        }
+
+        pathfinder_update_path_cost(route_ctx.trace[net_id].head, 1, checkpoint.pres_fac);
+    }
+    for (auto net_id : cluster_ctx.clb_nlist.nets()) {
+        route_ctx.route_bb[net_id] = read_checkpoint_value<t_bb>(is);
+    }
+
+    for (const auto& class_opins : route_ctx.clb_opins_used_locally) {
+        for (const auto& opins : class_opins) {
+            for (int inode : opins) {
+                if (inode != OPEN) pathfinder_update_single_node_cost(inode, -1, checkpoint.pres_fac);
+            }
+        }
+    }
+    route_ctx.clb_opins_used_locally = read_clb_opins_used(is);
+    check_checkpoint_stream(is, filename, "routing");
+    for (const auto& class_opins : route_ctx.clb_opins_used_locally) {
+        for (const auto& opins : class_opins) {
+            for (int inode : opins) {
+                if (inode != OPEN) pathfinder_update_single_node_cost(inode, 1, checkpoint.pres_fac);
+            }
+        }
+    }
+
+    //Congestion history (occupancy and pres_cost were rebuilt above as the routing was added)
+    for (size_t inode = 0; inode < device_ctx.rr_nodes.size(); ++inode) {
+        route_ctx.rr_node_route_inf[inode].acc_cost = read_checkpoint_value<float>(is);
+    }
+    check_checkpoint_stream(is, filename, "congestion history");
+
+    //Routing predictor history
+    routing_predictor = RoutingPredictor();
+    uint64_t num_predictor_iterations = read_checkpoint_value<uint64_t>(is);
+    for (size_t i = 0; i < num_predictor_iterations && is; ++i) {
+        size_t iteration = read_checkpoint_value<uint64_t>(is);
+        size_t overused_count = read_checkpoint_value<uint64_t>(is);
+        routing_predictor.add_iteration_overuse(iteration, overused_count);
+    }
+    check_checkpoint_stream(is, filename, "routing predictor");
+
+    connections_inf.read_checkpoint(is);
+    check_checkpoint_stream(is, filename, "connection based routing");
+
+    //Best routing
+    checkpoint.best_routing.clear();
+    checkpoint.best_clb_opins_used_locally.clear();
+    if (checkpoint.routing_is_successful) {
+        checkpoint.best_routing.resize(cluster_ctx.clb_nlist.nets().size());
+        for (auto net_id : cluster_ctx.clb_nlist.nets()) {
+            checkpoint.best_routing[net_id] = read_traceback(is);
+        }
+        checkpoint.best_clb_opins_used_locally = read_clb_opins_used(is);
+        check_checkpoint_stream(is, filename, "best routing");
+    }
+
+    if (read_checkpoint_value<uint32_t>(is) != ROUTING_CHECKPOINT_END) {
+        vpr_throw(VPR_ERROR_ROUTE, __FILE__, __LINE__,
+                  "Routing checkpoint '%s' is corrupt (missing end marker)\n", filename.c_str());
+    }
+
+    VTR_LOG("Resumed routing from checkpoint '%s' after routing iteration %d\n", filename.c_str(), checkpoint.itry);
+    return true;
+}
+
+static void write_traceback(std::ostream& os, const t_traceback& traceback) {
+    uint64_t num_elements = 0;
+    for (const t_trace* tptr = traceback.head; tptr != nullptr; tptr = tptr->next) {
+        ++num_elements;
+    }
+
+    write_checkpoint_value<uint64_t>(os, num_elements);
+    for (const t_trace* tptr = traceback.head; tptr != nullptr; tptr = tptr->next) {
+        write_checkpoint_value<int32_t>(os, tptr->index);
+        write_checkpoint_value<int16_t>(os, tptr->iswitch);
+    }
+}
+
+//Elements referring to non-existent rr nodes or switches fail the stream
+static t_traceback read_traceback(std::istream& is) {
+    auto& device_ctx = g_vpr_ctx.device();
+    t_traceback traceback;
+
+    uint64_t num_elements = read_checkpoint_value<uint64_t>(is);
+    for (size_t i = 0; i < num_elements && is; ++i) {
+        t_trace* tptr = alloc_trace_data();
+        tptr->index = read_checkpoint_value<int32_t>(is);
+        tptr->iswitch = read_checkpoint_value<int16_t>(is);
+        tptr->next = nullptr;
+
+        if (tptr->index < 0 || size_t(tptr->index) >= device_ctx.rr_nodes.size()
+            || tptr->iswitch < OPEN || tptr->iswitch >= device_ctx.num_rr_switches) {
+            is.setstate(std::ios::failbit);
+        }
+
+        if (traceback.tail) {
+            traceback.tail->next = tptr;
+        } else {
+            traceback.head = tptr;
+        }
+        traceback.tail = tptr;
+    }
+
+    return traceback;
+}
+
+static void write_clb_opins_used(std::ostream& os, const t_clb_opins_used& opins_used) {
+    write_checkpoint_value<uint64_t>(os, opins_used.size());
+    for (const auto& class_opins : opins_used) {
+        write_checkpoint_value<uint64_t>(os, class_opins.size());
+        for (const auto& opins : class_opins) {
+            write_checkpoint_value<uint64_t>(os, opins.size());
+            for (int inode : opins) {
+                write_checkpoint_value<int32_t>(os, inode);
+            }
+        }
+    }
+}
+
+//Counts are bounded by the blocks, pin classes and pins of the clustered netlist, and pins by
+//the rr graph, so a corrupt checkpoint fails the stream rather than being used
+static t_clb_opins_used read_clb_opins_used(std::istream& is) {
+    auto& device_ctx = g_vpr_ctx.device();
+    auto& cluster_ctx = g_vpr_ctx.clustering();
+    t_clb_opins_used opins_used;
+
+    opins_used.resize(read_checkpoint_count(is, cluster_ctx.clb_nlist.blocks().size()));
+    for (auto blk_id : opins_used.keys()) {
+        if (!is) break;
+        t_type_ptr type = cluster_ctx.clb_nlist.block_type(blk_id);
+        auto& class_opins = opins_used[blk_id];
+        class_opins.resize(read_checkpoint_count(is, type->num_class));
+        for (size_t iclass = 0; iclass < class_opins.size() && is; ++iclass) {
+            auto& opins = class_opins[iclass];
+            opins.resize(read_checkpoint_count(is, type->class_inf[iclass].num_pins));
+            for (int& inode : opins) {
+                inode = read_checkpoint_value<int32_t>(is);
+                if (inode != OPEN && (inode < 0 || size_t(inode) >= device_ctx.rr_nodes.size())) {
+                    is.setstate(std::ios::failbit);
+                }
+            }
+        }
+    }
+
+    return opins_used;
+}
+
+static void check_checkpoint_stream(const std::istream& is, const std::string& filename, const char* section) {
+    if (!is) {
+        vpr_throw(VPR_ERROR_ROUTE, __FILE__, __LINE__,
+                  "Routing checkpoint '%s' is truncated or corrupt (while reading %s)\n", filename.c_str(), section);
+    }
+}
+
+/*
+ * Connection based routing resources
+ */
+void Connection_based_routing_resources::write_checkpoint(std::ostream& os) const {
+    write_checkpoint_value<float>(os, last_stable_critical_path_delay);
+    write_checkpoint_value<float>(os, critical_path_growth_tolerance);
+    write_checkpoint_value<float>(os, connection_criticality_tolerance);
+    write_checkpoint_value<float>(os, connection_delay_optimality_tolerance);
+
+    write_checkpoint_value<uint64_t>(os, lower_bound_connection_delay.size());
+    for (const auto& net_delays : lower_bound_connection_delay) {
+        write_checkpoint_value<uint64_t>(os, net_delays.size());
+        for (float delay : net_delays) {
+            write_checkpoint_value<float>(os, delay);
+        }
+    }
+
+    write_checkpoint_value<uint64_t>(os, forcible_reroute_connection_flag.size());
+    for (const auto& net_flags : forcible_reroute_connection_flag) {
+        write_checkpoint_value<uint64_t>(os, net_flags.size());
+        for (const auto& sink_flag : net_flags) {
+            write_checkpoint_value<int32_t>(os, sink_flag.first);
+            write_checkpoint_value<uint8_t>(os, sink_flag.second);
+        }
+    }
+}
+
+void Connection_based_routing_resources::read_checkpoint(std::istream& is) {
+    auto& device_ctx = g_vpr_ctx.device();
+    auto& cluster_ctx = g_vpr_ctx.clustering();
+
+    last_stable_critical_path_delay = read_checkpoint_value<float>(is);
+    critical_path_growth_tolerance = read_checkpoint_value<float>(is);
+    connection_criticality_tolerance = read_checkpoint_value<float>(is);
+    connection_delay_optimality_tolerance = read_checkpoint_value<float>(is);
+
+    lower_bound_connection_delay.resize(read_checkpoint_count(is, cluster_ctx.clb_nlist.nets().size()));
+    for (auto net_id : lower_bound_connection_delay.keys()) {
+        if (!is) return;
+        auto& net_delays = lower_bound_connection_delay[net_id];
+        net_delays.resize(read_checkpoint_count(is, cluster_ctx.clb_nlist.net_pins(net_id).size()));
+        for (float& delay : net_delays) {
+            delay = read_checkpoint_value<float>(is);
+        }
+    }
+
+    forcible_reroute_connection_flag.resize(read_checkpoint_count(is, cluster_ctx.clb_nlist.nets().size()));
+    for (auto net_id : forcible_reroute_connection_flag.keys()) {
+        if (!is) return;
+        auto& net_flags = forcible_reroute_connection_flag[net_id];
+        net_flags.clear();
+        size_t num_flags = read_checkpoint_count(is, cluster_ctx.clb_nlist.net_pins(net_id).size());
+        for (size_t i = 0; i < num_flags && is; ++i) {
+            int sink_rr = read_checkpoint_value<int32_t>(is);
+            bool flag = read_checkpoint_value<uint8_t>(is);
+            if (sink_rr < 0 || size_t(sink_rr) >= device_ctx.rr_nodes.size()) {
+                is.setstate(std::ios::failbit);
+                return;
+            }
+            net_flags[sink_rr] = flag;
+        }
+    }
+}
@@ -0,0 +1,98 @@
+#ifndef VPR_ROUTE_CHECKPOINT_H
+#define VPR_ROUTE_CHECKPOINT_H
+/* Binary checkpoints of the timing-driven router's negotiated congestion state.
+ *
+ * try_timing_driven_route() writes one every --router_checkpoint_interval iterations
+ * (to --router_checkpoint_file), and can resume from one with --router_resume_checkpoint,
+ * so a pre-empted routing run loses at most the iterations since the last checkpoint.
+ *
+ * Besides the loop state below, a checkpoint holds the routing context the router
+ * negotiates with: the nets' tracebacks and bounding boxes, the locally used CLB
+ * OPINs and every rr node's acc_cost (occupancies and pres_cost are rebuilt from
+ * the tracebacks on resume). A checkpoint can only be resumed with the same netlist,
+ * placement and rr graph (i.e. channel width) it was written with; this is checked
+ * when it is read. */
+
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <type_traits>
+
+#include "vtr_vector.h"
+
+#include "vpr_types.h"
+#include "route_traceback.h"
+#include "connection_based_routing.h"
+#include "routing_predictor.h"
+
+struct t_routing_checkpoint {
+    int itry = 0; //Last completed routing iteration
+    float pres_fac = 0.; //Present congestion factor for the next iteration
+    int bb_fac = 0;
+    int itry_conflicted_mode = 0;
+    bool conflicted_mode = false; //Whether the router had switched to RouterCongestionMode::CONFLICTED
+    int legal_convergence_count = 0;
+    int itry_since_last_convergence = -1;
+
+    //Best legal routing found so far (if any)
+    bool routing_is_successful = false;
+    vtr::vector<ClusterNetId,t_traceback> best_routing;
+    t_clb_opins_used best_clb_opins_used_locally;
+    size_t best_used_wirelength = 0;
+    float best_sWNS = 0.;
+    float best_sTNS = 0.;
+    float best_hWNS = 0.;
+    float best_hTNS = 0.;
+    float best_critical_path_delay = 0.;
+    float best_critical_path_slack = 0.;
+};
+
+//Writes the checkpoint along with the current routing context. The file is written
+//under a temporary name and renamed, so an interrupted write never leaves a partial
+//checkpoint behind
+void write_routing_checkpoint(const std::string& filename,
+                              const t_routing_checkpoint& checkpoint,
+                              const CBRR& connections_inf,
+                              const RoutingPredictor& routing_predictor);
+
+//Loads a checkpoint, replacing the current routing with the checkpointed one and
+//restoring the rr node costs.
+//
+//Returns false (leaving everything untouched) if the checkpoint was written for a
+//different implementation, e.g. another channel width of a binary search.
+//Unreadable or corrupt checkpoints are errors.
+bool read_routing_checkpoint(const std::string& filename,
+                             t_routing_checkpoint& checkpoint,
+                             CBRR& connections_inf,
+                             RoutingPredictor& routing_predictor);
+
+/*
+ * Raw binary I/O helpers (host byte order: checkpoints are not meant to be portable)
+ */
+template<typename T>
+void write_checkpoint_value(std::ostream& os, const T& value) {
+    static_assert(std::is_trivially_copyable<T>::value, "Only plain values can be written directly");
+    os.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+//Returns a value-initialized T if the read comes up short (the stream is then failed)
+template<typename T>
+T read_checkpoint_value(std::istream& is) {
+    static_assert(std::is_trivially_copyable<T>::value, "Only plain values can be read directly");
+    T value{};
+    is.read(reinterpret_cast<char*>(&value), sizeof(T));
+    return value;
+}
+
+//Reads an element count, which must be at most max_count. A short read or an out-of-range
+//count fails the stream and returns zero, so corrupt counts are never used to size containers
+inline size_t read_checkpoint_count(std::istream& is, size_t max_count) {
+    uint64_t count = read_checkpoint_value<uint64_t>(is);
+    if (!is || count > max_count) {
+        is.setstate(std::ios::failbit);
+        return 0;
+    }
+    return count;
+}
+
+#endif
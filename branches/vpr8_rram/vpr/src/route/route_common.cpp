@@ -3,6 +3,7 @@
 #include <cmath>
 #include <algorithm>
 #include <vector>
+#include <deque>
 #include <iostream>
 using namespace std;
 
@@ -49,14 +50,19 @@ struct t_trace_branch {
 
 /**************** Static variables local to route_common.c ******************/
 
-static t_heap **heap; /* Indexed from [1..heap_size] */
-static int heap_size; /* Number of slots in the heap array */
-static int heap_tail; /* Index of first unused slot in the heap array */
+/* The heap is an implicit d-ary min-heap, indexed from [0..heap.size()-1]. *
+ * Each slot keeps a copy of its entry's cost, so sifting only touches the   *
+ * (contiguous) slot array and never the entries themselves.                 */
+struct t_heap_slot {
+    float cost;
+    t_heap* hptr;
+};
+static std::vector<t_heap_slot> heap;
 
-/* For managing my own list of currently free heap data structures.     */
+/* Arena holding all heap entries ever allocated (std::deque never moves    *
+ * its elements), and the list of entries currently free for re-use.        */
+static std::deque<t_heap> heap_arena;
 static t_heap *heap_free_head = nullptr;
-/* For keeping track of the sudo malloc memory for the heap*/
-static vtr::t_chunk heap_ch;
 
 /* For managing my own list of currently free trace data structures.    */
 static t_trace *trace_free_head = nullptr;
@@ -174,6 +180,7 @@ void restore_routing(vtr::vector<ClusterNetId, t_trace *> &best_routing,
 		/* Set the current routing to the saved one. */
 		route_ctx.trace[net_id].head = best_routing[net_id];
 		best_routing[net_id] = nullptr; /* No stored routing. */
+		route_ctx.net_status[net_id].is_checked = false;
 	}
 
 	/* Restore which OPINs are locally used.                           */
@@ -344,7 +351,7 @@ bool try_route(int width_fac,
             first_iteration_priority
             );
 
-		profiling::time_on_fanout_analysis();
+		if (router_opts.fanout_analysis) profiling::time_on_fanout_analysis();
 
 	}
 
@@ -495,14 +502,8 @@ void pathfinder_update_cost(float pres_fac, float acc_fac) {
 }
 
 void init_heap(const DeviceGrid& grid) {
-    if (heap != nullptr) {
-        vtr::free(heap + 1);
-        heap = nullptr;
-    }
-	heap_size = (grid.width() -1 ) * (grid.height() - 1);
-	heap = (t_heap **) vtr::malloc(heap_size * sizeof(t_heap *));
-	heap--; /* heap stores from [1..heap_size] */
-	heap_tail = 1;
+    heap.clear();
+	heap.reserve((grid.width() - 1) * (grid.height() - 1));
 }
 
 /* Call this before you route any nets.  It frees any old traceback and   *
@@ -532,7 +533,7 @@ void init_route_structs(int bb_factor) {
 	/* Check that things that should have been emptied after the last routing *
 	 * really were.                                                           */
 
-	if (heap_tail != 1) {
+	if (!heap.empty()) {
 		vpr_throw(VPR_ERROR_ROUTE, __FILE__, __LINE__,
 			"in init_route_structs. Heap is not empty.\n");
 	}
@@ -573,6 +574,7 @@ update_traceback(t_heap *hptr, ClusterNetId net_id) {
 	}
 
 	route_ctx.trace[net_id].tail = branch.tail;
+	route_ctx.net_status[net_id].is_checked = false;
 	return (ret_ptr);
 }
 
@@ -621,8 +623,8 @@ static t_trace_branch traceback_branch(int node, const std::vector<t_heap_prev>&
             trace_nodes.insert(inode); //Record this node as visited
             new_nodes_added_to_traceback.push_back(inode);
 
-            iedge = route_ctx.rr_node_route_inf[inode].prev_edge;
-            inode = route_ctx.rr_node_route_inf[inode].prev_node;
+            iedge = route_ctx.rr_node_route_inf[inode].prev_edge();
+            inode = route_ctx.rr_node_route_inf[inode].prev_node();
         }
     }
 
@@ -736,18 +738,17 @@ static std::pair<t_trace*,t_trace*> add_trace_non_configurable_recurr(int node,
     return {head, tail};
 }
 
-/* The routine sets the path_cost to HUGE_POSITIVE_FLOAT for  *
-* all channel segments touched by previous routing phases.    */
-void reset_path_costs(const std::vector<int>& visited_rr_nodes) {
-    auto& route_ctx = g_vpr_ctx.mutable_routing();
-
-    for (auto node : visited_rr_nodes) {
-        route_ctx.rr_node_route_inf[node].path_cost = std::numeric_limits<float>::infinity();
-        route_ctx.rr_node_route_inf[node].backward_path_cost = std::numeric_limits<float>::infinity();
-        route_ctx.rr_node_route_inf[node].prev_node = NO_PREVIOUS;;
-        route_ctx.rr_node_route_inf[node].prev_edge = NO_PREVIOUS;;
+/* The routine resets the path costs (and previous nodes) of all rr_nodes    *
+* touched by previous routing phases.  This only starts a new search epoch, *
+* so it takes constant time no matter how many nodes were touched.          */
+void reset_path_costs() {
+    if (!t_rr_node_route_inf::advance_search_epoch()) {
+        //Epoch counter wrapped around, which requires a full reset
+        auto& route_ctx = g_vpr_ctx.mutable_routing();
+        for (auto& node_inf : route_ctx.rr_node_route_inf) {
+            node_inf.reset_search_state();
+        }
     }
-
 }
 
 /* Returns the *congestion* cost of using this rr_node. */
@@ -802,7 +803,7 @@ void node_to_heap(int inode, float total_cost, int prev_node, int prev_edge,
 
     auto& route_ctx = g_vpr_ctx.routing();
 
-	if (total_cost >= route_ctx.rr_node_route_inf[inode].path_cost)
+	if (total_cost >= route_ctx.rr_node_route_inf[inode].path_cost())
 		return;
 
 	t_heap* hptr = alloc_heap_data();
@@ -835,6 +836,7 @@ void free_traceback(ClusterNetId net_id) {
 	route_ctx.trace[net_id].head = nullptr;
 	route_ctx.trace[net_id].tail = nullptr;
 	route_ctx.trace_nodes[net_id].clear();
+	route_ctx.net_status[net_id].is_checked = false;
 }
 
 void free_traceback(t_trace* tptr) {
@@ -949,36 +951,17 @@ void free_route_structs() {
 	 * final routing result is not freed.                                */
     auto& route_ctx = g_vpr_ctx.mutable_routing();
 
-	if(heap != nullptr) {
-        //Free the individiaul heap elements (calls destructors)
-        for (int i = 1; i < num_heap_allocated; i++) {
-            VTR_LOG("Freeing %p\n", heap[i]);
-            vtr::chunk_delete(heap[i], &heap_ch);
-        }
-
-        // coverity[offset_free : Intentional]
-		free(heap + 1);
-
-        heap = nullptr; /* Defensive coding:  crash hard if I use these. */
-	}
-
-    if (heap_free_head != nullptr) {
-        t_heap* curr = heap_free_head;
-        while(curr) {
-            t_heap* tmp = curr;
-            curr = curr->next;
+	//Free the heap and all heap entries (calls destructors)
+	heap.clear();
+	heap.shrink_to_fit();
+	heap_arena.clear();
+	heap_arena.shrink_to_fit();
+	heap_free_head = nullptr;
+	num_heap_allocated = 0;
 
-            vtr::chunk_delete(tmp, &heap_ch);
-        }
-
-        heap_free_head = nullptr;
-    }
 	if(route_ctx.route_bb.size() != 0) {
 		route_ctx.route_bb.clear();
 	}
-
-	/*free the memory chunks that were used by heap and linked f pointer */
-	free_chunk_memory(&heap_ch);
 }
 
 /* Frees the data structures needed to save a routing.                     */
@@ -1015,12 +998,9 @@ void reset_rr_node_route_structs() {
 	VTR_ASSERT(route_ctx.rr_node_route_inf.size() == size_t(device_ctx.rr_nodes.size()));
 
 	for (size_t inode = 0; inode < device_ctx.rr_nodes.size(); inode++) {
-		route_ctx.rr_node_route_inf[inode].prev_node = NO_PREVIOUS;
-		route_ctx.rr_node_route_inf[inode].prev_edge = NO_PREVIOUS;
+		route_ctx.rr_node_route_inf[inode].reset_search_state();
 		route_ctx.rr_node_route_inf[inode].pres_cost = 1.0;
 		route_ctx.rr_node_route_inf[inode].acc_cost = 1.0;
-		route_ctx.rr_node_route_inf[inode].path_cost = std::numeric_limits<float>::infinity();
-		route_ctx.rr_node_route_inf[inode].backward_path_cost = std::numeric_limits<float>::infinity();
 		route_ctx.rr_node_route_inf[inode].target_flag = 0;
 		route_ctx.rr_node_route_inf[inode].set_occ(0);
 	}
@@ -1197,38 +1177,34 @@ t_bb load_net_route_bb(ClusterNetId net_id, int bb_factor) {
     return bb;
 }
 
-void add_to_mod_list(int inode, std::vector<int>& modified_rr_node_inf) {
-    auto& route_ctx = g_vpr_ctx.routing();
-
-    if (std::isinf(route_ctx.rr_node_route_inf[inode].path_cost)) {
-        modified_rr_node_inf.push_back(inode);
-    }
-}
-
 namespace heap_ {
+	constexpr size_t ARITY = 4; // children per heap node
+
 	size_t parent(size_t i);
-	size_t left(size_t i);
-	size_t right(size_t i);
+	size_t first_child(size_t i);
 	size_t size();
-	void expand_heap_if_full();
 
-	size_t parent(size_t i) {return i >> 1;}
-	// child indices of a heap
-	size_t left(size_t i) {return i << 1;}
-	size_t right(size_t i) {return (i << 1) + 1;}
-	size_t size() {return static_cast<size_t>(heap_tail - 1);}	// heap[0] is not valid element
+	size_t parent(size_t i) {return (i - 1) / ARITY;}
+	size_t first_child(size_t i) {return ARITY * i + 1;}
+	size_t size() {return heap.size();}
 
-	// make a heap rooted at index i by **sifting down** in O(lgn) time
+	// make a heap rooted at index i by **sifting down** in O(d log_d n) time
 	void sift_down(size_t hole) {
-		t_heap* head {heap[hole]};
-		size_t child {left(hole)};
-		while ((int)child < heap_tail) {
-			if ((int)child + 1 < heap_tail && heap[child + 1]->cost < heap[child]->cost)
-				++child;
-			if (heap[child]->cost < head->cost) {
-				heap[hole] = heap[child];
-				hole = child;
-				child = left(child);
+		t_heap_slot head {heap[hole]};
+		size_t num_slots = heap.size();
+		size_t child = first_child(hole);
+		while (child < num_slots) {
+			// find the cheapest child
+			size_t last_child = std::min(child + ARITY, num_slots);
+			size_t cheapest_child = child;
+			for (size_t sibling = child + 1; sibling < last_child; ++sibling) {
+				if (heap[sibling].cost < heap[cheapest_child].cost)
+					cheapest_child = sibling;
+			}
+			if (heap[cheapest_child].cost < head.cost) {
+				heap[hole] = heap[cheapest_child];
+				hole = cheapest_child;
+				child = first_child(hole);
 			}
 			else break;
 		}
@@ -1236,40 +1212,28 @@ namespace heap_ {
 	}
 
 
-	// runs in O(n) time by sifting down; the least work is done on the most elements: 1 swap for bottom layer, 2 swap for 2nd, ... lgn swap for top
-	// 1*(n/2) + 2*(n/4) + 3*(n/8) + ... + lgn*1 = 2n (sum of i/2^i)
+	// runs in O(n) time by sifting down; the least work is done on the most elements
 	void build_heap() {
-		// second half of heap are leaves
-		for (size_t i = heap_tail >> 1; i != 0; --i)
-			sift_down(i);
+		if (heap.size() < 2) return;
+		// slots after the parent of the last slot are leaves
+		for (size_t i = parent(heap.size() - 1) + 1; i != 0; --i)
+			sift_down(i - 1);
 	}
 
 
-	// O(lgn) sifting up to maintain heap property after insertion (should sift down when building heap)
+	// O(log_d n) sifting up to maintain heap property after insertion (should sift down when building heap)
 	void sift_up(size_t leaf, t_heap* const node) {
-		while ((leaf > 1) && (node->cost < heap[parent(leaf)]->cost)) {
+		while ((leaf > 0) && (node->cost < heap[parent(leaf)].cost)) {
 			// sift hole up
 			heap[leaf] = heap[parent(leaf)];
 			leaf = parent(leaf);
 		}
-		heap[leaf] = node;
-	}
-
-
-	void expand_heap_if_full() {
-		if (heap_tail > heap_size) { /* Heap is full */
-			heap_size *= 2;
-			heap = (t_heap **) vtr::realloc((void *) (heap + 1),
-					heap_size * sizeof(t_heap *));
-			heap--; /* heap goes from [1..heap_size] */
-		}
+		heap[leaf] = {node->cost, node};
 	}
 
 	// adds an element to the back of heap and expand if necessary, but does not maintain heap property
 	void push_back(t_heap* const hptr) {
-		expand_heap_if_full();
-		heap[heap_tail] = hptr;
-		++heap_tail;
+		heap.push_back({hptr->cost, hptr});
 	}
 
 
@@ -1281,7 +1245,7 @@ namespace heap_ {
 		   bottom up with build_heap    */
 
         auto& route_ctx = g_vpr_ctx.routing();
-		if (total_cost >= route_ctx.rr_node_route_inf[inode].path_cost)
+		if (total_cost >= route_ctx.rr_node_route_inf[inode].path_cost())
 			return;
 
 		t_heap* hptr = alloc_heap_data();
@@ -1294,9 +1258,9 @@ namespace heap_ {
 	}
 
 	bool is_valid() {
-		for (size_t i = 1; (int)i <= heap_tail >> 1; ++i) {
-			if ((int)left(i) < heap_tail && heap[left(i)]->cost < heap[i]->cost) return false;
-			if ((int)right(i) < heap_tail && heap[right(i)]->cost < heap[i]->cost) return false;
+		for (size_t i = 0; i < heap.size(); ++i) {
+			if (heap[i].cost != heap[i].hptr->cost) return false;
+			if (i > 0 && heap[i].cost < heap[parent(i)].cost) return false;
 		}
 		return true;
 	}
@@ -1307,14 +1271,15 @@ namespace heap_ {
 	}
 	// print every element; not necessarily in order for minheap
 	void print_heap() {
-		for (int i = 1; i < heap_tail >> 1; ++i) VTR_LOG("(%e %e %e) ", heap[i]->cost, heap[left(i)]->cost, heap[right(i)]->cost);
+		for (size_t i = 0; i < heap.size(); ++i) VTR_LOG("%e ", heap[i].cost);
 		VTR_LOG("\n");
 	}
 	// verify correctness of extract top by making a copy, sorting it, and iterating it at the same time as extraction
 	void verify_extract_top() {
 		constexpr float float_epsilon = 1e-20;
 		std::cout << "copying heap\n";
-		std::vector<t_heap*> heap_copy {heap + 1, heap + heap_tail};
+		std::vector<t_heap*> heap_copy;
+		for (const t_heap_slot& slot : heap) heap_copy.push_back(slot.hptr);
 		// sort based on cost with cheapest first
 		VTR_ASSERT(heap_copy.size() == size());
 		std::sort(begin(heap_copy), end(heap_copy),
@@ -1336,15 +1301,14 @@ namespace heap_ {
 }
 // adds to heap and maintains heap quality
 void add_to_heap(t_heap *hptr) {
-	heap_::expand_heap_if_full();
 	// start with undefined hole
-	++heap_tail;
-	heap_::sift_up(heap_tail - 1, hptr);
+	heap.emplace_back();
+	heap_::sift_up(heap.size() - 1, hptr);
 }
 
 /*WMF: peeking accessor :) */
 bool is_empty_heap() {
-	return (bool)(heap_tail == 1);
+	return heap.empty();
 }
 
 t_heap *
@@ -1355,27 +1319,21 @@ get_heap_head() {
 	 * returned -- they are just skipped over.                                   */
 
 	t_heap *cheapest;
-	size_t hole, child;
 
 	do {
-		if (heap_tail == 1) { /* Empty heap. */
+		if (heap.empty()) { /* Empty heap. */
 			VTR_LOG_WARN("Empty heap occurred in get_heap_head.\n");
 			return (nullptr);
 		}
 
-		cheapest = heap[1];
-
-		hole = 1;
-		child = 2;
-		--heap_tail;
-		while ((int)child < heap_tail) {
-			if (heap[child + 1]->cost < heap[child]->cost)
-				++child;	// become right child
-			heap[hole] = heap[child];
-			hole = child;
-			child = heap_::left(child);
+		cheapest = heap.front().hptr;
+
+		// move the last slot to the root and sift it down into place
+		heap.front() = heap.back();
+		heap.pop_back();
+		if (!heap.empty()) {
+			heap_::sift_down(0);
 		}
-		heap_::sift_up(hole, heap[heap_tail]);
 
 	} while (cheapest->index == OPEN); /* Get another one if invalid entry. */
 
@@ -1384,17 +1342,18 @@ get_heap_head() {
 
 void empty_heap() {
 
-	for (int i = 1; i < heap_tail; i++)
-		free_heap_data(heap[i]);
+	for (const t_heap_slot& slot : heap)
+		free_heap_data(slot.hptr);
 
-	heap_tail = 1;
+	heap.clear();
 }
 
 t_heap *
 alloc_heap_data() {
 
 	if (heap_free_head == nullptr) { /* No elements on the free list */
-		heap_free_head = vtr::chunk_new<t_heap>(&heap_ch);
+		heap_arena.emplace_back();
+		heap_free_head = &heap_arena.back();
 	}
 
     //Extract the head
@@ -1425,11 +1384,11 @@ void invalidate_heap_entries(int sink_node, int ipin_node) {
 	 * via ipin_node, as invalid (OPEN).  Used only by the breadth_first router *
 	 * and even then only in rare circumstances.                                */
 
-	for (int i = 1; i < heap_tail; i++) {
-		if (heap[i]->index == sink_node) {
-            for (t_heap_prev prev : heap[i]->previous) {
+	for (const t_heap_slot& slot : heap) {
+		if (slot.hptr->index == sink_node) {
+            for (t_heap_prev prev : slot.hptr->previous) {
                 if (prev.from_node == ipin_node) {
-                    heap[i]->index = OPEN; /* Invalid. */
+                    slot.hptr->index = OPEN; /* Invalid. */
                     break;
                 }
             }
@@ -1865,9 +1824,9 @@ void print_rr_node_route_inf() {
     auto& route_ctx = g_vpr_ctx.routing();
     auto& device_ctx = g_vpr_ctx.device();
     for (size_t inode = 0; inode < route_ctx.rr_node_route_inf.size(); ++inode) {
-        if (!std::isinf(route_ctx.rr_node_route_inf[inode].path_cost)) {
-            int prev_node = route_ctx.rr_node_route_inf[inode].prev_node;
-            int prev_edge = route_ctx.rr_node_route_inf[inode].prev_edge;
+        if (!std::isinf(route_ctx.rr_node_route_inf[inode].path_cost())) {
+            int prev_node = route_ctx.rr_node_route_inf[inode].prev_node();
+            int prev_edge = route_ctx.rr_node_route_inf[inode].prev_edge();
             VTR_LOG("rr_node: %d prev_node: %d prev_edge: %d",
                     inode, prev_node, prev_edge);
 
@@ -1877,7 +1836,7 @@ void print_rr_node_route_inf() {
             }
 
             VTR_LOG(" pcost: %g back_pcost: %g\n",
-                    route_ctx.rr_node_route_inf[inode].path_cost, route_ctx.rr_node_route_inf[inode].backward_path_cost);
+                    route_ctx.rr_node_route_inf[inode].path_cost(), route_ctx.rr_node_route_inf[inode].backward_path_cost());
         }
     }
 }
@@ -1889,7 +1848,7 @@ void print_rr_node_route_inf_dot() {
     VTR_LOG("digraph G {\n");
     VTR_LOG("\tnode[shape=record]\n");
     for (size_t inode = 0; inode < route_ctx.rr_node_route_inf.size(); ++inode) {
-        if (!std::isinf(route_ctx.rr_node_route_inf[inode].path_cost)) {
+        if (!std::isinf(route_ctx.rr_node_route_inf[inode].path_cost())) {
 
             VTR_LOG("\tnode%zu[label=\"{%zu (%s)", inode, inode, device_ctx.rr_nodes[inode].type_string());
             if (route_ctx.rr_node_route_inf[inode].occ() > device_ctx.rr_nodes[inode].capacity()) {
@@ -1899,10 +1858,10 @@ void print_rr_node_route_inf_dot() {
         }
     }
     for (size_t inode = 0; inode < route_ctx.rr_node_route_inf.size(); ++inode) {
-        if (!std::isinf(route_ctx.rr_node_route_inf[inode].path_cost)) {
+        if (!std::isinf(route_ctx.rr_node_route_inf[inode].path_cost())) {
 
-            int prev_node = route_ctx.rr_node_route_inf[inode].prev_node;
-            int prev_edge = route_ctx.rr_node_route_inf[inode].prev_edge;
+            int prev_node = route_ctx.rr_node_route_inf[inode].prev_node();
+            int prev_edge = route_ctx.rr_node_route_inf[inode].prev_edge();
 
             if (prev_node != OPEN && prev_edge != OPEN) {
                 VTR_LOG("\tnode%d -> node%zu [", prev_node, inode);
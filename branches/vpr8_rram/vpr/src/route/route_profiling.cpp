@@ -1,37 +1,26 @@
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <fstream>
 #include <vector>
+
+#include "vtr_log.h"
+#include "vtr_util.h"
+
 #include "globals.h"
 #include "vpr_types.h"
 #include "route_profiling.h"
+#include "vpr_error.h"
 
 namespace profiling {
 
-#ifndef PROFILE
-void net_rerouted() {}
-void route_tree_pruned() {}
-void route_tree_preserved() {}
-void mark_for_forced_reroute() {}
-void perform_forced_reroute() {}
-
-// timing functions where *_start starts a clock and *_end terminates the clock
-void sink_criticality_start() {}
-void sink_criticality_end(float /*target_criticality*/) {}
-
-void net_rebuild_start() {}
-void net_rebuild_end(unsigned /*net_fanout*/, unsigned /*sinks_left_to_route*/) {}
-
-void net_fanout_start() {}
-void net_fanout_end(unsigned /*net_fanout*/) {}
-
-
-// analysis functions for printing out the profiling data for an iteration
-void congestion_analysis() {}
-void time_on_criticality_analysis() {}
-void time_on_fanout_analysis() {}
+using namespace std;
 
-void profiling_initialization(unsigned /*max_net_fanout*/) {}
+typedef std::chrono::steady_clock profiling_clock;
 
-#else
-using namespace std;
+static float seconds_since(profiling_clock::time_point start) {
+	return std::chrono::duration<float>(profiling_clock::now() - start).count();
+}
 
 constexpr unsigned int fanout_per_bin = 1;
 constexpr float criticality_per_bin = 0.05;
@@ -45,54 +34,107 @@ static vector<int> itry_on_criticality;
 static vector<int> rerouted_sinks;
 static vector<int> finished_sinks;
 
+// per-iteration telemetry, with net fanouts grouped in powers of two: bucket b holds
+// fanouts [2^b, 2^(b+1)-1], the last bucket also holds everything larger
+constexpr size_t num_fanout_buckets = 10;
+
+static size_t fanout_bucket(unsigned net_fanout) {
+	size_t bucket = 0;
+	while (net_fanout > 1 && bucket < num_fanout_buckets - 1) {
+		net_fanout >>= 1;
+		++bucket;
+	}
+	return bucket;
+}
+
+struct t_iteration_counters {
+	size_t nets_fully_rerouted = 0;
+	size_t trees_pruned = 0;
+	size_t trees_preserved = 0;
+	size_t forced_reroutes_marked = 0;
+	size_t forced_reroutes_performed = 0;
+
+	size_t connections = 0;
+	size_t nodes_expanded = 0;
+	size_t max_nodes_expanded = 0; // by a single connection
+
+	std::array<float,num_fanout_buckets> time_on_fanout_bucket {};
+	std::array<size_t,num_fanout_buckets> nets_in_fanout_bucket {};
+};
+
+struct t_iteration_record {
+	int attempt;
+	t_router_iteration_telemetry router;
+	t_iteration_counters counters;
+};
+
+static int routing_attempt = 0;
+static t_iteration_counters iteration_counters;
+static vector<t_iteration_record> telemetry; // iterations of the current routing attempt
+
+// the telemetry file accumulates the iterations of every attempt, and is appended to as they are recorded
+static std::string telemetry_file; // empty until the file has been created
+static size_t telemetry_file_records = 0; // records in the telemetry file
+static size_t telemetry_records_written = 0; // records of telemetry already in the telemetry file
+
 // action counters for what setup routing resources did
 static int entire_net_rerouted;
-void net_rerouted() {++entire_net_rerouted;}
+void net_rerouted() {++entire_net_rerouted; ++iteration_counters.nets_fully_rerouted;}
 
 static int entire_tree_pruned;
-void route_tree_pruned() {++entire_tree_pruned;}
+void route_tree_pruned() {++entire_tree_pruned; ++iteration_counters.trees_pruned;}
 
 static int part_tree_preserved;
-void route_tree_preserved() {++part_tree_preserved;}
+void route_tree_preserved() {++part_tree_preserved; ++iteration_counters.trees_preserved;}
 
 static int connections_forced_to_reroute;
-void mark_for_forced_reroute() {++connections_forced_to_reroute;}
+void mark_for_forced_reroute() {++connections_forced_to_reroute; ++iteration_counters.forced_reroutes_marked;}
 static int connections_rerouted_due_to_forcing;
-void perform_forced_reroute() {++connections_rerouted_due_to_forcing;}
+void perform_forced_reroute() {++connections_rerouted_due_to_forcing; ++iteration_counters.forced_reroutes_performed;}
+
+void connection_routed(size_t nodes_expanded) {
+	++iteration_counters.connections;
+	iteration_counters.nodes_expanded += nodes_expanded;
+	iteration_counters.max_nodes_expanded = std::max(iteration_counters.max_nodes_expanded, nodes_expanded);
+}
 
 // timing functions where *_start starts a clock and *_end terminates the clock
-static clock_t sink_criticality_clock;
-void sink_criticality_start() {sink_criticality_clock = clock();}
+static profiling_clock::time_point sink_criticality_clock;
+void sink_criticality_start() {sink_criticality_clock = profiling_clock::now();}
 
 void sink_criticality_end(float target_criticality) {
 	if (!time_on_criticality.empty()) {
-		time_on_criticality[target_criticality / criticality_per_bin] += static_cast<float>(clock() - sink_criticality_clock) / CLOCKS_PER_SEC;
+		time_on_criticality[target_criticality / criticality_per_bin] += seconds_since(sink_criticality_clock);
 		++itry_on_criticality[target_criticality / criticality_per_bin];
 	}
 }
 
-static clock_t net_rebuild_clock;
-void net_rebuild_start() {net_rebuild_clock = clock();}
+static profiling_clock::time_point net_rebuild_clock;
+void net_rebuild_start() {net_rebuild_clock = profiling_clock::now();}
 
 void net_rebuild_end(unsigned net_fanout, unsigned sinks_left_to_route) {
 	unsigned int bin {net_fanout / fanout_per_bin};
 	unsigned int sinks_already_routed = net_fanout - sinks_left_to_route;
-	float rebuild_time {static_cast<float>(clock() - net_rebuild_clock) / CLOCKS_PER_SEC};
+	float rebuild_time {seconds_since(net_rebuild_clock)};
 
 	finished_sinks[bin] += sinks_already_routed;
 	rerouted_sinks[bin] += sinks_left_to_route;
 	time_on_fanout_rebuild[bin] += rebuild_time;
 }
 
-static clock_t net_fanout_clock;
+static profiling_clock::time_point net_fanout_clock;
 void net_fanout_start() {
-	net_fanout_clock = clock();
+	net_fanout_clock = profiling_clock::now();
 }
 
 void net_fanout_end(unsigned net_fanout) {
-	float time_for_net = static_cast<float>(clock() - net_fanout_clock) / CLOCKS_PER_SEC;
+	float time_for_net = seconds_since(net_fanout_clock);
 	time_on_fanout[net_fanout / fanout_per_bin] += time_for_net;
 	itry_on_fanout[net_fanout / fanout_per_bin] += 1;
+
+	size_t bucket = fanout_bucket(net_fanout);
+	iteration_counters.time_on_fanout_bucket[bucket] += time_for_net;
+	++iteration_counters.nets_in_fanout_bucket[bucket];
 }
 
 void time_on_fanout_analysis() {
@@ -185,20 +227,168 @@ void congestion_analysis() {
 
 void profiling_initialization(unsigned max_fanout) {
 	// add 1 so that indexing on the max fanout would still be valid
-	time_on_fanout.resize((max_fanout / fanout_per_bin) + 1, 0);
-	itry_on_fanout.resize((max_fanout / fanout_per_bin) + 1, 0);
-	time_on_fanout_rebuild.resize((max_fanout / fanout_per_bin) + 1, 0);
-	rerouted_sinks.resize((max_fanout / fanout_per_bin) + 1, 0);
-	finished_sinks.resize((max_fanout / fanout_per_bin) + 1, 0);
-	time_on_criticality.resize((1 / criticality_per_bin) + 1, 0);
-	itry_on_criticality.resize((1 / criticality_per_bin) + 1, 0);
+	time_on_fanout.assign((max_fanout / fanout_per_bin) + 1, 0);
+	itry_on_fanout.assign((max_fanout / fanout_per_bin) + 1, 0);
+	time_on_fanout_rebuild.assign((max_fanout / fanout_per_bin) + 1, 0);
+	rerouted_sinks.assign((max_fanout / fanout_per_bin) + 1, 0);
+	finished_sinks.assign((max_fanout / fanout_per_bin) + 1, 0);
+	time_on_criticality.assign((1 / criticality_per_bin) + 1, 0);
+	itry_on_criticality.assign((1 / criticality_per_bin) + 1, 0);
 	entire_net_rerouted = 0;
 	entire_tree_pruned = 0;
 	part_tree_preserved = 0;
 	connections_forced_to_reroute = 0;
 	connections_rerouted_due_to_forcing = 0;
+
+	// each attempt starts a new set of telemetry samples (already written ones stay in the telemetry file)
+	++routing_attempt;
+	iteration_counters = t_iteration_counters();
+	telemetry.clear();
+	telemetry_records_written = 0;
 	return;
 }
-#endif
+
+/*
+ * Per-iteration telemetry
+ */
+void record_iteration(const t_router_iteration_telemetry& iteration) {
+	telemetry.push_back({routing_attempt, iteration, iteration_counters});
+
+	iteration_counters = t_iteration_counters();
+}
+
+static std::string fanout_bucket_name(size_t bucket) {
+	size_t low = size_t(1) << bucket;
+	if (bucket == num_fanout_buckets - 1) {
+		return vtr::string_fmt("%zu_up", low);
+	}
+	return vtr::string_fmt("%zu_%zu", low, 2 * low - 1);
+}
+
+//Column names and values of a record, in output order
+static std::vector<std::pair<std::string,double>> telemetry_fields(const t_iteration_record& record) {
+	const t_router_iteration_telemetry& router = record.router;
+	const t_iteration_counters& counters = record.counters;
+
+	float avg_nodes_expanded = 0.;
+	if (counters.connections > 0) {
+		avg_nodes_expanded = float(counters.nodes_expanded) / counters.connections;
+	}
+
+	std::vector<std::pair<std::string,double>> fields = {
+		{"attempt", record.attempt},
+		{"channel_width", router.channel_width},
+		{"iteration", router.iteration},
+		{"time_sec", router.elapsed_sec},
+		{"pres_fac", router.pres_fac},
+		{"bb_updated", router.num_bb_updated},
+		{"nets_routed", router.nets_routed},
+		{"connections_routed", router.connections_routed},
+		{"heap_pushes", router.heap_pushes},
+		{"heap_pops", router.heap_pops},
+		{"avg_nodes_expanded_per_connection", avg_nodes_expanded},
+		{"max_nodes_expanded_per_connection", counters.max_nodes_expanded},
+		{"nets_fully_rerouted", counters.nets_fully_rerouted},
+		{"route_trees_pruned", counters.trees_pruned},
+		{"route_trees_preserved", counters.trees_preserved},
+		{"forced_reroutes_marked", counters.forced_reroutes_marked},
+		{"forced_reroutes_performed", counters.forced_reroutes_performed},
+		{"overused_nodes", router.overused_nodes},
+		{"total_overuse", router.total_overuse},
+		{"worst_overuse", router.worst_overuse},
+		{"used_wirelength", router.used_wirelength},
+		{"est_success_iteration", router.est_success_iteration},
+		{"critical_path_delay", router.critical_path_delay},
+	};
+
+	for (size_t bucket = 0; bucket < num_fanout_buckets; ++bucket) {
+		fields.emplace_back("nets_fanout_" + fanout_bucket_name(bucket), counters.nets_in_fanout_bucket[bucket]);
+		fields.emplace_back("time_fanout_" + fanout_bucket_name(bucket), counters.time_on_fanout_bucket[bucket]);
+	}
+
+	return fields;
+}
+
+//Counts are written as integers, everything else with 6 significant digits
+static void write_telemetry_value(std::ostream& os, double value) {
+	if (std::isfinite(value) && value == std::floor(value) && std::fabs(value) < 1e15) {
+		os << static_cast<long long>(value);
+	} else {
+		os << value;
+	}
+}
+
+void write_telemetry(const std::string& filename) {
+	// the JSON array is kept closed after every write, by writing new records over its closing text
+	static const std::string json_close = "\n]\n";
+
+	bool json = (filename.size() >= 5 && filename.compare(filename.size() - 5, 5, ".json") == 0);
+	bool new_file = (filename != telemetry_file);
+
+	std::fstream os;
+	if (new_file) {
+		os.open(filename, std::ios::out | std::ios::trunc);
+	} else if (json) {
+		os.open(filename, std::ios::in | std::ios::out);
+		os.seekp(-static_cast<std::streamoff>(json_close.size()), std::ios::end);
+	} else {
+		os.open(filename, std::ios::out | std::ios::app);
+	}
+	if (!os) {
+		vpr_throw(VPR_ERROR_ROUTE, __FILE__, __LINE__,
+				"Failed to open router telemetry file '%s' for writing\n", filename.c_str());
+	}
+
+	if (new_file) {
+		telemetry_file = filename;
+		telemetry_file_records = 0;
+	}
+
+	os.precision(6);
+	if (json) {
+		if (new_file) {
+			os << "[";
+		}
+		for (size_t irecord = telemetry_records_written; irecord < telemetry.size(); ++irecord) {
+			os << (telemetry_file_records > 0 ? ",\n" : "\n") << "  {";
+			bool first = true;
+			for (const auto& field : telemetry_fields(telemetry[irecord])) {
+				os << (first ? "" : ", ") << "\"" << field.first << "\": ";
+				if (std::isfinite(field.second)) {
+					write_telemetry_value(os, field.second);
+				} else {
+					os << "null"; // no nan/inf in JSON
+				}
+				first = false;
+			}
+			os << "}";
+			++telemetry_file_records;
+		}
+		os << json_close;
+	} else {
+		bool first = true;
+		if (new_file) {
+			t_iteration_record header_record = {0, t_router_iteration_telemetry(), t_iteration_counters()};
+			for (const auto& field : telemetry_fields(header_record)) {
+				os << (first ? "" : ",") << field.first;
+				first = false;
+			}
+			os << "\n";
+		}
+
+		for (size_t irecord = telemetry_records_written; irecord < telemetry.size(); ++irecord) {
+			first = true;
+			for (const auto& field : telemetry_fields(telemetry[irecord])) {
+				os << (first ? "" : ",");
+				write_telemetry_value(os, field.second);
+				first = false;
+			}
+			os << "\n";
+			++telemetry_file_records;
+		}
+	}
+
+	telemetry_records_written = telemetry.size();
+}
 
 }	// end namespace profiling
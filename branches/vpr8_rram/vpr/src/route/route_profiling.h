@@ -1,10 +1,15 @@
 #pragma once
-/* optional profiling for developers on the breakdown of time spent and other quantities
+/* profiling of the router's behaviour, for developers tuning the router and router_opts.
    profiling mostly focuses on per-fanout, but also has per-type (SINK, IPIN, ...) and
-   per-criticality */
+   per-criticality.
 
-//Uncomment to enable profiling
-//#define PROFILE
+   The counters are cheap and always collected. Besides the developer analysis printouts,
+   one telemetry record is kept per iteration of the current routing attempt, which can be
+   appended to a CSV or JSON time series with write_telemetry(). The file accumulates the
+   iterations of every routing attempt (e.g. of a channel width binary search). */
+
+#include <cstddef>
+#include <string>
 
 namespace profiling {
 
@@ -15,6 +20,9 @@ void route_tree_preserved();
 void mark_for_forced_reroute();
 void perform_forced_reroute();
 
+// number of nodes expanded (popped off the heap) while routing a single connection
+void connection_routed(size_t nodes_expanded);
+
 // timing functions where *_start starts a clock and *_end terminates the clock
 void sink_criticality_start();
 void sink_criticality_end(float target_criticality);
@@ -31,6 +39,37 @@ void congestion_analysis();
 void time_on_criticality_analysis();
 void time_on_fanout_analysis();
 
+//Starts a new routing attempt (call once per try_*_route)
 void profiling_initialization(unsigned max_net_fanout);
 
+//Router-level state at the end of a routing iteration. The counters gathered
+//above (since the previous record) are attached to it by record_iteration()
+struct t_router_iteration_telemetry {
+    int iteration = 0;
+    int channel_width = 0;
+    float elapsed_sec = 0.; //Time spent in this iteration
+    float pres_fac = 0.;
+    int num_bb_updated = 0;
+
+    size_t nets_routed = 0;
+    size_t connections_routed = 0;
+    size_t heap_pushes = 0;
+    size_t heap_pops = 0;
+
+    size_t overused_nodes = 0;
+    size_t total_overuse = 0;
+    size_t worst_overuse = 0;
+    size_t used_wirelength = 0;
+
+    float est_success_iteration = 0.; //Routing predictor estimate (inf/nan if none yet)
+    float critical_path_delay = 0.; //Seconds, nan if not timing-driven
+};
+
+void record_iteration(const t_router_iteration_telemetry& iteration);
+
+//Appends the iterations recorded since the previous call to filename, as JSON if
+//filename ends in '.json', otherwise as CSV. The file is (re-)created by the first
+//call with a given filename, and is a complete CSV/JSON file after every call
+void write_telemetry(const std::string& filename);
+
 } // end namespace profiling
@@ -27,8 +27,10 @@
 #include "routing_predictor.h"
 #include "VprTimingGraphResolver.h"
 
-// all functions in profiling:: namespace, which are only activated if PROFILE is defined
+// all functions in profiling:: namespace, gathering router telemetry
 #include "route_profiling.h"
+#include "route_checkpoint.h"
+#include "check_route.h"
 
 #include "timing_info.h"
 #include "timing_util.h"
@@ -141,6 +143,10 @@ struct RoutingMetrics {
 //Note only enables debug output if compiled with VTR_ENABLE_DEBUG_LOGGING defined
 bool f_router_debug = false;
 
+//Spatial look-ups of the high fanout nets, kept from one routing iteration to
+//the next so they only need to be updated for what was pruned and re-routed
+static vtr::vector<ClusterNetId,SpatialRouteTreeLookup> f_spatial_rt_lookups;
+
 /******************** Subroutines local to route_timing.c ********************/
 
 static bool timing_driven_route_sink(ClusterNetId net_id, unsigned itarget, int target_pin,
@@ -157,20 +163,17 @@ static t_heap* timing_driven_route_connection_from_route_tree_high_fanout(t_rt_n
         t_bb bounding_box,
         const RouterLookahead& router_lookahead,
         const SpatialRouteTreeLookup& spatial_rt_lookup,
-        std::vector<int>& modified_rr_node_inf,
         RouterStats& router_stats);
     
 static t_heap* timing_driven_route_connection_from_heap(int sink_node,
         const t_conn_cost_params cost_params,
         t_bb bounding_box,
         const RouterLookahead& router_lookahead,
-        std::vector<int>& modified_rr_node_inf,
         RouterStats& router_stats);
     
 static std::vector<t_heap> timing_driven_find_all_shortest_paths_from_heap(
         const t_conn_cost_params cost_params,
         t_bb bounding_box,
-        std::vector<int>& modified_rr_node_inf,
         RouterStats& router_stats);
 
 static void timing_driven_expand_cheapest(t_heap* cheapest,
@@ -178,7 +181,6 @@ static void timing_driven_expand_cheapest(t_heap* cheapest,
                                            const t_conn_cost_params cost_params,
                                            t_bb bounding_box,
                                            const RouterLookahead& router_lookahead,
-                                           std::vector<int>& modified_rr_node_inf,
                                            RouterStats& router_stats);
 
 static t_rt_node* setup_routing_resources(int itry, ClusterNetId net_id, unsigned num_sinks, float pres_fac, int min_incremental_reroute_fanout,
@@ -309,6 +311,10 @@ bool try_timing_driven_route(
     //Initialize and properly size the lookups for profiling
     profiling::profiling_initialization(get_max_pins_per_net());
 
+    //Any spatial look-ups left over from a previous routing are stale
+    f_spatial_rt_lookups.clear();
+    f_spatial_rt_lookups.resize(cluster_ctx.clb_nlist.nets().size());
+
     //sort so net with most sinks is routed first.
     auto sorted_nets = std::vector<ClusterNetId>(cluster_ctx.clb_nlist.nets().begin(), cluster_ctx.clb_nlist.nets().end());
     std::sort(sorted_nets.begin(), sorted_nets.end(), more_sinks_than());
@@ -389,7 +395,52 @@ bool try_timing_driven_route(
     vtr::Timer iteration_timer;
     int num_net_bounding_boxes_updated = 0;
     int itry_since_last_convergence = -1;
-    for (itry = 1; itry <= router_opts.max_router_iterations; ++itry) {
+
+    /*
+     * Pick up from a checkpoint of an earlier (interrupted) run
+     */
+    int first_itry = 1;
+    if (!router_opts.resume_checkpoint_file.empty()) {
+        t_routing_checkpoint checkpoint;
+        if (read_routing_checkpoint(router_opts.resume_checkpoint_file, checkpoint, connections_inf, routing_predictor)) {
+            first_itry = checkpoint.itry + 1;
+            pres_fac = checkpoint.pres_fac;
+            bb_fac = checkpoint.bb_fac;
+            itry_conflicted_mode = checkpoint.itry_conflicted_mode;
+            if (checkpoint.conflicted_mode) {
+                router_congestion_mode = RouterCongestionMode::CONFLICTED;
+            }
+            legal_convergence_count = checkpoint.legal_convergence_count;
+            itry_since_last_convergence = checkpoint.itry_since_last_convergence;
+
+            routing_is_successful = checkpoint.routing_is_successful;
+            if (routing_is_successful) {
+                best_routing = std::move(checkpoint.best_routing);
+                best_clb_opins_used_locally = std::move(checkpoint.best_clb_opins_used_locally);
+                best_routing_metrics.used_wirelength = checkpoint.best_used_wirelength;
+                best_routing_metrics.sWNS = checkpoint.best_sWNS;
+                best_routing_metrics.sTNS = checkpoint.best_sTNS;
+                best_routing_metrics.hWNS = checkpoint.best_hWNS;
+                best_routing_metrics.hTNS = checkpoint.best_hTNS;
+                best_routing_metrics.critical_path = tatum::TimingPathInfo(tatum::TimingType::SETUP,
+                                                                           tatum::Time(checkpoint.best_critical_path_delay), tatum::Time(checkpoint.best_critical_path_slack),
+                                                                           tatum::NodeId::INVALID(), tatum::NodeId::INVALID(),
+                                                                           tatum::DomainId::INVALID(), tatum::DomainId::INVALID());
+            }
+
+            if (timing_info) {
+                //Criticalities for the next iteration come from the checkpointed routing
+                load_net_delay_from_routing(net_delay);
+                timing_info->update();
+                critical_path = timing_info->least_slack_critical_path();
+
+                //Budgets are not checkpointed, re-derive them from the restored delays
+                budgeting_inf.load_route_budgets(net_delay, timing_info, netlist_pin_lookup, router_opts);
+            }
+        }
+    }
+
+    for (itry = first_itry; itry <= router_opts.max_router_iterations; ++itry) {
 
         RouterStats router_iteration_stats;
 
@@ -445,6 +496,11 @@ bool try_timing_driven_route(
         bool rip_up_local_opins = (itry == 1 ? false : true);
         reserve_locally_used_opins(pres_fac, router_opts.acc_fac, rip_up_local_opins);
 
+#ifdef VTR_ASSERT_SAFE_ENABLED
+        //Verify the connectivity of the nets re-routed this iteration
+        check_route_incremental(router_opts.route_type, g_vpr_ctx.device().num_rr_switches);
+#endif
+
         /*
          * Calculate metrics for the current routing
          */
@@ -493,6 +549,30 @@ bool try_timing_driven_route(
 
         prev_iter_cumm_time = iter_cumm_time;
 
+        //Record telemetry
+        profiling::t_router_iteration_telemetry iteration_telemetry;
+        iteration_telemetry.iteration = itry;
+        iteration_telemetry.channel_width = g_vpr_ctx.device().chan_width.max;
+        iteration_telemetry.elapsed_sec = iter_elapsed_time;
+        iteration_telemetry.pres_fac = pres_fac;
+        iteration_telemetry.num_bb_updated = num_net_bounding_boxes_updated;
+        iteration_telemetry.nets_routed = router_iteration_stats.nets_routed;
+        iteration_telemetry.connections_routed = router_iteration_stats.connections_routed;
+        iteration_telemetry.heap_pushes = router_iteration_stats.heap_pushes;
+        iteration_telemetry.heap_pops = router_iteration_stats.heap_pops;
+        iteration_telemetry.overused_nodes = overuse_info.overused_nodes();
+        iteration_telemetry.total_overuse = overuse_info.total_overuse();
+        iteration_telemetry.worst_overuse = overuse_info.worst_overuse();
+        iteration_telemetry.used_wirelength = wirelength_info.used_wirelength();
+        iteration_telemetry.est_success_iteration = est_success_iteration;
+        iteration_telemetry.critical_path_delay = (timing_info) ? critical_path.delay() : std::numeric_limits<float>::quiet_NaN();
+        profiling::record_iteration(iteration_telemetry);
+
+        if (!router_opts.telemetry_file.empty()) {
+            //Appended every iteration so the time series is available even if routing is cut short
+            profiling::write_telemetry(router_opts.telemetry_file);
+        }
+
         //Update graphics
         if (itry == 1) {
             update_screen(first_iteration_priority, "Routing...", ROUTING, timing_info);
@@ -717,6 +797,33 @@ bool try_timing_driven_route(
         if (router_opts.congestion_analysis) profiling::congestion_analysis();
         if (router_opts.fanout_analysis) profiling::time_on_fanout_analysis();
         // profiling::time_on_criticality_analysis();
+
+        if (!router_opts.checkpoint_file.empty() && itry % router_opts.checkpoint_interval == 0) {
+            //Everything needed to start the next iteration is now in place
+            t_routing_checkpoint checkpoint;
+            checkpoint.itry = itry;
+            checkpoint.pres_fac = pres_fac;
+            checkpoint.bb_fac = bb_fac;
+            checkpoint.itry_conflicted_mode = itry_conflicted_mode;
+            checkpoint.conflicted_mode = (router_congestion_mode == RouterCongestionMode::CONFLICTED);
+            checkpoint.legal_convergence_count = legal_convergence_count;
+            checkpoint.itry_since_last_convergence = itry_since_last_convergence;
+
+            checkpoint.routing_is_successful = routing_is_successful;
+            if (routing_is_successful) {
+                checkpoint.best_routing = best_routing;
+                checkpoint.best_clb_opins_used_locally = best_clb_opins_used_locally;
+                checkpoint.best_used_wirelength = best_routing_metrics.used_wirelength;
+                checkpoint.best_sWNS = best_routing_metrics.sWNS;
+                checkpoint.best_sTNS = best_routing_metrics.sTNS;
+                checkpoint.best_hWNS = best_routing_metrics.hWNS;
+                checkpoint.best_hTNS = best_routing_metrics.hTNS;
+                checkpoint.best_critical_path_delay = best_routing_metrics.critical_path.delay();
+                checkpoint.best_critical_path_slack = best_routing_metrics.critical_path.slack();
+            }
+
+            write_routing_checkpoint(router_opts.checkpoint_file, checkpoint, connections_inf, routing_predictor);
+        }
     }
 
     if (routing_is_successful) {
@@ -834,6 +941,10 @@ void free_timing_driven_route_structs(float *pin_criticality, int *sink_order,
     // coverity[offset_free : Intentional]
     free(rt_node_of_sink + 1);
     free_route_tree_timing_structs();
+
+    //Free the spatial look-ups kept across routing iterations
+    f_spatial_rt_lookups.clear();
+    f_spatial_rt_lookups.shrink_to_fit();
 }
 
 timing_driven_route_structs::timing_driven_route_structs() {
@@ -924,9 +1035,16 @@ bool timing_driven_route_net(ClusterNetId net_id, int itry,
 
     bool high_fanout = is_high_fanout(num_sinks, router_opts.high_fanout_threshold);
 
-    SpatialRouteTreeLookup spatial_route_tree_lookup;
+    if (f_spatial_rt_lookups.size() != cluster_ctx.clb_nlist.nets().size()) {
+        //Not called through try_timing_driven_route()
+        f_spatial_rt_lookups.clear();
+        f_spatial_rt_lookups.resize(cluster_ctx.clb_nlist.nets().size());
+    }
+
+    SpatialRouteTreeLookup& spatial_route_tree_lookup = f_spatial_rt_lookups[net_id];
     if (high_fanout) {
-        spatial_route_tree_lookup = build_route_tree_spatial_lookup(net_id, rt_root);
+        update_route_tree_spatial_lookup(net_id, rt_root, spatial_route_tree_lookup);
+        VTR_ASSERT_DEBUG(validate_route_tree_spatial_lookup(rt_root, spatial_route_tree_lookup));
     }
 
     // after this point the route tree is correct
@@ -1040,6 +1158,7 @@ static bool timing_driven_route_sink(ClusterNetId net_id, unsigned itarget, int
     auto& cluster_ctx = g_vpr_ctx.clustering();
 
     profiling::sink_criticality_start();
+    size_t heap_pops_before_connection = router_stats.heap_pops;
 
     int sink_node = route_ctx.net_rr_terminals[net_id][target_pin];
 
@@ -1047,7 +1166,6 @@ static bool timing_driven_route_sink(ClusterNetId net_id, unsigned itarget, int
 
     VTR_ASSERT_DEBUG(verify_traceback_route_tree_equivalent(route_ctx.trace[net_id].head, rt_root));
 
-    std::vector<int> modified_rr_node_inf;
     t_heap* cheapest = nullptr;
     t_bb bounding_box = route_ctx.route_bb[net_id];
 
@@ -1064,14 +1182,12 @@ static bool timing_driven_route_sink(ClusterNetId net_id, unsigned itarget, int
                                 bounding_box,
                                 router_lookahead,
                                 spatial_rt_lookup,
-                                modified_rr_node_inf,
                                 router_stats);
     } else {
         cheapest = timing_driven_route_connection_from_route_tree(rt_root, sink_node,
                                 cost_params,
                                 bounding_box,
                                 router_lookahead,
-                                modified_rr_node_inf,
                                 router_stats);
     }
 
@@ -1090,6 +1206,7 @@ static bool timing_driven_route_sink(ClusterNetId net_id, unsigned itarget, int
     }
 
     profiling::sink_criticality_end(cost_params.criticality);
+    profiling::connection_routed(router_stats.heap_pops - heap_pops_before_connection);
 
     /* NB:  In the code below I keep two records of the partial routing:  the   *
      * traceback and the route_tree.  The route_tree enables fast recomputation *
@@ -1117,7 +1234,7 @@ static bool timing_driven_route_sink(ClusterNetId net_id, unsigned itarget, int
 
     // need to guarentee ALL nodes' path costs are HUGE_POSITIVE_FLOAT at the start of routing to a sink
     // do this by resetting all the path_costs that have been touched while routing to the current sink
-    reset_path_costs(modified_rr_node_inf);
+    reset_path_costs();
 
     // routed to a sink successfully
     return true;
@@ -1133,7 +1250,6 @@ t_heap* timing_driven_route_connection_from_route_tree(t_rt_node* rt_root, int s
         const t_conn_cost_params cost_params,
         t_bb bounding_box,
         const RouterLookahead& router_lookahead,
-        std::vector<int>& modified_rr_node_inf,
         RouterStats& router_stats) {
 
     // re-explore route tree from root to add any new nodes (buildheap afterwards)
@@ -1158,7 +1274,6 @@ t_heap* timing_driven_route_connection_from_route_tree(t_rt_node* rt_root, int s
                             cost_params,
                             bounding_box,
                             router_lookahead,
-                            modified_rr_node_inf,
                             router_stats);
 
     if (cheapest == nullptr) {
@@ -1180,7 +1295,6 @@ static t_heap* timing_driven_route_connection_from_route_tree_high_fanout(t_rt_n
         t_bb net_bounding_box,
         const RouterLookahead& router_lookahead,
         const SpatialRouteTreeLookup& spatial_rt_lookup,
-        std::vector<int>& modified_rr_node_inf,
         RouterStats& router_stats) {
 
     // re-explore route tree from root to add any new nodes (buildheap afterwards)
@@ -1205,14 +1319,13 @@ static t_heap* timing_driven_route_connection_from_route_tree_high_fanout(t_rt_n
                             cost_params,
                             high_fanout_bb,
                             router_lookahead,
-                            modified_rr_node_inf,
                             router_stats);
 
     if (cheapest == nullptr) {
         //Found no path, that may be due to an unlucky choice of existing route tree sub-set,
         //try again with the full route tree to be sure this is not an artifact of high-fanout routing
         VTR_LOG_WARN("No routing path found in high-fanout mode for net connection (to sink_rr %d), retrying with full route tree\n", sink_node);
-        cheapest = timing_driven_route_connection_from_route_tree(rt_root, sink_node, cost_params, net_bounding_box, router_lookahead, modified_rr_node_inf, router_stats);
+        cheapest = timing_driven_route_connection_from_route_tree(rt_root, sink_node, cost_params, net_bounding_box, router_lookahead, router_stats);
     }
     if (cheapest == nullptr) {
         VTR_LOG("%s\n", describe_unrouteable_connection(source_node, sink_node).c_str());
@@ -1233,7 +1346,6 @@ static t_heap* timing_driven_route_connection_from_heap(int sink_node,
         const t_conn_cost_params cost_params,
         t_bb bounding_box,
         const RouterLookahead& router_lookahead,
-        std::vector<int>& modified_rr_node_inf,
         RouterStats& router_stats) {
 
     VTR_ASSERT_SAFE(heap_::is_valid());
@@ -1265,7 +1377,6 @@ static t_heap* timing_driven_route_connection_from_heap(int sink_node,
                                       cost_params,
                                       bounding_box,
                                       router_lookahead,
-                                      modified_rr_node_inf,
                                       router_stats);
 
         free_heap_data(cheapest);
@@ -1285,7 +1396,6 @@ std::vector<t_heap> timing_driven_find_all_shortest_paths_from_route_tree(
         t_rt_node* rt_root,
         const t_conn_cost_params cost_params,
         t_bb bounding_box,
-        std::vector<int>& modified_rr_node_inf,
         RouterStats& router_stats) {
 
     //Add the route tree to the heap with no specific target node
@@ -1294,7 +1404,7 @@ std::vector<t_heap> timing_driven_find_all_shortest_paths_from_route_tree(
     add_route_tree_to_heap(rt_root, target_node, cost_params, *router_lookahead, router_stats);
     heap_::build_heap(); // via sifting down everything
 
-    auto res = timing_driven_find_all_shortest_paths_from_heap(cost_params, bounding_box, modified_rr_node_inf, router_stats);
+    auto res = timing_driven_find_all_shortest_paths_from_heap(cost_params, bounding_box, router_stats);
 
     return res;
 }
@@ -1309,7 +1419,6 @@ std::vector<t_heap> timing_driven_find_all_shortest_paths_from_route_tree(
 static std::vector<t_heap> timing_driven_find_all_shortest_paths_from_heap(
         const t_conn_cost_params cost_params,
         t_bb bounding_box,
-        std::vector<int>& modified_rr_node_inf,
         RouterStats& router_stats) {
     auto router_lookahead = make_router_lookahead(e_router_lookahead::NO_OP);
 
@@ -1343,7 +1452,6 @@ static std::vector<t_heap> timing_driven_find_all_shortest_paths_from_heap(
                                       cost_params,
                                       bounding_box,
                                       *router_lookahead,
-                                      modified_rr_node_inf,
                                       router_stats);
 
         if (cheapest_paths[inode].index == OPEN || cheapest_paths[inode].cost >= cheapest->cost) {
@@ -1364,14 +1472,13 @@ static void timing_driven_expand_cheapest(t_heap* cheapest,
                                           const t_conn_cost_params cost_params,
                                           t_bb bounding_box,
                                           const RouterLookahead& router_lookahead,
-                                          std::vector<int>& modified_rr_node_inf,
                                           RouterStats& router_stats) {
     auto& route_ctx = g_vpr_ctx.mutable_routing();
 
     int inode = cheapest->index;
 
-    float old_total_cost = route_ctx.rr_node_route_inf[inode].path_cost;
-    float old_back_cost = route_ctx.rr_node_route_inf[inode].backward_path_cost;
+    float old_total_cost = route_ctx.rr_node_route_inf[inode].path_cost();
+    float old_back_cost = route_ctx.rr_node_route_inf[inode].backward_path_cost();
 
     float new_total_cost = cheapest->cost;
     float new_back_cost = cheapest->backward_path_cost;
@@ -1390,12 +1497,9 @@ static void timing_driven_expand_cheapest(t_heap* cheapest,
         for (t_heap_prev prev : cheapest->previous) {
             VTR_LOGV_DEBUG(f_router_debug, "      Setting path costs for assicated node %d (from %d edge %d)\n", prev.to_node, prev.from_node, prev.from_edge);
 
-            add_to_mod_list(prev.to_node, modified_rr_node_inf);
-
-            route_ctx.rr_node_route_inf[prev.to_node].prev_node = prev.from_node;
-            route_ctx.rr_node_route_inf[prev.to_node].prev_edge = prev.from_edge;
-            route_ctx.rr_node_route_inf[prev.to_node].path_cost = new_total_cost;
-            route_ctx.rr_node_route_inf[prev.to_node].backward_path_cost = new_back_cost;
+            route_ctx.rr_node_route_inf[prev.to_node].set_prev(prev.from_node, prev.from_edge);
+            route_ctx.rr_node_route_inf[prev.to_node].set_path_cost(new_total_cost);
+            route_ctx.rr_node_route_inf[prev.to_node].set_backward_path_cost(new_back_cost);
         }
 
         timing_driven_expand_neighbours(cheapest, cost_params, bounding_box,
@@ -1615,7 +1719,10 @@ static t_bb add_high_fanout_route_tree_to_heap(t_rt_node* rt_root, int target_no
             
             if (bin_y > spatial_rt_lookup.dim_size(1) - 1) continue; //Out of range
 
-            for (t_rt_node* rt_node : spatial_rt_lookup[bin_x][bin_y]) {
+            for (int inode : spatial_rt_lookup[bin_x][bin_y]) {
+                t_rt_node* rt_node = rr_node_to_route_tree_node(inode);
+                VTR_ASSERT_SAFE(rt_node);
+
                 if (!rt_node->re_expand) continue; //Some nodes (like IPINs) shouldn't be re-expanded
 
                 //Put the node onto the heap
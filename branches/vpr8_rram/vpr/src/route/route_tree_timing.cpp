@@ -1,5 +1,6 @@
 #include <cstdio>
 #include <cmath>
+#include <memory>
 #include <vector>
 using namespace std;
 
@@ -35,10 +36,67 @@ using namespace std;
 static std::vector<t_rt_node *> rr_node_to_rt_node; /* [0..device_ctx.rr_nodes.size()-1] */
 
 
-/* Frees lists for fast addition and deletion of nodes and edges. */
+/* Route tree nodes and edges are carved out of fixed-size blocks rather than
+ * malloc'd one at a time.  Released items are recycled through a free list
+ * while a tree is alive (e.g. branches cut by prune_route_tree), and once
+ * every item has been released (i.e. the net's tree was freed) the arena is
+ * rewound, so the next net's tree is laid out contiguously in the same
+ * blocks.  Blocks are never moved, so t_rt_node and t_linked_rt_edge
+ * pointers stay valid for as long as the item is allocated.                 */
+
+template<typename T>
+class RouteTreeArena {
+    public:
+        T* alloc() {
+            ++num_live_;
+
+            if (!free_list_.empty()) {
+                T* item = free_list_.back();
+                free_list_.pop_back();
+                return item;
+            }
+
+            if (next_ == blocks_.size() * BLOCK_SIZE) {
+                blocks_.emplace_back(new T[BLOCK_SIZE]);
+            }
+            T* item = &blocks_[next_ / BLOCK_SIZE][next_ % BLOCK_SIZE];
+            ++next_;
+            return item;
+        }
 
-static t_rt_node *rt_node_free_list = nullptr;
-static t_linked_rt_edge *rt_edge_free_list = nullptr;
+        void free(T* item) {
+            VTR_ASSERT_SAFE(num_live_ > 0);
+            --num_live_;
+
+            if (num_live_ == 0) {
+                //Nothing is alive any more, start again from the first block
+                next_ = 0;
+                free_list_.clear();
+            } else {
+                free_list_.push_back(item);
+            }
+        }
+
+        bool allocated() const { return !blocks_.empty(); }
+
+        void release() {
+            blocks_.clear();
+            free_list_.clear();
+            next_ = 0;
+            num_live_ = 0;
+        }
+
+    private:
+        static constexpr size_t BLOCK_SIZE = 1024;
+
+        std::vector<std::unique_ptr<T[]>> blocks_;
+        std::vector<T*> free_list_;
+        size_t next_ = 0; //Next never-used item, as block * BLOCK_SIZE + offset
+        size_t num_live_ = 0;
+};
+
+static RouteTreeArena<t_rt_node> rt_node_arena;
+static RouteTreeArena<t_linked_rt_edge> rt_edge_arena;
 
 /********************** Subroutines local to this module *********************/
 
@@ -58,9 +116,7 @@ static t_rt_node* add_non_configurable_to_route_tree(const int rr_node, const bo
 static t_rt_node *update_unbuffered_ancestors_C_downstream(
 		t_rt_node * start_of_new_subtree_rt_node);
 
-bool verify_route_tree_recurr(t_rt_node* node, std::set<int>& seen_nodes);
-
-t_rt_node* prune_route_tree_recurr(t_rt_node* node, CBRR& connections_inf, bool congested);
+static t_rt_node* prune_route_tree_node(t_rt_node* node, CBRR& connections_inf, bool force_prune, bool all_children_pruned);
 
 t_rt_node* traceback_to_route_tree(t_trace* head);
 static t_trace* traceback_to_route_tree_branch(t_trace* trace, std::map<int,t_rt_node*>& rr_node_to_rt);
@@ -83,7 +139,7 @@ bool alloc_route_tree_timing_structs(bool exists_ok) {
 
     bool route_tree_structs_are_allocated =
         (rr_node_to_rt_node.size() == size_t(device_ctx.rr_nodes.size())
-			                                 || rt_node_free_list != nullptr);
+			                                 || rt_node_arena.allocated());
     if (route_tree_structs_are_allocated) {
         if (exists_ok) {
             return false;
@@ -101,86 +157,38 @@ bool alloc_route_tree_timing_structs(bool exists_ok) {
 void free_route_tree_timing_structs() {
 
 	/* Frees the structures needed to build routing trees, and really frees
-	 * (i.e. calls free) all the data on the free lists.                         */
-
-	t_rt_node *rt_node, *next_node;
-	t_linked_rt_edge *rt_edge, *next_edge;
+	 * all the node and edge storage held by the arenas.                     */
 
 	rr_node_to_rt_node.clear();
 
-	rt_node = rt_node_free_list;
-
-	while (rt_node != nullptr) {
-		next_node = rt_node->u.next;
-		free(rt_node);
-		rt_node = next_node;
-	}
-
-	rt_node_free_list = nullptr;
+	rt_node_arena.release();
+	rt_edge_arena.release();
+}
 
-	rt_edge = rt_edge_free_list;
+t_rt_node* rr_node_to_route_tree_node(int inode) {
 
-	while (rt_edge != nullptr) {
-		next_edge = rt_edge->next;
-		free(rt_edge);
-		rt_edge = next_edge;
-	}
+	/* Returns the node of the route tree currently being built which uses
+	 * rr node inode, or nullptr if inode is not part of it.                 */
 
-	rt_edge_free_list = nullptr;
+	return rr_node_to_rt_node[inode];
 }
 
 static t_rt_node*
 alloc_rt_node() {
-
-	/* Allocates a new rt_node, from the free list if possible, from the free
-	 * store otherwise.                                                         */
-
-	t_rt_node *rt_node;
-
-	rt_node = rt_node_free_list;
-
-	if (rt_node != nullptr) {
-		rt_node_free_list = rt_node->u.next;
-	} else {
-		rt_node = (t_rt_node *) vtr::malloc(sizeof(t_rt_node));
-	}
-
-	return (rt_node);
+	return rt_node_arena.alloc();
 }
 
 static void free_rt_node(t_rt_node * rt_node) {
-
-	/* Adds rt_node to the proper free list.          */
-
-	rt_node->u.next = rt_node_free_list;
-	rt_node_free_list = rt_node;
+	rt_node_arena.free(rt_node);
 }
 
 static t_linked_rt_edge*
 alloc_linked_rt_edge() {
-
-	/* Allocates a new linked_rt_edge, from the free list if possible, from the
-	 * free store otherwise.                                                     */
-
-	t_linked_rt_edge *linked_rt_edge;
-
-	linked_rt_edge = rt_edge_free_list;
-
-	if (linked_rt_edge != nullptr) {
-		rt_edge_free_list = linked_rt_edge->next;
-	} else {
-		linked_rt_edge = (t_linked_rt_edge *) vtr::malloc(
-				sizeof(t_linked_rt_edge));
-	}
-
-	VTR_ASSERT(linked_rt_edge != nullptr);
-	return (linked_rt_edge);
+	return rt_edge_arena.alloc();
 }
 
-/* Adds the rt_edge to the rt_edge free list.                       */
 static void free_linked_rt_edge(t_linked_rt_edge * rt_edge) {
-	rt_edge->next = rt_edge_free_list;
-	rt_edge_free_list = rt_edge;
+	rt_edge_arena.free(rt_edge);
 }
 
 /* Initializes the routing tree to just the net source, and returns the root
@@ -248,20 +256,28 @@ t_rt_node* update_route_tree(t_heap * hptr, SpatialRouteTreeLookup* spatial_rt_l
 	load_route_tree_Tdel(unbuffered_subtree_rt_root, Tdel_start);
 
     if (spatial_rt_lookup) {
-        update_route_tree_spatial_lookup_recur(start_of_new_subtree_rt_node, *spatial_rt_lookup);
+        add_route_tree_to_spatial_lookup(start_of_new_subtree_rt_node, *spatial_rt_lookup);
     }
 
 	return (sink_rt_node);
 }
 
 void add_route_tree_to_rr_node_lookup(t_rt_node* node) {
-    if (node) {
+    if (!node) {
+        return;
+    }
+
+    std::vector<t_rt_node*> stack = {node};
+    while (!stack.empty()) {
+        node = stack.back();
+        stack.pop_back();
+
         VTR_ASSERT(rr_node_to_rt_node[node->inode] == nullptr || rr_node_to_rt_node[node->inode] == node);
 
         rr_node_to_rt_node[node->inode] = node;
 
         for (auto edge = node->u.child_list; edge != nullptr; edge = edge->next) {
-            add_route_tree_to_rr_node_lookup(edge->child);
+            stack.push_back(edge->child);
         }
     }
 }
@@ -338,8 +354,8 @@ add_subtree_to_route_tree(t_heap *hptr, t_rt_node ** sink_rt_node_ptr) {
             }
 
             downstream_rt_node = rt_node;
-            iedge = route_ctx.rr_node_route_inf[inode].prev_edge;
-            inode = route_ctx.rr_node_route_inf[inode].prev_node;
+            iedge = route_ctx.rr_node_route_inf[inode].prev_edge();
+            inode = route_ctx.rr_node_route_inf[inode].prev_node();
             iswitch = device_ctx.rr_nodes[inode].edge_switch(iedge);
         }
     }
@@ -434,7 +450,9 @@ static t_rt_node* add_non_configurable_to_route_tree(const int rr_node, const bo
 void load_new_subtree_R_upstream(t_rt_node* rt_node) {
 
 	/* Sets the R_upstream values of all the nodes in the new path to the
-	 * correct value by traversing down to SINK from the start of the new path. */
+	 * correct value by traversing down to SINK from the start of the new path.
+	 * Parents are always visited before their children (explicit stack rather
+	 * than recursion, since paths through the routing can be very deep).      */
 
     if (!rt_node) {
         return;
@@ -442,51 +460,75 @@ void load_new_subtree_R_upstream(t_rt_node* rt_node) {
 
     auto& device_ctx = g_vpr_ctx.device();
 
-    t_rt_node* parent_rt_node = rt_node->parent_node;
-    int inode = rt_node->inode;
+    std::vector<t_rt_node*> stack = {rt_node};
+    while (!stack.empty()) {
+        rt_node = stack.back();
+        stack.pop_back();
+
+        t_rt_node* parent_rt_node = rt_node->parent_node;
+        int inode = rt_node->inode;
 
-    //Calculate upstream resistance
-    float R_upstream = 0.;
-    if (parent_rt_node) {
-        int iswitch = rt_node->parent_switch;
-        bool switch_buffered = device_ctx.rr_switch_inf[iswitch].buffered();
+        //Calculate upstream resistance
+        float R_upstream = 0.;
+        if (parent_rt_node) {
+            int iswitch = rt_node->parent_switch;
+            bool switch_buffered = device_ctx.rr_switch_inf[iswitch].buffered();
 
-        if (!switch_buffered) {
-                R_upstream += parent_rt_node->R_upstream; //Parent upstream R
+            if (!switch_buffered) {
+                    R_upstream += parent_rt_node->R_upstream; //Parent upstream R
+            }
+            R_upstream += device_ctx.rr_switch_inf[iswitch].R; //Parent switch R
         }
-        R_upstream += device_ctx.rr_switch_inf[iswitch].R; //Parent switch R
-    }
-    R_upstream += device_ctx.rr_nodes[inode].R(); //Current node R
+        R_upstream += device_ctx.rr_nodes[inode].R(); //Current node R
 
-    rt_node->R_upstream = R_upstream;
+        rt_node->R_upstream = R_upstream;
 
-    //Update children
-    for (t_linked_rt_edge* edge = rt_node->u.child_list; edge != nullptr; edge = edge->next) {
-        load_new_subtree_R_upstream(edge->child); //Recurse
+        //Update children
+        for (t_linked_rt_edge* edge = rt_node->u.child_list; edge != nullptr; edge = edge->next) {
+            stack.push_back(edge->child);
+        }
     }
 }
 
 
 float load_new_subtree_C_downstream(t_rt_node* rt_node) {
-    float C_downstream = 0.;
 
-    if (rt_node) {
-        auto& device_ctx = g_vpr_ctx.device();
+    /* Sets the C_downstream values of the subtree rooted at rt_node, and
+     * returns the value at rt_node.  Nodes are collected in pre-order and
+     * then processed in reverse, so every child is done before its parent. */
 
-        C_downstream += device_ctx.rr_nodes[rt_node->inode].C();
-        for (t_linked_rt_edge* edge = rt_node->u.child_list; edge != nullptr; edge = edge->next) {
+    if (!rt_node) {
+        return 0.;
+    }
 
-            float C_downstream_child = load_new_subtree_C_downstream(edge->child);
+    auto& device_ctx = g_vpr_ctx.device();
+
+    std::vector<t_rt_node*> order;
+    std::vector<t_rt_node*> stack = {rt_node};
+    while (!stack.empty()) {
+        t_rt_node* node = stack.back();
+        stack.pop_back();
 
+        order.push_back(node);
+        for (t_linked_rt_edge* edge = node->u.child_list; edge != nullptr; edge = edge->next) {
+            stack.push_back(edge->child);
+        }
+    }
+
+    for (auto itr = order.rbegin(); itr != order.rend(); ++itr) {
+        t_rt_node* node = *itr;
+
+        float C_downstream = device_ctx.rr_nodes[node->inode].C();
+        for (t_linked_rt_edge* edge = node->u.child_list; edge != nullptr; edge = edge->next) {
             if (!device_ctx.rr_switch_inf[edge->iswitch].buffered()) {
-                C_downstream += C_downstream_child;
+                C_downstream += edge->child->C_downstream;
             }
         }
 
-        rt_node->C_downstream = C_downstream;
+        node->C_downstream = C_downstream;
     }
 
-    return C_downstream;
+    return rt_node->C_downstream;
 }
 
 static t_rt_node*
@@ -521,41 +563,38 @@ update_unbuffered_ancestors_C_downstream(t_rt_node * start_of_new_path_rt_node)
 void load_route_tree_Tdel(t_rt_node * subtree_rt_root, float Tarrival) {
 
 	/* Updates the Tdel values of the subtree rooted at subtree_rt_root by
-	 * by calling itself recursively.  The C_downstream values of all the nodes
-	 * must be correct before this routine is called.  Tarrival is the time at
-	 * at which the signal arrives at this node's *input*.                      */
-
-	int inode;
-	short iswitch;
-	t_rt_node *child_node;
-	t_linked_rt_edge *linked_rt_edge;
-	float Tdel, Tchild;
+	 * a depth-first pre-order traversal.  The C_downstream values of all the
+	 * nodes must be correct before this routine is called.  Tarrival is the
+	 * time at which the signal arrives at this node's *input*.                */
 
     auto& device_ctx = g_vpr_ctx.device();
 
-	inode = subtree_rt_root->inode;
+	std::vector<std::pair<t_rt_node*,float>> stack = {{subtree_rt_root, Tarrival}};
 
-	/* Assuming the downstream connections are, on average, connected halfway
-	 * along a wire segment's length.  See discussion in net_delay.c if you want
-	 * to change this.                                                           */
+	while (!stack.empty()) {
+		t_rt_node* rt_node = stack.back().first;
+		float Tnode_arrival = stack.back().second;
+		stack.pop_back();
 
-	Tdel = Tarrival + 0.5 * subtree_rt_root->C_downstream * device_ctx.rr_nodes[inode].R();
-	subtree_rt_root->Tdel = Tdel;
+		int inode = rt_node->inode;
 
-	/* Now expand the children of this node to load their Tdel values (depth-
-	 * first pre-order traversal).                                              */
+		/* Assuming the downstream connections are, on average, connected halfway
+		 * along a wire segment's length.  See discussion in net_delay.c if you want
+		 * to change this.                                                           */
 
-	linked_rt_edge = subtree_rt_root->u.child_list;
+		float Tdel = Tnode_arrival + 0.5 * rt_node->C_downstream * device_ctx.rr_nodes[inode].R();
+		rt_node->Tdel = Tdel;
 
-	while (linked_rt_edge != nullptr) {
-		iswitch = linked_rt_edge->iswitch;
-		child_node = linked_rt_edge->child;
+		/* Now queue the children of this node to load their Tdel values. */
 
-		Tchild = Tdel + device_ctx.rr_switch_inf[iswitch].R * child_node->C_downstream;
-		Tchild += device_ctx.rr_switch_inf[iswitch].Tdel; /* Intrinsic switch delay. */
-		load_route_tree_Tdel(child_node, Tchild);
+		for (t_linked_rt_edge* linked_rt_edge = rt_node->u.child_list; linked_rt_edge != nullptr; linked_rt_edge = linked_rt_edge->next) {
+			short iswitch = linked_rt_edge->iswitch;
+			t_rt_node* child_node = linked_rt_edge->child;
 
-		linked_rt_edge = linked_rt_edge->next;
+			float Tchild = Tdel + device_ctx.rr_switch_inf[iswitch].R * child_node->C_downstream;
+			Tchild += device_ctx.rr_switch_inf[iswitch].Tdel; /* Intrinsic switch delay. */
+			stack.push_back({child_node, Tchild});
+		}
 	}
 }
 
@@ -572,11 +611,10 @@ void load_route_tree_rr_route_inf(t_rt_node* root) {
 
 	for (;;) {
 		int inode = root->inode;
-		route_ctx.rr_node_route_inf[inode].prev_node = NO_PREVIOUS;
-		route_ctx.rr_node_route_inf[inode].prev_edge = NO_PREVIOUS;
 		// path cost should be unset
-		VTR_ASSERT(std::isinf(route_ctx.rr_node_route_inf[inode].path_cost));
-		VTR_ASSERT(std::isinf(route_ctx.rr_node_route_inf[inode].backward_path_cost));
+		VTR_ASSERT(std::isinf(route_ctx.rr_node_route_inf[inode].path_cost()));
+		VTR_ASSERT(std::isinf(route_ctx.rr_node_route_inf[inode].backward_path_cost()));
+		VTR_ASSERT(route_ctx.rr_node_route_inf[inode].prev_node() == NO_PREVIOUS);
 
 		// reached a sink
 		if (!edge) {return;}
@@ -598,41 +636,48 @@ void load_route_tree_rr_route_inf(t_rt_node* root) {
 bool verify_route_tree(t_rt_node* root) {
 
     std::set<int> seen_nodes;
-    return verify_route_tree_recurr(root, seen_nodes);
-}
 
-bool verify_route_tree_recurr(t_rt_node* node, std::set<int>& seen_nodes) {
-    if (seen_nodes.count(node->inode)) {
-        VPR_THROW(VPR_ERROR_ROUTE, "Duplicate route tree nodes found for node %d", node->inode);
-    }
+    std::vector<t_rt_node*> stack = {root};
+    while (!stack.empty()) {
+        t_rt_node* node = stack.back();
+        stack.pop_back();
+
+        if (seen_nodes.count(node->inode)) {
+            VPR_THROW(VPR_ERROR_ROUTE, "Duplicate route tree nodes found for node %d", node->inode);
+        }
 
-    seen_nodes.insert(node->inode);
+        seen_nodes.insert(node->inode);
 
-    for (t_linked_rt_edge* edge = node->u.child_list; edge != nullptr; edge = edge->next) {
-        verify_route_tree_recurr(edge->child, seen_nodes);
+        for (t_linked_rt_edge* edge = node->u.child_list; edge != nullptr; edge = edge->next) {
+            stack.push_back(edge->child);
+        }
     }
     return true;
 }
 
 void free_route_tree(t_rt_node * rt_node) {
 
-	/* Puts the rt_nodes and edges in the tree rooted at rt_node back on the
-	 * free lists.  Recursive, depth-first post-order traversal.                */
+	/* Puts the rt_nodes and edges in the tree rooted at rt_node back into
+	 * their arenas.  Freeing the whole tree rewinds the arenas.             */
 
-	t_linked_rt_edge *rt_edge, *next_edge;
+	std::vector<t_rt_node*> stack = {rt_node};
 
-	rt_edge = rt_node->u.child_list;
+	while (!stack.empty()) {
+		rt_node = stack.back();
+		stack.pop_back();
 
-	while (rt_edge != nullptr) { /* For all children */
-		t_rt_node* child_node = rt_edge->child;
-        free_route_tree(child_node);
-		next_edge = rt_edge->next;
-		free_linked_rt_edge(rt_edge);
-		rt_edge = next_edge;
-	}
+		t_linked_rt_edge* rt_edge = rt_node->u.child_list;
+		while (rt_edge != nullptr) { /* For all children */
+			stack.push_back(rt_edge->child);
+
+			t_linked_rt_edge* next_edge = rt_edge->next;
+			free_linked_rt_edge(rt_edge);
+			rt_edge = next_edge;
+		}
 
-    rr_node_to_rt_node[rt_node->inode] = nullptr;
-	free_rt_node(rt_node);
+		rr_node_to_rt_node[rt_node->inode] = nullptr;
+		free_rt_node(rt_node);
+	}
 }
 
 void print_route_tree(const t_rt_node* rt_node, int depth) {
@@ -872,69 +917,19 @@ t_trace* traceback_from_route_tree(ClusterNetId inet, const t_rt_node* root, int
 	route_ctx.trace[inet].tail = tail;
 	route_ctx.trace[inet].head = head;
 	route_ctx.trace_nodes[inet] = nodes;
+	route_ctx.net_status[inet].is_checked = false;
 
 	return head;
 }
 
 
-//Prunes a route tree (recursively) based on congestion and the 'force_prune' argument
+//Decides whether a route tree node is pruned, once all of its children have been
+//visited (and the edges to any pruned children removed) by prune_route_tree()
 //
-//Returns true if the current node was pruned
-t_rt_node* prune_route_tree_recurr(t_rt_node* node, CBRR& connections_inf, bool force_prune) {
-
-    //Recursively traverse the route tree rooted at node and remove any congested
-    //sub-trees
-
-    VTR_ASSERT(node);
+//Returns the node if it was kept, or nullptr if it was pruned
+static t_rt_node* prune_route_tree_node(t_rt_node* node, CBRR& connections_inf, bool force_prune, bool all_children_pruned) {
 
     auto& device_ctx = g_vpr_ctx.device();
-    auto& route_ctx = g_vpr_ctx.routing();
-
-
-    bool congested = (route_ctx.rr_node_route_inf[node->inode].occ() > device_ctx.rr_nodes[node->inode].capacity());
-
-    if (congested) {
-        //This connection is congested -- prune it
-        force_prune = true;
-    }
-
-    if (connections_inf.should_force_reroute_connection(node->inode)) {
-        //Forcibly re-route (e.g. to improve delay)
-        force_prune = true;
-    }
-
-    //Recursively prune children
-    bool all_children_pruned = true;
-    t_linked_rt_edge* prev_edge = nullptr;
-    t_linked_rt_edge* edge = node->u.child_list;
-    while (edge) {
-        t_rt_node* child = prune_route_tree_recurr(edge->child, connections_inf, force_prune);
-
-        if (!child) { //Child was pruned
-
-            //Remove the edge
-            if (edge == node->u.child_list) { //Was Head
-                node->u.child_list = edge->next;
-            } else { //Was intermediate
-                VTR_ASSERT(prev_edge);
-                prev_edge->next = edge->next;
-            }
-
-            t_linked_rt_edge* old_edge = edge;
-            edge = edge->next;
-
-            free_linked_rt_edge(old_edge);
-
-            //Note prev_edge is unchanged
-
-        } else { //Child not pruned
-            all_children_pruned = false;
-
-            //Edge not removed
-            prev_edge = edge;
-            edge = edge->next;
-        }
-    }
 
     if (device_ctx.rr_nodes[node->inode].type() == SINK) {
 
@@ -1015,7 +1010,11 @@ t_rt_node* prune_route_tree_recurr(t_rt_node* node, CBRR& connections_inf, bool
 t_rt_node* prune_route_tree(t_rt_node* rt_root, CBRR& connections_inf) {
 	/* Prune a skeleton route tree of illegal branches - when there is at least 1 congested node on the path to a sink
 	 * This is the top level function to be called with the SOURCE node as root.
-	 * Returns true if the entire tree has been pruned.
+	 * Returns nullptr if the entire tree has been pruned.
+     *
+     * The tree is walked depth-first post-order with an explicit stack, visiting
+     * children in child-list order so sinks are reported to connections_inf in
+     * the same order as a recursive traversal would.
      *
      * Note: does not update R_upstream/C_downstream
      */
@@ -1030,7 +1029,80 @@ t_rt_node* prune_route_tree(t_rt_node* rt_root, CBRR& connections_inf) {
 	VTR_ASSERT_MSG(route_ctx.rr_node_route_inf[rt_root->inode].occ() <= device_ctx.rr_nodes[rt_root->inode].capacity(),
             "Route tree root/SOURCE should never be congested");
 
-    return prune_route_tree_recurr(rt_root, connections_inf, false);
+    struct t_prune_frame {
+        t_rt_node* node;
+        bool force_prune;
+        t_linked_rt_edge* prev_edge; //Last edge kept so far
+        t_linked_rt_edge* edge; //Edge to the child currently being (or next to be) visited
+        bool all_children_pruned;
+    };
+
+    std::vector<t_prune_frame> stack;
+
+    auto push_frame = [&](t_rt_node* node, bool force_prune) {
+        VTR_ASSERT(node);
+
+        if (route_ctx.rr_node_route_inf[node->inode].occ() > device_ctx.rr_nodes[node->inode].capacity()) {
+            //This connection is congested -- prune it
+            force_prune = true;
+        }
+
+        if (connections_inf.should_force_reroute_connection(node->inode)) {
+            //Forcibly re-route (e.g. to improve delay)
+            force_prune = true;
+        }
+
+        stack.push_back({node, force_prune, nullptr, node->u.child_list, true});
+    };
+
+    push_frame(rt_root, false);
+
+    t_rt_node* result = nullptr; //Result of the most recently finished node
+    bool child_finished = false;
+    while (!stack.empty()) {
+        t_prune_frame& frame = stack.back();
+
+        if (child_finished) {
+            child_finished = false;
+
+            if (!result) { //Child was pruned
+
+                //Remove the edge
+                if (frame.edge == frame.node->u.child_list) { //Was Head
+                    frame.node->u.child_list = frame.edge->next;
+                } else { //Was intermediate
+                    VTR_ASSERT(frame.prev_edge);
+                    frame.prev_edge->next = frame.edge->next;
+                }
+
+                t_linked_rt_edge* old_edge = frame.edge;
+                frame.edge = frame.edge->next;
+
+                free_linked_rt_edge(old_edge);
+
+                //Note prev_edge is unchanged
+
+            } else { //Child not pruned
+                frame.all_children_pruned = false;
+
+                //Edge not removed
+                frame.prev_edge = frame.edge;
+                frame.edge = frame.edge->next;
+            }
+        }
+
+        if (frame.edge) {
+            //Visit the next child (invalidates frame)
+            push_frame(frame.edge->child, frame.force_prune);
+            continue;
+        }
+
+        result = prune_route_tree_node(frame.node, connections_inf, frame.force_prune, frame.all_children_pruned);
+        stack.pop_back();
+        child_finished = true;
+    }
+
+    return result;
 }
 
 
@@ -1125,8 +1197,8 @@ static void print_node_inf(const t_rt_node* rt_node) {
 
 	int inode = rt_node->inode;
 	const auto& node_inf = route_ctx.rr_node_route_inf[inode];
-	VTR_LOG("%5.1e %5.1e%6d%3d|%-6d-> ", node_inf.path_cost, node_inf.backward_path_cost,
-		node_inf.prev_node, node_inf.prev_edge, inode);
+	VTR_LOG("%5.1e %5.1e%6d%3d|%-6d-> ", node_inf.path_cost(), node_inf.backward_path_cost(),
+		node_inf.prev_node(), node_inf.prev_edge(), inode);
 }
 
 
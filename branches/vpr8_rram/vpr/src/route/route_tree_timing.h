@@ -30,6 +30,7 @@ void load_route_tree_rr_route_inf(t_rt_node* root);
 t_rt_node* init_route_tree_to_source_no_net(int inode);
 
 void add_route_tree_to_rr_node_lookup(t_rt_node* node);
+t_rt_node* rr_node_to_route_tree_node(int inode);
 
 bool verify_route_tree(t_rt_node* root);
 bool verify_traceback_route_tree_equivalent(const t_trace* trace_head, const t_rt_node* rt_root);
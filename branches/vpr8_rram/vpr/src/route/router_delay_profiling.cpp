@@ -41,10 +41,9 @@ bool calculate_delay(int source_node, int sink_node,
 
     init_heap(device_ctx.grid);
 
-    std::vector<int> modified_rr_node_inf;
     RouterStats router_stats;
     auto router_lookahead = make_router_lookahead(router_opts.lookahead_type);
-    t_heap* cheapest = timing_driven_route_connection_from_route_tree(rt_root, sink_node, cost_params, bounding_box, *router_lookahead, modified_rr_node_inf, router_stats);
+    t_heap* cheapest = timing_driven_route_connection_from_route_tree(rt_root, sink_node, cost_params, bounding_box, *router_lookahead, router_stats);
 
     bool found_path = (cheapest != nullptr);
     if (found_path) {
@@ -62,7 +61,7 @@ bool calculate_delay(int source_node, int sink_node,
 
     //Reset for the next router call
     empty_heap();
-    reset_path_costs(modified_rr_node_inf);
+    reset_path_costs();
 
     return found_path;
 }
@@ -87,7 +86,6 @@ std::vector<float> calculate_all_path_delays_from_rr_node(int src_rr_node, const
     cost_params.astar_fac = router_opts.astar_fac;
     cost_params.bend_cost = router_opts.bend_cost;
 
-    std::vector<int> modified_rr_node_inf;
     RouterStats router_stats;
 
     init_heap(device_ctx.grid);
@@ -95,7 +93,6 @@ std::vector<float> calculate_all_path_delays_from_rr_node(int src_rr_node, const
     std::vector<t_heap> shortest_paths = timing_driven_find_all_shortest_paths_from_route_tree(rt_root,
                                                                                                 cost_params,
                                                                                                 bounding_box,
-                                                                                                modified_rr_node_inf,
                                                                                                 router_stats);
 
     free_route_tree(rt_root);
@@ -121,7 +118,7 @@ std::vector<float> calculate_all_path_delays_from_rr_node(int src_rr_node, const
             free_route_tree(rt_root);
         }
     }
-    reset_path_costs(modified_rr_node_inf);
+    reset_path_costs();
     empty_heap();
 
 #if 0
@@ -26,6 +26,10 @@ public:
     void add_iteration_overuse(size_t iteration, size_t overused_rr_node_count);
 
     float get_slope();
+
+    //Recorded overuse history (e.g. for checkpointing)
+    const std::vector<size_t>& iterations() const { return iterations_; }
+    const std::vector<size_t>& iteration_overused_rr_node_counts() const { return iteration_overused_rr_node_counts_; }
 private:
     size_t min_history_;
     float history_factor_;
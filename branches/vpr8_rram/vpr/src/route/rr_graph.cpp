@@ -28,6 +28,7 @@ using namespace std;
 #include "rr_graph_timing_params.h"
 #include "rr_graph_indexed_data.h"
 #include "check_rr_graph.h"
+#include "check_route.h"
 #include "read_xml_arch_file.h"
 #include "echo_files.h"
 #include "cb_metrics.h"
@@ -38,6 +39,10 @@ using namespace std;
 
 #include "rr_types.h"
 
+#if defined(TATUM_USE_TBB)
+# include <tbb/parallel_for.h>
+#endif
+
 //#define VERBOSE
 
 struct t_mux {
@@ -75,6 +80,27 @@ typedef std::vector<std::map<int,int>> t_arch_switch_fanin;
 
 
 /********************* Subroutines local to this module. *******************/
+//RC data to attach to an RR node. It is recorded rather than created directly, so
+//that the (shared) RC data look-up is populated in a deterministic order
+struct t_rr_rc_info {
+    t_rr_rc_info(int inode, float r, float c)
+        : node(inode), R(r), C(c) {}
+
+    int node = OPEN;
+    float R = 0.;
+    float C = 0.;
+};
+
+typedef std::vector<t_rr_rc_info> t_rr_rc_info_set;
+
+//The edges and RC data recorded by one unit of RR graph construction work
+//(e.g. the pins of a grid tile, or the wires starting in a channel segment)
+struct t_rr_build_result {
+    t_rr_edge_info_set edges; //Uniquified
+    t_rr_rc_info_set rcs;
+    bool Fc_clipped = false;
+};
+
 bool channel_widths_unchanged(const t_chan_width& current, const t_chan_width& proposed);
 
 static vtr::NdMatrix<std::vector<int>, 4> alloc_and_load_pin_to_track_map(const e_pin_type pin_type,
@@ -183,6 +209,7 @@ static void build_rr_sinks_sources(
         const int i, const int j,
         std::vector<t_rr_node>& L_rr_node,
         t_rr_edge_info_set& rr_edges_to_create,
+        t_rr_rc_info_set& rr_rcs_to_create,
         const t_rr_node_indices& L_rr_node_indices,
         const int delayless_switch, const DeviceGrid& grid);
 
@@ -199,14 +226,20 @@ static void build_rr_chan(
         const t_chan_details& chan_details_x, const t_chan_details& chan_details_y,
         const t_rr_node_indices& L_rr_node_indices,
         t_rr_edge_info_set& created_rr_edges,
+        t_rr_rc_info_set& created_rr_rcs,
         std::vector<t_rr_node>& L_rr_node,
         const int wire_to_ipin_switch,
         const enum e_directionality directionality);
 
+template<typename Fn>
+static void build_rr_items(std::vector<t_rr_build_result>& results, const size_t num_items,
+        const bool parallel, const Fn& build_item);
+
+static void commit_rr_build_results(std::vector<t_rr_node>& L_rr_node,
+        const std::vector<t_rr_build_result>& results);
+
 void uniquify_edges(t_rr_edge_info_set& rr_edges_to_create);
 
-void alloc_and_load_edges(std::vector<t_rr_node>& L_rr_node,
-        const t_rr_edge_info_set& rr_edges_to_create);
 
 static int alloc_and_load_rr_switch_inf(const int num_arch_switches, const float R_minW_nmos, const float R_minW_pmos,
                                         const int wire_to_arch_ipin_switch, int *wire_to_rr_ipin_switch);
@@ -1163,99 +1196,102 @@ static void alloc_and_load_rr_graph(const int num_nodes,
     //instead record the edges they wish to create in rr_edges_to_create.
     //
     //We uniquify the edges to be created (avoiding any duplicates), and create
-    //the edges in alloc_and_load_edges().
+    //the edges in commit_rr_build_results().
     //
     //By doing things in this manner we ensure we know exactly how many edges leave each RR
     //node, which avoids resizing the RR edge arrays (which can cause significant memory 
     //fragmentation, and significantly increasing peak memory usage). This is important since
     //RR graph creation is the high-watermark of VPR's memory use.
-    t_rr_edge_info_set rr_edges_to_create;
+    //
+    //The work is split into items (the pins of a grid tile, or the wires starting in a
+    //channel segment) which record their edges independently, so the items of a grid
+    //column are built in parallel (when VPR is built with TBB). The recorded edges are
+    //then committed in the same item order as a serial build, so the resulting RR graph
+    //(and any RR graph file written from it) does not depend on the number of threads.
+    std::vector<t_rr_build_result> results;
 
     /* If Fc gets clipped, this will be flagged to true */
     *Fc_clipped = false;
 
     /* Connection SINKS and SOURCES to their pins. */
     for (size_t i = 0; i < grid.width(); ++i) {
-        for (size_t j = 0; j < grid.height(); ++j) {
-            build_rr_sinks_sources(i, j, L_rr_node, rr_edges_to_create, L_rr_node_indices,
-                    delayless_switch, grid);
+        build_rr_items(results, grid.height(), true,
+            [&](size_t j, t_rr_build_result& result) {
+                build_rr_sinks_sources(i, j, L_rr_node, result.edges, result.rcs, L_rr_node_indices,
+                        delayless_switch, grid);
+            });
 
-            //Create the actual SOURCE->OPIN, IPIN->SINK edges
-            uniquify_edges(rr_edges_to_create);
-            alloc_and_load_edges(L_rr_node, rr_edges_to_create);
-            rr_edges_to_create.clear();
-        }
+        //Create the actual SOURCE->OPIN, IPIN->SINK edges
+        commit_rr_build_results(L_rr_node, results);
     }
 
-
-
     /* Build opins */
+    //Note that the uni-directional OPINs rotate through the channel wires via the shared
+    //Fc_xofs/Fc_yofs offsets, and so must be built serially
     for (size_t i = 0; i < grid.width(); ++i) {
-        for (size_t j = 0; j < grid.height(); ++j) {
-            for (e_side side : SIDES) {
+        build_rr_items(results, grid.height() * NUM_SIDES, BI_DIRECTIONAL == directionality,
+            [&](size_t item, t_rr_build_result& result) {
+                size_t j = item / NUM_SIDES;
+                e_side side = SIDES[item % NUM_SIDES];
                 if (BI_DIRECTIONAL == directionality) {
                     build_bidir_rr_opins(i, j, side, L_rr_node_indices, L_rr_node,
-                            opin_to_track_map, Fc_out, rr_edges_to_create, chan_details_x, chan_details_y,
+                            opin_to_track_map, Fc_out, result.edges, chan_details_x, chan_details_y,
                             grid,
                             directs, num_directs, clb_to_clb_directs, num_seg_types);
                 } else {
                     VTR_ASSERT(UNI_DIRECTIONAL == directionality);
-                    bool clipped;
                     build_unidir_rr_opins(i, j, side, grid, Fc_out, max_chan_width,
                             chan_details_x, chan_details_y, Fc_xofs, Fc_yofs,
-                            rr_edges_to_create, &clipped, L_rr_node_indices, L_rr_node,
+                            result.edges, &result.Fc_clipped, L_rr_node_indices, L_rr_node,
                             directs, num_directs, clb_to_clb_directs, num_seg_types);
-                    if (clipped) {
-                        *Fc_clipped = true;
-                    }
                 }
+            });
 
-                //Create the actual OPIN->CHANX/CHANY edges
-                uniquify_edges(rr_edges_to_create);
-                alloc_and_load_edges(L_rr_node, rr_edges_to_create);
-                rr_edges_to_create.clear();
-
+        for (const t_rr_build_result& result : results) {
+            if (result.Fc_clipped) {
+                *Fc_clipped = true;
             }
         }
+
+        //Create the actual OPIN->CHANX/CHANY edges
+        commit_rr_build_results(L_rr_node, results);
     }
 
     /* Build channels */
+    //Each channel segment only loads the wires starting there, and only updates the
+    //switch block pattern entries of those wires, so segments can be built in parallel
     VTR_ASSERT(Fs % 3 == 0);
     for (size_t i = 0; i < grid.width() - 1; ++i) {
-        for (size_t j = 0; j < grid.height() - 1; ++j) {
-            if (i > 0) {
-                int tracks_per_chan = ((is_global_graph) ? 1 : chan_width.x_list[j]);
-                build_rr_chan(i, j, CHANX, track_to_pin_lookup, sb_conn_map, switch_block_conn,
-                        CHANX_COST_INDEX_START,
-                        max_chan_width, grid, tracks_per_chan,
-                        sblock_pattern, Fs / 3, chan_details_x, chan_details_y,
-                        L_rr_node_indices, rr_edges_to_create, L_rr_node,
-                        wire_to_ipin_switch,
-                        directionality);
-
-                //Create the actual CHAN->CHAN edges
-                uniquify_edges(rr_edges_to_create);
-                alloc_and_load_edges(L_rr_node, rr_edges_to_create);
-                rr_edges_to_create.clear();
-
-            }
-            if (j > 0) {
-                int tracks_per_chan = ((is_global_graph) ? 1 : chan_width.y_list[i]);
-                build_rr_chan(i, j, CHANY, track_to_pin_lookup, sb_conn_map, switch_block_conn,
-                        CHANX_COST_INDEX_START + num_seg_types,
-                        max_chan_width, grid, tracks_per_chan,
-                        sblock_pattern, Fs / 3, chan_details_x, chan_details_y,
-                        L_rr_node_indices, rr_edges_to_create, L_rr_node,
-                        wire_to_ipin_switch,
-                        directionality);
-
-                //Create the actual CHAN->CHAN edges
-                uniquify_edges(rr_edges_to_create);
-                alloc_and_load_edges(L_rr_node, rr_edges_to_create);
-                rr_edges_to_create.clear();
-            }
-        }
+        build_rr_items(results, 2 * (grid.height() - 1), true,
+            [&](size_t item, t_rr_build_result& result) {
+                size_t j = item / 2;
+                if (item % 2 == 0) {
+                    if (i > 0) {
+                        int tracks_per_chan = ((is_global_graph) ? 1 : chan_width.x_list[j]);
+                        build_rr_chan(i, j, CHANX, track_to_pin_lookup, sb_conn_map, switch_block_conn,
+                                CHANX_COST_INDEX_START,
+                                max_chan_width, grid, tracks_per_chan,
+                                sblock_pattern, Fs / 3, chan_details_x, chan_details_y,
+                                L_rr_node_indices, result.edges, result.rcs, L_rr_node,
+                                wire_to_ipin_switch,
+                                directionality);
+                    }
+                } else {
+                    if (j > 0) {
+                        int tracks_per_chan = ((is_global_graph) ? 1 : chan_width.y_list[i]);
+                        build_rr_chan(i, j, CHANY, track_to_pin_lookup, sb_conn_map, switch_block_conn,
+                                CHANX_COST_INDEX_START + num_seg_types,
+                                max_chan_width, grid, tracks_per_chan,
+                                sblock_pattern, Fs / 3, chan_details_x, chan_details_y,
+                                L_rr_node_indices, result.edges, result.rcs, L_rr_node,
+                                wire_to_ipin_switch,
+                                directionality);
+                    }
+                }
+            });
 
+        //Create the actual CHAN->CHAN edges
+        commit_rr_build_results(L_rr_node, results);
     }
 
     init_fan_in(L_rr_node, num_nodes);
@@ -1345,11 +1381,14 @@ void free_rr_graph() {
     device_ctx.num_rr_switches = 0;
 
     device_ctx.switch_fanin_remap.clear();
+
+    free_route_check_structs();
 }
 
 static void build_rr_sinks_sources(const int i, const int j,
         std::vector<t_rr_node>& L_rr_node, 
         t_rr_edge_info_set& rr_edges_to_create,
+        t_rr_rc_info_set& rr_rcs_to_create,
         const t_rr_node_indices& L_rr_node_indices,
         const int delayless_switch, const DeviceGrid& grid) {
 
@@ -1415,7 +1454,7 @@ static void build_rr_sinks_sources(const int i, const int j,
         L_rr_node[inode].set_coordinates(i, j, i + type->width - 1, j + type->height - 1);
         float R = 0.;
         float C = 0.;
-        L_rr_node[inode].set_rc_index(find_create_rr_rc_data(R, C));
+        rr_rcs_to_create.emplace_back(inode, R, C);
         L_rr_node[inode].set_ptc_num(iclass);
     }
 
@@ -1459,7 +1498,7 @@ static void build_rr_sinks_sources(const int i, const int j,
                         L_rr_node[inode].set_capacity(1);
                         float R = 0.;
                         float C = 0.;
-                        L_rr_node[inode].set_rc_index(find_create_rr_rc_data(R, C));
+                        rr_rcs_to_create.emplace_back(inode, R, C);
                         L_rr_node[inode].set_ptc_num(ipin);
 
                         //Note that we store the grid tile location and side where the pin is located,
@@ -1509,6 +1548,7 @@ static void build_rr_chan(const int x_coord, const int y_coord, const t_rr_type
         const t_chan_details& chan_details_x, const t_chan_details& chan_details_y,
         const t_rr_node_indices& L_rr_node_indices,
         t_rr_edge_info_set& rr_edges_to_create,
+        t_rr_rc_info_set& rr_rcs_to_create,
         std::vector<t_rr_node>& L_rr_node,
         const int wire_to_ipin_switch,
         const enum e_directionality directionality) {
@@ -1659,7 +1699,7 @@ static void build_rr_chan(const int x_coord, const int y_coord, const t_rr_type
         int length = end - start + 1;
         float R = length * seg_details[track].Rmetal();
         float C = length * seg_details[track].Cmetal();
-        L_rr_node[node].set_rc_index(find_create_rr_rc_data(R, C));
+        rr_rcs_to_create.emplace_back(node, R, C);
 
         L_rr_node[node].set_ptc_num(track);
         L_rr_node[node].set_type(chan_type);
@@ -1667,63 +1707,138 @@ static void build_rr_chan(const int x_coord, const int y_coord, const t_rr_type
     }
 }
 
-void uniquify_edges(t_rr_edge_info_set& rr_edges_to_create) {
-    std::sort(rr_edges_to_create.begin(), rr_edges_to_create.end());
-    rr_edges_to_create.erase(std::unique(rr_edges_to_create.begin(), rr_edges_to_create.end()), rr_edges_to_create.end());
+/* Builds num_items units of RR graph work (in parallel if requested and VPR is built
+ * with TBB), recording the uniquified edges and RC data of item i in results[i] */
+template<typename Fn>
+static void build_rr_items(std::vector<t_rr_build_result>& results, const size_t num_items,
+        const bool parallel, const Fn& build_item) {
+    results.clear();
+    results.resize(num_items);
+
+    auto run_item = [&](size_t item) {
+        build_item(item, results[item]);
+        uniquify_edges(results[item].edges);
+    };
+
+#if defined(TATUM_USE_TBB)
+    if (parallel) {
+        tbb::parallel_for(size_t(0), num_items, run_item);
+        return;
+    }
+#else
+    (void) parallel;
+#endif
+    for (size_t item = 0; item < num_items; ++item) {
+        run_item(item);
+    }
 }
 
-void alloc_and_load_edges(std::vector<t_rr_node>& L_rr_node,
-        const t_rr_edge_info_set& rr_edges_to_create) {
+/* Creates the RC data and edges recorded by a set of build items.
+ *
+ * Edges are created in two passes. The first collects the runs of edges leaving each
+ * node (a node's edges may be recorded by several items, e.g. the reverse edges of
+ * bi-directional switches) and so counts each node's edges; the second sizes each
+ * node's edge array exactly once and fills it, in parallel across nodes. A node's
+ * edges are ordered by item, then as sorted within the item, exactly as if each item's
+ * edges were created in turn. */
+static void commit_rr_build_results(std::vector<t_rr_node>& L_rr_node,
+        const std::vector<t_rr_build_result>& results) {
+
+    //RC data indices are assigned on creation, so create them in item order
+    for (const t_rr_build_result& result : results) {
+        for (const t_rr_rc_info& rc : result.rcs) {
+            L_rr_node[rc.node].set_rc_index(find_create_rr_rc_data(rc.R, rc.C));
+        }
+    }
+
+    //A contiguous range of (sorted) edges from the same node, recorded by one item
+    struct t_edge_run {
+        int node;
+        size_t item;
+        size_t begin;
+        size_t end;
+    };
 
-    /* Sets up all the edge related information for rr_node */
+    //Pass 1: collect each node's runs of edges
+    std::vector<t_edge_run> runs;
+    for (size_t item = 0; item < results.size(); ++item) {
+        const t_rr_edge_info_set& edges = results[item].edges;
+        VTR_ASSERT_SAFE(std::is_sorted(edges.begin(), edges.end()));
 
-    struct compare_from_node {
-        auto operator()(const t_rr_edge_info& lhs, const int from_node) {
-            return lhs.from_node < from_node;
-        }
-        auto operator()(const int from_node, const t_rr_edge_info& rhs) {
-            return from_node < rhs.from_node;
+        for (size_t begin = 0; begin < edges.size();) {
+            size_t end = begin + 1;
+            while (end < edges.size() && edges[end].from_node == edges[begin].from_node) {
+                ++end;
+            }
+            runs.push_back({edges[begin].from_node, item, begin, end});
+            begin = end;
         }
-    };
-
-    std::set<int> from_nodes;
-    for (auto& edge : rr_edges_to_create) {
-        from_nodes.insert(edge.from_node);
     }
+    //Stable, so each node's runs remain in item order
+    std::stable_sort(runs.begin(), runs.end(),
+        [](const t_edge_run& lhs, const t_edge_run& rhs) {
+            return lhs.node < rhs.node;
+        });
 
-    VTR_ASSERT_SAFE(std::is_sorted(rr_edges_to_create.begin(), rr_edges_to_create.end()));
-
-    for (int inode : from_nodes) {
-
-        auto edge_range = std::equal_range(rr_edges_to_create.begin(), rr_edges_to_create.end(), inode, compare_from_node());
+    std::vector<size_t> node_run_starts;
+    for (size_t irun = 0; irun < runs.size(); ++irun) {
+        if (irun == 0 || runs[irun].node != runs[irun - 1].node) {
+            node_run_starts.push_back(irun);
+        }
+    }
+    node_run_starts.push_back(runs.size());
 
-        size_t edge_count = std::distance(edge_range.first, edge_range.second);
+    //Pass 2: size and fill each node's edges
+    auto load_node_edges = [&](size_t inode_runs) {
+        size_t first_run = node_run_starts[inode_runs];
+        size_t last_run = node_run_starts[inode_runs + 1];
+        t_rr_node& node = L_rr_node[runs[first_run].node];
 
-        if (L_rr_node[inode].num_edges() == 0) {
+        if (node.num_edges() == 0) {
             //Create initial edges
             //
             //Note that we do this in bulk instead of via add_edge() to reduce
             //memory fragmentation
-
-            L_rr_node[inode].set_num_edges(edge_count);
+            size_t edge_count = 0;
+            for (size_t irun = first_run; irun < last_run; ++irun) {
+                edge_count += runs[irun].end - runs[irun].begin;
+            }
+            node.set_num_edges(edge_count);
 
             int iedge = 0;
-            for (auto itr = edge_range.first; itr != edge_range.second; ++itr) {
-                VTR_ASSERT(itr->from_node == inode);
-
-                L_rr_node[inode].set_edge_sink_node(iedge, itr->to_node);
-                L_rr_node[inode].set_edge_switch(iedge, itr->switch_type);
-                ++iedge;
+            for (size_t irun = first_run; irun < last_run; ++irun) {
+                const t_rr_edge_info_set& edges = results[runs[irun].item].edges;
+                for (size_t iedge_info = runs[irun].begin; iedge_info < runs[irun].end; ++iedge_info) {
+                    node.set_edge_sink_node(iedge, edges[iedge_info].to_node);
+                    node.set_edge_switch(iedge, edges[iedge_info].switch_type);
+                    ++iedge;
+                }
             }
         } else {
-            //Add new edge incrementally
-            //
-            //This should occur relatively rarely (e.g. a backward bidir edge) so memory fragmentation shouldn't be a big problem
-            for (auto itr = edge_range.first; itr != edge_range.second; ++itr) {
-                L_rr_node[inode].add_edge(itr->to_node, itr->switch_type);
+            //Add new edges incrementally (the node already has edges from a previous
+            //set of items, e.g. a backward bidir edge)
+            for (size_t irun = first_run; irun < last_run; ++irun) {
+                const t_rr_edge_info_set& edges = results[runs[irun].item].edges;
+                for (size_t iedge_info = runs[irun].begin; iedge_info < runs[irun].end; ++iedge_info) {
+                    node.add_edge(edges[iedge_info].to_node, edges[iedge_info].switch_type);
+                }
             }
         }
+    };
+
+    size_t num_nodes_with_edges = node_run_starts.size() - 1;
+#if defined(TATUM_USE_TBB)
+    tbb::parallel_for(size_t(0), num_nodes_with_edges, load_node_edges);
+#else
+    for (size_t inode_runs = 0; inode_runs < num_nodes_with_edges; ++inode_runs) {
+        load_node_edges(inode_runs);
     }
+#endif
+}
+
+void uniquify_edges(t_rr_edge_info_set& rr_edges_to_create) {
+    std::sort(rr_edges_to_create.begin(), rr_edges_to_create.end());
+    rr_edges_to_create.erase(std::unique(rr_edges_to_create.begin(), rr_edges_to_create.end()), rr_edges_to_create.end());
 }
 
 /* allocate pin to track map for each segment type individually and then combine into a single
@@ -1786,11 +1786,13 @@ static int get_track_to_chan_seg(
     }
 
     /* get coordinate to index into the SB map */
+    //Note that the map is only searched (never modified), since the channels are built in parallel
     Switchblock_Lookup sb_coord(tile_x, tile_y, from_side, to_side);
-    if (sb_conn_map->count(sb_coord) > 0) {
+    auto sb_conn_iter = sb_conn_map->find(sb_coord);
+    if (sb_conn_iter != sb_conn_map->end()) {
         /* get reference to the connections vector which lists all destination wires for a given source wire
            at a specific coordinate sb_coord */
-        vector<t_switchblock_edge> &conn_vector = (*sb_conn_map)[sb_coord];
+        const vector<t_switchblock_edge> &conn_vector = sb_conn_iter->second;
 
         /* go through the connections... */
         for (int iconn = 0; iconn < (int) conn_vector.size(); ++iconn) {
@@ -1,8 +1,15 @@
+#include <algorithm>
+#include <array>
+#include <cmath>
+
 #include "spatial_route_tree_lookup.h"
 
 #include "globals.h"
+#include "route_tree_timing.h"
 
-SpatialRouteTreeLookup build_route_tree_spatial_lookup(ClusterNetId net, t_rt_node* rt_root) {
+static std::array<size_t,2> route_tree_spatial_lookup_dims(ClusterNetId net);
+
+static std::array<size_t,2> route_tree_spatial_lookup_dims(ClusterNetId net) {
     constexpr float BIN_AREA_PER_SINK_FACTOR = 4;
 
     auto& device_ctx = g_vpr_ctx.device();
@@ -21,40 +28,73 @@ SpatialRouteTreeLookup build_route_tree_spatial_lookup(ClusterNetId net, t_rt_no
     size_t bins_x = std::ceil(device_ctx.grid.width() / bin_dim);
     size_t bins_y = std::ceil(device_ctx.grid.height() / bin_dim);
 
-    SpatialRouteTreeLookup spatial_lookup({bins_x, bins_y});
+    return {bins_x, bins_y};
+}
+
+SpatialRouteTreeLookup build_route_tree_spatial_lookup(ClusterNetId net, t_rt_node* rt_root) {
+    SpatialRouteTreeLookup spatial_lookup(route_tree_spatial_lookup_dims(net));
 
-    update_route_tree_spatial_lookup_recur(rt_root, spatial_lookup);
+    add_route_tree_to_spatial_lookup(rt_root, spatial_lookup);
 
     return spatial_lookup;
 }
 
-//Adds the sub-tree rooted at rt_node to the spatial look-up
-void update_route_tree_spatial_lookup_recur(t_rt_node* rt_node, SpatialRouteTreeLookup& spatial_lookup) {
-    auto& device_ctx = g_vpr_ctx.device();
-
-    auto& rr_node = device_ctx.rr_nodes[rt_node->inode];
-
-    int bin_xlow = grid_to_bin_x(rr_node.xlow(), spatial_lookup);
-    int bin_ylow = grid_to_bin_y(rr_node.ylow(), spatial_lookup);
-    int bin_xhigh = grid_to_bin_x(rr_node.xhigh(), spatial_lookup);
-    int bin_yhigh = grid_to_bin_y(rr_node.yhigh(), spatial_lookup);
+void update_route_tree_spatial_lookup(ClusterNetId net, t_rt_node* rt_root, SpatialRouteTreeLookup& spatial_lookup) {
+    auto dims = route_tree_spatial_lookup_dims(net);
 
-    spatial_lookup[bin_xlow][bin_ylow].push_back(rt_node);
+    if (spatial_lookup.empty() || spatial_lookup.dim_size(0) != dims[0] || spatial_lookup.dim_size(1) != dims[1]) {
+        //Nothing usable from the last routing (first time through, or the bounding box changed)
+        spatial_lookup = build_route_tree_spatial_lookup(net, rt_root);
+        return;
+    }
 
-    //We current look at the start/end locations of the RR nodes and add the node
-    //to both bins if they are different
-    //
-    //TODO: Depending on bin size, long wires may end up being added only to bins at
-    //      their start/end and may pass through bins along their length to which they
-    //      are not added. If this becomes an issues, reconsider how we add nodes to
-    //      bins
-    if (bin_xhigh != bin_xlow || bin_yhigh != bin_ylow) {
-        spatial_lookup[bin_xhigh][bin_yhigh].push_back(rt_node);
+    //The route tree is what remains of the previous routing, so the look-up
+    //already holds every node in it; only the pruned nodes need removing.
+    for (size_t bin_x = 0; bin_x < spatial_lookup.dim_size(0); ++bin_x) {
+        for (size_t bin_y = 0; bin_y < spatial_lookup.dim_size(1); ++bin_y) {
+            auto& bin = spatial_lookup[bin_x][bin_y];
+
+            bin.erase(std::remove_if(bin.begin(), bin.end(),
+                                     [](int inode) {
+                                         return rr_node_to_route_tree_node(inode) == nullptr;
+                                     }),
+                      bin.end());
+        }
     }
+}
+
+//Adds the sub-tree rooted at rt_node to the spatial look-up
+void add_route_tree_to_spatial_lookup(t_rt_node* rt_node, SpatialRouteTreeLookup& spatial_lookup) {
+    auto& device_ctx = g_vpr_ctx.device();
 
-    //Recurse
-    for (t_linked_rt_edge* rt_edge = rt_node->u.child_list; rt_edge != nullptr; rt_edge = rt_edge->next) {
-        update_route_tree_spatial_lookup_recur(rt_edge->child, spatial_lookup);
+    std::vector<t_rt_node*> stack = {rt_node};
+    while (!stack.empty()) {
+        rt_node = stack.back();
+        stack.pop_back();
+
+        auto& rr_node = device_ctx.rr_nodes[rt_node->inode];
+
+        int bin_xlow = grid_to_bin_x(rr_node.xlow(), spatial_lookup);
+        int bin_ylow = grid_to_bin_y(rr_node.ylow(), spatial_lookup);
+        int bin_xhigh = grid_to_bin_x(rr_node.xhigh(), spatial_lookup);
+        int bin_yhigh = grid_to_bin_y(rr_node.yhigh(), spatial_lookup);
+
+        spatial_lookup[bin_xlow][bin_ylow].push_back(rt_node->inode);
+
+        //We current look at the start/end locations of the RR nodes and add the node
+        //to both bins if they are different
+        //
+        //TODO: Depending on bin size, long wires may end up being added only to bins at
+        //      their start/end and may pass through bins along their length to which they
+        //      are not added. If this becomes an issues, reconsider how we add nodes to
+        //      bins
+        if (bin_xhigh != bin_xlow || bin_yhigh != bin_ylow) {
+            spatial_lookup[bin_xhigh][bin_yhigh].push_back(rt_node->inode);
+        }
+
+        for (t_linked_rt_edge* rt_edge = rt_node->u.child_list; rt_edge != nullptr; rt_edge = rt_edge->next) {
+            stack.push_back(rt_edge->child);
+        }
     }
 }
 
@@ -74,36 +114,55 @@ size_t grid_to_bin_y(size_t grid_y, const SpatialRouteTreeLookup& spatial_lookup
     return grid_y / bin_height;
 }
 
-bool validate_route_tree_spatial_lookup(t_rt_node* rt_node, const SpatialRouteTreeLookup& spatial_lookup) {
+bool validate_route_tree_spatial_lookup(t_rt_node* rt_root, const SpatialRouteTreeLookup& spatial_lookup) {
 
     auto& device_ctx = g_vpr_ctx.device();
 
-    auto& rr_node = device_ctx.rr_nodes[rt_node->inode];
-
-    int bin_xlow = grid_to_bin_x(rr_node.xlow(), spatial_lookup);
-    int bin_ylow = grid_to_bin_y(rr_node.ylow(), spatial_lookup);
-    int bin_xhigh = grid_to_bin_x(rr_node.xhigh(), spatial_lookup);
-    int bin_yhigh = grid_to_bin_y(rr_node.yhigh(), spatial_lookup);
-
     bool valid = true;
 
-    auto& low_bin_rt_nodes = spatial_lookup[bin_xlow][bin_ylow];
-    if (std::find(low_bin_rt_nodes.begin(), low_bin_rt_nodes.end(), rt_node) == low_bin_rt_nodes.end()) {
-        valid = false;
-        VPR_THROW(VPR_ERROR_ROUTE, "Failed to find route tree node %d at (low coord %d,%d) in spatial lookup [bin %d,%d]",
-                rt_node->inode, rr_node.xlow(), rr_node.ylow(), bin_xlow, bin_ylow);
-    }
-
-    auto& high_bin_rt_nodes = spatial_lookup[bin_xhigh][bin_yhigh];
-    if (std::find(high_bin_rt_nodes.begin(), high_bin_rt_nodes.end(), rt_node) == high_bin_rt_nodes.end()) {
-        valid = false;
-        VPR_THROW(VPR_ERROR_ROUTE, "Failed to find route tree node %d at (high coord %d,%d) in spatial lookup [bin %d,%d]",
-                rt_node->inode, rr_node.xhigh(), rr_node.yhigh(), bin_xhigh, bin_yhigh);
+    //Every route tree node must be in the bins covering its end points
+    std::vector<t_rt_node*> stack = {rt_root};
+    while (!stack.empty()) {
+        t_rt_node* rt_node = stack.back();
+        stack.pop_back();
+
+        auto& rr_node = device_ctx.rr_nodes[rt_node->inode];
+
+        int bin_xlow = grid_to_bin_x(rr_node.xlow(), spatial_lookup);
+        int bin_ylow = grid_to_bin_y(rr_node.ylow(), spatial_lookup);
+        int bin_xhigh = grid_to_bin_x(rr_node.xhigh(), spatial_lookup);
+        int bin_yhigh = grid_to_bin_y(rr_node.yhigh(), spatial_lookup);
+
+        auto& low_bin_nodes = spatial_lookup[bin_xlow][bin_ylow];
+        if (std::find(low_bin_nodes.begin(), low_bin_nodes.end(), rt_node->inode) == low_bin_nodes.end()) {
+            valid = false;
+            VPR_THROW(VPR_ERROR_ROUTE, "Failed to find route tree node %d at (low coord %d,%d) in spatial lookup [bin %d,%d]",
+                    rt_node->inode, rr_node.xlow(), rr_node.ylow(), bin_xlow, bin_ylow);
+        }
+
+        auto& high_bin_nodes = spatial_lookup[bin_xhigh][bin_yhigh];
+        if (std::find(high_bin_nodes.begin(), high_bin_nodes.end(), rt_node->inode) == high_bin_nodes.end()) {
+            valid = false;
+            VPR_THROW(VPR_ERROR_ROUTE, "Failed to find route tree node %d at (high coord %d,%d) in spatial lookup [bin %d,%d]",
+                    rt_node->inode, rr_node.xhigh(), rr_node.yhigh(), bin_xhigh, bin_yhigh);
+        }
+
+        for (t_linked_rt_edge* rt_edge = rt_node->u.child_list; rt_edge != nullptr; rt_edge = rt_edge->next) {
+            stack.push_back(rt_edge->child);
+        }
     }
 
-    //Recurse
-    for (t_linked_rt_edge* rt_edge = rt_node->u.child_list; rt_edge != nullptr; rt_edge = rt_edge->next) {
-        valid &= validate_route_tree_spatial_lookup(rt_edge->child, spatial_lookup);
+    //And every node in the look-up must still be part of the route tree
+    for (size_t bin_x = 0; bin_x < spatial_lookup.dim_size(0); ++bin_x) {
+        for (size_t bin_y = 0; bin_y < spatial_lookup.dim_size(1); ++bin_y) {
+            for (int inode : spatial_lookup[bin_x][bin_y]) {
+                if (!rr_node_to_route_tree_node(inode)) {
+                    valid = false;
+                    VPR_THROW(VPR_ERROR_ROUTE, "Stale node %d (not in the route tree) found in spatial lookup [bin %zu,%zu]",
+                            inode, bin_x, bin_y);
+                }
+            }
+        }
     }
 
     return valid;
@@ -8,11 +8,20 @@
 #include "route_tree_type.h"
 
 
-typedef vtr::Matrix<std::vector<t_rt_node*>> SpatialRouteTreeLookup;
+//Bins of the rr node indices used by a net's route tree, keyed by grid location.
+//Indices (rather than route tree nodes) are stored so a net's look-up can outlive
+//the route tree it was built from, and be carried over to the next iteration.
+typedef vtr::Matrix<std::vector<int>> SpatialRouteTreeLookup;
 
 SpatialRouteTreeLookup build_route_tree_spatial_lookup(ClusterNetId net, t_rt_node* rt_root);
 
-void update_route_tree_spatial_lookup_recur(t_rt_node* rt_node, SpatialRouteTreeLookup& spatial_lookup);
+//Brings a look-up kept from the net's previous routing in line with its current
+//(pruned or ripped-up) route tree rooted at rt_root. Nodes no longer in the route
+//tree are dropped; the look-up is only rebuilt from scratch if it is empty or its
+//bins no longer match the net's bounding box.
+void update_route_tree_spatial_lookup(ClusterNetId net, t_rt_node* rt_root, SpatialRouteTreeLookup& spatial_lookup);
+
+void add_route_tree_to_spatial_lookup(t_rt_node* rt_node, SpatialRouteTreeLookup& spatial_lookup);
 
 size_t grid_to_bin_x(size_t grid_x, const SpatialRouteTreeLookup& spatial_lookup);
 size_t grid_to_bin_y(size_t grid_y, const SpatialRouteTreeLookup& spatial_lookup);
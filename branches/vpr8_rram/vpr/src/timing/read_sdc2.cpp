@@ -1,6 +1,8 @@
 #include "read_sdc2.h"
 
 #include <regex>
+#include <algorithm>
+#include <unordered_map>
 
 #include "vtr_log.h"
 #include "vtr_assert.h"
@@ -51,6 +53,152 @@ std::string orig_blif_name(std::string name);
 
 std::regex glob_pattern_to_regex(const std::string& glob_pattern);
 
+//A compiled SDC object name pattern.
+//
+//SDC targets are glob-style patterns which are matched as regexes (see glob_pattern_to_regex()).
+//Most patterns are either literal names or contain only '*' wildcards, which can be matched
+//directly (and looked up in a SdcNameIndex) without running the regex engine.
+//Patterns using any other regex syntax fall back to a std::regex.
+class SdcNamePattern {
+    public:
+        enum class Type {
+            LITERAL, //No wildcards, must match the name exactly
+            GLOB,    //Only '*' wildcards
+            REGEX    //Other regex syntax, matched with std::regex
+        };
+
+    public:
+        SdcNamePattern(const std::string& pattern)
+            : pattern_(pattern) {
+            if (pattern.find_first_of("^$\\+?()[]{}|") != std::string::npos) {
+                type_ = Type::REGEX;
+                regex_ = glob_pattern_to_regex(pattern);
+            } else if (pattern.find('*') != std::string::npos) {
+                type_ = Type::GLOB;
+            } else {
+                type_ = Type::LITERAL;
+            }
+        }
+
+        Type type() const { return type_; }
+        const std::string& pattern() const { return pattern_; }
+
+        //The literal characters every matching name starts with
+        std::string literal_prefix() const {
+            if (type_ == Type::REGEX) return "";
+            return pattern_.substr(0, pattern_.find('*'));
+        }
+
+        bool matches(const std::string& name) const {
+            switch (type_) {
+                case Type::LITERAL:
+                    return name == pattern_;
+                case Type::GLOB:
+                    return glob_match(name);
+                case Type::REGEX:
+                    return std::regex_match(name, regex_);
+                default:
+                    VTR_ASSERT_MSG(false, "Unrecognized SDC name pattern type");
+                    return false;
+            }
+        }
+
+    private:
+        //Matches name against a pattern whose only special character is '*'.
+        //On a mismatch we backtrack to the most recent '*' and let it absorb one more character.
+        bool glob_match(const std::string& name) const {
+            size_t ipat = 0;
+            size_t iname = 0;
+            size_t star_pat = std::string::npos;
+            size_t star_name = 0;
+
+            while (iname < name.size()) {
+                if (ipat < pattern_.size() && pattern_[ipat] == '*') {
+                    star_pat = ipat++;
+                    star_name = iname;
+                } else if (ipat < pattern_.size() && pattern_[ipat] == name[iname]) {
+                    ++ipat;
+                    ++iname;
+                } else if (star_pat != std::string::npos) {
+                    ipat = star_pat + 1;
+                    iname = ++star_name;
+                } else {
+                    return false;
+                }
+            }
+
+            while (ipat < pattern_.size() && pattern_[ipat] == '*') {
+                ++ipat;
+            }
+            return ipat == pattern_.size();
+        }
+
+    private:
+        std::string pattern_;
+        Type type_;
+        std::regex regex_;
+};
+
+//An index over a set of named netlist objects, used to resolve SDC name patterns.
+//
+//The names are kept sorted, so the candidates for a literal name or for a pattern with a
+//literal prefix (e.g. 'top|u_core|*') form a contiguous range found by binary search, and
+//only that range needs to be checked against the pattern.
+template<typename Id>
+class SdcNameIndex {
+    public:
+        void add(const std::string& name, Id id) {
+            entries_.emplace_back(name, id);
+            sorted_ = false;
+        }
+
+        size_t size() const { return entries_.size(); }
+
+        //Calls fn(name, id) for every indexed object matching pattern.
+        //Returns true if any object matched.
+        template<typename Fn>
+        bool for_each_match(const SdcNamePattern& pattern, Fn&& fn) {
+            if (!sorted_) {
+                std::sort(entries_.begin(), entries_.end());
+                sorted_ = true;
+            }
+
+            auto begin = entries_.begin();
+            auto end = entries_.end();
+
+            std::string prefix = pattern.literal_prefix();
+            if (!prefix.empty()) {
+                //Names starting with prefix sort together, starting at the first name >= prefix
+                begin = std::lower_bound(entries_.begin(), entries_.end(), prefix,
+                                         [](const Entry& entry, const std::string& key) {
+                                             return entry.first < key;
+                                         });
+            }
+
+            bool found = false;
+            for (auto iter = begin; iter != end; ++iter) {
+                if (iter->first.compare(0, prefix.size(), prefix) != 0) break; //Past the prefix range
+
+                if (pattern.type() == SdcNamePattern::Type::LITERAL && iter->first.size() != prefix.size()) {
+                    //A longer name with the literal as prefix; longer names sort after the literal itself
+                    break;
+                }
+
+                if (pattern.matches(iter->first)) {
+                    found = true;
+                    fn(iter->first, iter->second);
+                }
+            }
+            return found;
+        }
+
+    private:
+        typedef std::pair<std::string,Id> Entry;
+
+        std::vector<Entry> entries_;
+        bool sorted_ = true;
+};
+
 class SdcParseCallback2 : public sdcparse::Callback {
     public:
         SdcParseCallback2(const AtomNetlist& netlist,
@@ -66,7 +214,13 @@ class SdcParseCallback2 : public sdcparse::Callback {
         //Start of parsing
         void start_parse() override {
             netlist_clock_drivers_ = find_netlist_logical_clock_drivers(netlist_);
-            netlist_primary_ios_ = find_netlist_primary_ios(netlist_);
+            for (AtomPinId clock_pin : netlist_clock_drivers_) {
+                netlist_clock_index_.add(netlist_.net_name(netlist_.pin_net(clock_pin)), clock_pin);
+            }
+
+            for (const auto& kv : find_netlist_primary_ios(netlist_)) {
+                netlist_primary_io_index_.add(kv.first, kv.second);
+            }
         }
 
         //Sets current filename
@@ -100,38 +254,40 @@ class SdcParseCallback2 : public sdcparse::Callback {
             } else {
                 //Create a netlist clock for every matching netlist clock
                 for(const std::string& clock_name_glob_pattern : cmd.targets.strings) {
-                    bool found = false;
-
-                    //We interpret each SDC target as glob-style pattern matches, which we
-                    //convert to a regex
-                    auto clock_name_regex = glob_pattern_to_regex(clock_name_glob_pattern);
-
-                    //Look for matching netlist clocks
-                    for(AtomPinId clock_pin : netlist_clock_drivers_) {
+                    //We interpret each SDC target as glob-style pattern matches
+                    const SdcNamePattern& clock_name_pattern = name_pattern(clock_name_glob_pattern);
+
+                    //Look for matching netlist clocks. Clocks are created in netlist clock driver order
+                    //(rather than name order) so clock domain ids do not depend on how they were matched
+                    std::vector<AtomPinId> matching_clock_pins;
+                    bool found = netlist_clock_index_.for_each_match(clock_name_pattern,
+                                                                     [&](const std::string& /*name*/, AtomPinId clock_pin) {
+                                                                         matching_clock_pins.push_back(clock_pin);
+                                                                     });
+                    std::sort(matching_clock_pins.begin(), matching_clock_pins.end());
+
+                    for(AtomPinId clock_pin : matching_clock_pins) {
                         AtomNetId clock_net = netlist_.pin_net(clock_pin);
                         const auto& clock_name = netlist_.net_name(clock_net);
 
-                        if(std::regex_match(clock_name, clock_name_regex)) {
-                            found = true;
-                            //Create netlist clock
-                            tatum::DomainId netlist_clk = tc_.create_clock_domain(clock_name);
+                        //Create netlist clock
+                        tatum::DomainId netlist_clk = tc_.create_clock_domain(clock_name);
 
-                            if(sdc_clocks_.count(netlist_clk)) {
-                                vpr_throw(VPR_ERROR_SDC, fname_.c_str(), lineno_,
-                                          "Found duplicate netlist clock definition for clock '%s' matching target pattern '%s'",
-                                          clock_name.c_str(), clock_name_glob_pattern.c_str());
-                            }
+                        if(sdc_clocks_.count(netlist_clk)) {
+                            vpr_throw(VPR_ERROR_SDC, fname_.c_str(), lineno_,
+                                      "Found duplicate netlist clock definition for clock '%s' matching target pattern '%s'",
+                                      clock_name.c_str(), clock_name_glob_pattern.c_str());
+                        }
 
-                            //Set the clock source
-                            AtomPinId clock_driver = netlist_.net_driver(clock_net);
-                            tatum::NodeId clock_source = lookup_.atom_pin_tnode(clock_driver);
-                            VTR_ASSERT(clock_source);
-                            tc_.set_clock_domain_source(clock_source, netlist_clk);
+                        //Set the clock source
+                        AtomPinId clock_driver = netlist_.net_driver(clock_net);
+                        tatum::NodeId clock_source = lookup_.atom_pin_tnode(clock_driver);
+                        VTR_ASSERT(clock_source);
+                        tc_.set_clock_domain_source(clock_source, netlist_clk);
 
 
-                            //Save the mapping to the clock info
-                            sdc_clocks_[netlist_clk] = cmd;
-                        }
+                        //Save the mapping to the clock info
+                        sdc_clocks_[netlist_clk] = cmd;
                     }
 
                     if(!found) {
@@ -792,20 +948,10 @@ class SdcParseCallback2 : public sdcparse::Callback {
 
             std::set<AtomPinId> pins;
             for (const auto& port_pattern : port_group.strings) {
-                std::regex port_regex = glob_pattern_to_regex(port_pattern);
-
-                bool found = false;
-                for(const auto& kv : netlist_primary_ios_) {
-
-                    const std::string& io_name = kv.first;
-                    if(std::regex_match(io_name, port_regex)) {
-                        found = true;
-
-                        AtomPinId pin = kv.second;
-
-                        pins.insert(pin);
-                    }
-                }
+                bool found = netlist_primary_io_index_.for_each_match(name_pattern(port_pattern),
+                                                                      [&](const std::string& /*io_name*/, AtomPinId pin) {
+                                                                          pins.insert(pin);
+                                                                      });
 
                 if(!found) {
                     VTR_LOGF_WARN(fname_.c_str(), lineno_,
@@ -830,13 +976,15 @@ class SdcParseCallback2 : public sdcparse::Callback {
             }
 
             for (const auto& clock_glob_pattern : clock_group.strings) {
-                std::regex clock_regex = glob_pattern_to_regex(clock_glob_pattern);
+                const SdcNamePattern& clock_pattern = name_pattern(clock_glob_pattern);
 
+                //Clock domains are still being created while parsing (and there are few of them),
+                //so they are searched directly rather than indexed
                 bool found = false;
                 for(tatum::DomainId domain : tc_.clock_domains()) {
 
                     const std::string& clock_name = tc_.clock_domain_name(domain);
-                    if(std::regex_match(clock_name, clock_regex)) {
+                    if(clock_pattern.matches(clock_name)) {
                         found = true;
 
                         domains.insert(domain);
@@ -865,20 +1013,18 @@ class SdcParseCallback2 : public sdcparse::Callback {
                          "Expected pin collection via get_pins");
             }
 
-            for (const auto& pin_pattern : pin_group.strings) {
-                std::regex pin_regex = glob_pattern_to_regex(pin_pattern);
-
-                bool found = false;
+            if (netlist_pin_index_.size() == 0) {
+                //Only built on first use, since most SDC files never refer to individual pins
                 for(AtomPinId pin : netlist_.pins()) {
-
-                    const std::string& pin_name = netlist_.pin_name(pin);
-
-                    if(std::regex_match(pin_name, pin_regex)) {
-                        found = true;
-
-                        pins.insert(pin);
-                    }
+                    netlist_pin_index_.add(netlist_.pin_name(pin), pin);
                 }
+            }
+
+            for (const auto& pin_pattern : pin_group.strings) {
+                bool found = netlist_pin_index_.for_each_match(name_pattern(pin_pattern),
+                                                               [&](const std::string& /*pin_name*/, AtomPinId pin) {
+                                                                   pins.insert(pin);
+                                                               });
 
                 if(!found) {
                     VTR_LOGF_WARN(fname_.c_str(), lineno_,
@@ -890,6 +1036,16 @@ class SdcParseCallback2 : public sdcparse::Callback {
             return pins;
         }
 
+        //Returns the compiled form of an SDC name pattern. Patterns are compiled once and
+        //re-used, since the same names tend to be repeated across many commands
+        const SdcNamePattern& name_pattern(const std::string& pattern) {
+            auto iter = name_patterns_.find(pattern);
+            if (iter == name_patterns_.end()) {
+                iter = name_patterns_.emplace(pattern, SdcNamePattern(pattern)).first;
+            }
+            return iter->second;
+        }
+
         std::set<tatum::DomainId> get_all_clocks() {
             auto domains = tc_.clock_domains();
             return std::set<tatum::DomainId>(domains.begin(), domains.end());
@@ -917,7 +1073,10 @@ class SdcParseCallback2 : public sdcparse::Callback {
 
         std::map<tatum::DomainId,sdcparse::CreateClock> sdc_clocks_;
         std::set<AtomPinId> netlist_clock_drivers_;
-        std::map<std::string,AtomPinId> netlist_primary_ios_;
+        SdcNameIndex<AtomPinId> netlist_clock_index_;
+        SdcNameIndex<AtomPinId> netlist_primary_io_index_;
+        SdcNameIndex<AtomPinId> netlist_pin_index_;
+        std::unordered_map<std::string,SdcNamePattern> name_patterns_;
 
         std::set<std::pair<tatum::DomainId,tatum::DomainId>> disabled_domain_pairs_;
         std::map<std::pair<tatum::DomainId,tatum::DomainId>, float> setup_override_constraints_;
@@ -0,0 +1,201 @@
+#include "catch.hpp"
+
+#include <cmath>
+#include <string>
+#include <vector>
+
+#include "vpr_types.h"
+#include "globals.h"
+#include "analytic_placement.h"
+
+namespace {
+
+constexpr int GRID_WIDTH = 6;
+constexpr int GRID_HEIGHT = 6;
+
+//Sets up a GRID_WIDTH x GRID_HEIGHT device of a single type (of capacity 1) and an empty
+//placement of num_blocks clustered blocks of that type
+struct t_test_device {
+    explicit t_test_device(int num_blocks) {
+        type.name = const_cast<char*>("test_clb");
+        type.index = 0;
+        type.capacity = 1;
+        type.num_pins = 0;
+
+        auto& device_ctx = g_vpr_ctx.mutable_device();
+        vtr::Matrix<t_grid_tile> grid({GRID_WIDTH, GRID_HEIGHT});
+        for (int x = 0; x < GRID_WIDTH; ++x) {
+            for (int y = 0; y < GRID_HEIGHT; ++y) {
+                grid[x][y].type = &type;
+            }
+        }
+        device_ctx.grid = DeviceGrid("test_grid", grid);
+
+        auto& cluster_ctx = g_vpr_ctx.mutable_clustering();
+        cluster_ctx.clb_nlist = ClusteredNetlist("test_netlist", "test_netlist_id");
+        for (int iblk = 0; iblk < num_blocks; ++iblk) {
+            blocks.push_back(cluster_ctx.clb_nlist.create_block(("blk" + std::to_string(iblk)).c_str(), nullptr, &type));
+        }
+
+        auto& place_ctx = g_vpr_ctx.mutable_placement();
+        place_ctx.block_locs.clear();
+        place_ctx.block_locs.resize(num_blocks);
+        place_ctx.grid_blocks.resize({GRID_WIDTH, GRID_HEIGHT});
+        for (int x = 0; x < GRID_WIDTH; ++x) {
+            for (int y = 0; y < GRID_HEIGHT; ++y) {
+                place_ctx.grid_blocks[x][y].usage = 0;
+                place_ctx.grid_blocks[x][y].blocks.assign(type.capacity, EMPTY_BLOCK_ID);
+            }
+        }
+    }
+
+    ~t_test_device() {
+        g_vpr_ctx.mutable_device().grid.clear();
+        g_vpr_ctx.mutable_clustering().clb_nlist = ClusteredNetlist();
+        g_vpr_ctx.mutable_placement().block_locs.clear();
+        g_vpr_ctx.mutable_placement().grid_blocks.clear();
+    }
+
+    t_type_descriptor type;
+    std::vector<ClusterBlockId> blocks;
+};
+
+//Occupies (x, y) with blk_id, as if it had been placed there
+void occupy(ClusterBlockId blk_id, int x, int y) {
+    auto& place_ctx = g_vpr_ctx.mutable_placement();
+    place_ctx.grid_blocks[x][y].blocks[0] = blk_id;
+    place_ctx.grid_blocks[x][y].usage = 1;
+    place_ctx.block_locs[blk_id].x = x;
+    place_ctx.block_locs[blk_id].y = y;
+    place_ctx.block_locs[blk_id].z = 0;
+}
+
+//Checks every member of macro is placed at its offset from the head, and recorded in the grid
+void check_macro_offsets(const t_pl_macro& macro) {
+    auto& place_ctx = g_vpr_ctx.placement();
+    const t_pl_macro_member& head = macro.members[0];
+    const t_block_loc& head_loc = place_ctx.block_locs[head.blk_index];
+    REQUIRE(head_loc.x != OPEN);
+
+    for (int imember = 0; imember < macro.num_blocks; ++imember) {
+        const t_pl_macro_member& member = macro.members[imember];
+        const t_block_loc& loc = place_ctx.block_locs[member.blk_index];
+        REQUIRE(loc.x == head_loc.x + member.x_offset - head.x_offset);
+        REQUIRE(loc.y == head_loc.y + member.y_offset - head.y_offset);
+        REQUIRE(loc.z == head_loc.z + member.z_offset - head.z_offset);
+        REQUIRE(place_ctx.grid_blocks[loc.x][loc.y].blocks[loc.z] == member.blk_index);
+    }
+}
+
+}
+
+TEST_CASE("Analytic placement CG solve", "[analytic_placement]") {
+    //A chain of springs, with every variable also anchored to a fixed location (as add_spring()
+    //builds them), which makes a symmetric positive definite tridiagonal system
+    const int num_rows = 20;
+    std::vector<t_matrix_entry> entries;
+    for (int row = 0; row < num_rows; ++row) {
+        entries.push_back({row, row, 3.});
+        if (row > 0) {
+            entries.push_back({row, row - 1, -1.});
+            entries.push_back({row - 1, row, -1.});
+        }
+    }
+    //Duplicate entries are summed
+    entries.push_back({0, 0, 1.});
+    entries.push_back({0, 0, -1.});
+    t_sparse_matrix matrix = build_sparse_matrix(num_rows, entries);
+
+    REQUIRE(matrix.num_rows() == num_rows);
+    REQUIRE(matrix.values.size() == size_t(3 * num_rows - 2));
+    for (int row = 0; row < num_rows; ++row) {
+        REQUIRE(matrix.cols[matrix.diag[row]] == row);
+        REQUIRE(matrix.values[matrix.diag[row]] == 3.);
+    }
+
+    std::vector<double> expected_x(num_rows);
+    for (int row = 0; row < num_rows; ++row) {
+        expected_x[row] = std::sin(0.3 * row) + 0.1 * row;
+    }
+    std::vector<double> b(num_rows, 0.);
+    for (int row = 0; row < num_rows; ++row) {
+        for (int i = matrix.row_starts[row]; i < matrix.row_starts[row + 1]; ++i) {
+            b[row] += matrix.values[i] * expected_x[matrix.cols[i]];
+        }
+    }
+
+    std::vector<double> x(num_rows, 0.);
+    int num_iterations = solve_cg(matrix, b, x);
+    REQUIRE(num_iterations > 0);
+    REQUIRE(num_iterations <= num_rows);
+    for (int row = 0; row < num_rows; ++row) {
+        REQUIRE(x[row] == Approx(expected_x[row]).epsilon(1e-4));
+    }
+
+    //Starting from the solution takes no iterations
+    REQUIRE(solve_cg(matrix, b, x) == 0);
+}
+
+TEST_CASE("Analytic placement macro legalization", "[analytic_placement]") {
+    const int macro_length = 3;
+    t_test_device device(2 * macro_length + 1);
+
+    //A vertical carry chain: each member one tile above the last
+    std::vector<t_pl_macro_member> chain_members;
+    for (int imember = 0; imember < macro_length; ++imember) {
+        chain_members.push_back({device.blocks[imember], 0, imember, 0});
+    }
+    t_pl_macro chain = {macro_length, chain_members.data()};
+
+    //A horizontal macro whose head is not at offset zero
+    std::vector<t_pl_macro_member> row_members;
+    for (int imember = 0; imember < macro_length; ++imember) {
+        row_members.push_back({device.blocks[macro_length + imember], imember + 1, 2, 0});
+    }
+    t_pl_macro row = {macro_length, row_members.data()};
+
+    //Block the location the chain is solved at
+    ClusterBlockId obstacle = device.blocks[2 * macro_length];
+    occupy(obstacle, 2, 3);
+
+    SECTION("macro placed around an obstacle") {
+        REQUIRE(legalize_macro(chain, 2., 2.));
+        check_macro_offsets(chain);
+
+        //Not over the obstacle, and as close to (2, 2) as the chain can go
+        auto& place_ctx = g_vpr_ctx.placement();
+        const t_block_loc& head_loc = place_ctx.block_locs[chain.members[0].blk_index];
+        REQUIRE(std::abs(head_loc.x - 2) + std::abs(head_loc.y - 2) == 1);
+        REQUIRE(place_ctx.grid_blocks[2][3].blocks[0] == obstacle);
+    }
+
+    SECTION("macro solved off the device") {
+        REQUIRE(legalize_macro(row, 4., 10.));
+        check_macro_offsets(row);
+
+        //Its head is pulled back onto the device, with room for the members
+        auto& place_ctx = g_vpr_ctx.placement();
+        const t_block_loc& head_loc = place_ctx.block_locs[row.members[0].blk_index];
+        REQUIRE(head_loc.x == GRID_WIDTH - macro_length);
+        REQUIRE(head_loc.y == GRID_HEIGHT - 1);
+    }
+
+    SECTION("macros placed in turn do not overlap") {
+        REQUIRE(legalize_macro(chain, 1., 1.));
+        REQUIRE(legalize_macro(row, 0., 1.));
+        check_macro_offsets(chain);
+        check_macro_offsets(row);
+    }
+
+    SECTION("macro which cannot fit") {
+        std::vector<t_pl_macro_member> long_members;
+        for (int imember = 0; imember < 2 * macro_length; ++imember) {
+            long_members.push_back({device.blocks[imember], 0, imember, 0});
+        }
+        //Taller than the device
+        long_members.push_back({device.blocks[2 * macro_length], 0, GRID_HEIGHT, 0});
+
+        t_pl_macro long_chain = {int(long_members.size()), long_members.data()};
+        REQUIRE(!legalize_macro(long_chain, 0., 0.));
+    }
+}
@@ -0,0 +1,120 @@
+#include "catch.hpp"
+
+#include <vector>
+using namespace std;
+
+#include "vpr_types.h"
+#include "pack_types.h"
+#include "cluster_router.h"
+
+namespace {
+
+struct t_test_edge {
+    int from;
+    int to;
+};
+
+//A small single-mode cluster: two sources competing for one wire, plus an unconnected source
+//driving a single-terminal net
+//
+//  0 (src A) -> 2, 3      2 (wire) -> 4, 5      4 (sink A)
+//  1 (src B) -> 2         3 (wire) -> 4         5 (sink B)
+//  6 (src C)
+std::vector<t_lb_type_rr_node> build_test_lb_type_graph() {
+    const std::vector<e_lb_rr_type> types = {LB_SOURCE, LB_SOURCE, LB_INTERMEDIATE, LB_INTERMEDIATE, LB_SINK, LB_SINK, LB_SOURCE};
+    const std::vector<t_test_edge> edges = {{0, 2}, {0, 3}, {1, 2}, {2, 4}, {2, 5}, {3, 4}};
+
+    std::vector<t_lb_type_rr_node> lb_type_graph(types.size());
+    for (size_t inode = 0; inode < types.size(); ++inode) {
+        t_lb_type_rr_node& node = lb_type_graph[inode];
+        node.type = types[inode];
+        node.capacity = 1;
+        node.intrinsic_cost = 1;
+        node.num_fanout = new short[1];
+        node.num_fanout[0] = 0;
+        node.outedges = new t_lb_type_rr_node_edge*[1];
+        node.outedges[0] = new t_lb_type_rr_node_edge[edges.size()];
+    }
+    for (const t_test_edge& edge : edges) {
+        t_lb_type_rr_node& node = lb_type_graph[edge.from];
+        node.outedges[0][node.num_fanout[0]].node_index = edge.to;
+        node.outedges[0][node.num_fanout[0]].intrinsic_cost = 1;
+        node.num_fanout[0]++;
+    }
+    return lb_type_graph;
+}
+
+void free_test_lb_type_graph(std::vector<t_lb_type_rr_node>& lb_type_graph) {
+    for (t_lb_type_rr_node& node : lb_type_graph) {
+        delete[] node.outedges[0];
+        delete[] node.outedges;
+        delete[] node.num_fanout;
+    }
+    lb_type_graph.clear();
+}
+
+void add_test_net(t_lb_router_data* router_data, std::vector<int> terminals) {
+    t_intra_lb_net net;
+    net.terminals = terminals;
+    net.atom_pins.resize(terminals.size());
+    net.fixed_terminals.resize(terminals.size(), false);
+    router_data->intra_lb_nets->push_back(net);
+}
+
+//The nodes of each net's saved route tree, with their parents
+std::vector<std::vector<std::pair<int, int>>> saved_routes(const t_lb_router_data* router_data) {
+    std::vector<std::vector<std::pair<int, int>>> routes;
+    for (const t_intra_lb_net& net : *router_data->saved_lb_nets) {
+        routes.emplace_back();
+        for (const t_lb_trace_node& trace_node : net.rt_tree->nodes) {
+            routes.back().emplace_back(trace_node.current_node, trace_node.parent);
+        }
+    }
+    return routes;
+}
+
+} //namespace
+
+TEST_CASE("Cached intra-cluster routes", "[vpr_cluster_router]") {
+    std::vector<t_lb_type_rr_node> lb_type_graph = build_test_lb_type_graph();
+    t_type_descriptor type;
+    type.index = 0;
+
+    t_lb_router_data* router_data = alloc_and_load_router_data(&lb_type_graph, &type);
+    add_test_net(router_data, {0, 4});
+    add_test_net(router_data, {1, 5});
+    add_test_net(router_data, {6});
+
+    free_intra_lb_route_cache();
+
+    //Uncached
+    REQUIRE(try_intra_lb_route(router_data, 0));
+    auto uncached_routes = saved_routes(router_data);
+    REQUIRE(uncached_routes.size() == 3);
+
+    //Net B can only use wire 2, so net A must use wire 3
+    const std::vector<std::pair<int, int>> net_a_route = {{0, OPEN}, {3, 0}, {4, 1}};
+    const std::vector<std::pair<int, int>> net_b_route = {{1, OPEN}, {2, 0}, {5, 1}};
+    REQUIRE(uncached_routes[0] == net_a_route);
+    REQUIRE(uncached_routes[1] == net_b_route);
+
+    for (int iattempt = 0; iattempt < 3; ++iattempt) {
+        //Cached
+        REQUIRE(try_intra_lb_route(router_data, 0));
+        REQUIRE(saved_routes(router_data) == uncached_routes);
+
+        //Uncached again, after other routing attempts
+        free_intra_lb_route_cache();
+        REQUIRE(try_intra_lb_route(router_data, 0));
+        REQUIRE(saved_routes(router_data) == uncached_routes);
+
+        //Occupancy is reset between attempts, including the never-expanded single-terminal net source
+        for (size_t inode = 0; inode < lb_type_graph.size(); ++inode) {
+            REQUIRE(router_data->lb_rr_node_stats[inode].occ <= lb_type_graph[inode].capacity);
+        }
+    }
+
+    free_intra_lb_route_cache();
+    free_router_data(router_data);
+    free_test_lb_type_graph(lb_type_graph);
+}
@@ -0,0 +1,173 @@
+#include "catch.hpp"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "vpr_types.h"
+#include "atom_netlist.h"
+#include "hypergraph_partitioner.h"
+
+namespace {
+
+constexpr int CLUSTER_SIZE = 16;
+constexpr int NUM_INTRA_CLUSTER_SINKS = 3;
+
+//A single-output block with one input per intra-cluster net, plus one for an inter-cluster net
+struct t_test_model {
+    t_test_model() {
+        in_port.dir = IN_PORT;
+        in_port.name = const_cast<char*>("in");
+        in_port.size = NUM_INTRA_CLUSTER_SINKS + 1;
+
+        out_port.dir = OUT_PORT;
+        out_port.name = const_cast<char*>("out");
+        out_port.size = 1;
+
+        model.name = const_cast<char*>("test_lut");
+        model.inputs = &in_port;
+        model.outputs = &out_port;
+    }
+
+    t_model_ports in_port;
+    t_model_ports out_port;
+    t_model model;
+};
+
+std::string block_name(int iblk) {
+    return "blk" + std::to_string(iblk);
+}
+
+//Builds num_clusters clusters of CLUSTER_SIZE blocks.  Each block drives a net which is sunk by the
+//next NUM_INTRA_CLUSTER_SINKS blocks of its cluster (wrapping around), so splitting a cluster cuts
+//several nets.  Each of the given inter-cluster connections is a net from the first block of one
+//cluster sunk by the first block of another, and is the only way the clusters are connected.
+AtomNetlist build_clustered_netlist(const t_test_model& test_model, int num_clusters,
+        const std::vector<std::pair<int, int>>& cluster_connections) {
+    AtomNetlist netlist("test_netlist");
+
+    int num_blocks = num_clusters * CLUSTER_SIZE;
+    std::vector<AtomBlockId> blocks;
+    std::vector<AtomPortId> in_ports;
+    for (int iblk = 0; iblk < num_blocks; ++iblk) {
+        AtomBlockId blk_id = netlist.create_block(block_name(iblk), &test_model.model);
+        blocks.push_back(blk_id);
+        in_ports.push_back(netlist.create_port(blk_id, &test_model.in_port));
+
+        AtomPortId out_port_id = netlist.create_port(blk_id, &test_model.out_port);
+        AtomNetId net_id = netlist.create_net(block_name(iblk));
+        netlist.create_pin(out_port_id, 0, net_id, PinType::DRIVER);
+    }
+
+    for (int iblk = 0; iblk < num_blocks; ++iblk) {
+        int cluster_start = (iblk / CLUSTER_SIZE) * CLUSTER_SIZE;
+        for (int isink = 1; isink <= NUM_INTRA_CLUSTER_SINKS; ++isink) {
+            int sink_blk = cluster_start + (iblk - cluster_start + isink) % CLUSTER_SIZE;
+            AtomNetId net_id = netlist.find_net(block_name(iblk));
+            netlist.create_pin(in_ports[sink_blk], isink - 1, net_id, PinType::SINK);
+        }
+    }
+
+    for (const auto& connection : cluster_connections) {
+        int driver_blk = connection.first * CLUSTER_SIZE;
+        int sink_blk = connection.second * CLUSTER_SIZE;
+        AtomNetId net_id = netlist.find_net(block_name(driver_blk));
+        netlist.create_pin(in_ports[sink_blk], NUM_INTRA_CLUSTER_SINKS, net_id, PinType::SINK);
+    }
+
+    return netlist;
+}
+
+std::vector<int> count_part_blocks(const vtr::vector<AtomBlockId, int>& partitions, int num_parts) {
+    std::vector<int> part_blocks(num_parts, 0);
+    for (int part : partitions) {
+        REQUIRE(part >= 0);
+        REQUIRE(part < num_parts);
+        ++part_blocks[part];
+    }
+    return part_blocks;
+}
+
+}
+
+TEST_CASE("Partitioner bisects along the minimum cut", "[hypergraph_partitioner]") {
+    t_test_model test_model;
+    const std::vector<std::pair<int, int>> cluster_connections = {{0, 1}};
+    AtomNetlist netlist = build_clustered_netlist(test_model, 2, cluster_connections);
+
+    auto partitions = partition_atom_netlist(netlist, 2);
+
+    //Each cluster ends up whole in its own part, so only the connecting net is cut
+    REQUIRE(count_partition_cut_nets(netlist, partitions) == 1);
+
+    auto part_blocks = count_part_blocks(partitions, 2);
+    REQUIRE(part_blocks[0] == CLUSTER_SIZE);
+    REQUIRE(part_blocks[1] == CLUSTER_SIZE);
+    for (auto blk_id : netlist.blocks()) {
+        int cluster_start = (size_t(blk_id) / CLUSTER_SIZE) * CLUSTER_SIZE;
+        REQUIRE(partitions[blk_id] == partitions[AtomBlockId(cluster_start)]);
+    }
+}
+
+TEST_CASE("Partitioner recursive bisection", "[hypergraph_partitioner]") {
+    t_test_model test_model;
+    //A ring of four clusters
+    const std::vector<std::pair<int, int>> cluster_connections = {{0, 1}, {1, 2}, {2, 3}, {3, 0}};
+    AtomNetlist netlist = build_clustered_netlist(test_model, 4, cluster_connections);
+
+    auto partitions = partition_atom_netlist(netlist, 4);
+
+    REQUIRE(count_partition_cut_nets(netlist, partitions) == cluster_connections.size());
+
+    auto part_blocks = count_part_blocks(partitions, 4);
+    for (int num_blocks : part_blocks) {
+        REQUIRE(num_blocks == CLUSTER_SIZE);
+    }
+}
+
+TEST_CASE("Partitioner balance", "[hypergraph_partitioner]") {
+    t_test_model test_model;
+    //Three clusters cannot be split evenly into two parts along cluster boundaries,
+    //so a cluster must be split to keep the parts balanced
+    const std::vector<std::pair<int, int>> cluster_connections = {{0, 1}, {1, 2}};
+    AtomNetlist netlist = build_clustered_netlist(test_model, 3, cluster_connections);
+
+    const int num_blocks = 3 * CLUSTER_SIZE;
+    for (float imbalance : {0.05f, 0.2f}) {
+        auto partitions = partition_atom_netlist(netlist, 2, imbalance);
+
+        //Each part may exceed its even share by the imbalance, or by one block if that is larger
+        int max_part_blocks = std::max(int((1. + imbalance) * num_blocks / 2), num_blocks / 2 + 1);
+        auto part_blocks = count_part_blocks(partitions, 2);
+        REQUIRE(part_blocks[0] <= max_part_blocks);
+        REQUIRE(part_blocks[1] <= max_part_blocks);
+
+        //A cluster is split, but not needlessly: the cut stays well below that of a random split
+        REQUIRE(count_partition_cut_nets(netlist, partitions) > 0);
+        REQUIRE(count_partition_cut_nets(netlist, partitions) <= 2 * NUM_INTRA_CLUSTER_SINKS + cluster_connections.size());
+    }
+}
+
+TEST_CASE("Grown bisection reaches the target weight", "[hypergraph_partitioner]") {
+    //A clique of two-pin nets: the first vertex grown queues every other vertex at once,
+    //so side 0 must keep growing from the queue after every vertex has been visited
+    const int num_vertices = 12;
+    std::vector<std::vector<int>> nets;
+    for (int i = 0; i < num_vertices; ++i) {
+        for (int j = i + 1; j < num_vertices; ++j) {
+            nets.push_back({i, j});
+        }
+    }
+    std::vector<int> net_weights(nets.size(), 1);
+    t_hypergraph hg = build_hypergraph(std::vector<int>(num_vertices, 1), nets, net_weights);
+    REQUIRE(hg.total_weight == num_vertices);
+
+    for (int target_weight : {1, num_vertices / 3, num_vertices / 2}) {
+        const t_side_weights max_side_weights = {{target_weight + 1, num_vertices}};
+        vtr::RandState rand_state = 1;
+        auto sides = grow_bisection(hg, max_side_weights, target_weight, rand_state);
+
+        REQUIRE(sides.size() == size_t(num_vertices));
+        REQUIRE(std::count(sides.begin(), sides.end(), 0) == target_weight);
+    }
+}
@@ -0,0 +1,82 @@
+#include "catch.hpp"
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <iterator>
+
+#include "vpr_error.h"
+#include "route_checkpoint.h"
+
+namespace {
+
+std::string read_file(const std::string& filename) {
+    std::ifstream is(filename, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(is), std::istreambuf_iterator<char>());
+}
+
+void write_file(const std::string& filename, const std::string& contents) {
+    std::ofstream os(filename, std::ios::binary | std::ios::trunc);
+    os.write(contents.data(), contents.size());
+}
+
+} //namespace
+
+TEST_CASE("Checkpoint values", "[vpr_route_checkpoint]") {
+    std::stringstream ss;
+    write_checkpoint_value<uint64_t>(ss, 3);
+    write_checkpoint_value<uint64_t>(ss, 1000);
+
+    SECTION("counts") {
+        REQUIRE(read_checkpoint_count(ss, 3) == 3);
+        REQUIRE(ss);
+
+        //Out of range
+        REQUIRE(read_checkpoint_count(ss, 999) == 0);
+        REQUIRE(!ss);
+    }
+
+    SECTION("truncated") {
+        std::string bytes = ss.str();
+        std::stringstream truncated(bytes.substr(0, sizeof(uint64_t) + 3));
+
+        REQUIRE(read_checkpoint_value<uint64_t>(truncated) == 3);
+        REQUIRE(read_checkpoint_value<uint64_t>(truncated) == 0);
+        REQUIRE(!truncated);
+
+        std::stringstream truncated_count(bytes.substr(0, 5));
+        REQUIRE(read_checkpoint_count(truncated_count, 1000) == 0);
+        REQUIRE(!truncated_count);
+    }
+}
+
+TEST_CASE("Truncated checkpoint", "[vpr_route_checkpoint]") {
+    //Checkpoint the (empty) routing context
+    const std::string filename = "test_route_checkpoint.rcp";
+    t_routing_checkpoint checkpoint;
+    checkpoint.itry = 7;
+    CBRR connections_inf;
+    RoutingPredictor routing_predictor;
+    write_routing_checkpoint(filename, checkpoint, connections_inf, routing_predictor);
+
+    std::string contents = read_file(filename);
+    REQUIRE(!contents.empty());
+
+    SECTION("complete") {
+        t_routing_checkpoint resumed;
+        REQUIRE(read_routing_checkpoint(filename, resumed, connections_inf, routing_predictor));
+        REQUIRE(resumed.itry == 7);
+    }
+
+    SECTION("truncated") {
+        //Every proper prefix is rejected with an error
+        for (size_t len = 0; len < contents.size(); ++len) {
+            write_file(filename, contents.substr(0, len));
+
+            t_routing_checkpoint resumed;
+            REQUIRE_THROWS_AS(read_routing_checkpoint(filename, resumed, connections_inf, routing_predictor), const VprError&);
+        }
+    }
+
+    std::remove(filename.c_str());
+}